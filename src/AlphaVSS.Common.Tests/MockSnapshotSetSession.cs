@@ -0,0 +1,276 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   /// <summary>
+   ///     Simulates the VSS backend used by the sessions of a <see cref="VssSnapshotOrchestrator"/>. Every call is recorded in
+   ///     <see cref="Events"/>, and each operation can be delayed or made to fail.
+   /// </summary>
+   internal sealed class MockSnapshotSetBackend
+   {
+      #region Private Fields
+
+      private readonly object m_lock = new object();
+      private readonly List<string> m_events = new List<string>();
+      private readonly List<MockSnapshotSetSession> m_sessions = new List<MockSnapshotSetSession>();
+
+      #endregion
+
+      #region Constructor
+
+      public MockSnapshotSetBackend()
+      {
+         MaximumVolumesPerSet = VssSnapshotOrchestrator.DefaultMaximumVolumesPerSet;
+      }
+
+      #endregion
+
+      #region Properties
+
+      // The number of volumes a shadow copy set accepts before AddToSnapshotSet throws VssMaximumNumberOfVolumesReachedException.
+      public int MaximumVolumesPerSet { get; set; }
+
+      public TimeSpan InitializeLatency { get; set; }
+
+      public TimeSpan AddToSnapshotSetLatency { get; set; }
+
+      public TimeSpan PrepareForBackupLatency { get; set; }
+
+      public TimeSpan DoSnapshotSetLatency { get; set; }
+
+      // Each failure function receives the number of the session, starting at one, and returns the exception to throw, or null.
+
+      public Func<int, Exception> InitializeFailure { get; set; }
+
+      public Func<int, string, Exception> AddToSnapshotSetFailure { get; set; }
+
+      public Func<int, Exception> DoSnapshotSetFailure { get; set; }
+
+      public Func<int, Exception> AbortBackupFailure { get; set; }
+
+      public Func<int, Exception> DisposeFailure { get; set; }
+
+      public IList<MockSnapshotSetSession> Sessions
+      {
+         get
+         {
+            lock (m_lock)
+            {
+               return m_sessions.ToList();
+            }
+         }
+      }
+
+      // The recorded calls, in the form "<session>.<method>" or "<session>.<method>.Begin" and "<session>.<method>.End" for
+      // the methods that have a latency.
+      public IList<string> Events
+      {
+         get
+         {
+            lock (m_lock)
+            {
+               return m_events.ToList();
+            }
+         }
+      }
+
+      #endregion
+
+      #region Methods
+
+      public IVssSnapshotSetSession CreateSession()
+      {
+         lock (m_lock)
+         {
+            MockSnapshotSetSession session = new MockSnapshotSetSession(this, m_sessions.Count + 1);
+            m_sessions.Add(session);
+            return session;
+         }
+      }
+
+      public int IndexOf(string e)
+      {
+         int index = Events.IndexOf(e);
+         if (index == -1)
+            throw new InvalidOperationException(String.Format("The event \"{0}\" was not recorded.", e));
+
+         return index;
+      }
+
+      internal void Record(int session, string e)
+      {
+         lock (m_lock)
+         {
+            m_events.Add(session + "." + e);
+         }
+      }
+
+      #endregion
+   }
+
+   internal sealed class MockSnapshotSetSession : IVssSnapshotSetSession
+   {
+      #region Private Fields
+
+      private readonly MockSnapshotSetBackend m_backend;
+      private readonly List<string> m_volumes = new List<string>();
+      private readonly HashSet<int> m_callerThreadIds = new HashSet<int>();
+      private int m_activeCalls;
+
+      #endregion
+
+      #region Constructor
+
+      public MockSnapshotSetSession(MockSnapshotSetBackend backend, int number)
+      {
+         m_backend = backend;
+         Number = number;
+         CreationThreadId = Thread.CurrentThread.ManagedThreadId;
+      }
+
+      #endregion
+
+      #region Properties
+
+      public int Number { get; private set; }
+
+      public int CreationThreadId { get; private set; }
+
+      public int InitializeThreadId { get; private set; }
+
+      // The threads on which the methods other than Initialize were called.
+      public ICollection<int> CallerThreadIds
+      {
+         get
+         {
+            lock (m_callerThreadIds)
+            {
+               return m_callerThreadIds.ToList();
+            }
+         }
+      }
+
+      public IList<string> Volumes
+      {
+         get
+         {
+            return m_volumes.AsReadOnly();
+         }
+      }
+
+      public bool IsAborted { get; private set; }
+
+      public bool IsDisposed { get; private set; }
+
+      public bool ConcurrentCallDetected { get; private set; }
+
+      #endregion
+
+      #region IVssSnapshotSetSession Members
+
+      public void Initialize()
+      {
+         InitializeThreadId = Thread.CurrentThread.ManagedThreadId;
+         Invoke("Initialize", m_backend.InitializeLatency, m_backend.InitializeFailure);
+      }
+
+      public Guid StartSnapshotSet()
+      {
+         Invoke("StartSnapshotSet", TimeSpan.Zero, null);
+         return Guid.NewGuid();
+      }
+
+      public Guid AddToSnapshotSet(string volumeName, Guid providerId)
+      {
+         Func<int, string, Exception> failure = m_backend.AddToSnapshotSetFailure;
+         Invoke("AddToSnapshotSet", m_backend.AddToSnapshotSetLatency, number =>
+            {
+               if (m_volumes.Count >= m_backend.MaximumVolumesPerSet)
+                  return new VssMaximumNumberOfVolumesReachedException();
+
+               return failure == null ? null : failure(number, volumeName);
+            });
+
+         m_volumes.Add(volumeName);
+         return Guid.NewGuid();
+      }
+
+      public void PrepareForBackup()
+      {
+         Invoke("PrepareForBackup", m_backend.PrepareForBackupLatency, null);
+      }
+
+      public void DoSnapshotSet()
+      {
+         Invoke("DoSnapshotSet", m_backend.DoSnapshotSetLatency, m_backend.DoSnapshotSetFailure);
+      }
+
+      public void AbortBackup()
+      {
+         IsAborted = true;
+         Invoke("AbortBackup", TimeSpan.Zero, m_backend.AbortBackupFailure);
+      }
+
+      public void Dispose()
+      {
+         if (IsDisposed)
+            return;
+
+         IsDisposed = true;
+         Invoke("Dispose", TimeSpan.Zero, m_backend.DisposeFailure, false);
+      }
+
+      #endregion
+
+      #region Private Members
+
+      private void Invoke(string method, TimeSpan latency, Func<int, Exception> failure)
+      {
+         if (IsDisposed)
+            throw new ObjectDisposedException(GetType().FullName);
+
+         Invoke(method, latency, failure, true);
+      }
+
+      private void Invoke(string method, TimeSpan latency, Func<int, Exception> failure, bool recordThread)
+      {
+         if (recordThread && method != "Initialize")
+         {
+            lock (m_callerThreadIds)
+            {
+               m_callerThreadIds.Add(Thread.CurrentThread.ManagedThreadId);
+            }
+         }
+
+         if (Interlocked.Increment(ref m_activeCalls) > 1)
+            ConcurrentCallDetected = true;
+
+         try
+         {
+            if (latency > TimeSpan.Zero)
+            {
+               m_backend.Record(Number, method + ".Begin");
+               Thread.Sleep(latency);
+               m_backend.Record(Number, method + ".End");
+            }
+            else
+            {
+               m_backend.Record(Number, method);
+            }
+
+            Exception exception = failure == null ? null : failure(Number);
+            if (exception != null)
+               throw exception;
+         }
+         finally
+         {
+            Interlocked.Decrement(ref m_activeCalls);
+         }
+      }
+
+      #endregion
+   }
+}
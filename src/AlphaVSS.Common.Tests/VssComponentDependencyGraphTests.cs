@@ -0,0 +1,174 @@
+using System;
+using System.Collections.Generic;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   [TestClass]
+   public class VssComponentDependencyGraphTests
+   {
+      private static readonly Guid s_writerA = new Guid("8d4dd8a7-39a6-4e8e-9c5b-2a0d3f1b7c01");
+      private static readonly Guid s_writerB = new Guid("8d4dd8a7-39a6-4e8e-9c5b-2a0d3f1b7c02");
+      private static readonly Guid s_instanceA = new Guid("1f0e3c55-8b2d-4a57-a6f1-0c9e2b7d4e01");
+      private static readonly Guid s_instanceB1 = new Guid("1f0e3c55-8b2d-4a57-a6f1-0c9e2b7d4e02");
+      private static readonly Guid s_instanceB2 = new Guid("1f0e3c55-8b2d-4a57-a6f1-0c9e2b7d4e03");
+
+      #region Diamond
+
+      [TestMethod]
+      public void Diamond_ExpandSelection_OrdersEveryComponentAfterItsDependencies()
+      {
+         // top -> left, right; left -> bottom; right -> bottom
+         VssComponentDependencyGraph graph = VssComponentDependencyGraph.Create(new[]
+         {
+            Component(s_instanceA, s_writerA, "top", Dependency(s_writerA, "left"), Dependency(s_writerA, "right")),
+            Component(s_instanceA, s_writerA, "left", Dependency(s_writerA, "bottom")),
+            Component(s_instanceA, s_writerA, "right", Dependency(s_writerA, "bottom")),
+            Component(s_instanceA, s_writerA, "bottom"),
+         });
+
+         int top = Find(graph, s_instanceA, "top");
+         int left = Find(graph, s_instanceA, "left");
+         int right = Find(graph, s_instanceA, "right");
+         int bottom = Find(graph, s_instanceA, "bottom");
+
+         Assert.IsFalse(graph.HasCycles);
+
+         IList<int> expanded = graph.ExpandSelection(new[] { top });
+         Assert.AreEqual(4, expanded.Count);
+         Assert.AreEqual(bottom, expanded[0]);
+         Assert.AreEqual(top, expanded[3]);
+         Assert.IsTrue(expanded.IndexOf(left) > 0 && expanded.IndexOf(left) < 3);
+         Assert.IsTrue(expanded.IndexOf(right) > 0 && expanded.IndexOf(right) < 3);
+      }
+
+      [TestMethod]
+      public void Diamond_GetTransitiveDependencies_ReturnsSharedDependencyOnce()
+      {
+         VssComponentDependencyGraph graph = VssComponentDependencyGraph.Create(new[]
+         {
+            Component(s_instanceA, s_writerA, "top", Dependency(s_writerA, "left"), Dependency(s_writerA, "right")),
+            Component(s_instanceA, s_writerA, "left", Dependency(s_writerA, "bottom")),
+            Component(s_instanceA, s_writerA, "right", Dependency(s_writerA, "bottom")),
+            Component(s_instanceA, s_writerA, "bottom"),
+         });
+
+         IList<int> dependencies = graph.GetTransitiveDependencies(Find(graph, s_instanceA, "top"));
+
+         Assert.AreEqual(3, dependencies.Count);
+         Assert.AreEqual(Find(graph, s_instanceA, "bottom"), dependencies[0]);
+         Assert.IsFalse(dependencies.Contains(Find(graph, s_instanceA, "top")));
+      }
+
+      #endregion
+
+      #region Cycles
+
+      [TestMethod]
+      public void Cycle_IsDetectedAndOrderedBeforeDependents()
+      {
+         // first <-> second; dependent -> first
+         VssComponentDependencyGraph graph = VssComponentDependencyGraph.Create(new[]
+         {
+            Component(s_instanceA, s_writerA, "dependent", Dependency(s_writerA, "first")),
+            Component(s_instanceA, s_writerA, "first", Dependency(s_writerA, "second")),
+            Component(s_instanceA, s_writerA, "second", Dependency(s_writerA, "first")),
+         });
+
+         int dependent = Find(graph, s_instanceA, "dependent");
+         int first = Find(graph, s_instanceA, "first");
+         int second = Find(graph, s_instanceA, "second");
+
+         Assert.IsTrue(graph.HasCycles);
+         Assert.AreEqual(1, graph.Cycles.Count);
+         CollectionAssert.AreEqual(new[] { first, second }, new List<int>(graph.Cycles[0]));
+
+         IList<int> order = graph.DependencyOrder;
+         Assert.IsTrue(order.IndexOf(first) < order.IndexOf(dependent));
+         Assert.IsTrue(order.IndexOf(second) < order.IndexOf(dependent));
+
+         // A member of a cycle depends on itself, indirectly.
+         CollectionAssert.AreEquivalent(new[] { first, second }, new List<int>(graph.GetTransitiveDependencies(first)));
+      }
+
+      [TestMethod]
+      public void Cycle_SelfDependencyFormsCycleOnItsOwn()
+      {
+         VssComponentDependencyGraph graph = VssComponentDependencyGraph.Create(new[]
+         {
+            Component(s_instanceA, s_writerA, "self", Dependency(s_writerA, "self")),
+            Component(s_instanceA, s_writerA, "other"),
+         });
+
+         int self = Find(graph, s_instanceA, "self");
+
+         Assert.AreEqual(1, graph.Cycles.Count);
+         CollectionAssert.AreEqual(new[] { self }, new List<int>(graph.Cycles[0]));
+         CollectionAssert.AreEqual(new[] { self }, new List<int>(graph.ExpandSelection(new[] { self })));
+      }
+
+      #endregion
+
+      #region Missing Dependencies
+
+      [TestMethod]
+      public void MissingDependency_IsReportedAsUnresolvedAndIgnored()
+      {
+         VssComponentDependencyGraph graph = VssComponentDependencyGraph.Create(new[]
+         {
+            Component(s_instanceA, s_writerA, "component", Dependency(s_writerA, "present"), Dependency(s_writerB, "missing")),
+            Component(s_instanceA, s_writerA, "present"),
+         });
+
+         int component = Find(graph, s_instanceA, "component");
+
+         Assert.IsFalse(graph.HasCycles);
+         CollectionAssert.AreEqual(new[] { Find(graph, s_instanceA, "present") }, new List<int>(graph.GetDependencies(component)));
+
+         IList<VssWMDependency> unresolved = graph.GetUnresolvedDependencies(component);
+         Assert.AreEqual(1, unresolved.Count);
+         Assert.AreEqual(s_writerB, unresolved[0].WriterId);
+         Assert.AreEqual("missing", unresolved[0].ComponentName);
+
+         Assert.AreEqual(2, graph.ExpandSelection(new[] { component }).Count);
+      }
+
+      [TestMethod]
+      public void Dependency_ResolvesToEveryInstanceOfTheWriter()
+      {
+         VssComponentDependencyGraph graph = VssComponentDependencyGraph.Create(new[]
+         {
+            Component(s_instanceA, s_writerA, "component", Dependency(s_writerB, "shared")),
+            Component(s_instanceB1, s_writerB, "shared"),
+            Component(s_instanceB2, s_writerB, "shared"),
+         });
+
+         CollectionAssert.AreEquivalent(new[] { Find(graph, s_instanceB1, "shared"), Find(graph, s_instanceB2, "shared") },
+            new List<int>(graph.GetDependencies(Find(graph, s_instanceA, "component"))));
+         Assert.AreEqual(0, graph.GetUnresolvedDependencies(Find(graph, s_instanceA, "component")).Count);
+      }
+
+      #endregion
+
+      #region Helpers
+
+      private static VssDependencyGraphComponent Component(Guid instanceId, Guid writerId, string name, params VssWMDependency[] dependencies)
+      {
+         return new VssDependencyGraphComponent(instanceId, writerId, VssComponentType.Database, "Root", name, dependencies);
+      }
+
+      private static VssWMDependency Dependency(Guid writerId, string name)
+      {
+         return new VssWMDependency(writerId, "Root", name);
+      }
+
+      private static int Find(VssComponentDependencyGraph graph, Guid instanceId, string name)
+      {
+         int id = graph.FindComponent(instanceId, "Root", name);
+         Assert.IsTrue(id >= 0, "Component {0} not found.", name);
+         return id;
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,243 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   [TestClass]
+   public class VssComponentTreeTests
+   {
+      public TestContext TestContext { get; set; }
+
+      private sealed class TestComponent
+      {
+         public TestComponent(string fullPath, bool isSelectable)
+         {
+            FullPath = fullPath;
+            IsSelectable = isSelectable;
+         }
+
+         public string FullPath { get; private set; }
+         public bool IsSelectable { get; private set; }
+
+         public override string ToString()
+         {
+            return FullPath;
+         }
+      }
+
+      [TestMethod]
+      public void Constructor_SmallTree_LinksNearestAncestors()
+      {
+         TestComponent sql = new TestComponent(@"\Sql", false);
+         TestComponent master = new TestComponent(@"\sql\Instance\master", true);
+         TestComponent model = new TestComponent(@"\SQL\Instance\model\", true);
+         TestComponent modelLog = new TestComponent(@"\Sql\Instance\model\Log", false);
+         TestComponent sqlOther = new TestComponent(@"\SqlOther", false);
+         VssComponentTree<TestComponent> tree = CreateTree(sql, master, model, modelLog, sqlOther);
+
+         CollectionAssert.AreEqual(new[] { sql, sqlOther }, tree.Roots.ToList());
+         CollectionAssert.AreEqual(new[] { sql, master, model, modelLog, sqlOther }, tree.PreOrder.ToList());
+
+         // "\Sql\Instance" is not a component, so the components below it are children of "\Sql".
+         Assert.AreSame(sql, tree.GetParent(master));
+         Assert.AreSame(model, tree.GetParent(modelLog));
+         Assert.IsNull(tree.GetParent(sqlOther));
+         CollectionAssert.AreEqual(new[] { master, model }, tree.GetChildren(sql).ToList());
+         CollectionAssert.AreEqual(new[] { model, sql }, tree.GetAncestors(modelLog).ToList());
+         CollectionAssert.AreEqual(new[] { master, model, modelLog }, tree.GetDescendants(sql).ToList());
+         Assert.AreEqual(0, tree.GetDescendants(sqlOther).Count);
+
+         Assert.IsTrue(tree.IsAncestorOf(sql, modelLog));
+         Assert.IsFalse(tree.IsAncestorOf(modelLog, sql));
+         Assert.IsFalse(tree.IsAncestorOf(sql, sql));
+         Assert.IsFalse(tree.IsAncestorOf(sql, sqlOther));
+
+         Assert.AreSame(model, tree.Find(@"\sql\instance\MODEL"));
+         Assert.AreSame(model, tree.Find(@"\Sql\Instance\model\\"));
+         Assert.IsNull(tree.Find(@"\Sql\Instance"));
+         Assert.IsNull(tree.Find(null));
+      }
+
+      [TestMethod]
+      public void CanBeExplicitlyIncluded_SelectableOrTopLevel_ReturnsTrue()
+      {
+         TestComponent root = new TestComponent(@"\Root", false);
+         TestComponent selectable = new TestComponent(@"\Root\Selectable", true);
+         TestComponent fixedChild = new TestComponent(@"\Root\Selectable\Fixed", false);
+         TestComponent selectableRoot = new TestComponent(@"\Other", true);
+         VssComponentTree<TestComponent> tree = CreateTree(root, selectable, fixedChild, selectableRoot);
+
+         Assert.IsTrue(tree.CanBeExplicitlyIncluded(root));
+         Assert.IsTrue(tree.CanBeExplicitlyIncluded(selectable));
+         Assert.IsFalse(tree.CanBeExplicitlyIncluded(fixedChild));
+         Assert.IsTrue(tree.CanBeExplicitlyIncluded(selectableRoot));
+      }
+
+      [TestMethod]
+      public void Constructor_InvalidComponents_ThrowsArgumentException()
+      {
+         TestComponent component = new TestComponent(@"\A", true);
+         AssertThrows<ArgumentNullException>(() => new VssComponentTree<TestComponent>(null, c => c.FullPath, c => c.IsSelectable));
+         AssertThrows<ArgumentNullException>(() => new VssComponentTree<TestComponent>(new TestComponent[0], null, c => c.IsSelectable));
+         AssertThrows<ArgumentNullException>(() => new VssComponentTree<TestComponent>(new TestComponent[0], c => c.FullPath, null));
+         AssertThrows<ArgumentException>(() => CreateTree(component, null));
+         AssertThrows<ArgumentException>(() => CreateTree(component, component));
+         AssertThrows<ArgumentException>(() => CreateTree(new TestComponent(null, true)));
+
+         VssComponentTree<TestComponent> tree = CreateTree(component);
+         AssertThrows<ArgumentNullException>(() => tree.GetParent(null));
+         AssertThrows<ArgumentException>(() => tree.GetChildren(new TestComponent(@"\A", true)));
+         AssertThrows<ArgumentException>(() => tree.GetAncestors(new TestComponent(@"\B", true)));
+      }
+
+      [TestMethod]
+      public void Queries_LargeSyntheticTree_MatchPathPrefixes()
+      {
+         List<TestComponent> components = CreateSyntheticComponents(10000, 1);
+         VssComponentTree<TestComponent> tree = CreateTree(components.ToArray());
+         Dictionary<TestComponent, int> position = tree.PreOrder.Select((c, i) => new KeyValuePair<TestComponent, int>(c, i)).ToDictionary(p => p.Key, p => p.Value);
+
+         Assert.AreEqual(components.Count, tree.PreOrder.Count);
+         Assert.AreEqual(components.Count, position.Count);
+
+         Random random = new Random(2);
+         for (int i = 0; i < 200; i++)
+         {
+            TestComponent component = components[random.Next(components.Count)];
+
+            // The ancestors are exactly the components whose path is a proper prefix ending at a backslash.
+            List<TestComponent> expectedAncestors = components.Where(c => IsPathPrefix(c.FullPath, component.FullPath)).OrderByDescending(c => c.FullPath.Length).ToList();
+            CollectionAssert.AreEqual(expectedAncestors, tree.GetAncestors(component).ToList());
+            Assert.AreSame(expectedAncestors.FirstOrDefault(), tree.GetParent(component));
+            Assert.AreEqual(expectedAncestors.Count == 0 || component.IsSelectable, tree.CanBeExplicitlyIncluded(component));
+
+            List<TestComponent> expectedDescendants = components.Where(c => IsPathPrefix(component.FullPath, c.FullPath)).OrderBy(c => position[c]).ToList();
+            CollectionAssert.AreEqual(expectedDescendants, tree.GetDescendants(component).ToList());
+            CollectionAssert.AreEqual(expectedDescendants.Where(c => tree.GetParent(c) == component).ToList(), tree.GetChildren(component).ToList());
+
+            // Every component precedes its descendants in pre-order.
+            foreach (TestComponent descendant in expectedDescendants)
+               Assert.IsTrue(position[component] < position[descendant]);
+
+            TestComponent other = components[random.Next(components.Count)];
+            Assert.AreEqual(IsPathPrefix(component.FullPath, other.FullPath), tree.IsAncestorOf(component, other));
+            Assert.AreSame(component, tree.Find(component.FullPath.ToUpperInvariant()));
+         }
+      }
+
+      [TestMethod]
+      public void Constructor_DeepChain_DoesNotOverflowStack()
+      {
+         const int depth = 5000;
+         List<TestComponent> components = new List<TestComponent>(depth);
+         string path = String.Empty;
+         for (int i = 0; i < depth; i++)
+         {
+            path += @"\c";
+            components.Add(new TestComponent(path, i % 2 == 0));
+         }
+
+         VssComponentTree<TestComponent> tree = CreateTree(components.ToArray());
+
+         Assert.AreEqual(1, tree.Roots.Count);
+         Assert.AreEqual(depth - 1, tree.GetDescendants(components[0]).Count);
+         Assert.IsTrue(tree.IsAncestorOf(components[0], components[depth - 1]));
+         Assert.AreSame(components[depth - 2], tree.GetParent(components[depth - 1]));
+      }
+
+      [TestMethod, TestCategory("Benchmark")]
+      public void Benchmark_BuildAndQuery50000Components()
+      {
+         List<TestComponent> components = CreateSyntheticComponents(50000, 3);
+
+         Stopwatch stopwatch = Stopwatch.StartNew();
+         VssComponentTree<TestComponent> tree = CreateTree(components.ToArray());
+         TimeSpan build = stopwatch.Elapsed;
+
+         const int queries = 1000000;
+         Random random = new Random(4);
+         int ancestors = 0;
+         stopwatch.Restart();
+         for (int i = 0; i < queries; i++)
+         {
+            if (tree.IsAncestorOf(components[random.Next(components.Count)], components[random.Next(components.Count)]))
+               ancestors++;
+         }
+         TimeSpan isAncestorOf = stopwatch.Elapsed;
+
+         stopwatch.Restart();
+         int includable = 0;
+         foreach (TestComponent component in components)
+         {
+            if (tree.CanBeExplicitlyIncluded(component) && tree.Find(component.FullPath) == component)
+               includable++;
+         }
+         TimeSpan lookup = stopwatch.Elapsed;
+
+         TestContext.WriteLine("{0:N0} components, {1:N0} roots", components.Count, tree.Roots.Count);
+         TestContext.WriteLine("Build {0:F1} ms, IsAncestorOf {1:F3} us ({2:N0} hits), Find and CanBeExplicitlyIncluded {3:F3} us ({4:N0} includable)",
+            build.TotalMilliseconds, isAncestorOf.TotalMilliseconds * 1000 / queries, ancestors, lookup.TotalMilliseconds * 1000 / components.Count, includable);
+      }
+
+      #region Helpers
+
+      private static VssComponentTree<TestComponent> CreateTree(params TestComponent[] components)
+      {
+         return new VssComponentTree<TestComponent>(components, c => c.FullPath, c => c.IsSelectable);
+      }
+
+      // Creates components in random order, each below a random earlier path. Some paths have a trailing backslash, and one in
+      // eight paths is only used as an intermediate path, so that the parent of some components is not the immediate prefix.
+      private static List<TestComponent> CreateSyntheticComponents(int count, int seed)
+      {
+         Random random = new Random(seed);
+         List<string> paths = new List<string> { String.Empty };
+         List<TestComponent> components = new List<TestComponent>(count);
+         while (components.Count < count)
+         {
+            string path = paths[random.Next(paths.Count)] + @"\Component" + paths.Count;
+            paths.Add(path);
+            if (random.Next(8) == 0)
+               continue;
+
+            components.Add(new TestComponent(random.Next(4) == 0 ? path + @"\" : path, random.Next(3) == 0));
+         }
+
+         for (int i = components.Count - 1; i > 0; i--)
+         {
+            int j = random.Next(i + 1);
+            TestComponent swap = components[i];
+            components[i] = components[j];
+            components[j] = swap;
+         }
+
+         return components;
+      }
+
+      private static bool IsPathPrefix(string ancestor, string descendant)
+      {
+         ancestor = ancestor.TrimEnd('\\') + @"\";
+         descendant = descendant.TrimEnd('\\');
+         return descendant.Length > ancestor.Length && descendant.StartsWith(ancestor, StringComparison.OrdinalIgnoreCase);
+      }
+
+      private static void AssertThrows<T>(Action action) where T : Exception
+      {
+         try
+         {
+            action();
+         }
+         catch (T)
+         {
+            return;
+         }
+
+         Assert.Fail("Expected " + typeof(T).Name + ".");
+      }
+
+      #endregion
+   }
+}
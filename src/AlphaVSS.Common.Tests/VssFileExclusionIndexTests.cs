@@ -0,0 +1,187 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Runtime.Serialization.Formatters.Binary;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   [TestClass]
+   public class VssFileExclusionIndexTests
+   {
+      private static readonly Guid SearchInstanceId = new Guid("11111111-2222-3333-4444-555555555555");
+      private static readonly Guid SearchWriterId = new Guid("cd3f2362-8bef-46c7-9181-d62844cdc0b2");
+      private static readonly Guid ShadowInstanceId = new Guid("66666666-7777-8888-9999-000000000000");
+      private static readonly Guid ShadowWriterId = new Guid("e8132975-6f93-4464-a53e-1050253ae220");
+
+      [TestMethod]
+      public void Create_WriterMetadata_ReportsExcludingWriter()
+      {
+         VssFileExclusionIndex index = CreateIndex();
+
+         Assert.AreEqual(4, index.Exclusions.Count);
+
+         VssFileExclusion search = index.FindExclusion(@"C:\ProgramData\Search\Data\catalog.edb");
+         Assert.AreEqual(SearchInstanceId, search.InstanceId);
+         Assert.AreEqual(SearchWriterId, search.WriterId);
+         Assert.AreEqual("Search Writer", search.WriterName);
+         Assert.IsFalse(search.IsExcludedFromSnapshot);
+
+         VssFileExclusion shadow = index.FindExclusion(@"C:\pagefile.sys");
+         Assert.AreEqual(ShadowInstanceId, shadow.InstanceId);
+         Assert.AreEqual(ShadowWriterId, shadow.WriterId);
+         Assert.AreEqual("Shadow Copy Optimization Writer", shadow.WriterName);
+         Assert.IsTrue(shadow.IsExcludedFromSnapshot);
+
+         Assert.IsTrue(index.IsExcluded(@"c:\programdata\search\DATA\Temp\x.LOG"));
+         Assert.IsFalse(index.IsExcluded(@"C:\ProgramData\Other\catalog.edb"));
+         Assert.IsNull(index.FindExclusion(@"C:\Users\file.txt"));
+      }
+
+      [TestMethod]
+      public void FindExclusion_OverlappingSpecifications_ReturnsFirstExclusion()
+      {
+         VssFileExclusionIndex index = CreateIndex();
+
+         // "C:\ProgramData\Search\Data\*.log" is excluded from backup by the search writer, and the recursive exclusion
+         // of "C:\ProgramData\Search\*.log" from shadow copies, which occurs later, covers the same files.
+         VssFileExclusion log = index.FindExclusion(@"C:\ProgramData\Search\Data\Applications.log");
+         Assert.AreSame(index.Exclusions[1], log);
+         Assert.AreEqual("Search Writer", log.WriterName);
+
+         VssFileExclusion nestedLog = index.FindExclusion(@"C:\ProgramData\Search\Logs\Gather.log");
+         Assert.AreSame(index.Exclusions[3], nestedLog);
+         Assert.AreEqual("Shadow Copy Optimization Writer", nestedLog.WriterName);
+
+         VssFileExclusion[] exclusions = index.FindExclusions(@"C:\ProgramData\Search\Data", new[] { "catalog.edb", "Applications.log", "readme.txt" });
+         Assert.AreSame(index.Exclusions[0], exclusions[0]);
+         Assert.AreSame(index.Exclusions[1], exclusions[1]);
+         Assert.IsNull(exclusions[2]);
+      }
+
+      [TestMethod]
+      public void Deserialize_SerializedIndex_ReturnsEquivalentIndex()
+      {
+         VssFileExclusionIndex original = CreateIndex();
+
+         VssFileExclusionIndex copy;
+         using (MemoryStream stream = new MemoryStream())
+         {
+            BinaryFormatter formatter = new BinaryFormatter();
+            formatter.Serialize(stream, original);
+            stream.Position = 0;
+            copy = (VssFileExclusionIndex)formatter.Deserialize(stream);
+         }
+
+         Assert.AreEqual(original.Exclusions.Count, copy.Exclusions.Count);
+         for (int i = 0; i < original.Exclusions.Count; i++)
+         {
+            VssFileExclusion expected = original.Exclusions[i];
+            VssFileExclusion actual = copy.Exclusions[i];
+            Assert.AreEqual(expected.InstanceId, actual.InstanceId);
+            Assert.AreEqual(expected.WriterId, actual.WriterId);
+            Assert.AreEqual(expected.WriterName, actual.WriterName);
+            Assert.AreEqual(expected.IsExcludedFromSnapshot, actual.IsExcludedFromSnapshot);
+            Assert.AreEqual(expected.FileDescriptor.Path, actual.FileDescriptor.Path);
+            Assert.AreEqual(expected.FileDescriptor.FileSpecification, actual.FileDescriptor.FileSpecification);
+            Assert.AreEqual(expected.FileDescriptor.IsRecursive, actual.FileDescriptor.IsRecursive);
+         }
+
+         foreach (string path in new[] { @"C:\ProgramData\Search\Data\catalog.edb", @"C:\ProgramData\Search\Logs\Gather.log", @"C:\pagefile.sys", @"C:\Users\file.txt" })
+         {
+            VssFileExclusion expected = original.FindExclusion(path);
+            VssFileExclusion actual = copy.FindExclusion(path);
+            Assert.AreEqual(expected == null ? -1 : original.Exclusions.IndexOf(expected), actual == null ? -1 : copy.Exclusions.IndexOf(actual));
+         }
+      }
+
+      [TestMethod]
+      public void Create_NullWriter_ThrowsArgumentException()
+      {
+         try
+         {
+            VssFileExclusionIndex.Create(new IVssExamineWriterMetadata[] { null });
+            Assert.Fail("Expected ArgumentException.");
+         }
+         catch (ArgumentException)
+         {
+         }
+      }
+
+      #region Helpers
+
+      private static VssFileExclusionIndex CreateIndex()
+      {
+         MockWriterMetadata search = new MockWriterMetadata(SearchInstanceId, SearchWriterId, "Search Writer");
+         search.ExcludeFiles.Add(CreateFile(@"C:\ProgramData\Search\Data", "*.edb", false));
+         search.ExcludeFiles.Add(CreateFile(@"C:\ProgramData\Search\Data", "*.log", true));
+
+         MockWriterMetadata shadow = new MockWriterMetadata(ShadowInstanceId, ShadowWriterId, "Shadow Copy Optimization Writer");
+         shadow.ExcludeFromSnapshotFiles.Add(CreateFile(@"C:\", "pagefile.sys", false));
+         shadow.ExcludeFromSnapshotFiles.Add(CreateFile(@"C:\ProgramData\Search", "*.log", true));
+
+         return VssFileExclusionIndex.Create(new IVssExamineWriterMetadata[] { search, shadow });
+      }
+
+      private static VssWMFileDescriptor CreateFile(string path, string fileSpecification, bool isRecursive)
+      {
+         return new VssWMFileDescriptor(null, VssFileSpecificationBackupType.FullBackupRequired, fileSpecification, path, isRecursive);
+      }
+
+      // Writer metadata providing only the identity and the excluded files of a writer.
+      private sealed class MockWriterMetadata : IVssExamineWriterMetadata
+      {
+         private readonly List<VssWMFileDescriptor> m_excludeFiles = new List<VssWMFileDescriptor>();
+         private readonly List<VssWMFileDescriptor> m_excludeFromSnapshotFiles = new List<VssWMFileDescriptor>();
+
+         public MockWriterMetadata(Guid instanceId, Guid writerId, string writerName)
+         {
+            InstanceId = instanceId;
+            WriterId = writerId;
+            WriterName = writerName;
+         }
+
+         public Guid InstanceId { get; private set; }
+         public Guid WriterId { get; private set; }
+         public string WriterName { get; private set; }
+
+         public IList<VssWMFileDescriptor> ExcludeFiles { get { return m_excludeFiles; } }
+         public IList<VssWMFileDescriptor> ExcludeFromSnapshotFiles { get { return m_excludeFromSnapshotFiles; } }
+
+         public string InstanceName { get { return null; } }
+         public VssUsageType Usage { get { return VssUsageType.Undefined; } }
+         public VssSourceType Source { get { return VssSourceType.Undefined; } }
+         public VssBackupSchema BackupSchema { get { return VssBackupSchema.Undefined; } }
+         public Version Version { get { return new Version(1, 0); } }
+         public VssWMRestoreMethod RestoreMethod { get { return null; } }
+         public IList<VssWMFileDescriptor> AlternateLocationMappings { get { return new VssWMFileDescriptor[0]; } }
+         public IList<IVssWMComponent> Components { get { return new IVssWMComponent[0]; } }
+
+         public bool LoadFromXml(string xml)
+         {
+            throw new NotSupportedException();
+         }
+
+         public bool LoadFromXml(Stream stream, VssXmlStreamFormat format)
+         {
+            throw new NotSupportedException();
+         }
+
+         public string SaveAsXml()
+         {
+            throw new NotSupportedException();
+         }
+
+         public void SaveAsXml(Stream stream, VssXmlStreamFormat format)
+         {
+            throw new NotSupportedException();
+         }
+
+         public void Dispose()
+         {
+         }
+      }
+
+      #endregion
+   }
+}
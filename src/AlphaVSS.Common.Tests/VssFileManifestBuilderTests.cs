@@ -0,0 +1,211 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   [TestClass]
+   public class VssFileManifestBuilderTests
+   {
+      // The volume the file descriptors refer to, which is mapped to a temporary directory standing in for the shadow copy.
+      private const string Volume = @"X:\";
+
+      private string m_root;
+
+      public TestContext TestContext { get; set; }
+
+      [TestInitialize]
+      public void Initialize()
+      {
+         m_root = Path.Combine(Path.GetTempPath(), "VssFileManifestBuilderTests-" + Guid.NewGuid().ToString("N"));
+         Directory.CreateDirectory(m_root);
+      }
+
+      [TestCleanup]
+      public void Cleanup()
+      {
+         Directory.Delete(m_root, true);
+      }
+
+      [TestMethod]
+      public void Build_OverlappingComponents_ListsFilesOfFirstOwningComponent()
+      {
+         CreateFile(@"Data\a.mdf", 10);
+         CreateFile(@"Data\a.ldf", 20);
+         CreateFile(@"Data\Sub\b.mdf", 30);
+         CreateFile(@"Data\Sub\Deeper\c.MDF", 40);
+         CreateFile(@"Data\Sub\Deeper\notes.txt", 50);
+         CreateFile(@"Logs\x.log", 60);
+         CreateFile(@"Other\y.mdf", 70);
+
+         foreach (int degreeOfParallelism in new[] { 1, 4, 16 })
+         {
+            VssFileManifestBuilder builder = CreateBuilder(degreeOfParallelism);
+            int database = builder.AddComponent("Database", new[] { CreateDescriptor(@"X:\Data", "*.mdf", true) });
+            int logs = builder.AddComponent("Logs", new[] { CreateDescriptor(@"X:\Data", "*.ldf", false), CreateDescriptor(@"X:\Logs\", "*", false) });
+            int all = builder.AddComponent("All", new[] { CreateDescriptor(@"X:\Data\", "*", true) });
+
+            VssFileManifest manifest = builder.Build();
+
+            CollectionAssert.AreEqual(new[] { "Database", "Logs", "All" }, manifest.Components.ToList());
+            CollectionAssert.AreEqual(new[]
+               {
+                  @"X:\Data\a.ldf=" + logs,
+                  @"X:\Data\a.mdf=" + database,
+                  @"X:\Data\Sub\b.mdf=" + database,
+                  @"X:\Data\Sub\Deeper\c.MDF=" + database,
+                  @"X:\Data\Sub\Deeper\notes.txt=" + all,
+                  @"X:\Logs\x.log=" + logs
+               }, manifest.Entries.Select(e => e.Path + "=" + e.ComponentId).ToList(), "Degree of parallelism {0}", degreeOfParallelism);
+
+            Assert.AreEqual(40, manifest.Entries.Single(e => e.Path.EndsWith("c.MDF")).Length);
+            Assert.AreEqual(10 + 20 + 30 + 40 + 50 + 60, manifest.TotalLength);
+            Assert.AreEqual(0, manifest.InaccessibleDirectories.Count);
+         }
+      }
+
+      [TestMethod]
+      public void Build_SyntheticTree_SameManifestForEveryDegreeOfParallelism()
+      {
+         CreateTree(40, 24);
+
+         List<string> expected = null;
+         foreach (int degreeOfParallelism in new[] { 1, 4, 16 })
+         {
+            VssFileManifestBuilder builder = CreateBuilder(degreeOfParallelism);
+            builder.AddComponent("Data", new[] { CreateDescriptor(Volume, "*.dat", true) });
+            builder.AddComponent("Text", new[] { CreateDescriptor(Volume, "*", true) });
+
+            List<string> actual = builder.Build().Entries.Select(e => e.Path + "=" + e.ComponentId + "," + e.Length).ToList();
+            if (expected == null)
+            {
+               Assert.AreEqual(Directory.GetFiles(m_root, "*", SearchOption.AllDirectories).Length, actual.Count);
+               Assert.AreEqual(actual.Count / 2, actual.Count(e => e.EndsWith(".dat=0,1")));
+               expected = actual;
+            }
+
+            CollectionAssert.AreEqual(expected, actual, "Degree of parallelism {0}", degreeOfParallelism);
+         }
+      }
+
+      [TestMethod]
+      public void Build_MissingDirectory_ReturnsEmptyManifest()
+      {
+         VssFileManifestBuilder builder = CreateBuilder(4);
+         builder.AddComponent("Missing", new[] { CreateDescriptor(@"X:\DoesNotExist", "*", true) });
+
+         VssFileManifest manifest = builder.Build();
+
+         Assert.AreEqual(0, manifest.Entries.Count);
+         Assert.AreEqual(0, manifest.InaccessibleDirectories.Count);
+      }
+
+      [TestMethod]
+      public void Build_CanceledToken_RethrowsCancellationOfWalk()
+      {
+         CreateTree(20, 5);
+
+         foreach (int degreeOfParallelism in new[] { 1, 4, 16 })
+         {
+            VssFileManifestBuilder builder = CreateBuilder(degreeOfParallelism);
+            builder.AddComponent("All", new[] { CreateDescriptor(Volume, "*", true) });
+
+            // The walking thread that takes the first directory throws, and Build rethrows its exception once all threads have stopped.
+            using (CancellationTokenSource cancellation = new CancellationTokenSource())
+            {
+               cancellation.Cancel();
+               try
+               {
+                  builder.Build(cancellation.Token);
+                  Assert.Fail("Expected OperationCanceledException.");
+               }
+               catch (OperationCanceledException ex)
+               {
+                  Assert.AreEqual(cancellation.Token, ex.CancellationToken);
+                  Assert.IsTrue(ex.StackTrace.Contains(".Walk("), "The stack trace of the walking thread is preserved: {0}", ex.StackTrace);
+               }
+            }
+
+            // Without any directory to read, the token is still observed.
+            VssFileManifestBuilder empty = CreateBuilder(degreeOfParallelism);
+            try
+            {
+               empty.Build(new CancellationToken(true));
+               Assert.Fail("Expected OperationCanceledException.");
+            }
+            catch (OperationCanceledException)
+            {
+            }
+         }
+      }
+
+      [TestMethod, TestCategory("Benchmark")]
+      public void Benchmark_Build250000Files()
+      {
+         // 500 directories of 500 files each.
+         CreateTree(500, 500);
+
+         foreach (int degreeOfParallelism in new[] { 1, 4, 16 })
+         {
+            VssFileManifestBuilder builder = CreateBuilder(degreeOfParallelism);
+            builder.AddComponent("Data", new[] { CreateDescriptor(Volume, "*.dat", true) });
+            builder.AddComponent("Text", new[] { CreateDescriptor(Volume, "*", true) });
+
+            Stopwatch stopwatch = Stopwatch.StartNew();
+            VssFileManifest manifest = builder.Build();
+            stopwatch.Stop();
+
+            Assert.AreEqual(250000, manifest.Entries.Count);
+            TestContext.WriteLine("{0,2} threads: {1:F0} ms, {2:N0} files/s", degreeOfParallelism, stopwatch.Elapsed.TotalMilliseconds,
+               manifest.Entries.Count / stopwatch.Elapsed.TotalSeconds);
+         }
+      }
+
+      #region Helpers
+
+      private VssFileManifestBuilder CreateBuilder(int degreeOfParallelism)
+      {
+         VssFileManifestBuilder builder = new VssFileManifestBuilder();
+         builder.DegreeOfParallelism = degreeOfParallelism;
+         builder.MapVolume(Volume, m_root);
+         return builder;
+      }
+
+      private static VssWMFileDescriptor CreateDescriptor(string path, string fileSpecification, bool isRecursive)
+      {
+         return new VssWMFileDescriptor(null, VssFileSpecificationBackupType.FullBackupRequired, fileSpecification, path, isRecursive);
+      }
+
+      private void CreateFile(string relativePath, int length)
+      {
+         string path = Path.Combine(m_root, relativePath.Replace('\\', Path.DirectorySeparatorChar));
+         Directory.CreateDirectory(Path.GetDirectoryName(path));
+         File.WriteAllBytes(path, new byte[length]);
+      }
+
+      // Creates directories three levels deep, each containing the specified number of files, alternately
+      // one byte .dat files and empty .txt files.
+      private void CreateTree(int directoryCount, int filesPerDirectory)
+      {
+         byte[] data = new byte[1];
+         for (int d = 0; d < directoryCount; d++)
+         {
+            string directory = Path.Combine(m_root, "Dir" + (d % 10), "Dir" + (d / 10 % 10), "Dir" + d);
+            Directory.CreateDirectory(directory);
+            for (int f = 0; f < filesPerDirectory; f++)
+            {
+               if (f % 2 == 0)
+                  File.WriteAllBytes(Path.Combine(directory, "file" + f + ".dat"), data);
+               else
+                  File.WriteAllBytes(Path.Combine(directory, "file" + f + ".txt"), new byte[0]);
+            }
+         }
+      }
+
+      #endregion
+   }
+}
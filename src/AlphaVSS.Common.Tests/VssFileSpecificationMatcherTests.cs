@@ -0,0 +1,125 @@
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   [TestClass]
+   public class VssFileSpecificationMatcherTests
+   {
+      [TestMethod]
+      public void IsMatch_Asterisk_MatchesAllNames()
+      {
+         VssFileSpecificationMatcher matcher = CreateMatcher(@"C:\d", "*", false);
+
+         Assert.IsTrue(matcher.IsMatch(@"C:\d\file.txt"));
+         Assert.IsTrue(matcher.IsMatch(@"C:\d\noext"));
+         Assert.IsTrue(matcher.IsMatch(@"C:\d\.hidden"));
+         Assert.IsFalse(matcher.IsMatch(@"C:\d\"));
+         Assert.IsFalse(matcher.IsMatch(@"C:\other\file.txt"));
+      }
+
+      [TestMethod]
+      public void IsMatch_StarDotStar_MatchesNamesWithAndWithoutExtension()
+      {
+         VssFileSpecificationMatcher matcher = CreateMatcher(@"C:\d", "*.*", false);
+
+         Assert.IsTrue(matcher.IsMatch(@"C:\d\file.txt"));
+         Assert.IsTrue(matcher.IsMatch(@"C:\d\archive.tar.gz"));
+         Assert.IsTrue(matcher.IsMatch(@"C:\d\noext"));
+      }
+
+      [TestMethod]
+      public void IsMatch_StarDot_MatchesNamesWithoutExtensionOnly()
+      {
+         VssFileSpecificationMatcher matcher = CreateMatcher(@"C:\d", "*.", false);
+
+         Assert.IsTrue(matcher.IsMatch(@"C:\d\noext"));
+         Assert.IsFalse(matcher.IsMatch(@"C:\d\file.txt"));
+         Assert.IsFalse(matcher.IsMatch(@"C:\d\.hidden"));
+
+         VssFileSpecificationMatcher named = CreateMatcher(@"C:\d", "NAME.", false);
+         Assert.IsTrue(named.IsMatch(@"C:\d\name"));
+         Assert.IsFalse(named.IsMatch(@"C:\d\name.txt"));
+      }
+
+      [TestMethod]
+      public void IsMatch_NameDotStar_MatchesNameWithAnyOrNoExtension()
+      {
+         VssFileSpecificationMatcher matcher = CreateMatcher(@"C:\d", "NAME.*", false);
+
+         Assert.IsTrue(matcher.IsMatch(@"C:\d\name.txt"));
+         Assert.IsTrue(matcher.IsMatch(@"C:\d\name.tar.gz"));
+         Assert.IsTrue(matcher.IsMatch(@"C:\d\name"));
+         Assert.IsFalse(matcher.IsMatch(@"C:\d\names.txt"));
+         Assert.IsFalse(matcher.IsMatch(@"C:\d\other"));
+      }
+
+      [TestMethod]
+      public void IsMatch_QuestionMark_MatchesExactlyOneCharacter()
+      {
+         VssFileSpecificationMatcher matcher = CreateMatcher(@"C:\d", "log?.txt", false);
+
+         Assert.IsTrue(matcher.IsMatch(@"C:\d\log1.txt"));
+         Assert.IsTrue(matcher.IsMatch(@"C:\d\logA.txt"));
+         Assert.IsFalse(matcher.IsMatch(@"C:\d\log.txt"));
+         Assert.IsFalse(matcher.IsMatch(@"C:\d\log12.txt"));
+
+         VssFileSpecificationMatcher mixed = CreateMatcher(@"C:\d", "a*b?c", false);
+         Assert.IsTrue(mixed.IsMatch(@"C:\d\abxc"));
+         Assert.IsTrue(mixed.IsMatch(@"C:\d\a-b-bxc"));
+         Assert.IsFalse(mixed.IsMatch(@"C:\d\abc"));
+      }
+
+      [TestMethod]
+      public void IsMatch_NonRecursiveSpecification_MatchesDirectoryOnly()
+      {
+         VssFileSpecificationMatcher matcher = CreateMatcher(@"C:\Data", "*.mdf", false);
+
+         Assert.IsTrue(matcher.IsMatch(@"C:\Data\db.mdf"));
+         Assert.IsFalse(matcher.IsMatch(@"C:\Data\Sub\db.mdf"));
+         Assert.IsFalse(matcher.IsMatch(@"C:\DataOther\db.mdf"));
+         Assert.IsFalse(matcher.IsMatch(@"C:\db.mdf"));
+      }
+
+      [TestMethod]
+      public void IsMatch_RecursiveSpecification_MatchesSubdirectories()
+      {
+         VssFileSpecificationMatcher matcher = CreateMatcher(@"C:\Data\", "*.mdf", true);
+
+         Assert.IsTrue(matcher.IsMatch(@"C:\Data\db.mdf"));
+         Assert.IsTrue(matcher.IsMatch(@"C:\Data\Sub\Deeper\db.mdf"));
+         Assert.IsFalse(matcher.IsMatch(@"C:\Data\Sub\db.ldf"));
+         Assert.IsFalse(matcher.IsMatch(@"C:\DataOther\db.mdf"));
+      }
+
+      [TestMethod]
+      public void IsMatch_DifferentCase_Matches()
+      {
+         VssFileSpecificationMatcher matcher = CreateMatcher(@"c:\program files\App", "Config*.XML", false);
+
+         Assert.IsTrue(matcher.IsMatch(@"C:\PROGRAM FILES\app\config.xml"));
+         Assert.IsTrue(matcher.IsMatch(@"c:/Program Files/APP/CONFIGuration.Xml"));
+         Assert.IsTrue(CreateMatcher("C:\\\u00C4", "\u00F6.TXT", false).IsMatch("c:\\\u00E4\\\u00D6.txt"));
+      }
+
+      [TestMethod]
+      public void FindMatch_SeveralDescriptors_ReturnsFirstMatchingDescriptor()
+      {
+         VssWMFileDescriptor recursive = new VssWMFileDescriptor(null, VssFileSpecificationBackupType.FullBackupRequired, "*", @"C:\Data", true);
+         VssWMFileDescriptor logs = new VssWMFileDescriptor(null, VssFileSpecificationBackupType.FullBackupRequired, "*.log", @"C:\Data\Logs", false);
+         VssFileSpecificationMatcher matcher = new VssFileSpecificationMatcher(new[] { logs, recursive });
+
+         Assert.AreSame(logs, matcher.FindMatch(@"C:\Data\Logs\a.log"));
+         Assert.AreSame(recursive, matcher.FindMatch(@"C:\Data\Logs\a.txt"));
+         Assert.IsNull(matcher.FindMatch(@"D:\Data\a.log"));
+
+         VssWMFileDescriptor[] matches = matcher.FindMatches(@"C:\Data\Logs\", new[] { "a.log", "b.txt" });
+         Assert.AreSame(logs, matches[0]);
+         Assert.AreSame(recursive, matches[1]);
+      }
+
+      private static VssFileSpecificationMatcher CreateMatcher(string path, string fileSpecification, bool isRecursive)
+      {
+         return new VssFileSpecificationMatcher(new[] { new VssWMFileDescriptor(null, VssFileSpecificationBackupType.FullBackupRequired, fileSpecification, path, isRecursive) });
+      }
+   }
+}
@@ -0,0 +1,311 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Text;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   [TestClass]
+   public class VssMetadataIndexTests
+   {
+      private static readonly Guid SqlWriterId = new Guid("a65faa63-5ea8-4ebc-9dbd-a0c4db26912a");
+      private static readonly Guid SqlInstanceId = new Guid("4e1b2f3a-3c7d-4e5f-8a9b-0c1d2e3f4a5b");
+      private static readonly Guid RegistryWriterId = new Guid("afbab4a2-367d-4d15-a586-71dbb18f8485");
+      private static readonly Guid RegistryInstanceId = new Guid("5a6b7c8d-9e0f-4a1b-8c2d-3e4f5a6b7c8d");
+
+      public TestContext TestContext { get; set; }
+
+      private const string WriterMetadataDocument =
+         @"<?xml version=""1.0""?>
+<WRITER_METADATA xmlns=""x-schema:#VssWriterMetadataInfo"" version=""1.1"">
+   <IDENTIFICATION writerId=""a65faa63-5ea8-4ebc-9dbd-a0c4db26912a"" instanceId=""4e1b2f3a-3c7d-4e5f-8a9b-0c1d2e3f4a5b"" friendlyName=""SqlServerWriter"" instanceName=""MSSQLSERVER"" usage=""USER_DATA"" dataSource=""TRANSACTION_DB""/>
+   <RESTORE_METHOD method=""RESTORE_IF_CAN_BE_REPLACED"" writerRestore=""never"" rebootRequired=""no""/>
+   <BACKUP_LOCATIONS>
+      <DATABASE logicalPath=""SERVER\MSSQLSERVER\"" componentName=""master"" caption=""master database"">
+         <DATABASE_FILES path=""C:\Data"" filespec=""master.mdf"" filespecBackupType=""0x3FF""/>
+         <DATABASE_LOGFILES path=""C:\Data"" filespec=""mastlog.ldf"" filespecBackupType=""0x3FF""/>
+      </DATABASE>
+      <DATABASE logicalPath=""SERVER\MSSQLSERVER"" componentName=""model""/>
+      <FILE_GROUP logicalPath=""SERVER\MSSQLSERVER\FullText"" componentName=""Catalogs"">
+         <FILE_LIST path=""C:\FTData"" filespec=""*"" recursive=""yes""/>
+      </FILE_GROUP>
+      <FILE_GROUP logicalPath=""SERVER\MSSQLSERVER2"" componentName=""other""/>
+      <FILE_GROUP componentName=""Tools"">
+         <FILE_LIST path=""%ProgramFiles%\Tools"" filespec=""*.exe"" recursive=""no"" alternatePath=""D:\Restore""/>
+      </FILE_GROUP>
+   </BACKUP_LOCATIONS>
+</WRITER_METADATA>";
+
+      private const string BackupComponentsDocument =
+         @"<?xml version=""1.0""?>
+<BACKUP_COMPONENTS xmlns=""x-schema:#VssComponentMetadata"" version=""1.2"" bootableSystemStateBackup=""no"" selectComponents=""yes"" backupType=""INCREMENTAL"" partialFileSupport=""no"">
+   <WRITER_COMPONENTS instanceId=""4e1b2f3a-3c7d-4e5f-8a9b-0c1d2e3f4a5b"" writerId=""a65faa63-5ea8-4ebc-9dbd-a0c4db26912a"">
+      <COMPONENT logicalPath=""SERVER\MSSQLSERVER"" componentName=""master"" componentType=""DATABASE"" backupSucceeded=""yes"" backupStamp=""stamp-2"" previousBackupStamp=""stamp-1""/>
+      <COMPONENT logicalPath=""SERVER\MSSQLSERVER"" componentName=""model"" componentType=""DATABASE"" backupSucceeded=""no""/>
+   </WRITER_COMPONENTS>
+   <WRITER_COMPONENTS instanceId=""5a6b7c8d-9e0f-4a1b-8c2d-3e4f5a6b7c8d"" writerId=""afbab4a2-367d-4d15-a586-71dbb18f8485"">
+      <COMPONENT componentName=""Registry"" componentType=""FILE_GROUP""/>
+   </WRITER_COMPONENTS>
+   <WRITER_METADATA version=""1.1"">
+      <IDENTIFICATION writerId=""afbab4a2-367d-4d15-a586-71dbb18f8485"" instanceId=""5a6b7c8d-9e0f-4a1b-8c2d-3e4f5a6b7c8d"" friendlyName=""Registry Writer"" instanceName=""""/>
+   </WRITER_METADATA>
+</BACKUP_COMPONENTS>";
+
+      [TestMethod]
+      public void Parse_WriterMetadataDocument_IndexesWriterComponentsAndFiles()
+      {
+         VssMetadataIndex index = VssMetadataIndex.Parse(WriterMetadataDocument);
+
+         Assert.IsFalse(index.IsBackupComponentsDocument);
+         Assert.AreEqual(VssBackupType.Undefined, index.BackupType);
+         Assert.AreEqual(1, index.Writers.Count);
+         Assert.AreEqual(SqlInstanceId, index.Writers[0].InstanceId);
+         Assert.AreEqual(SqlWriterId, index.Writers[0].WriterId);
+         Assert.AreEqual("SqlServerWriter", index.Writers[0].WriterName);
+         Assert.AreEqual("MSSQLSERVER", index.Writers[0].InstanceName);
+         Assert.AreEqual(5, index.Components.Count);
+
+         VssMetadataIndexComponent master = index.FindComponent(@"SERVER\MSSQLSERVER", "MASTER");
+         Assert.IsNotNull(master);
+         Assert.AreEqual(VssComponentType.Database, master.ComponentType);
+         Assert.AreEqual(@"SERVER\MSSQLSERVER\", master.LogicalPath);
+         Assert.AreEqual("master database", master.Caption);
+         Assert.AreEqual(0, master.Files.Count);
+         Assert.AreEqual("master.mdf", master.DatabaseFiles.Single().FileSpecification);
+         Assert.AreEqual((VssFileSpecificationBackupType)0x3FF, master.DatabaseFiles.Single().BackupTypeMask);
+         Assert.AreEqual("mastlog.ldf", master.DatabaseLogFiles.Single().FileSpecification);
+
+         VssMetadataIndexComponent catalogs = index.FindComponent(@"server\mssqlserver\fulltext", "Catalogs");
+         Assert.AreEqual(VssComponentType.FileGroup, catalogs.ComponentType);
+         Assert.IsTrue(catalogs.Files.Single().IsRecursive);
+
+         VssWMFileDescriptor tools = index.FindComponent(null, "Tools").Files.Single();
+         Assert.AreEqual(@"%ProgramFiles%\Tools", tools.Path);
+         Assert.AreEqual(@"D:\Restore", tools.AlternateLocation);
+         Assert.IsFalse(tools.IsRecursive);
+      }
+
+      [TestMethod]
+      public void Parse_BackupComponentsDocument_IndexesComponentsAndEmbeddedWriterMetadata()
+      {
+         VssMetadataIndex index = VssMetadataIndex.Parse(BackupComponentsDocument);
+
+         Assert.IsTrue(index.IsBackupComponentsDocument);
+         Assert.AreEqual(VssBackupType.Incremental, index.BackupType);
+         Assert.AreEqual(2, index.Writers.Count);
+
+         // The registry writer is named by the embedded writer metadata, the SQL writer only by its components.
+         VssMetadataIndexWriter registry = index.Writers.Single(w => w.InstanceId == RegistryInstanceId);
+         Assert.AreEqual(RegistryWriterId, registry.WriterId);
+         Assert.AreEqual("Registry Writer", registry.WriterName);
+         Assert.IsNull(index.Writers.Single(w => w.InstanceId == SqlInstanceId).WriterName);
+
+         VssMetadataIndexComponent master = index.FindComponent(@"SERVER\MSSQLSERVER", "master");
+         Assert.AreEqual(SqlInstanceId, master.InstanceId);
+         Assert.AreEqual(SqlWriterId, master.WriterId);
+         Assert.AreEqual(VssComponentType.Database, master.ComponentType);
+         Assert.AreEqual(true, master.BackupSucceeded);
+         Assert.AreEqual("stamp-2", master.BackupStamp);
+         Assert.AreEqual("stamp-1", master.PreviousBackupStamp);
+         Assert.AreEqual(false, index.FindComponent(@"SERVER\MSSQLSERVER", "model").BackupSucceeded);
+         Assert.IsNull(index.FindComponent(null, "Registry").BackupSucceeded);
+      }
+
+      [TestMethod]
+      public void GetComponentsForWriter_ByInstanceId_ReturnsComponentsOfWriter()
+      {
+         VssMetadataIndex index = VssMetadataIndex.Parse(BackupComponentsDocument);
+
+         CollectionAssert.AreEqual(new[] { "master", "model" }, index.GetComponentsForWriter(SqlInstanceId).Select(c => c.ComponentName).ToList());
+         CollectionAssert.AreEqual(new[] { "Registry" }, index.GetComponentsForWriter(RegistryInstanceId).Select(c => c.ComponentName).ToList());
+         Assert.AreEqual(0, index.GetComponentsForWriter(Guid.NewGuid()).Count);
+      }
+
+      [TestMethod]
+      public void GetComponents_TrailingBackslashOnEitherSide_MatchesSameComponents()
+      {
+         VssMetadataIndex index = VssMetadataIndex.Parse(WriterMetadataDocument);
+
+         // "master" is stored with a trailing backslash and "model" without one.
+         string[] expected = { "master", "model" };
+         CollectionAssert.AreEqual(expected, index.GetComponents(@"SERVER\MSSQLSERVER").Select(c => c.ComponentName).ToList());
+         CollectionAssert.AreEqual(expected, index.GetComponents(@"server\mssqlserver\").Select(c => c.ComponentName).ToList());
+         Assert.IsNotNull(index.FindComponent(@"SERVER\MSSQLSERVER\", "model"));
+         Assert.IsNotNull(index.FindComponent(@"SERVER\MSSQLSERVER", "master"));
+
+         CollectionAssert.AreEqual(new[] { "Tools" }, index.GetComponents(null).Select(c => c.ComponentName).ToList());
+         CollectionAssert.AreEqual(new[] { "Tools" }, index.GetComponents(String.Empty).Select(c => c.ComponentName).ToList());
+      }
+
+      [TestMethod]
+      public void GetComponentsUnder_LogicalPath_ReturnsPathAndDescendantsOnly()
+      {
+         VssMetadataIndex index = VssMetadataIndex.Parse(WriterMetadataDocument);
+
+         string[] expected = { "master", "model", "Catalogs" };
+         CollectionAssert.AreEqual(expected, index.GetComponentsUnder(@"SERVER\MSSQLSERVER").Select(c => c.ComponentName).ToList());
+         CollectionAssert.AreEqual(expected, index.GetComponentsUnder(@"SERVER\MSSQLSERVER\").Select(c => c.ComponentName).ToList());
+         Assert.AreEqual(4, index.GetComponentsUnder("SERVER").Count);
+         Assert.AreEqual(5, index.GetComponentsUnder(String.Empty).Count);
+      }
+
+      [TestMethod]
+      public void Load_SavedIndex_RoundTripsWritersAndComponents()
+      {
+         foreach (string document in new[] { WriterMetadataDocument, BackupComponentsDocument })
+         {
+            VssMetadataIndex original = VssMetadataIndex.Parse(document);
+            VssMetadataIndex loaded;
+            using (MemoryStream stream = new MemoryStream())
+            {
+               original.Save(stream);
+               stream.Position = 0;
+               loaded = VssMetadataIndex.Load(stream);
+               Assert.AreEqual(stream.Length, stream.Position);
+            }
+
+            Assert.AreEqual(original.IsBackupComponentsDocument, loaded.IsBackupComponentsDocument);
+            Assert.AreEqual(original.BackupType, loaded.BackupType);
+            Assert.AreEqual(original.Writers.Count, loaded.Writers.Count);
+            for (int i = 0; i < original.Writers.Count; i++)
+            {
+               Assert.AreEqual(original.Writers[i].InstanceId, loaded.Writers[i].InstanceId);
+               Assert.AreEqual(original.Writers[i].WriterId, loaded.Writers[i].WriterId);
+               Assert.AreEqual(original.Writers[i].WriterName, loaded.Writers[i].WriterName);
+               Assert.AreEqual(original.Writers[i].InstanceName, loaded.Writers[i].InstanceName);
+            }
+
+            Assert.AreEqual(original.Components.Count, loaded.Components.Count);
+            for (int i = 0; i < original.Components.Count; i++)
+               AssertComponentEqual(original.Components[i], loaded.Components[i]);
+
+            Assert.IsNotNull(loaded.FindComponent(@"SERVER\MSSQLSERVER\", "master"));
+         }
+      }
+
+      [TestMethod]
+      public void Load_OtherData_ThrowsInvalidDataException()
+      {
+         foreach (byte[] data in new[] { new byte[0], Encoding.ASCII.GetBytes("AVSSMDX1 truncated"), new byte[64] })
+         {
+            try
+            {
+               VssMetadataIndex.Load(new MemoryStream(data));
+               Assert.Fail("Expected InvalidDataException.");
+            }
+            catch (InvalidDataException)
+            {
+            }
+         }
+      }
+
+      [TestMethod, TestCategory("Benchmark")]
+      public void Benchmark_ParseSaveLoadAndLookup()
+      {
+         // A backup components document of 200 writers with 250 components each, of about 19 million characters.
+         const int writerCount = 200;
+         const int componentsPerWriter = 250;
+         string document = CreateBackupComponentsDocument(writerCount, componentsPerWriter);
+
+         Stopwatch stopwatch = Stopwatch.StartNew();
+         VssMetadataIndex index = VssMetadataIndex.Parse(document);
+         TimeSpan parse = stopwatch.Elapsed;
+         // Each component is listed once by its writer components and once by the embedded writer metadata.
+         Assert.AreEqual(2 * writerCount * componentsPerWriter, index.Components.Count);
+
+         byte[] saved;
+         stopwatch.Restart();
+         using (MemoryStream stream = new MemoryStream())
+         {
+            index.Save(stream);
+            saved = stream.ToArray();
+         }
+         TimeSpan save = stopwatch.Elapsed;
+
+         stopwatch.Restart();
+         VssMetadataIndex loaded = VssMetadataIndex.Load(new MemoryStream(saved));
+         TimeSpan load = stopwatch.Elapsed;
+
+         const int lookups = 100000;
+         Random random = new Random(1);
+         stopwatch.Restart();
+         for (int i = 0; i < lookups; i++)
+         {
+            int w = random.Next(writerCount);
+            int c = random.Next(componentsPerWriter);
+            Assert.IsNotNull(loaded.FindComponent(LogicalPath(w, c), "db" + c));
+         }
+         TimeSpan lookup = stopwatch.Elapsed;
+
+         TestContext.WriteLine("Document: {0:N0} characters, {1:N0} components; saved index: {2:N0} bytes", document.Length, index.Components.Count, saved.Length);
+         TestContext.WriteLine("Parse {0:F1} ms, Save {1:F1} ms, Load {2:F1} ms, FindComponent {3:F2} us", parse.TotalMilliseconds, save.TotalMilliseconds,
+            load.TotalMilliseconds, lookup.TotalMilliseconds * 1000 / lookups);
+      }
+
+      #region Helpers
+
+      private static string LogicalPath(int writer, int component)
+      {
+         // Every other path has a trailing backslash, as some writers report them.
+         return String.Format(@"SERVER\INSTANCE{0}\Group{1}{2}", writer, component % 10, component % 2 == 0 ? @"\" : String.Empty);
+      }
+
+      private static string CreateBackupComponentsDocument(int writerCount, int componentsPerWriter)
+      {
+         StringBuilder xml = new StringBuilder();
+         xml.Append(@"<BACKUP_COMPONENTS xmlns=""x-schema:#VssComponentMetadata"" version=""1.2"" backupType=""FULL"">");
+         for (int w = 0; w < writerCount; w++)
+         {
+            Guid instanceId = Guid.NewGuid();
+            xml.AppendFormat(@"<WRITER_COMPONENTS instanceId=""{0}"" writerId=""{1}"">", instanceId, SqlWriterId);
+            for (int c = 0; c < componentsPerWriter; c++)
+               xml.AppendFormat(@"<COMPONENT logicalPath=""{0}"" componentName=""db{1}"" componentType=""DATABASE"" backupSucceeded=""yes"" backupStamp=""{2}""/>",
+                  LogicalPath(w, c), c, Guid.NewGuid());
+            xml.Append("</WRITER_COMPONENTS>");
+
+            xml.AppendFormat(@"<WRITER_METADATA version=""1.1""><IDENTIFICATION writerId=""{0}"" instanceId=""{1}"" friendlyName=""SqlServerWriter"" instanceName=""INSTANCE{2}""/><BACKUP_LOCATIONS>",
+               SqlWriterId, instanceId, w);
+            for (int c = 0; c < componentsPerWriter; c++)
+               xml.AppendFormat(@"<DATABASE logicalPath=""{0}"" componentName=""db{1}""><DATABASE_FILES path=""C:\Data\INSTANCE{2}"" filespec=""db{1}.mdf""/><DATABASE_LOGFILES path=""C:\Logs\INSTANCE{2}"" filespec=""db{1}.ldf""/></DATABASE>",
+                  LogicalPath(w, c), c, w);
+            xml.Append("</BACKUP_LOCATIONS></WRITER_METADATA>");
+         }
+         xml.Append("</BACKUP_COMPONENTS>");
+         return xml.ToString();
+      }
+
+      private static void AssertComponentEqual(VssMetadataIndexComponent expected, VssMetadataIndexComponent actual)
+      {
+         Assert.AreEqual(expected.InstanceId, actual.InstanceId);
+         Assert.AreEqual(expected.WriterId, actual.WriterId);
+         Assert.AreEqual(expected.ComponentType, actual.ComponentType);
+         Assert.AreEqual(expected.LogicalPath, actual.LogicalPath);
+         Assert.AreEqual(expected.ComponentName, actual.ComponentName);
+         Assert.AreEqual(expected.Caption, actual.Caption);
+         Assert.AreEqual(expected.BackupSucceeded, actual.BackupSucceeded);
+         Assert.AreEqual(expected.BackupStamp, actual.BackupStamp);
+         Assert.AreEqual(expected.PreviousBackupStamp, actual.PreviousBackupStamp);
+         AssertFilesEqual(expected.Files, actual.Files);
+         AssertFilesEqual(expected.DatabaseFiles, actual.DatabaseFiles);
+         AssertFilesEqual(expected.DatabaseLogFiles, actual.DatabaseLogFiles);
+      }
+
+      private static void AssertFilesEqual(IList<VssWMFileDescriptor> expected, IList<VssWMFileDescriptor> actual)
+      {
+         Assert.AreEqual(expected.Count, actual.Count);
+         for (int i = 0; i < expected.Count; i++)
+         {
+            Assert.AreEqual(expected[i].Path, actual[i].Path);
+            Assert.AreEqual(expected[i].FileSpecification, actual[i].FileSpecification);
+            Assert.AreEqual(expected[i].AlternateLocation, actual[i].AlternateLocation);
+            Assert.AreEqual(expected[i].BackupTypeMask, actual[i].BackupTypeMask);
+            Assert.AreEqual(expected[i].IsRecursive, actual[i].IsRecursive);
+         }
+      }
+
+      #endregion
+   }
+}
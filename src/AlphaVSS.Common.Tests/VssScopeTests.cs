@@ -0,0 +1,138 @@
+using System;
+using System.Collections.Generic;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   [TestClass]
+   public class VssScopeTests
+   {
+      [TestMethod]
+      public void Dispose_InnermostScope_RestoresPreviousScope()
+      {
+         using (VssScope outer = new VssScope())
+         {
+            VssScope inner = new VssScope();
+            Assert.AreSame(inner, VssScope.Current);
+
+            inner.Dispose();
+            Assert.AreSame(outer, VssScope.Current);
+         }
+
+         Assert.IsNull(VssScope.Current);
+      }
+
+      [TestMethod]
+      public void Dispose_OuterScopeFirst_CurrentSkipsDisposedScopes()
+      {
+         VssScope outer = new VssScope();
+         VssScope middle = new VssScope();
+         VssScope inner = new VssScope();
+
+         middle.Dispose();
+         Assert.AreSame(inner, VssScope.Current);
+
+         inner.Dispose();
+         Assert.AreSame(outer, VssScope.Current);
+
+         outer.Dispose();
+         Assert.IsNull(VssScope.Current);
+      }
+
+      [TestMethod]
+      public void Constructor_AfterOutOfOrderDispose_DoesNotLinkToDisposedScope()
+      {
+         VssScope outer = new VssScope();
+         VssScope inner = new VssScope();
+         outer.Dispose();
+         inner.Dispose();
+
+         using (VssScope scope = new VssScope())
+         {
+            Assert.AreSame(scope, VssScope.Current);
+         }
+
+         Assert.IsNull(VssScope.Current);
+      }
+
+      [TestMethod]
+      public void Remove_RegisteredObject_DecrementsCountButNotTotalCount()
+      {
+         using (VssScope scope = new VssScope())
+         {
+            Disposable first = new Disposable(null);
+            Disposable second = new Disposable(null);
+            scope.Add(first);
+            scope.Add(second);
+            scope.Add(second);
+
+            Assert.AreEqual(2, scope.Count);
+            Assert.IsTrue(scope.Remove(first));
+            Assert.IsFalse(scope.Remove(first));
+            Assert.AreEqual(1, scope.Count);
+            Assert.AreEqual(2, scope.TotalCount);
+
+            scope.Dispose();
+            Assert.IsFalse(first.IsDisposed);
+            Assert.IsTrue(second.IsDisposed);
+            Assert.AreEqual(0, scope.Count);
+         }
+      }
+
+      [TestMethod]
+      public void Dispose_ObjectThrows_DisposesRemainingObjectsInReverseOrderAndRethrows()
+      {
+         List<Disposable> order = new List<Disposable>();
+         VssScope scope = new VssScope();
+         Disposable first = new Disposable(order);
+         Disposable failing = new Disposable(order, new InvalidOperationException());
+         Disposable last = new Disposable(order);
+         scope.Add(first);
+         scope.Add(failing);
+         scope.Add(last);
+
+         try
+         {
+            scope.Dispose();
+            Assert.Fail("Expected InvalidOperationException.");
+         }
+         catch (InvalidOperationException ex)
+         {
+            Assert.AreSame(failing.Exception, ex);
+         }
+
+         CollectionAssert.AreEqual(new[] { last, failing, first }, order);
+         Assert.IsNull(VssScope.Current);
+      }
+
+      private sealed class Disposable : IDisposable
+      {
+         private readonly List<Disposable> m_order;
+
+         public Disposable(List<Disposable> order)
+            : this(order, null)
+         {
+         }
+
+         public Disposable(List<Disposable> order, Exception exception)
+         {
+            m_order = order;
+            Exception = exception;
+         }
+
+         public Exception Exception { get; private set; }
+
+         public bool IsDisposed { get; private set; }
+
+         public void Dispose()
+         {
+            IsDisposed = true;
+            if (m_order != null)
+               m_order.Add(this);
+
+            if (Exception != null)
+               throw Exception;
+         }
+      }
+   }
+}
@@ -0,0 +1,279 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   [TestClass]
+   public class VssSnapshotInventoryTests
+   {
+      private string m_path;
+
+      [TestInitialize]
+      public void Initialize()
+      {
+         m_path = Path.Combine(Path.GetTempPath(), "AlphaVSS." + Guid.NewGuid().ToString("N") + ".inventory");
+      }
+
+      [TestCleanup]
+      public void Cleanup()
+      {
+         File.Delete(m_path);
+         File.Delete(m_path + ".tmp");
+      }
+
+      [TestMethod]
+      public void Refresh_ChangedSnapshots_ReportsAddedUpdatedRemovedAndUnchanged()
+      {
+         Guid setId = Guid.NewGuid();
+         List<VssSnapshotProperties> snapshots = Enumerable.Range(0, 4).Select(i => CreateSnapshot(setId, "C")).ToList();
+
+         using (VssSnapshotInventory inventory = new VssSnapshotInventory(m_path))
+         {
+            Assert.IsNull(inventory.LastRefreshTime);
+            AssertResult(inventory.Refresh(snapshots), 4, 0, 0, 0);
+            AssertResult(inventory.Refresh(snapshots), 0, 0, 0, 4);
+            Assert.IsNotNull(inventory.LastRefreshTime);
+
+            snapshots[1] = WithExposedName(snapshots[1], @"X:\");
+            snapshots.RemoveAt(3);
+            snapshots.Add(CreateSnapshot(setId, "D"));
+
+            AssertResult(inventory.Refresh(snapshots), 1, 1, 1, 2);
+            Assert.AreEqual(4, inventory.Count);
+            AssertSnapshotEqual(snapshots[1], inventory.FindSnapshot(snapshots[1].SnapshotId));
+
+            AssertResult(inventory.Refresh(new VssSnapshotProperties[0]), 0, 0, 4, 0);
+            Assert.AreEqual(0, inventory.Count);
+         }
+      }
+
+      [TestMethod]
+      public void FindSnapshot_ById_ReturnsStoredPropertiesOrNull()
+      {
+         VssSnapshotProperties first = CreateSnapshot(Guid.NewGuid(), "C");
+         VssSnapshotProperties second = new VssSnapshotProperties(Guid.NewGuid(), Guid.NewGuid(), 1, null, null, null, null, null, null,
+            Guid.Empty, 0, DateTime.MinValue, VssSnapshotState.Unknown);
+
+         using (VssSnapshotInventory inventory = new VssSnapshotInventory(m_path))
+         {
+            inventory.Refresh(new[] { first, second });
+
+            AssertSnapshotEqual(first, inventory.FindSnapshot(first.SnapshotId));
+            AssertSnapshotEqual(second, inventory.FindSnapshot(second.SnapshotId));
+            Assert.IsNull(inventory.FindSnapshot(Guid.NewGuid()));
+         }
+      }
+
+      [TestMethod]
+      public void GetSnapshotsForVolume_DifferentCase_ReturnsSnapshotsOfVolume()
+      {
+         VssSnapshotProperties lower = CreateSnapshot(Guid.NewGuid(), @"\\?\Volume{abcdef01-0000-0000-0000-000000000000}\");
+         VssSnapshotProperties upper = CreateSnapshot(Guid.NewGuid(), @"\\?\VOLUME{ABCDEF01-0000-0000-0000-000000000000}\");
+         VssSnapshotProperties other = CreateSnapshot(Guid.NewGuid(), @"\\?\Volume{abcdef02-0000-0000-0000-000000000000}\");
+
+         using (VssSnapshotInventory inventory = new VssSnapshotInventory(m_path))
+         {
+            inventory.Refresh(new[] { lower, upper, other });
+
+            AssertIds(new[] { lower, upper }, inventory.GetSnapshotsForVolume(@"\\?\volume{ABCDEF01-0000-0000-0000-000000000000}\"));
+            AssertIds(new[] { other }, inventory.GetSnapshotsForVolume(other.OriginalVolumeName.ToUpperInvariant()));
+            Assert.AreEqual(0, inventory.GetSnapshotsForVolume(@"\\?\Volume{abcdef03-0000-0000-0000-000000000000}\").Count);
+         }
+      }
+
+      [TestMethod]
+      public void GetSnapshotsForSet_BySetId_ReturnsMembersOfSet()
+      {
+         Guid firstSet = Guid.NewGuid();
+         Guid secondSet = Guid.NewGuid();
+         VssSnapshotProperties[] snapshots = { CreateSnapshot(firstSet, "C"), CreateSnapshot(secondSet, "C"), CreateSnapshot(firstSet, "D") };
+
+         using (VssSnapshotInventory inventory = new VssSnapshotInventory(m_path))
+         {
+            inventory.Refresh(snapshots);
+
+            AssertIds(new[] { snapshots[0], snapshots[2] }, inventory.GetSnapshotsForSet(firstSet));
+            AssertIds(new[] { snapshots[1] }, inventory.GetSnapshotsForSet(secondSet));
+            Assert.AreEqual(0, inventory.GetSnapshotsForSet(Guid.NewGuid()).Count);
+
+            inventory.Refresh(new[] { snapshots[0], snapshots[1] });
+            AssertIds(new[] { snapshots[0] }, inventory.GetSnapshotsForSet(firstSet));
+         }
+      }
+
+      [TestMethod]
+      public void Constructor_ExistingFile_ReopensStoredSnapshots()
+      {
+         Guid setId = Guid.NewGuid();
+         VssSnapshotProperties[] snapshots = Enumerable.Range(0, 10).Select(i => CreateSnapshot(setId, i % 2 == 0 ? "C" : "D")).ToArray();
+         DateTime? lastRefreshTime;
+
+         using (VssSnapshotInventory inventory = new VssSnapshotInventory(m_path))
+         {
+            inventory.Refresh(snapshots);
+            lastRefreshTime = inventory.LastRefreshTime;
+         }
+
+         using (VssSnapshotInventory inventory = new VssSnapshotInventory(m_path))
+         {
+            Assert.AreEqual(snapshots.Length, inventory.Count);
+            Assert.AreEqual(lastRefreshTime, inventory.LastRefreshTime);
+            foreach (VssSnapshotProperties snapshot in snapshots)
+               AssertSnapshotEqual(snapshot, inventory.FindSnapshot(snapshot.SnapshotId));
+
+            AssertIds(snapshots.Where(s => s.OriginalVolumeName == VolumeName("D")), inventory.GetSnapshotsForVolume(VolumeName("D")));
+            AssertIds(snapshots, inventory.GetSnapshotsForSet(setId));
+            AssertResult(inventory.Refresh(snapshots), 0, 0, 0, snapshots.Length);
+         }
+      }
+
+      [TestMethod]
+      public void Constructor_FileOfOtherFormat_ThrowsInvalidDataException()
+      {
+         File.WriteAllBytes(m_path, new byte[1024]);
+
+         try
+         {
+            new VssSnapshotInventory(m_path).Dispose();
+            Assert.Fail("Expected InvalidDataException.");
+         }
+         catch (InvalidDataException)
+         {
+         }
+      }
+
+      [TestMethod]
+      public void Refresh_BeyondInitialCapacity_GrowsFileAndKeepsIndexes()
+      {
+         // 2000 shadow copies on 500 volumes in 400 sets need several rebuilds of the initial file, which holds 64 records.
+         List<VssSnapshotProperties> snapshots = CreateSnapshots(2000, 500, 400);
+
+         using (VssSnapshotInventory inventory = new VssSnapshotInventory(m_path))
+         {
+            long initialLength = new FileInfo(m_path).Length;
+            AssertResult(inventory.Refresh(snapshots), snapshots.Count, 0, 0, 0);
+
+            Assert.IsTrue(new FileInfo(m_path).Length > initialLength);
+            Assert.IsFalse(File.Exists(m_path + ".tmp"));
+            AssertIndexes(inventory, snapshots);
+         }
+
+         using (VssSnapshotInventory inventory = new VssSnapshotInventory(m_path))
+         {
+            AssertIndexes(inventory, snapshots);
+         }
+      }
+
+      [TestMethod]
+      public void Refresh_RemovingVolumesAndSets_KeepsRemainingEntriesReachable()
+      {
+         // Removing the last shadow copy of a volume or set deletes its index entry by moving back the entries following it in
+         // its probe sequence. Removing every third volume and set, then adding them back, exercises entries in collision chains.
+         List<VssSnapshotProperties> snapshots = CreateSnapshots(1200, 300, 240);
+
+         using (VssSnapshotInventory inventory = new VssSnapshotInventory(m_path))
+         {
+            inventory.Refresh(snapshots);
+
+            HashSet<string> removedVolumes = new HashSet<string>(Enumerable.Range(0, 300).Where(i => i % 3 == 0).Select(i => VolumeName("V" + i)), StringComparer.OrdinalIgnoreCase);
+            HashSet<Guid> removedSets = new HashSet<Guid>(snapshots.Select(s => s.SnapshotSetId).Distinct().Where((id, i) => i % 3 == 1));
+            List<VssSnapshotProperties> remaining = snapshots.Where(s => !removedVolumes.Contains(s.OriginalVolumeName) && !removedSets.Contains(s.SnapshotSetId)).ToList();
+
+            AssertResult(inventory.Refresh(remaining), 0, 0, snapshots.Count - remaining.Count, remaining.Count);
+            AssertIndexes(inventory, remaining);
+            foreach (string volume in removedVolumes)
+               Assert.AreEqual(0, inventory.GetSnapshotsForVolume(volume).Count);
+            foreach (Guid setId in removedSets)
+               Assert.AreEqual(0, inventory.GetSnapshotsForSet(setId).Count);
+
+            AssertResult(inventory.Refresh(snapshots), snapshots.Count - remaining.Count, 0, 0, remaining.Count);
+            AssertIndexes(inventory, snapshots);
+         }
+      }
+
+      #region Helpers
+
+      private static int s_counter;
+
+      private static string VolumeName(string name)
+      {
+         return @"\\?\Volume{" + name + @"}\";
+      }
+
+      private static VssSnapshotProperties CreateSnapshot(Guid setId, string volume)
+      {
+         return CreateSnapshot(setId, volume.StartsWith(@"\\?\", StringComparison.Ordinal) ? volume : VolumeName(volume), ++s_counter);
+      }
+
+      private static VssSnapshotProperties CreateSnapshot(Guid setId, string volumeName, int number)
+      {
+         return new VssSnapshotProperties(Guid.NewGuid(), setId, 1, @"\\?\GLOBALROOT\Device\HarddiskVolumeShadowCopy" + number,
+            volumeName, "machine.example.com", "machine.example.com", null, null, Guid.NewGuid(),
+            VssVolumeSnapshotAttributes.Persistent | VssVolumeSnapshotAttributes.ClientAccessible,
+            new DateTime(2016, 1, 1, 0, 0, 0, DateTimeKind.Utc).AddMinutes(number), VssSnapshotState.Created);
+      }
+
+      private static List<VssSnapshotProperties> CreateSnapshots(int count, int volumeCount, int setCount)
+      {
+         Guid[] setIds = Enumerable.Range(0, setCount).Select(i => Guid.NewGuid()).ToArray();
+         return Enumerable.Range(0, count).Select(i => CreateSnapshot(setIds[i % setCount], VolumeName("V" + (i % volumeCount)), i)).ToList();
+      }
+
+      private static VssSnapshotProperties WithExposedName(VssSnapshotProperties s, string exposedName)
+      {
+         return new VssSnapshotProperties(s.SnapshotId, s.SnapshotSetId, s.SnapshotsCount, s.SnapshotDeviceObject, s.OriginalVolumeName,
+            s.OriginatingMachine, s.ServiceMachine, exposedName, s.ExposedPath, s.ProviderId, s.SnapshotAttributes | VssVolumeSnapshotAttributes.ExposedLocally,
+            s.CreationTimestamp, s.Status);
+      }
+
+      private static void AssertResult(VssSnapshotInventoryRefreshResult result, int added, int updated, int removed, int unchanged)
+      {
+         Assert.AreEqual(added, result.Added, "Added");
+         Assert.AreEqual(updated, result.Updated, "Updated");
+         Assert.AreEqual(removed, result.Removed, "Removed");
+         Assert.AreEqual(unchanged, result.Unchanged, "Unchanged");
+      }
+
+      private static void AssertSnapshotEqual(VssSnapshotProperties expected, VssSnapshotProperties actual)
+      {
+         Assert.IsNotNull(actual);
+         Assert.AreEqual(expected.SnapshotId, actual.SnapshotId);
+         Assert.AreEqual(expected.SnapshotSetId, actual.SnapshotSetId);
+         Assert.AreEqual(expected.SnapshotsCount, actual.SnapshotsCount);
+         Assert.AreEqual(expected.SnapshotDeviceObject, actual.SnapshotDeviceObject);
+         Assert.AreEqual(expected.OriginalVolumeName, actual.OriginalVolumeName);
+         Assert.AreEqual(expected.OriginatingMachine, actual.OriginatingMachine);
+         Assert.AreEqual(expected.ServiceMachine, actual.ServiceMachine);
+         Assert.AreEqual(expected.ExposedName, actual.ExposedName);
+         Assert.AreEqual(expected.ExposedPath, actual.ExposedPath);
+         Assert.AreEqual(expected.ProviderId, actual.ProviderId);
+         Assert.AreEqual(expected.SnapshotAttributes, actual.SnapshotAttributes);
+         Assert.AreEqual(expected.CreationTimestamp, actual.CreationTimestamp);
+         Assert.AreEqual(expected.Status, actual.Status);
+      }
+
+      private static void AssertIds(IEnumerable<VssSnapshotProperties> expected, IEnumerable<VssSnapshotProperties> actual)
+      {
+         CollectionAssert.AreEquivalent(expected.Select(s => s.SnapshotId).ToList(), actual.Select(s => s.SnapshotId).ToList());
+      }
+
+      private static void AssertIndexes(VssSnapshotInventory inventory, IList<VssSnapshotProperties> snapshots)
+      {
+         Assert.AreEqual(snapshots.Count, inventory.Count);
+
+         foreach (VssSnapshotProperties snapshot in snapshots)
+            AssertSnapshotEqual(snapshot, inventory.FindSnapshot(snapshot.SnapshotId));
+
+         foreach (IGrouping<string, VssSnapshotProperties> volume in snapshots.GroupBy(s => s.OriginalVolumeName, StringComparer.OrdinalIgnoreCase))
+            AssertIds(volume, inventory.GetSnapshotsForVolume(volume.Key));
+
+         foreach (IGrouping<Guid, VssSnapshotProperties> set in snapshots.GroupBy(s => s.SnapshotSetId))
+            AssertIds(set, inventory.GetSnapshotsForSet(set.Key));
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,286 @@
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Alphaleonis.Win32.Vss.Tests
+{
+   [TestClass]
+   public class VssSnapshotOrchestratorTests
+   {
+      private static readonly string[] s_volumes = { @"C:\", @"D:\", @"E:\", @"F:\", @"G:\" };
+
+      #region Partitioning
+
+      [TestMethod]
+      public void CreateSnapshots_MoreVolumesThanFitInASet_CreatesOneSessionPerSet()
+      {
+         MockSnapshotSetBackend backend = new MockSnapshotSetBackend();
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(backend.CreateSession);
+         orchestrator.MaximumVolumesPerSet = 2;
+
+         Outcome outcome = Run(orchestrator, s_volumes);
+         Assert.IsNull(outcome.Exception);
+
+         using (VssSnapshotOrchestrationResult result = outcome.Result)
+         {
+            Assert.AreEqual(3, result.Sets.Count);
+            Assert.AreEqual(0, result.SplitCount);
+            CollectionAssert.AreEqual(s_volumes, result.Sets.SelectMany(set => set.Volumes).ToArray());
+            Assert.AreEqual(3, backend.Sessions.Count);
+            Assert.IsFalse(backend.Sessions.Any(session => session.IsAborted || session.IsDisposed));
+         }
+
+         Assert.IsTrue(backend.Sessions.All(session => session.IsDisposed));
+      }
+
+      [TestMethod]
+      public void CreateSnapshots_ProviderAcceptsFewerVolumes_AbortsSetAndSplitsRemainingVolumes()
+      {
+         MockSnapshotSetBackend backend = new MockSnapshotSetBackend();
+         backend.MaximumVolumesPerSet = 2;
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(backend.CreateSession);
+
+         Outcome outcome = Run(orchestrator, s_volumes);
+         Assert.IsNull(outcome.Exception);
+
+         using (VssSnapshotOrchestrationResult result = outcome.Result)
+         {
+            Assert.AreEqual(1, result.SplitCount);
+            Assert.AreEqual(2, result.MaximumVolumesPerSet);
+            Assert.AreEqual(3, result.Sets.Count);
+            CollectionAssert.AreEqual(s_volumes, result.Sets.SelectMany(set => set.Volumes).ToArray());
+
+            MockSnapshotSetSession rejected = backend.Sessions[0];
+            Assert.IsTrue(rejected.IsAborted);
+            Assert.IsTrue(rejected.IsDisposed);
+            Assert.IsFalse(result.Sets.Any(set => set.Session == rejected));
+         }
+      }
+
+      [TestMethod]
+      public void CreateSnapshots_FirstVolumeRejectedAsFull_ThrowsAndAbortsSession()
+      {
+         MockSnapshotSetBackend backend = new MockSnapshotSetBackend();
+         backend.MaximumVolumesPerSet = 0;
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(backend.CreateSession);
+
+         Outcome outcome = Run(orchestrator, s_volumes);
+
+         Assert.IsInstanceOfType(outcome.Exception, typeof(VssMaximumNumberOfVolumesReachedException));
+         Assert.AreEqual(1, backend.Sessions.Count);
+         Assert.IsTrue(backend.Sessions[0].IsAborted);
+         Assert.IsTrue(backend.Sessions[0].IsDisposed);
+      }
+
+      #endregion
+
+      #region Failures
+
+      [TestMethod]
+      public void CreateSnapshots_VolumeRejected_RethrowsExceptionAndAbortsCompletedSets()
+      {
+         VssVolumeNotSupportedException error = new VssVolumeNotSupportedException();
+         MockSnapshotSetBackend backend = new MockSnapshotSetBackend();
+         backend.AddToSnapshotSetFailure = (session, volume) => volume == @"E:\" ? error : null;
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(backend.CreateSession);
+         orchestrator.MaximumVolumesPerSet = 2;
+
+         Outcome outcome = Run(orchestrator, s_volumes);
+
+         Assert.AreSame(error, outcome.Exception);
+         Assert.AreEqual(2, backend.Sessions.Count);
+         Assert.IsTrue(backend.Sessions.All(session => session.IsAborted && session.IsDisposed));
+         Assert.IsTrue(backend.IndexOf("1.AbortBackup") < backend.IndexOf("1.Dispose"));
+      }
+
+      [TestMethod]
+      public void CreateSnapshots_CleanupThrows_RethrowsOriginalException()
+      {
+         VssProviderVetoException error = new VssProviderVetoException();
+         MockSnapshotSetBackend backend = new MockSnapshotSetBackend();
+         backend.DoSnapshotSetFailure = session => session == 3 ? error : null;
+         backend.AbortBackupFailure = session => new InvalidOperationException("Abort failed.");
+         backend.DisposeFailure = session => new InvalidOperationException("Dispose failed.");
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(backend.CreateSession);
+         orchestrator.MaximumVolumesPerSet = 2;
+         orchestrator.PipelineInitialization = false;
+
+         Outcome outcome = Run(orchestrator, s_volumes);
+
+         Assert.AreSame(error, outcome.Exception);
+         Assert.AreEqual(3, backend.Sessions.Count);
+         Assert.IsTrue(backend.Sessions.All(session => session.IsAborted && session.IsDisposed));
+      }
+
+      [TestMethod]
+      public void CreateSnapshots_PipelinedInitializationFails_RethrowsExceptionAndAbortsCompletedSets()
+      {
+         VssUnexpectedErrorException error = new VssUnexpectedErrorException();
+         MockSnapshotSetBackend backend = new MockSnapshotSetBackend();
+         backend.InitializeFailure = session => session == 2 ? error : null;
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(backend.CreateSession);
+         orchestrator.MaximumVolumesPerSet = 2;
+
+         Outcome outcome = Run(orchestrator, s_volumes);
+
+         Assert.AreSame(error, outcome.Exception);
+         Assert.AreEqual(2, backend.Sessions.Count);
+         Assert.IsTrue(backend.Sessions[0].IsAborted);
+         Assert.IsTrue(backend.Sessions.All(session => session.IsDisposed));
+      }
+
+      [TestMethod]
+      public void CreateSnapshots_FailsWhileNextSessionInitializes_DisposesSessionAfterInitialization()
+      {
+         VssProviderVetoException error = new VssProviderVetoException();
+         MockSnapshotSetBackend backend = new MockSnapshotSetBackend();
+         backend.InitializeLatency = TimeSpan.FromMilliseconds(300);
+         backend.DoSnapshotSetFailure = session => error;
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(backend.CreateSession);
+         orchestrator.MaximumVolumesPerSet = 2;
+
+         Outcome outcome = Run(orchestrator, s_volumes);
+
+         Assert.AreSame(error, outcome.Exception);
+         Assert.AreEqual(2, backend.Sessions.Count);
+         Assert.IsTrue(backend.IndexOf("2.Initialize.End") < backend.IndexOf("2.Dispose"));
+         Assert.IsFalse(backend.Sessions.Any(session => session.ConcurrentCallDetected));
+      }
+
+      [TestMethod]
+      public void CreateSnapshots_Canceled_ThrowsWithoutCreatingSessions()
+      {
+         MockSnapshotSetBackend backend = new MockSnapshotSetBackend();
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(backend.CreateSession);
+
+         using (CancellationTokenSource cancellation = new CancellationTokenSource())
+         {
+            cancellation.Cancel();
+            Outcome outcome = Run(() => orchestrator.CreateSnapshots(s_volumes, cancellation.Token), ApartmentState.MTA);
+
+            Assert.IsInstanceOfType(outcome.Exception, typeof(OperationCanceledException));
+            Assert.AreEqual(0, backend.Sessions.Count);
+         }
+      }
+
+      #endregion
+
+      #region Pipelining
+
+      [TestMethod]
+      public void CreateSnapshots_Pipelined_InitializesNextSessionWhileSnapshotIsCreated()
+      {
+         MockSnapshotSetBackend backend = new MockSnapshotSetBackend();
+         backend.InitializeLatency = TimeSpan.FromMilliseconds(100);
+         backend.DoSnapshotSetLatency = TimeSpan.FromMilliseconds(400);
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(backend.CreateSession);
+         orchestrator.MaximumVolumesPerSet = 2;
+
+         Outcome outcome = Run(orchestrator, s_volumes);
+         Assert.IsNull(outcome.Exception);
+
+         using (VssSnapshotOrchestrationResult result = outcome.Result)
+         {
+            Assert.IsTrue(backend.IndexOf("2.Initialize.Begin") < backend.IndexOf("1.DoSnapshotSet.End"));
+            Assert.IsTrue(backend.IndexOf("3.Initialize.Begin") < backend.IndexOf("2.DoSnapshotSet.End"));
+            Assert.IsTrue(result.Sets[1].WaitTime < backend.InitializeLatency);
+            Assert.IsTrue(result.Sets[2].WaitTime < backend.InitializeLatency);
+
+            // The sessions are created and used on the calling thread; only Initialize of the pipelined sessions runs elsewhere.
+            IList<MockSnapshotSetSession> sessions = backend.Sessions;
+            Assert.IsTrue(sessions.All(session => session.CreationThreadId == outcome.ThreadId));
+            Assert.IsTrue(sessions.All(session => session.CallerThreadIds.SequenceEqual(new[] { outcome.ThreadId })));
+            Assert.AreEqual(outcome.ThreadId, sessions[0].InitializeThreadId);
+            Assert.AreNotEqual(outcome.ThreadId, sessions[1].InitializeThreadId);
+            Assert.AreNotEqual(outcome.ThreadId, sessions[2].InitializeThreadId);
+         }
+      }
+
+      [TestMethod]
+      public void CreateSnapshots_PipelineDisabled_InitializesEachSessionAfterThePreviousSet()
+      {
+         MockSnapshotSetBackend backend = new MockSnapshotSetBackend();
+         backend.InitializeLatency = TimeSpan.FromMilliseconds(50);
+         backend.DoSnapshotSetLatency = TimeSpan.FromMilliseconds(50);
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(backend.CreateSession);
+         orchestrator.MaximumVolumesPerSet = 2;
+         orchestrator.PipelineInitialization = false;
+
+         AssertNotPipelined(backend, Run(orchestrator, s_volumes));
+      }
+
+      [TestMethod]
+      public void CreateSnapshots_SingleThreadedApartment_InitializesEachSessionOnCallingThread()
+      {
+         MockSnapshotSetBackend backend = new MockSnapshotSetBackend();
+         backend.InitializeLatency = TimeSpan.FromMilliseconds(50);
+         backend.DoSnapshotSetLatency = TimeSpan.FromMilliseconds(50);
+         VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(backend.CreateSession);
+         orchestrator.MaximumVolumesPerSet = 2;
+
+         AssertNotPipelined(backend, Run(orchestrator, s_volumes, ApartmentState.STA));
+      }
+
+      #endregion
+
+      #region Private Members
+
+      private sealed class Outcome
+      {
+         public VssSnapshotOrchestrationResult Result { get; set; }
+
+         public Exception Exception { get; set; }
+
+         public int ThreadId { get; set; }
+      }
+
+      private static void AssertNotPipelined(MockSnapshotSetBackend backend, Outcome outcome)
+      {
+         Assert.IsNull(outcome.Exception);
+
+         using (outcome.Result)
+         {
+            Assert.IsTrue(backend.IndexOf("1.DoSnapshotSet.End") < backend.IndexOf("2.Initialize.Begin"));
+            Assert.IsTrue(backend.IndexOf("2.DoSnapshotSet.End") < backend.IndexOf("3.Initialize.Begin"));
+            Assert.IsTrue(backend.Sessions.All(session => session.InitializeThreadId == outcome.ThreadId));
+         }
+      }
+
+      private static Outcome Run(VssSnapshotOrchestrator orchestrator, IEnumerable<string> volumes)
+      {
+         return Run(orchestrator, volumes, ApartmentState.MTA);
+      }
+
+      private static Outcome Run(VssSnapshotOrchestrator orchestrator, IEnumerable<string> volumes, ApartmentState apartment)
+      {
+         return Run(() => orchestrator.CreateSnapshots(volumes), apartment);
+      }
+
+      // Runs the orchestration on a new thread, since the test thread may belong to either apartment.
+      private static Outcome Run(Func<VssSnapshotOrchestrationResult> createSnapshots, ApartmentState apartment)
+      {
+         Outcome outcome = new Outcome();
+         Thread thread = new Thread(() =>
+            {
+               outcome.ThreadId = Thread.CurrentThread.ManagedThreadId;
+               try
+               {
+                  outcome.Result = createSnapshots();
+               }
+               catch (Exception ex)
+               {
+                  outcome.Exception = ex;
+               }
+            });
+
+         thread.SetApartmentState(apartment);
+         thread.Start();
+         thread.Join();
+         return outcome;
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,45 @@
+using System;
+using System.ComponentModel;
+using System.Reflection;
+#if NET45
+using System.Runtime.ExceptionServices;
+#endif
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     Infrastructure. Helper methods for exception handling shared by this assembly and the platform specific assemblies.
+   ///     This type is not intended to be used directly from your code.
+   /// </summary>
+   [EditorBrowsable(EditorBrowsableState.Never)]
+   public static class ExceptionHelper
+   {
+      /// <summary>
+      ///     Prepares an exception caught earlier, possibly on another thread, to be rethrown without losing its stack trace.
+      /// </summary>
+      /// <param name="exception">The exception to rethrow.</param>
+      /// <returns><paramref name="exception"/>, which the caller must throw.</returns>
+      /// <remarks>
+      ///     <para>
+      ///         Used as <c>throw ExceptionHelper.Rethrow(ex);</c>. On .NET 4.5 the exception is rethrown by <c>ExceptionDispatchInfo</c>
+      ///         and this method does not return. .NET 4.0 has no <c>ExceptionDispatchInfo</c>, so the runtime is instead asked to keep
+      ///         the original stack trace when the exception is thrown again.
+      ///     </para>
+      ///     <para>
+      ///         The platform specific assemblies call this method too, so that the <c>NET45</c> symbol of this project is the only
+      ///         switch between the two implementations.
+      ///     </para>
+      /// </remarks>
+      public static Exception Rethrow(Exception exception)
+      {
+#if NET45
+         ExceptionDispatchInfo.Capture(exception).Throw();
+#else
+         MethodInfo preserveStackTrace = typeof(Exception).GetMethod("InternalPreserveStackTrace", BindingFlags.Instance | BindingFlags.NonPublic);
+         if (preserveStackTrace != null)
+            preserveStackTrace.Invoke(exception, null);
+#endif
+         return exception;
+      }
+   }
+}
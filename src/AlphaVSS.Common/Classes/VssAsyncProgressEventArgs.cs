@@ -0,0 +1,54 @@
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     Provides data for the <see cref="IVssAsyncResult.ProgressChanged"/> event.
+   /// </summary>
+   [Serializable]
+   public class VssAsyncProgressEventArgs : EventArgs
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssAsyncProgressEventArgs"/> class.
+      /// </summary>
+      /// <param name="status">The status of the operation.</param>
+      /// <param name="previousStatus">The status of the operation reported by the previous sample.</param>
+      /// <param name="elapsed">The time elapsed since the operation was started.</param>
+      public VssAsyncProgressEventArgs(VssAsyncStatus status, VssAsyncStatus previousStatus, TimeSpan elapsed)
+      {
+         Status = status;
+         PreviousStatus = previousStatus;
+         Elapsed = elapsed;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the status of the operation.
+      /// </summary>
+      public VssAsyncStatus Status { get; private set; }
+
+      /// <summary>
+      /// Gets the status of the operation reported by the previous sample.
+      /// </summary>
+      public VssAsyncStatus PreviousStatus { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the status of the operation changed since the previous sample.
+      /// </summary>
+      public bool IsStatusChange
+      {
+         get
+         {
+            return Status != PreviousStatus;
+         }
+      }
+
+      /// <summary>
+      /// Gets the time elapsed since the operation was started.
+      /// </summary>
+      public TimeSpan Elapsed { get; private set; }
+
+      #endregion
+   }
+}
@@ -0,0 +1,69 @@
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssAsyncTiming"/> class records the timing of the phases of an asynchronous VSS operation, as
+   ///     returned by <see cref="IVssAsyncResult.Timing"/>.
+   /// </summary>
+   [Serializable]
+   public class VssAsyncTiming
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssAsyncTiming"/> class.
+      /// </summary>
+      /// <param name="startTime">The time (in UTC) at which the operation was started.</param>
+      /// <param name="firstSample">The time from the start of the operation until its status was first queried, or <see langword="null"/> if the status has not been queried yet.</param>
+      /// <param name="completion">The time from the start of the operation until it was observed to be complete, or <see langword="null"/> if it is still pending.</param>
+      /// <param name="status">The last observed status of the operation.</param>
+      /// <param name="sampleCount">The number of times the status of the operation was queried.</param>
+      public VssAsyncTiming(DateTime startTime, TimeSpan? firstSample, TimeSpan? completion, VssAsyncStatus status, int sampleCount)
+      {
+         StartTime = startTime;
+         FirstSample = firstSample;
+         Completion = completion;
+         Status = status;
+         SampleCount = sampleCount;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the time, in UTC, at which the operation was started.
+      /// </summary>
+      public DateTime StartTime { get; private set; }
+
+      /// <summary>
+      /// Gets the time from the start of the operation until its status was first queried.
+      /// </summary>
+      /// <value>The time until the first sample of the status, or <see langword="null"/> if the status has not been queried yet.</value>
+      /// <remarks>
+      ///     This is the time of the first poll, whatever status it returned; it does not mark a change of the status reported by VSS.
+      ///     It includes the time spent waiting for the first response of VSS, and equals <see cref="Completion"/> only if the operation
+      ///     was already complete at that time.
+      /// </remarks>
+      public TimeSpan? FirstSample { get; private set; }
+
+      /// <summary>
+      /// Gets the time from the start of the operation until it was observed to be complete.
+      /// </summary>
+      /// <value>The time until completion, or <see langword="null"/> if the operation is still pending.</value>
+      /// <remarks>
+      ///     The status of an operation is sampled, so this value may exceed the actual duration of the operation by up to the
+      ///     interval at which the status is queried.
+      /// </remarks>
+      public TimeSpan? Completion { get; private set; }
+
+      /// <summary>
+      /// Gets the last observed status of the operation.
+      /// </summary>
+      public VssAsyncStatus Status { get; private set; }
+
+      /// <summary>
+      /// Gets the number of times the status of the operation was queried.
+      /// </summary>
+      public int SampleCount { get; private set; }
+
+      #endregion
+   }
+}
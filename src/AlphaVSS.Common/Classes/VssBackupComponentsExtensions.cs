@@ -0,0 +1,316 @@
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssBackupComponentsExtensions"/> class provides <see cref="Task"/> based versions of the asynchronous
+   ///     operations of <see cref="IVssBackupComponents"/>.
+   /// </summary>
+   /// <remarks>
+   ///     <para>
+   ///         Each method starts the operation using the corresponding <c>Begin</c> method and completes the returned task from the
+   ///         callback of the operation, so no thread is blocked while the operation is in progress.
+   ///     </para>
+   ///     <para>
+   ///         When the <see cref="CancellationToken"/> passed to a method is canceled while the operation is in progress,
+   ///         <see cref="IVssAsyncResult.Cancel"/> is called to request cancellation of the operation. If VSS reports the operation as
+   ///         canceled, the returned task is canceled. Note that not all operations can be canceled at all stages, in which case the task
+   ///         completes normally. If the request for cancellation itself fails, the task is faulted with the resulting exception, which is
+   ///         never thrown to the caller of <see cref="CancellationTokenSource.Cancel()"/>.
+   ///     </para>
+   /// </remarks>
+   public static class VssBackupComponentsExtensions
+   {
+      #region Public Methods
+
+      /// <summary>
+      /// Causes VSS to generate a <b>BackupComplete</b> event, which signals writers that the backup process has completed, as an asynchronous operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object on which to perform the operation.</param>
+      /// <param name="cancellationToken">A token used to request cancellation of the operation.</param>
+      /// <returns>A task representing the asynchronous operation.</returns>
+      /// <seealso cref="IVssBackupComponents.BackupComplete"/>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      public static Task BackupCompleteAsync(this IVssBackupComponents backupComponents, CancellationToken cancellationToken = default(CancellationToken))
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException("backupComponents");
+
+         return FromAsync(callback => backupComponents.BeginBackupComplete(callback, null), backupComponents.EndBackupComplete, cancellationToken);
+      }
+
+      /// <summary>
+      /// Breaks a shadow copy set according to requester-specified options, as an asynchronous operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object on which to perform the operation.</param>
+      /// <param name="snapshotSetId">A shadow copy set identifier.</param>
+      /// <param name="breakFlags">A bitmask of <see cref="VssHardwareOptions"/> flags that specify how the shadow copy set is broken.</param>
+      /// <param name="cancellationToken">A token used to request cancellation of the operation.</param>
+      /// <returns>A task representing the asynchronous operation.</returns>
+      /// <seealso cref="IVssBackupComponents.BreakSnapshotSet(Guid, VssHardwareOptions)"/>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      public static Task BreakSnapshotSetAsync(this IVssBackupComponents backupComponents, Guid snapshotSetId, VssHardwareOptions breakFlags, CancellationToken cancellationToken = default(CancellationToken))
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException("backupComponents");
+
+         return FromAsync(callback => backupComponents.BeginBreakSnapshotSet(snapshotSetId, breakFlags, callback, null), backupComponents.EndBreakSnapshotSet, cancellationToken);
+      }
+
+      /// <summary>
+      /// Commits all shadow copies in this set simultaneously as an asynchronous operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object on which to perform the operation.</param>
+      /// <param name="cancellationToken">A token used to request cancellation of the operation.</param>
+      /// <returns>A task representing the asynchronous operation.</returns>
+      /// <seealso cref="IVssBackupComponents.DoSnapshotSet"/>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      public static Task DoSnapshotSetAsync(this IVssBackupComponents backupComponents, CancellationToken cancellationToken = default(CancellationToken))
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException("backupComponents");
+
+         return FromAsync(callback => backupComponents.BeginDoSnapshotSet(callback, null), backupComponents.EndDoSnapshotSet, cancellationToken);
+      }
+
+      /// <summary>
+      /// Prompts each writer to send the metadata they have collected, as an asynchronous operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object on which to perform the operation.</param>
+      /// <param name="cancellationToken">A token used to request cancellation of the operation.</param>
+      /// <returns>A task representing the asynchronous operation.</returns>
+      /// <seealso cref="IVssBackupComponents.GatherWriterMetadata"/>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      public static Task GatherWriterMetadataAsync(this IVssBackupComponents backupComponents, CancellationToken cancellationToken = default(CancellationToken))
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException("backupComponents");
+
+         return FromAsync(callback => backupComponents.BeginGatherWriterMetadata(callback, null), backupComponents.EndGatherWriterMetadata, cancellationToken);
+      }
+
+      /// <summary>
+      /// Prompts each writer to send a status message, as an asynchronous operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object on which to perform the operation.</param>
+      /// <param name="cancellationToken">A token used to request cancellation of the operation.</param>
+      /// <returns>A task representing the asynchronous operation.</returns>
+      /// <seealso cref="IVssBackupComponents.GatherWriterStatus"/>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      public static Task GatherWriterStatusAsync(this IVssBackupComponents backupComponents, CancellationToken cancellationToken = default(CancellationToken))
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException("backupComponents");
+
+         return FromAsync(callback => backupComponents.BeginGatherWriterStatus(callback, null), backupComponents.EndGatherWriterStatus, cancellationToken);
+      }
+
+      /// <summary>
+      /// Imports shadow copies transported from a different machine, as an asynchronous operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object on which to perform the operation.</param>
+      /// <param name="cancellationToken">A token used to request cancellation of the operation.</param>
+      /// <returns>A task representing the asynchronous operation.</returns>
+      /// <seealso cref="IVssBackupComponents.ImportSnapshots"/>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      public static Task ImportSnapshotsAsync(this IVssBackupComponents backupComponents, CancellationToken cancellationToken = default(CancellationToken))
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException("backupComponents");
+
+         return FromAsync(callback => backupComponents.BeginImportSnapshots(callback, null), backupComponents.EndImportSnapshots, cancellationToken);
+      }
+
+      /// <summary>
+      /// Causes VSS to generate a <b>PostRestore</b> event, signaling writers that the current restore operation has finished, as an asynchronous operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object on which to perform the operation.</param>
+      /// <param name="cancellationToken">A token used to request cancellation of the operation.</param>
+      /// <returns>A task representing the asynchronous operation.</returns>
+      /// <seealso cref="IVssBackupComponents.PostRestore"/>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      public static Task PostRestoreAsync(this IVssBackupComponents backupComponents, CancellationToken cancellationToken = default(CancellationToken))
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException("backupComponents");
+
+         return FromAsync(callback => backupComponents.BeginPostRestore(callback, null), backupComponents.EndPostRestore, cancellationToken);
+      }
+
+      /// <summary>
+      /// Notifies writers to prepare for a backup operation, as an asynchronous operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object on which to perform the operation.</param>
+      /// <param name="cancellationToken">A token used to request cancellation of the operation.</param>
+      /// <returns>A task representing the asynchronous operation.</returns>
+      /// <seealso cref="IVssBackupComponents.PrepareForBackup"/>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      public static Task PrepareForBackupAsync(this IVssBackupComponents backupComponents, CancellationToken cancellationToken = default(CancellationToken))
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException("backupComponents");
+
+         return FromAsync(callback => backupComponents.BeginPrepareForBackup(callback, null), backupComponents.EndPrepareForBackup, cancellationToken);
+      }
+
+      /// <summary>
+      /// Notifies writers to prepare for a restore operation, as an asynchronous operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object on which to perform the operation.</param>
+      /// <param name="cancellationToken">A token used to request cancellation of the operation.</param>
+      /// <returns>A task representing the asynchronous operation.</returns>
+      /// <seealso cref="IVssBackupComponents.PreRestore"/>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      public static Task PreRestoreAsync(this IVssBackupComponents backupComponents, CancellationToken cancellationToken = default(CancellationToken))
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException("backupComponents");
+
+         return FromAsync(callback => backupComponents.BeginPreRestore(callback, null), backupComponents.EndPreRestore, cancellationToken);
+      }
+
+      /// <summary>
+      /// Waits for the completion of a revert operation on the specified volume, as an asynchronous operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object on which to perform the operation.</param>
+      /// <param name="volumeName">Name of the volume. The name must be in one of the formats accepted by <see cref="IVssBackupComponents.BeginQueryRevertStatus"/>.</param>
+      /// <param name="cancellationToken">A token used to request cancellation of the operation.</param>
+      /// <returns>A task representing the asynchronous operation.</returns>
+      /// <seealso cref="IVssBackupComponents.BeginQueryRevertStatus"/>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      public static Task QueryRevertStatusAsync(this IVssBackupComponents backupComponents, string volumeName, CancellationToken cancellationToken = default(CancellationToken))
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException("backupComponents");
+
+         return FromAsync(callback => backupComponents.BeginQueryRevertStatus(volumeName, callback, null), backupComponents.EndQueryRevertStatus, cancellationToken);
+      }
+
+      /// <summary>
+      /// Initiates a LUN resynchronization operation, as an asynchronous operation.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object on which to perform the operation.</param>
+      /// <param name="options">A combination of <see cref="VssRecoveryOptions"/> flags.</param>
+      /// <param name="cancellationToken">A token used to request cancellation of the operation.</param>
+      /// <returns>A task representing the asynchronous operation.</returns>
+      /// <seealso cref="IVssBackupComponents.RecoverSet"/>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      public static Task RecoverSetAsync(this IVssBackupComponents backupComponents, VssRecoveryOptions options, CancellationToken cancellationToken = default(CancellationToken))
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException("backupComponents");
+
+         return FromAsync(callback => backupComponents.BeginRecoverSet(options, callback, null), backupComponents.EndRecoverSet, cancellationToken);
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private static Task FromAsync(Func<AsyncCallback, IVssAsyncResult> begin, Action<IAsyncResult> end, CancellationToken cancellationToken)
+      {
+         TaskCompletionSource<object> completion = new TaskCompletionSource<object>();
+         if (cancellationToken.IsCancellationRequested)
+         {
+            completion.SetCanceled();
+            return completion.Task;
+         }
+
+         AsyncOperation operation = new AsyncOperation(completion, end);
+         IVssAsyncResult asyncResult = begin(operation.OnCompleted);
+         operation.RegisterCancellation(asyncResult, cancellationToken);
+         return completion.Task;
+      }
+
+      #endregion
+
+      #region Nested Types
+
+      // Completes a task from the callback of a Begin/End operation, and links the cancellation token
+      // to IVssAsyncResult.Cancel for as long as the operation is in progress.
+      private sealed class AsyncOperation
+      {
+         private readonly object m_syncRoot = new object();
+         private readonly TaskCompletionSource<object> m_completion;
+         private readonly Action<IAsyncResult> m_end;
+         private CancellationTokenRegistration m_registration;
+         private bool m_isCompleted;
+
+         public AsyncOperation(TaskCompletionSource<object> completion, Action<IAsyncResult> end)
+         {
+            m_completion = completion;
+            m_end = end;
+         }
+
+         public void RegisterCancellation(IVssAsyncResult asyncResult, CancellationToken cancellationToken)
+         {
+            if (!cancellationToken.CanBeCanceled)
+               return;
+
+            CancellationTokenRegistration registration = cancellationToken.Register(Cancel, asyncResult);
+            lock (m_syncRoot)
+            {
+               if (!m_isCompleted)
+               {
+                  m_registration = registration;
+                  return;
+               }
+            }
+
+            // The operation completed before the registration could be stored.
+            registration.Dispose();
+         }
+
+         public void OnCompleted(IAsyncResult asyncResult)
+         {
+            try
+            {
+               m_end(asyncResult);
+               m_completion.TrySetResult(null);
+            }
+            catch (OperationCanceledException)
+            {
+               m_completion.TrySetCanceled();
+            }
+            catch (Exception ex)
+            {
+               m_completion.TrySetException(ex);
+            }
+            finally
+            {
+               CancellationTokenRegistration registration;
+               lock (m_syncRoot)
+               {
+                  m_isCompleted = true;
+                  registration = m_registration;
+               }
+
+               registration.Dispose();
+               ((IDisposable)asyncResult).Dispose();
+            }
+         }
+
+         // Runs on the thread calling CancellationTokenSource.Cancel, so no exception may escape; a failure
+         // to cancel is reported through the task instead.
+         private void Cancel(object state)
+         {
+            try
+            {
+               ((IVssAsyncResult)state).Cancel();
+            }
+            catch (ObjectDisposedException)
+            {
+               // The operation completed concurrently.
+            }
+            catch (Exception ex)
+            {
+               m_completion.TrySetException(ex);
+            }
+         }
+      }
+
+      #endregion
+   }
+}
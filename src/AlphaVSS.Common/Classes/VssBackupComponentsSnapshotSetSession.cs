@@ -0,0 +1,145 @@
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssBackupComponentsSnapshotSetSession"/> class implements <see cref="IVssSnapshotSetSession"/> on top of an
+   ///     <see cref="IVssBackupComponents"/> instance.
+   /// </summary>
+   /// <remarks>
+   ///     The session owns the backup components object, and disposes it when the session is disposed. The backup components object
+   ///     can be used through <see cref="BackupComponents"/> to complete the backup once the shadow copies have been created, for
+   ///     example by calling <see cref="IVssBackupComponents.BackupComplete"/>.
+   /// </remarks>
+   public sealed class VssBackupComponentsSnapshotSetSession : IVssSnapshotSetSession
+   {
+      #region Private Fields
+
+      private readonly VssSnapshotContext m_context;
+      private readonly VssBackupType m_backupType;
+      private readonly bool m_withWriters;
+      private IVssBackupComponents m_backupComponents;
+
+      #endregion
+
+      #region Constructor
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssBackupComponentsSnapshotSetSession"/> class.
+      /// </summary>
+      /// <param name="backupComponents">The backup components object used by the session. The session takes ownership of the object.</param>
+      /// <param name="context">The context of the shadow copies to create.</param>
+      /// <param name="backupType">The type of backup to perform.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      public VssBackupComponentsSnapshotSetSession(IVssBackupComponents backupComponents, VssSnapshotContext context, VssBackupType backupType)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException("backupComponents");
+
+         m_backupComponents = backupComponents;
+         m_context = context;
+         m_backupType = backupType;
+         m_withWriters = ((VssVolumeSnapshotAttributes)context & VssVolumeSnapshotAttributes.NoWriters) == 0;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the backup components object used by this session.
+      /// </summary>
+      /// <exception cref="ObjectDisposedException">The session has been disposed.</exception>
+      public IVssBackupComponents BackupComponents
+      {
+         get
+         {
+            if (m_backupComponents == null)
+               throw new ObjectDisposedException(GetType().FullName);
+
+            return m_backupComponents;
+         }
+      }
+
+      #endregion
+
+      #region IVssSnapshotSetSession Members
+
+      /// <summary>
+      /// Initializes the backup components object for backup, and gathers the writer metadata unless the context excludes writers.
+      /// </summary>
+      public void Initialize()
+      {
+         IVssBackupComponents backupComponents = BackupComponents;
+         backupComponents.InitializeForBackup(null);
+         backupComponents.SetContext(m_context);
+         backupComponents.SetBackupState(false, false, m_backupType, false);
+
+         if (m_withWriters)
+            backupComponents.GatherWriterMetadata();
+      }
+
+      /// <summary>
+      /// Creates a new, empty shadow copy set.
+      /// </summary>
+      /// <returns>The identifier of the created shadow copy set.</returns>
+      public Guid StartSnapshotSet()
+      {
+         return BackupComponents.StartSnapshotSet();
+      }
+
+      /// <summary>
+      /// Adds an original volume to the shadow copy set.
+      /// </summary>
+      /// <param name="volumeName">The name of the volume to be shadow copied.</param>
+      /// <param name="providerId">The provider to be used, or <see cref="Guid.Empty"/> to use the default provider.</param>
+      /// <returns>The identifier of the added shadow copy.</returns>
+      public Guid AddToSnapshotSet(string volumeName, Guid providerId)
+      {
+         return BackupComponents.AddToSnapshotSet(volumeName, providerId);
+      }
+
+      /// <summary>
+      /// Notifies the writers to prepare for the backup, unless the context excludes writers.
+      /// </summary>
+      public void PrepareForBackup()
+      {
+         if (m_withWriters)
+            BackupComponents.PrepareForBackup();
+      }
+
+      /// <summary>
+      /// Creates the shadow copies of the volumes in the shadow copy set.
+      /// </summary>
+      public void DoSnapshotSet()
+      {
+         BackupComponents.DoSnapshotSet();
+      }
+
+      /// <summary>
+      /// Aborts the backup, deleting any shadow copies created by the session.
+      /// </summary>
+      public void AbortBackup()
+      {
+         BackupComponents.AbortBackup();
+      }
+
+      #endregion
+
+      #region IDisposable Members
+
+      /// <summary>
+      /// Disposes the backup components object owned by this session.
+      /// </summary>
+      public void Dispose()
+      {
+         if (m_backupComponents != null)
+         {
+            m_backupComponents.Dispose();
+            m_backupComponents = null;
+         }
+      }
+
+      #endregion
+   }
+}
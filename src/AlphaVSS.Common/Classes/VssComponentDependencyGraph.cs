@@ -0,0 +1,454 @@
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssComponentDependencyGraph"/> class resolves the dependencies declared by the components of a set of writers,
+   ///     allowing a requester to determine which components must be added to a backup along with a selected component, and in which order.
+   /// </summary>
+   /// <remarks>
+   ///     <para>
+   ///         Components are identified by dense integer ids, which are their positions in <see cref="Components"/>. A dependency
+   ///         (<see cref="VssWMDependency"/>) identifies the component it refers to by writer class id, logical path and component name,
+   ///         and therefore resolves to the matching component of every instance of that writer. Dependencies that do not match any component
+   ///         of the graph are ignored, and can be retrieved using <see cref="GetUnresolvedDependencies"/>.
+   ///     </para>
+   ///     <para>
+   ///         The graph is built in time linear in the number of components and dependencies. Dependency cycles are detected while the graph
+   ///         is built, and the components are ordered so that every component follows the components it depends on; the components of a
+   ///         cycle are ordered by id. Transitive dependencies are computed on demand, in time linear in the size of the part of the graph
+   ///         that is reachable from the selected components.
+   ///     </para>
+   ///     <para>
+   ///         A graph can be built from <see cref="VssDependencyGraphComponent"/> instances as well as from writer metadata, so it can be
+   ///         used on metadata obtained without a VSS session.
+   ///     </para>
+   /// </remarks>
+   public sealed class VssComponentDependencyGraph
+   {
+      #region Private Fields
+
+      private static readonly StringComparer s_pathComparer = StringComparer.OrdinalIgnoreCase;
+
+      private readonly VssDependencyGraphComponent[] m_components;
+
+      // Lookup of component ids by writer class id, logical path and component name, and by writer instance id, logical path and component name.
+      private readonly Dictionary<string, List<int>> m_byWriterId = new Dictionary<string, List<int>>(s_pathComparer);
+      private readonly Dictionary<string, int> m_byInstanceId = new Dictionary<string, int>(s_pathComparer);
+
+      // The resolved dependencies in compressed sparse row form; the dependencies of component i are
+      // m_edges[m_edgeStart[i]] through m_edges[m_edgeStart[i + 1] - 1].
+      private readonly int[] m_edgeStart;
+      private readonly int[] m_edges;
+
+      // The component ids in dependency order, and the position of each component in that order.
+      private readonly int[] m_order;
+      private readonly int[] m_rank;
+
+      private readonly IList<IList<int>> m_cycles;
+
+      #endregion
+
+      #region Constructors
+
+      private VssComponentDependencyGraph(IEnumerable<VssDependencyGraphComponent> components)
+      {
+         m_components = new List<VssDependencyGraphComponent>(components).ToArray();
+
+         for (int id = 0; id < m_components.Length; id++)
+         {
+            VssDependencyGraphComponent component = m_components[id];
+            if (component == null)
+               throw new ArgumentException("The sequence of components contains a null reference.", "components");
+
+            string key = GetKey(component.WriterId, component.LogicalPath, component.ComponentName);
+            List<int> ids;
+            if (!m_byWriterId.TryGetValue(key, out ids))
+            {
+               ids = new List<int>(1);
+               m_byWriterId.Add(key, ids);
+            }
+            ids.Add(id);
+
+            key = GetKey(component.InstanceId, component.LogicalPath, component.ComponentName);
+            if (!m_byInstanceId.ContainsKey(key))
+               m_byInstanceId.Add(key, id);
+         }
+
+         List<int> edges = new List<int>();
+         m_edgeStart = new int[m_components.Length + 1];
+         for (int id = 0; id < m_components.Length; id++)
+         {
+            m_edgeStart[id] = edges.Count;
+            foreach (VssWMDependency dependency in m_components[id].Dependencies)
+            {
+               List<int> targets;
+               if (dependency != null && m_byWriterId.TryGetValue(GetKey(dependency.WriterId, dependency.LogicalPath, dependency.ComponentName), out targets))
+                  edges.AddRange(targets);
+            }
+         }
+         m_edgeStart[m_components.Length] = edges.Count;
+         m_edges = edges.ToArray();
+
+         m_order = new int[m_components.Length];
+         m_rank = new int[m_components.Length];
+         List<IList<int>> cycles = new List<IList<int>>();
+         SortComponents(cycles);
+         m_cycles = cycles.AsReadOnly();
+      }
+
+      #endregion
+
+      #region Public Properties
+
+      /// <summary>
+      /// Gets the components of the graph. The id of a component is its index in this list.
+      /// </summary>
+      public IList<VssDependencyGraphComponent> Components
+      {
+         get
+         {
+            return Array.AsReadOnly(m_components);
+         }
+      }
+
+      /// <summary>
+      /// Gets the ids of all components, ordered so that every component follows the components it depends on.
+      /// </summary>
+      public IList<int> DependencyOrder
+      {
+         get
+         {
+            return Array.AsReadOnly(m_order);
+         }
+      }
+
+      /// <summary>
+      /// Gets a value indicating whether the dependencies of the components contain a cycle.
+      /// </summary>
+      public bool HasCycles
+      {
+         get
+         {
+            return m_cycles.Count > 0;
+         }
+      }
+
+      /// <summary>
+      /// Gets the dependency cycles of the graph.
+      /// </summary>
+      /// <value>
+      /// A list containing, for every set of components that (directly or indirectly) depend on each other, the ids of these components in
+      /// ascending order. A component that depends on itself forms a cycle on its own.
+      /// </value>
+      public IList<IList<int>> Cycles
+      {
+         get
+         {
+            return m_cycles;
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Creates a dependency graph of the components of the specified writers.
+      /// </summary>
+      /// <param name="writers">The metadata of the writers, as returned by <see cref="IVssBackupComponents.WriterMetadata"/>.</param>
+      /// <returns>The dependency graph of the components of <paramref name="writers"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="writers"/> is <see langword="null"/>.</exception>
+      public static VssComponentDependencyGraph Create(IEnumerable<IVssExamineWriterMetadata> writers)
+      {
+         if (writers == null)
+            throw new ArgumentNullException("writers");
+
+         List<VssDependencyGraphComponent> components = new List<VssDependencyGraphComponent>();
+         foreach (IVssExamineWriterMetadata writer in writers)
+         {
+            if (writer == null)
+               throw new ArgumentException("The sequence of writers contains a null reference.", "writers");
+
+            foreach (IVssWMComponent component in writer.Components)
+            {
+               components.Add(new VssDependencyGraphComponent(writer.InstanceId, writer.WriterId, component.Type, component.LogicalPath,
+                  component.ComponentName, component.Dependencies));
+            }
+         }
+
+         return new VssComponentDependencyGraph(components);
+      }
+
+      /// <summary>
+      /// Creates a dependency graph of the specified components.
+      /// </summary>
+      /// <param name="components">The components of the graph.</param>
+      /// <returns>The dependency graph of <paramref name="components"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="components"/> is <see langword="null"/>.</exception>
+      public static VssComponentDependencyGraph Create(IEnumerable<VssDependencyGraphComponent> components)
+      {
+         if (components == null)
+            throw new ArgumentNullException("components");
+
+         return new VssComponentDependencyGraph(components);
+      }
+
+      /// <summary>
+      /// Finds the id of the component with the specified logical path and name, owned by the specified writer instance.
+      /// </summary>
+      /// <param name="instanceId">The instance id of the writer owning the component.</param>
+      /// <param name="logicalPath">The logical path of the component. Paths are compared without regard to case or trailing backslashes.</param>
+      /// <param name="componentName">The name of the component. Names are compared without regard to case.</param>
+      /// <returns>The id of the component, or <c>-1</c> if no such component exists.</returns>
+      public int FindComponent(Guid instanceId, string logicalPath, string componentName)
+      {
+         int id;
+         if (componentName == null || !m_byInstanceId.TryGetValue(GetKey(instanceId, logicalPath, componentName), out id))
+            return -1;
+
+         return id;
+      }
+
+      /// <summary>
+      /// Gets the ids of the components that a component directly depends on.
+      /// </summary>
+      /// <param name="id">The id of the component.</param>
+      /// <returns>The ids of the components that the component directly depends on.</returns>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="id"/> is not a valid component id.</exception>
+      public IList<int> GetDependencies(int id)
+      {
+         CheckId(id, "id");
+
+         int[] dependencies = new int[m_edgeStart[id + 1] - m_edgeStart[id]];
+         Array.Copy(m_edges, m_edgeStart[id], dependencies, 0, dependencies.Length);
+         return Array.AsReadOnly(dependencies);
+      }
+
+      /// <summary>
+      /// Gets the dependencies declared by a component that do not match any component of the graph.
+      /// </summary>
+      /// <param name="id">The id of the component.</param>
+      /// <returns>The unresolved dependencies of the component.</returns>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="id"/> is not a valid component id.</exception>
+      public IList<VssWMDependency> GetUnresolvedDependencies(int id)
+      {
+         CheckId(id, "id");
+
+         List<VssWMDependency> unresolved = new List<VssWMDependency>();
+         foreach (VssWMDependency dependency in m_components[id].Dependencies)
+         {
+            if (dependency != null && !m_byWriterId.ContainsKey(GetKey(dependency.WriterId, dependency.LogicalPath, dependency.ComponentName)))
+               unresolved.Add(dependency);
+         }
+
+         return unresolved.AsReadOnly();
+      }
+
+      /// <summary>
+      /// Gets the ids of all components that a component directly or indirectly depends on.
+      /// </summary>
+      /// <param name="id">The id of the component.</param>
+      /// <returns>
+      /// The ids of the components that the component depends on, in dependency order. The component itself is included only if it is
+      /// part of a dependency cycle.
+      /// </returns>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="id"/> is not a valid component id.</exception>
+      public IList<int> GetTransitiveDependencies(int id)
+      {
+         CheckId(id, "id");
+
+         ulong[] visited = new ulong[(m_components.Length + 63) >> 6];
+         Stack<int> pending = new Stack<int>();
+         List<int> result = new List<int>();
+
+         // The component itself is only marked once it is reached through a dependency.
+         Expand(id, visited, pending, result);
+
+         return ToDependencyOrder(result);
+      }
+
+      /// <summary>
+      /// Expands a selection of components with all components they directly or indirectly depend on.
+      /// </summary>
+      /// <param name="ids">The ids of the selected components.</param>
+      /// <returns>
+      /// The ids of the selected components and all components they depend on, each exactly once, in dependency order. Adding the components
+      /// to a backup in this order (using <see cref="IVssBackupComponents.AddComponent"/>) adds every component after the components it depends on.
+      /// </returns>
+      /// <exception cref="ArgumentNullException"><paramref name="ids"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="ids"/> contains an id that is not a valid component id.</exception>
+      public IList<int> ExpandSelection(IEnumerable<int> ids)
+      {
+         if (ids == null)
+            throw new ArgumentNullException("ids");
+
+         ulong[] visited = new ulong[(m_components.Length + 63) >> 6];
+         Stack<int> pending = new Stack<int>();
+         List<int> result = new List<int>();
+
+         foreach (int id in ids)
+         {
+            CheckId(id, "ids");
+            if (Mark(visited, id))
+               result.Add(id);
+            Expand(id, visited, pending, result);
+         }
+
+         return ToDependencyOrder(result);
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private static string GetKey(Guid writerId, string logicalPath, string componentName)
+      {
+         return writerId.ToString("N") + ":" + (logicalPath == null ? String.Empty : logicalPath.TrimEnd('\\')) + "\\" + componentName;
+      }
+
+      private void CheckId(int id, string paramName)
+      {
+         if (id < 0 || id >= m_components.Length)
+            throw new ArgumentOutOfRangeException(paramName, id, "The id does not identify a component of the graph.");
+      }
+
+      private static bool Mark(ulong[] visited, int id)
+      {
+         ulong bit = 1UL << (id & 63);
+         if ((visited[id >> 6] & bit) != 0)
+            return false;
+
+         visited[id >> 6] |= bit;
+         return true;
+      }
+
+      // Adds the unvisited components reachable from the dependencies of id to result.
+      private void Expand(int id, ulong[] visited, Stack<int> pending, List<int> result)
+      {
+         pending.Push(id);
+         while (pending.Count > 0)
+         {
+            int current = pending.Pop();
+            for (int i = m_edgeStart[current]; i < m_edgeStart[current + 1]; i++)
+            {
+               int target = m_edges[i];
+               if (Mark(visited, target))
+               {
+                  result.Add(target);
+                  pending.Push(target);
+               }
+            }
+         }
+      }
+
+      private IList<int> ToDependencyOrder(List<int> ids)
+      {
+         int[] result = ids.ToArray();
+         int[] ranks = new int[result.Length];
+         for (int i = 0; i < result.Length; i++)
+            ranks[i] = m_rank[result[i]];
+
+         Array.Sort(ranks, result);
+         return Array.AsReadOnly(result);
+      }
+
+      // Computes m_order and m_rank using Tarjan's strongly connected components algorithm, which completes
+      // every component only after all components it depends on. The recursion is replaced by an explicit stack,
+      // since dependency chains may be long.
+      private void SortComponents(List<IList<int>> cycles)
+      {
+         int count = m_components.Length;
+         int[] index = new int[count];
+         int[] lowLink = new int[count];
+         int[] nextEdge = new int[count];
+         bool[] onStack = new bool[count];
+         Stack<int> componentStack = new Stack<int>();
+         Stack<int> callStack = new Stack<int>();
+         int nextIndex = 0;
+         int nextRank = 0;
+
+         for (int i = 0; i < count; i++)
+            index[i] = -1;
+
+         for (int root = 0; root < count; root++)
+         {
+            if (index[root] >= 0)
+               continue;
+
+            index[root] = lowLink[root] = nextIndex++;
+            nextEdge[root] = m_edgeStart[root];
+            componentStack.Push(root);
+            onStack[root] = true;
+            callStack.Push(root);
+
+            while (callStack.Count > 0)
+            {
+               int v = callStack.Peek();
+               if (nextEdge[v] < m_edgeStart[v + 1])
+               {
+                  int w = m_edges[nextEdge[v]++];
+                  if (index[w] < 0)
+                  {
+                     index[w] = lowLink[w] = nextIndex++;
+                     nextEdge[w] = m_edgeStart[w];
+                     componentStack.Push(w);
+                     onStack[w] = true;
+                     callStack.Push(w);
+                  }
+                  else if (onStack[w])
+                  {
+                     lowLink[v] = Math.Min(lowLink[v], index[w]);
+                  }
+                  continue;
+               }
+
+               callStack.Pop();
+               if (callStack.Count > 0)
+               {
+                  int parent = callStack.Peek();
+                  lowLink[parent] = Math.Min(lowLink[parent], lowLink[v]);
+               }
+
+               if (lowLink[v] != index[v])
+                  continue;
+
+               // v is the root of a strongly connected component; all components it depends on have been ranked.
+               List<int> members = new List<int>();
+               int member;
+               do
+               {
+                  member = componentStack.Pop();
+                  onStack[member] = false;
+                  members.Add(member);
+               }
+               while (member != v);
+
+               members.Sort();
+               foreach (int id in members)
+               {
+                  m_rank[id] = nextRank;
+                  m_order[nextRank++] = id;
+               }
+
+               if (members.Count > 1 || DependsOnItself(v))
+                  cycles.Add(members.AsReadOnly());
+            }
+         }
+      }
+
+      private bool DependsOnItself(int id)
+      {
+         for (int i = m_edgeStart[id]; i < m_edgeStart[id + 1]; i++)
+         {
+            if (m_edges[i] == id)
+               return true;
+         }
+
+         return false;
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,259 @@
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssComponentSnapshot"/> class contains the values of the scalar properties and the number of elements of the lists
+   ///     of an <see cref="IVssComponent"/>, as read in a single pass by <see cref="IVssComponent.GetSnapshot"/>.
+   /// </summary>
+   /// <remarks>
+   ///     <para>
+   ///         On operating systems that do not support them, the properties <see cref="IsAuthoritativeRestore"/>, <see cref="PostSnapshotFailureMsg"/>,
+   ///         <see cref="PrepareForBackupFailureMsg"/>, <see cref="RestoreName"/>, <see cref="RollForwardRestorePoint"/>,
+   ///         <see cref="RollForwardType"/> and <see cref="Failure"/> have their default values (<see langword="false"/>, <see langword="null"/> or
+   ///         <see cref="VssRollForwardType.Undefined"/>), where the corresponding properties of <see cref="IVssComponent"/> throw an
+   ///         <see cref="UnsupportedOperatingSystemException"/>. The same default values are used if the operating system supports a property
+   ///         but fails to return its value.
+   ///     </para>
+   ///     <para>
+   ///         Instances are immutable, and remain valid after the component is disposed.
+   ///     </para>
+   /// </remarks>
+   [Serializable]
+   public class VssComponentSnapshot
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssComponentSnapshot"/> class.
+      /// </summary>
+      /// <param name="additionalRestores">Whether additional restores will occur for the component.</param>
+      /// <param name="backupOptions">The backup options of the component.</param>
+      /// <param name="backupStamp">The backup stamp of the component.</param>
+      /// <param name="backupSucceeded">Whether the component was successfully backed up.</param>
+      /// <param name="componentName">The name of the component.</param>
+      /// <param name="componentType">The type of the component.</param>
+      /// <param name="fileRestoreStatus">The status of the restore of the files of the component.</param>
+      /// <param name="logicalPath">The logical path of the component.</param>
+      /// <param name="postRestoreFailureMsg">The failure message generated by the writer during PostRestore.</param>
+      /// <param name="preRestoreFailureMsg">The failure message generated by the writer during PreRestore.</param>
+      /// <param name="previousBackupStamp">The backup stamp of the previous backup of the component.</param>
+      /// <param name="restoreOptions">The restore options of the component.</param>
+      /// <param name="restoreTarget">The restore target of the component.</param>
+      /// <param name="isSelectedForRestore">Whether the component has been selected to be restored.</param>
+      /// <param name="isAuthoritativeRestore">Whether the component is being restored as authoritative.</param>
+      /// <param name="postSnapshotFailureMsg">The failure message generated by the writer during PostSnapshot.</param>
+      /// <param name="prepareForBackupFailureMsg">The failure message generated by the writer during PrepareForBackup.</param>
+      /// <param name="restoreName">The restore name of the component.</param>
+      /// <param name="rollForwardRestorePoint">The restore point up to which the component is rolled forward.</param>
+      /// <param name="rollForwardType">The type of roll-forward operation of the component.</param>
+      /// <param name="failure">The component-level error reported by the writer, or <see langword="null"/>.</param>
+      /// <param name="alternateLocationMappingCount">The number of alternate location mappings of the component.</param>
+      /// <param name="directedTargetCount">The number of directed targets of the component.</param>
+      /// <param name="newTargetCount">The number of new targets of the component.</param>
+      /// <param name="partialFileCount">The number of partial files of the component.</param>
+      /// <param name="differencedFileCount">The number of differenced files of the component.</param>
+      /// <param name="restoreSubcomponentCount">The number of restore subcomponents of the component.</param>
+      /// <param name="nativeCallCount">The number of native calls made to read the values.</param>
+      public VssComponentSnapshot(bool additionalRestores, string backupOptions, string backupStamp, bool backupSucceeded, string componentName,
+         VssComponentType componentType, VssFileRestoreStatus fileRestoreStatus, string logicalPath, string postRestoreFailureMsg,
+         string preRestoreFailureMsg, string previousBackupStamp, string restoreOptions, VssRestoreTarget restoreTarget, bool isSelectedForRestore,
+         bool isAuthoritativeRestore, string postSnapshotFailureMsg, string prepareForBackupFailureMsg, string restoreName,
+         string rollForwardRestorePoint, VssRollForwardType rollForwardType, VssComponentFailure failure, int alternateLocationMappingCount,
+         int directedTargetCount, int newTargetCount, int partialFileCount, int differencedFileCount, int restoreSubcomponentCount, int nativeCallCount)
+      {
+         AdditionalRestores = additionalRestores;
+         BackupOptions = backupOptions;
+         BackupStamp = backupStamp;
+         BackupSucceeded = backupSucceeded;
+         ComponentName = componentName;
+         ComponentType = componentType;
+         FileRestoreStatus = fileRestoreStatus;
+         LogicalPath = logicalPath;
+         PostRestoreFailureMsg = postRestoreFailureMsg;
+         PreRestoreFailureMsg = preRestoreFailureMsg;
+         PreviousBackupStamp = previousBackupStamp;
+         RestoreOptions = restoreOptions;
+         RestoreTarget = restoreTarget;
+         IsSelectedForRestore = isSelectedForRestore;
+         IsAuthoritativeRestore = isAuthoritativeRestore;
+         PostSnapshotFailureMsg = postSnapshotFailureMsg;
+         PrepareForBackupFailureMsg = prepareForBackupFailureMsg;
+         RestoreName = restoreName;
+         RollForwardRestorePoint = rollForwardRestorePoint;
+         RollForwardType = rollForwardType;
+         Failure = failure;
+         AlternateLocationMappingCount = alternateLocationMappingCount;
+         DirectedTargetCount = directedTargetCount;
+         NewTargetCount = newTargetCount;
+         PartialFileCount = partialFileCount;
+         DifferencedFileCount = differencedFileCount;
+         RestoreSubcomponentCount = restoreSubcomponentCount;
+         NativeCallCount = nativeCallCount;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets a value indicating whether additional restores will occur for the component.
+      /// </summary>
+      /// <seealso cref="IVssComponent.AdditionalRestores"/>
+      public bool AdditionalRestores { get; private set; }
+
+      /// <summary>
+      /// Gets the backup options of the component.
+      /// </summary>
+      /// <seealso cref="IVssComponent.BackupOptions"/>
+      public string BackupOptions { get; private set; }
+
+      /// <summary>
+      /// Gets the backup stamp of the component.
+      /// </summary>
+      /// <seealso cref="IVssComponent.BackupStamp"/>
+      public string BackupStamp { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the component was successfully backed up.
+      /// </summary>
+      /// <seealso cref="IVssComponent.BackupSucceeded"/>
+      public bool BackupSucceeded { get; private set; }
+
+      /// <summary>
+      /// Gets the name of the component.
+      /// </summary>
+      /// <seealso cref="IVssComponent.ComponentName"/>
+      public string ComponentName { get; private set; }
+
+      /// <summary>
+      /// Gets the type of the component.
+      /// </summary>
+      /// <seealso cref="IVssComponent.ComponentType"/>
+      public VssComponentType ComponentType { get; private set; }
+
+      /// <summary>
+      /// Gets the status of the restore of the files of the component.
+      /// </summary>
+      /// <seealso cref="IVssComponent.FileRestoreStatus"/>
+      public VssFileRestoreStatus FileRestoreStatus { get; private set; }
+
+      /// <summary>
+      /// Gets the logical path of the component.
+      /// </summary>
+      /// <seealso cref="IVssComponent.LogicalPath"/>
+      public string LogicalPath { get; private set; }
+
+      /// <summary>
+      /// Gets the failure message generated by the writer during PostRestore.
+      /// </summary>
+      /// <seealso cref="IVssComponent.PostRestoreFailureMsg"/>
+      public string PostRestoreFailureMsg { get; private set; }
+
+      /// <summary>
+      /// Gets the failure message generated by the writer during PreRestore.
+      /// </summary>
+      /// <seealso cref="IVssComponent.PreRestoreFailureMsg"/>
+      public string PreRestoreFailureMsg { get; private set; }
+
+      /// <summary>
+      /// Gets the backup stamp of the previous backup of the component.
+      /// </summary>
+      /// <seealso cref="IVssComponent.PreviousBackupStamp"/>
+      public string PreviousBackupStamp { get; private set; }
+
+      /// <summary>
+      /// Gets the restore options of the component.
+      /// </summary>
+      /// <seealso cref="IVssComponent.RestoreOptions"/>
+      public string RestoreOptions { get; private set; }
+
+      /// <summary>
+      /// Gets the restore target of the component.
+      /// </summary>
+      /// <seealso cref="IVssComponent.RestoreTarget"/>
+      public VssRestoreTarget RestoreTarget { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the component has been selected to be restored.
+      /// </summary>
+      /// <seealso cref="IVssComponent.IsSelectedForRestore"/>
+      public bool IsSelectedForRestore { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the component is being restored as authoritative.
+      /// </summary>
+      /// <seealso cref="IVssComponent.IsAuthoritativeRestore"/>
+      public bool IsAuthoritativeRestore { get; private set; }
+
+      /// <summary>
+      /// Gets the failure message generated by the writer during PostSnapshot.
+      /// </summary>
+      /// <seealso cref="IVssComponent.PostSnapshotFailureMsg"/>
+      public string PostSnapshotFailureMsg { get; private set; }
+
+      /// <summary>
+      /// Gets the failure message generated by the writer during PrepareForBackup.
+      /// </summary>
+      /// <seealso cref="IVssComponent.PrepareForBackupFailureMsg"/>
+      public string PrepareForBackupFailureMsg { get; private set; }
+
+      /// <summary>
+      /// Gets the restore name of the component.
+      /// </summary>
+      /// <seealso cref="IVssComponent.RestoreName"/>
+      public string RestoreName { get; private set; }
+
+      /// <summary>
+      /// Gets the restore point up to which the component is rolled forward.
+      /// </summary>
+      /// <seealso cref="IVssComponent.RollForwardRestorePoint"/>
+      public string RollForwardRestorePoint { get; private set; }
+
+      /// <summary>
+      /// Gets the type of roll-forward operation of the component.
+      /// </summary>
+      /// <seealso cref="IVssComponent.RollForwardType"/>
+      public VssRollForwardType RollForwardType { get; private set; }
+
+      /// <summary>
+      /// Gets the component-level error reported by the writer, or <see langword="null"/> if it could not be read.
+      /// </summary>
+      /// <seealso cref="IVssComponent.Failure"/>
+      public VssComponentFailure Failure { get; private set; }
+
+      /// <summary>
+      /// Gets the number of elements of <see cref="IVssComponent.AlternateLocationMappings"/>.
+      /// </summary>
+      public int AlternateLocationMappingCount { get; private set; }
+
+      /// <summary>
+      /// Gets the number of elements of <see cref="IVssComponent.DirectedTargets"/>.
+      /// </summary>
+      public int DirectedTargetCount { get; private set; }
+
+      /// <summary>
+      /// Gets the number of elements of <see cref="IVssComponent.NewTargets"/>.
+      /// </summary>
+      public int NewTargetCount { get; private set; }
+
+      /// <summary>
+      /// Gets the number of elements of <see cref="IVssComponent.PartialFiles"/>.
+      /// </summary>
+      public int PartialFileCount { get; private set; }
+
+      /// <summary>
+      /// Gets the number of elements of <see cref="IVssComponent.DifferencedFiles"/>, or 0 if the operating system does not support
+      /// differenced files.
+      /// </summary>
+      public int DifferencedFileCount { get; private set; }
+
+      /// <summary>
+      /// Gets the number of elements of <see cref="IVssComponent.RestoreSubcomponents"/>.
+      /// </summary>
+      public int RestoreSubcomponentCount { get; private set; }
+
+      /// <summary>
+      /// Gets the number of native calls that were made to read the values of this snapshot.
+      /// </summary>
+      public int NativeCallCount { get; private set; }
+
+      #endregion
+   }
+}
@@ -0,0 +1,311 @@
+using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssComponentTree{TComponent}"/> class indexes the components of a writer as a tree by their full logical path,
+   ///     i.e. the logical path of a component followed by a backslash and the name of the component.
+   /// </summary>
+   /// <typeparam name="TComponent">The type of the objects describing the components.</typeparam>
+   /// <remarks>
+   ///     <para>
+   ///         The parent of a component is its nearest ancestor that is itself a component of the tree; a component is an ancestor of
+   ///         another component if its full path is a prefix of the full path of the other component that ends at a backslash. Full paths
+   ///         are compared case insensitively, and trailing backslashes are ignored.
+   ///     </para>
+   ///     <para>
+   ///         The tree is built in time linear in the total length of the full paths, and ancestor tests are answered in constant time by
+   ///         comparing the pre-order and post-order positions of the components. The tree does not track changes to the sequence of
+   ///         components it was built from.
+   ///     </para>
+   /// </remarks>
+   public sealed class VssComponentTree<TComponent> where TComponent : class
+   {
+      #region Private Fields
+
+      private readonly Dictionary<string, Node> m_byPath = new Dictionary<string, Node>(StringComparer.OrdinalIgnoreCase);
+      private readonly Dictionary<TComponent, Node> m_byComponent = new Dictionary<TComponent, Node>();
+      private readonly List<TComponent> m_roots = new List<TComponent>();
+      private readonly TComponent[] m_preOrder;
+
+      private sealed class Node
+      {
+         public Node(TComponent component, bool isSelectable)
+         {
+            Component = component;
+            IsSelectable = isSelectable;
+            Children = new List<TComponent>();
+         }
+
+         public TComponent Component;
+         public bool IsSelectable;
+         public Node Parent;
+         public List<TComponent> Children;
+         public int PreOrder;
+         public int PostOrder;
+         public int DescendantCount;
+      }
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssComponentTree{TComponent}"/> class.
+      /// </summary>
+      /// <param name="components">The components of the tree. If several components have the same full path, the first one is returned by <see cref="Find"/>.</param>
+      /// <param name="fullPathSelector">A function returning the full logical path of a component.</param>
+      /// <param name="isSelectableSelector">A function returning whether a component is selectable for backup, as reported by <see cref="IVssWMComponent.Selectable"/>.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="components"/>, <paramref name="fullPathSelector"/> or <paramref name="isSelectableSelector"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="components"/> contains a null reference or the same component more than once, or the full path of a component is <see langword="null"/>.</exception>
+      public VssComponentTree(IEnumerable<TComponent> components, Func<TComponent, string> fullPathSelector, Func<TComponent, bool> isSelectableSelector)
+      {
+         if (components == null)
+            throw new ArgumentNullException("components");
+
+         if (fullPathSelector == null)
+            throw new ArgumentNullException("fullPathSelector");
+
+         if (isSelectableSelector == null)
+            throw new ArgumentNullException("isSelectableSelector");
+
+         List<Node> nodes = new List<Node>();
+         List<string> keys = new List<string>();
+         foreach (TComponent component in components)
+         {
+            if (component == null)
+               throw new ArgumentException("The sequence of components contains a null reference.", "components");
+
+            if (m_byComponent.ContainsKey(component))
+               throw new ArgumentException("The sequence of components contains the same component more than once.", "components");
+
+            string fullPath = fullPathSelector(component);
+            if (fullPath == null)
+               throw new ArgumentException("The full path of a component is a null reference.", "components");
+
+            Node node = new Node(component, isSelectableSelector(component));
+            nodes.Add(node);
+            m_byComponent.Add(component, node);
+
+            string key = GetKey(fullPath);
+            keys.Add(key);
+            if (!m_byPath.ContainsKey(key))
+               m_byPath.Add(key, node);
+         }
+
+         // Link each component to its nearest ancestor, by looking up the successively shorter prefixes of its path.
+         for (int n = 0; n < nodes.Count; n++)
+         {
+            Node node = nodes[n];
+            string path = keys[n];
+            for (int index = path.LastIndexOf('\\'); index >= 0; index = path.LastIndexOf('\\'))
+            {
+               path = path.Substring(0, index);
+
+               Node parent;
+               if (m_byPath.TryGetValue(path, out parent))
+               {
+                  node.Parent = parent;
+                  parent.Children.Add(node.Component);
+                  break;
+               }
+            }
+
+            if (node.Parent == null)
+               m_roots.Add(node.Component);
+         }
+
+         // Number the components in pre-order and post-order, using an explicit stack since the tree may be deep.
+         m_preOrder = new TComponent[nodes.Count];
+         int preOrder = 0;
+         int postOrder = 0;
+         Stack<KeyValuePair<Node, bool>> stack = new Stack<KeyValuePair<Node, bool>>();
+         for (int i = m_roots.Count - 1; i >= 0; i--)
+            stack.Push(new KeyValuePair<Node, bool>(m_byComponent[m_roots[i]], false));
+
+         while (stack.Count > 0)
+         {
+            KeyValuePair<Node, bool> entry = stack.Pop();
+            Node node = entry.Key;
+            if (!entry.Value)
+            {
+               node.PreOrder = preOrder;
+               m_preOrder[preOrder++] = node.Component;
+
+               stack.Push(new KeyValuePair<Node, bool>(node, true));
+               for (int i = node.Children.Count - 1; i >= 0; i--)
+                  stack.Push(new KeyValuePair<Node, bool>(m_byComponent[node.Children[i]], false));
+            }
+            else
+            {
+               // The descendants of the component have been numbered in pre-order since the component itself.
+               node.PostOrder = postOrder++;
+               node.DescendantCount = preOrder - node.PreOrder - 1;
+            }
+         }
+      }
+
+      #endregion
+
+      #region Public Properties
+
+      /// <summary>
+      /// Gets the components that have no ancestor, in the order in which they were specified.
+      /// </summary>
+      /// <value>The top level components of the tree.</value>
+      public IList<TComponent> Roots
+      {
+         get
+         {
+            return new ReadOnlyCollection<TComponent>(m_roots);
+         }
+      }
+
+      /// <summary>
+      /// Gets all components in pre-order, i.e. every component precedes its descendants.
+      /// </summary>
+      /// <value>All components of the tree in pre-order.</value>
+      public IList<TComponent> PreOrder
+      {
+         get
+         {
+            return Array.AsReadOnly(m_preOrder);
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Finds the component with the specified full path.
+      /// </summary>
+      /// <param name="fullPath">The full logical path of the component. The comparison is case insensitive and ignores trailing backslashes.</param>
+      /// <returns>The component, or <see langword="null"/> if no component has the specified path.</returns>
+      public TComponent Find(string fullPath)
+      {
+         Node node;
+         if (fullPath == null || !m_byPath.TryGetValue(GetKey(fullPath), out node))
+            return null;
+
+         return node.Component;
+      }
+
+      /// <summary>
+      /// Gets the nearest ancestor of a component.
+      /// </summary>
+      /// <param name="component">A component of the tree.</param>
+      /// <returns>The parent of <paramref name="component"/>, or <see langword="null"/> if the component has no ancestor.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="component"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="component"/> is not part of the tree.</exception>
+      public TComponent GetParent(TComponent component)
+      {
+         Node parent = GetNode(component, "component").Parent;
+         return parent == null ? null : parent.Component;
+      }
+
+      /// <summary>
+      /// Gets the components of which the specified component is the nearest ancestor.
+      /// </summary>
+      /// <param name="component">A component of the tree.</param>
+      /// <returns>The children of <paramref name="component"/>, in the order in which they were specified.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="component"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="component"/> is not part of the tree.</exception>
+      public IList<TComponent> GetChildren(TComponent component)
+      {
+         return new ReadOnlyCollection<TComponent>(GetNode(component, "component").Children);
+      }
+
+      /// <summary>
+      /// Enumerates the ancestors of a component, starting with its parent.
+      /// </summary>
+      /// <param name="component">A component of the tree.</param>
+      /// <returns>The ancestors of <paramref name="component"/>, nearest first.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="component"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="component"/> is not part of the tree.</exception>
+      public IEnumerable<TComponent> GetAncestors(TComponent component)
+      {
+         // Validate eagerly, rather than when the enumeration starts.
+         return GetAncestors(GetNode(component, "component"));
+      }
+
+      /// <summary>
+      /// Gets the descendants of a component in pre-order.
+      /// </summary>
+      /// <param name="component">A component of the tree.</param>
+      /// <returns>The descendants of <paramref name="component"/>, not including the component itself.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="component"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="component"/> is not part of the tree.</exception>
+      public IList<TComponent> GetDescendants(TComponent component)
+      {
+         // The descendants of a component immediately follow it in pre-order.
+         Node node = GetNode(component, "component");
+         TComponent[] descendants = new TComponent[node.DescendantCount];
+         Array.Copy(m_preOrder, node.PreOrder + 1, descendants, 0, descendants.Length);
+         return Array.AsReadOnly(descendants);
+      }
+
+      /// <summary>
+      /// Determines whether a component is an ancestor of another component of the tree.
+      /// </summary>
+      /// <param name="ancestor">A component of the tree.</param>
+      /// <param name="descendant">A component of the tree.</param>
+      /// <returns><see langword="true"/> if <paramref name="ancestor"/> is an ancestor of <paramref name="descendant"/>; otherwise <see langword="false"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="ancestor"/> or <paramref name="descendant"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="ancestor"/> or <paramref name="descendant"/> is not part of the tree.</exception>
+      public bool IsAncestorOf(TComponent ancestor, TComponent descendant)
+      {
+         Node a = GetNode(ancestor, "ancestor");
+         Node d = GetNode(descendant, "descendant");
+         return a.PreOrder < d.PreOrder && a.PostOrder > d.PostOrder;
+      }
+
+      /// <summary>
+      /// Determines whether a component can be explicitly included in a backup.
+      /// </summary>
+      /// <param name="component">A component of the tree.</param>
+      /// <returns><see langword="true"/> if <paramref name="component"/> is selectable for backup or is a top level component; otherwise <see langword="false"/>.</returns>
+      /// <remarks>
+      ///     A component that is not selectable for backup and has an ancestor is only backed up as part of the component set
+      ///     defined by the nearest of its ancestors that can be explicitly included.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="component"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="component"/> is not part of the tree.</exception>
+      public bool CanBeExplicitlyIncluded(TComponent component)
+      {
+         Node node = GetNode(component, "component");
+         return node.IsSelectable || node.Parent == null;
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private Node GetNode(TComponent component, string paramName)
+      {
+         if (component == null)
+            throw new ArgumentNullException(paramName);
+
+         Node node;
+         if (!m_byComponent.TryGetValue(component, out node))
+            throw new ArgumentException("The component is not part of this tree.", paramName);
+
+         return node;
+      }
+
+      private static IEnumerable<TComponent> GetAncestors(Node node)
+      {
+         for (Node parent = node.Parent; parent != null; parent = parent.Parent)
+            yield return parent.Component;
+      }
+
+      private static string GetKey(string fullPath)
+      {
+         return fullPath.TrimEnd('\\');
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,74 @@
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssDependencyGraphComponent"/> class describes a component of a <see cref="VssComponentDependencyGraph"/>,
+   ///     together with the dependencies it declares.
+   /// </summary>
+   [Serializable]
+   public class VssDependencyGraphComponent
+   {
+      private static readonly IList<VssWMDependency> s_noDependencies = Array.AsReadOnly(new VssWMDependency[0]);
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssDependencyGraphComponent"/> class.
+      /// </summary>
+      /// <param name="instanceId">The instance id of the writer owning the component.</param>
+      /// <param name="writerId">The class id of the writer owning the component.</param>
+      /// <param name="componentType">The type of the component.</param>
+      /// <param name="logicalPath">The logical path of the component.</param>
+      /// <param name="componentName">The name of the component.</param>
+      /// <param name="dependencies">The dependencies declared by the component, or <see langword="null"/> if the component declares no dependencies.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="componentName"/> is <see langword="null"/>.</exception>
+      public VssDependencyGraphComponent(Guid instanceId, Guid writerId, VssComponentType componentType, string logicalPath, string componentName,
+         IList<VssWMDependency> dependencies)
+      {
+         if (componentName == null)
+            throw new ArgumentNullException("componentName");
+
+         InstanceId = instanceId;
+         WriterId = writerId;
+         ComponentType = componentType;
+         LogicalPath = logicalPath;
+         ComponentName = componentName;
+         Dependencies = dependencies ?? s_noDependencies;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the instance id of the writer owning the component.
+      /// </summary>
+      public Guid InstanceId { get; private set; }
+
+      /// <summary>
+      /// Gets the class id of the writer owning the component.
+      /// </summary>
+      public Guid WriterId { get; private set; }
+
+      /// <summary>
+      /// Gets the type of the component.
+      /// </summary>
+      public VssComponentType ComponentType { get; private set; }
+
+      /// <summary>
+      /// Gets the logical path of the component.
+      /// </summary>
+      /// <value>The logical path of the component, or <see langword="null"/> if the component has no logical path.</value>
+      public string LogicalPath { get; private set; }
+
+      /// <summary>
+      /// Gets the name of the component.
+      /// </summary>
+      public string ComponentName { get; private set; }
+
+      /// <summary>
+      /// Gets the dependencies declared by the component.
+      /// </summary>
+      public IList<VssWMDependency> Dependencies { get; private set; }
+
+      #endregion
+   }
+}
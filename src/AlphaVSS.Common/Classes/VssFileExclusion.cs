@@ -0,0 +1,69 @@
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssFileExclusion"/> class describes a set of files that a writer has excluded from backup or from shadow copies,
+   ///     as indexed by a <see cref="VssFileExclusionIndex"/>.
+   /// </summary>
+   [Serializable]
+   public class VssFileExclusion
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssFileExclusion"/> class.
+      /// </summary>
+      /// <param name="instanceId">The instance id of the writer that excluded the files.</param>
+      /// <param name="writerId">The class id of the writer that excluded the files.</param>
+      /// <param name="writerName">The name of the writer that excluded the files.</param>
+      /// <param name="fileDescriptor">The file descriptor describing the excluded files.</param>
+      /// <param name="isExcludedFromSnapshot">
+      ///     <see langword="true"/> if the files are excluded from shadow copies (<see cref="IVssExamineWriterMetadata.ExcludeFromSnapshotFiles"/>);
+      ///     <see langword="false"/> if they are excluded from backup (<see cref="IVssExamineWriterMetadata.ExcludeFiles"/>).
+      /// </param>
+      /// <exception cref="ArgumentNullException"><paramref name="fileDescriptor"/> is <see langword="null"/>.</exception>
+      public VssFileExclusion(Guid instanceId, Guid writerId, string writerName, VssWMFileDescriptor fileDescriptor, bool isExcludedFromSnapshot)
+      {
+         if (fileDescriptor == null)
+            throw new ArgumentNullException("fileDescriptor");
+
+         InstanceId = instanceId;
+         WriterId = writerId;
+         WriterName = writerName;
+         FileDescriptor = fileDescriptor;
+         IsExcludedFromSnapshot = isExcludedFromSnapshot;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the instance id of the writer that excluded the files.
+      /// </summary>
+      public Guid InstanceId { get; private set; }
+
+      /// <summary>
+      /// Gets the class id of the writer that excluded the files.
+      /// </summary>
+      public Guid WriterId { get; private set; }
+
+      /// <summary>
+      /// Gets the name of the writer that excluded the files.
+      /// </summary>
+      public string WriterName { get; private set; }
+
+      /// <summary>
+      /// Gets the file descriptor describing the excluded files.
+      /// </summary>
+      public VssWMFileDescriptor FileDescriptor { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the files are excluded from shadow copies rather than from backup.
+      /// </summary>
+      /// <value>
+      ///     <see langword="true"/> if the files are excluded from shadow copies (<see cref="IVssExamineWriterMetadata.ExcludeFromSnapshotFiles"/>);
+      ///     <see langword="false"/> if they are excluded from backup (<see cref="IVssExamineWriterMetadata.ExcludeFiles"/>).
+      /// </value>
+      public bool IsExcludedFromSnapshot { get; private set; }
+
+      #endregion
+   }
+}
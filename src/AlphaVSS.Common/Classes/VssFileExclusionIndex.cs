@@ -0,0 +1,159 @@
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssFileExclusionIndex"/> class combines the files excluded by a set of writers into a single index, which determines
+   ///     whether a file is excluded, and by which writer.
+   /// </summary>
+   /// <remarks>
+   ///     <para>
+   ///         The index contains both the files excluded from backup (<see cref="IVssExamineWriterMetadata.ExcludeFiles"/>) and the files
+   ///         excluded from shadow copies (<see cref="IVssExamineWriterMetadata.ExcludeFromSnapshotFiles"/>) of every writer. The excluded
+   ///         directories are organized as a tree by a <see cref="VssFileSpecificationMatcher"/>, so that a path is checked in time proportional to
+   ///         its length, regardless of the number of exclusions.
+   ///     </para>
+   ///     <para>
+   ///         The index is serializable, so it can be saved and reused by later backups, as long as the writers and the environment variables
+   ///         used in their exclusions do not change. Instances are immutable and may be used from multiple threads.
+   ///     </para>
+   /// </remarks>
+   [Serializable]
+   public sealed class VssFileExclusionIndex
+   {
+      #region Private Fields
+
+      private readonly VssFileExclusion[] m_exclusions;
+      private readonly VssFileSpecificationMatcher m_matcher;
+
+      #endregion
+
+      #region Constructors
+
+      private VssFileExclusionIndex(IEnumerable<VssFileExclusion> exclusions)
+      {
+         m_exclusions = new List<VssFileExclusion>(exclusions).ToArray();
+
+         VssWMFileDescriptor[] fileDescriptors = new VssWMFileDescriptor[m_exclusions.Length];
+         for (int i = 0; i < m_exclusions.Length; i++)
+         {
+            if (m_exclusions[i] == null)
+               throw new ArgumentException("The sequence of exclusions contains a null reference.", "exclusions");
+
+            fileDescriptors[i] = m_exclusions[i].FileDescriptor;
+         }
+
+         m_matcher = new VssFileSpecificationMatcher(fileDescriptors);
+      }
+
+      #endregion
+
+      #region Public Properties
+
+      /// <summary>
+      /// Gets the exclusions contained in this index.
+      /// </summary>
+      public IList<VssFileExclusion> Exclusions
+      {
+         get
+         {
+            return Array.AsReadOnly(m_exclusions);
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Creates an index of the files excluded by the specified writers.
+      /// </summary>
+      /// <param name="writers">The metadata of the writers, as returned by <see cref="IVssBackupComponents.WriterMetadata"/>.</param>
+      /// <returns>An index of the files excluded from backup or from shadow copies by <paramref name="writers"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="writers"/> is <see langword="null"/>.</exception>
+      public static VssFileExclusionIndex Create(IEnumerable<IVssExamineWriterMetadata> writers)
+      {
+         if (writers == null)
+            throw new ArgumentNullException("writers");
+
+         List<VssFileExclusion> exclusions = new List<VssFileExclusion>();
+         foreach (IVssExamineWriterMetadata writer in writers)
+         {
+            if (writer == null)
+               throw new ArgumentException("The sequence of writers contains a null reference.", "writers");
+
+            foreach (VssWMFileDescriptor file in writer.ExcludeFiles)
+               exclusions.Add(new VssFileExclusion(writer.InstanceId, writer.WriterId, writer.WriterName, file, false));
+
+            foreach (VssWMFileDescriptor file in writer.ExcludeFromSnapshotFiles)
+               exclusions.Add(new VssFileExclusion(writer.InstanceId, writer.WriterId, writer.WriterName, file, true));
+         }
+
+         return new VssFileExclusionIndex(exclusions);
+      }
+
+      /// <summary>
+      /// Creates an index of the specified exclusions.
+      /// </summary>
+      /// <param name="exclusions">The exclusions to index.</param>
+      /// <returns>An index of <paramref name="exclusions"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="exclusions"/> is <see langword="null"/>.</exception>
+      public static VssFileExclusionIndex Create(IEnumerable<VssFileExclusion> exclusions)
+      {
+         if (exclusions == null)
+            throw new ArgumentNullException("exclusions");
+
+         return new VssFileExclusionIndex(exclusions);
+      }
+
+      /// <summary>
+      /// Determines whether a file is excluded by any writer.
+      /// </summary>
+      /// <param name="path">The full path of the file.</param>
+      /// <returns><see langword="true"/> if the file is excluded; otherwise <see langword="false"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="path"/> is <see langword="null"/>.</exception>
+      public bool IsExcluded(string path)
+      {
+         return m_matcher.IsMatch(path);
+      }
+
+      /// <summary>
+      /// Finds the exclusion that excludes a file.
+      /// </summary>
+      /// <param name="path">The full path of the file.</param>
+      /// <returns>The first exclusion in <see cref="Exclusions"/> that excludes the file, or <see langword="null"/> if the file is not excluded.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="path"/> is <see langword="null"/>.</exception>
+      public VssFileExclusion FindExclusion(string path)
+      {
+         int index = m_matcher.FindMatchIndex(path);
+         return index < 0 ? null : m_exclusions[index];
+      }
+
+      /// <summary>
+      /// Finds the exclusions that exclude each of a number of files in the same directory, such as the files of a directory listing.
+      /// </summary>
+      /// <param name="directory">The full path of the directory containing the files.</param>
+      /// <param name="fileNames">The names of the files, without a directory.</param>
+      /// <returns>
+      /// An array containing, for each element of <paramref name="fileNames"/>, the first exclusion in <see cref="Exclusions"/> that excludes
+      /// the file, or <see langword="null"/> if the file is not excluded.
+      /// </returns>
+      /// <exception cref="ArgumentNullException"><paramref name="directory"/> or <paramref name="fileNames"/> is <see langword="null"/>, or <paramref name="fileNames"/> contains a <see langword="null"/> reference.</exception>
+      public VssFileExclusion[] FindExclusions(string directory, IList<string> fileNames)
+      {
+         int[] indices = m_matcher.FindMatchIndices(directory, fileNames);
+
+         VssFileExclusion[] result = new VssFileExclusion[indices.Length];
+         for (int i = 0; i < indices.Length; i++)
+         {
+            if (indices[i] >= 0)
+               result[i] = m_exclusions[indices[i]];
+         }
+
+         return result;
+      }
+
+      #endregion
+   }
+}
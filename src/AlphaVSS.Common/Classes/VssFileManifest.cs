@@ -0,0 +1,71 @@
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssFileManifest"/> class lists the files described by the file descriptors of a set of components, as
+   ///     created by a <see cref="VssFileManifestBuilder"/>.
+   /// </summary>
+   [Serializable]
+   public sealed class VssFileManifest
+   {
+      private readonly IList<string> m_components;
+      private readonly IList<VssFileManifestEntry> m_entries;
+      private readonly IList<string> m_inaccessibleDirectories;
+
+      internal VssFileManifest(IList<string> components, VssFileManifestEntry[] entries, string[] inaccessibleDirectories)
+      {
+         m_components = components;
+         m_entries = Array.AsReadOnly(entries);
+         m_inaccessibleDirectories = Array.AsReadOnly(inaccessibleDirectories);
+
+         foreach (VssFileManifestEntry entry in entries)
+            TotalLength += entry.Length;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the names of the components, as specified when they were added to the <see cref="VssFileManifestBuilder"/>. The id of a
+      /// component is its index in this list.
+      /// </summary>
+      public IList<string> Components
+      {
+         get
+         {
+            return m_components;
+         }
+      }
+
+      /// <summary>
+      /// Gets the files of the manifest, ordered by path.
+      /// </summary>
+      public IList<VssFileManifestEntry> Entries
+      {
+         get
+         {
+            return m_entries;
+         }
+      }
+
+      /// <summary>
+      /// Gets the total size of the files of the manifest, in bytes.
+      /// </summary>
+      public long TotalLength { get; private set; }
+
+      /// <summary>
+      /// Gets the paths (on the original volume) of the directories that could not be read, for instance due to insufficient permissions.
+      /// Files in these directories are missing from the manifest. Directories that do not exist are not included.
+      /// </summary>
+      public IList<string> InaccessibleDirectories
+      {
+         get
+         {
+            return m_inaccessibleDirectories;
+         }
+      }
+
+      #endregion
+   }
+}
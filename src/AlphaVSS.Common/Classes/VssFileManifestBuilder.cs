@@ -0,0 +1,441 @@
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.IO;
+using System.Threading;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssFileManifestBuilder"/> class expands the file descriptors of a set of components into a <see cref="VssFileManifest"/>
+   ///     listing the files they describe, by walking the directories of a shadow copy in parallel.
+   /// </summary>
+   /// <remarks>
+   ///     <para>
+   ///         The paths of the file descriptors refer to the original volumes. Use <see cref="MapVolume"/> to specify the directory through which
+   ///         the shadow copy of each volume is accessed; paths on volumes that are not mapped are read directly. The files of all components are
+   ///         collected in a single traversal, in which every directory is read at most once, even if it is described by several file descriptors.
+   ///         A file described by the file descriptors of several components is owned by the component that was added first. Reparse points,
+   ///         such as junctions and symbolic links to directories, are not followed.
+   ///     </para>
+   ///     <para>
+   ///         The directories are read by <see cref="DegreeOfParallelism"/> threads, including the calling thread. Each thread first processes the
+   ///         subdirectories it discovered itself, and takes work from the other threads when it runs out.
+   ///     </para>
+   /// </remarks>
+   public sealed class VssFileManifestBuilder
+   {
+      #region Private Fields
+
+      private readonly List<string> m_components = new List<string>();
+      private readonly List<VssWMFileDescriptor> m_fileDescriptors = new List<VssWMFileDescriptor>();
+      private readonly List<int> m_fileDescriptorComponents = new List<int>();
+
+      // The mapped volumes, as pairs of a volume path ending with a backslash and a snapshot directory.
+      private readonly List<KeyValuePair<string, string>> m_volumes = new List<KeyValuePair<string, string>>();
+
+      private int m_degreeOfParallelism = Environment.ProcessorCount;
+
+      #endregion
+
+      #region Public Properties
+
+      /// <summary>
+      /// Gets or sets the number of threads used to read directories.
+      /// </summary>
+      /// <value>The number of threads used to read directories. The default is the number of processors.</value>
+      /// <exception cref="ArgumentOutOfRangeException">The value is less than one.</exception>
+      public int DegreeOfParallelism
+      {
+         get
+         {
+            return m_degreeOfParallelism;
+         }
+
+         set
+         {
+            if (value < 1)
+               throw new ArgumentOutOfRangeException("value", "The degree of parallelism must be at least one.");
+
+            m_degreeOfParallelism = value;
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Specifies the directory through which the shadow copy of a volume is accessed.
+      /// </summary>
+      /// <param name="volumePath">The path of the original volume, for example <c>C:\</c>.</param>
+      /// <param name="snapshotPath">The directory containing the root of the shadow copy of the volume.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="volumePath"/> or <paramref name="snapshotPath"/> is <see langword="null"/>.</exception>
+      public void MapVolume(string volumePath, string snapshotPath)
+      {
+         if (volumePath == null)
+            throw new ArgumentNullException("volumePath");
+
+         if (snapshotPath == null)
+            throw new ArgumentNullException("snapshotPath");
+
+         m_volumes.Add(new KeyValuePair<string, string>(volumePath.Replace('/', '\\').TrimEnd('\\') + "\\", snapshotPath));
+
+         // Keep the longest volume paths first, so that volumes mounted in a directory of another volume take precedence.
+         m_volumes.Sort((x, y) => y.Key.Length.CompareTo(x.Key.Length));
+      }
+
+      /// <summary>
+      /// Adds the files described by a set of file descriptors as a component of the manifest.
+      /// </summary>
+      /// <param name="name">The name identifying the component in the manifest.</param>
+      /// <param name="fileDescriptors">The file descriptors of the component.</param>
+      /// <returns>The id of the component in the manifest.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="fileDescriptors"/> is <see langword="null"/>.</exception>
+      public int AddComponent(string name, IEnumerable<VssWMFileDescriptor> fileDescriptors)
+      {
+         if (fileDescriptors == null)
+            throw new ArgumentNullException("fileDescriptors");
+
+         int id = m_components.Count;
+         m_components.Add(name);
+         foreach (VssWMFileDescriptor fileDescriptor in fileDescriptors)
+         {
+            if (fileDescriptor == null)
+               throw new ArgumentException("The sequence of file descriptors contains a null reference.", "fileDescriptors");
+
+            m_fileDescriptors.Add(fileDescriptor);
+            m_fileDescriptorComponents.Add(id);
+         }
+
+         return id;
+      }
+
+      /// <summary>
+      /// Adds the files, database files and database log files of a writer component as a component of the manifest.
+      /// </summary>
+      /// <param name="component">The component to add. The component is named by its logical path and name in the manifest.</param>
+      /// <returns>The id of the component in the manifest.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="component"/> is <see langword="null"/>.</exception>
+      public int AddComponent(IVssWMComponent component)
+      {
+         if (component == null)
+            throw new ArgumentNullException("component");
+
+         List<VssWMFileDescriptor> fileDescriptors = new List<VssWMFileDescriptor>(component.Files);
+         fileDescriptors.AddRange(component.DatabaseFiles);
+         fileDescriptors.AddRange(component.DatabaseLogFiles);
+
+         string name = String.IsNullOrEmpty(component.LogicalPath) ? component.ComponentName : component.LogicalPath.TrimEnd('\\') + "\\" + component.ComponentName;
+         return AddComponent(name, fileDescriptors);
+      }
+
+      /// <summary>
+      /// Gets the path through which a file or directory on an original volume is accessed, according to the mapped volumes.
+      /// </summary>
+      /// <param name="path">The full path of a file or directory on the original volume.</param>
+      /// <returns>The path of the file or directory in the shadow copy of its volume, or <paramref name="path"/> if the volume has not been mapped.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="path"/> is <see langword="null"/>.</exception>
+      public string GetSnapshotPath(string path)
+      {
+         if (path == null)
+            throw new ArgumentNullException("path");
+
+         string normalizedPath = path.Replace('/', '\\');
+         foreach (KeyValuePair<string, string> volume in m_volumes)
+         {
+            if (normalizedPath.StartsWith(volume.Key, StringComparison.OrdinalIgnoreCase) ||
+                String.Compare(normalizedPath, 0, volume.Key, 0, volume.Key.Length - 1, StringComparison.OrdinalIgnoreCase) == 0 && normalizedPath.Length == volume.Key.Length - 1)
+            {
+               string relativePath = normalizedPath.Length < volume.Key.Length ? String.Empty : normalizedPath.Substring(volume.Key.Length);
+               if (relativePath.Length == 0)
+                  return volume.Value;
+
+               return volume.Value.TrimEnd(Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar) + Path.DirectorySeparatorChar +
+                  relativePath.Replace('\\', Path.DirectorySeparatorChar);
+            }
+         }
+
+         return path;
+      }
+
+      /// <summary>
+      /// Walks the directories described by the file descriptors of the components and creates the manifest of the files they describe.
+      /// </summary>
+      /// <returns>The manifest of the files described by the file descriptors of the components.</returns>
+      public VssFileManifest Build()
+      {
+         return Build(CancellationToken.None);
+      }
+
+      /// <summary>
+      /// Walks the directories described by the file descriptors of the components and creates the manifest of the files they describe.
+      /// </summary>
+      /// <param name="cancellationToken">A token that stops the walk when canceled. The threads check the token before reading each directory.</param>
+      /// <returns>The manifest of the files described by the file descriptors of the components.</returns>
+      /// <exception cref="OperationCanceledException"><paramref name="cancellationToken"/> was canceled.</exception>
+      public VssFileManifest Build(CancellationToken cancellationToken)
+      {
+         using (WalkState state = new WalkState(new VssFileSpecificationMatcher(m_fileDescriptors), m_degreeOfParallelism, cancellationToken))
+            return Build(state);
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private VssFileManifest Build(WalkState state)
+      {
+         // Determine the directories to start from: every directory of a file descriptor, unless it is a subdirectory of
+         // the directory of a recursive file descriptor, in which case it is reached by walking that directory.
+         HashSet<string> recursiveDirectories = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+         foreach (VssWMFileDescriptor fileDescriptor in m_fileDescriptors)
+         {
+            if (fileDescriptor.IsRecursive && fileDescriptor.Path != null)
+               recursiveDirectories.Add(NormalizeDirectory(fileDescriptor.Path));
+         }
+
+         HashSet<string> startDirectories = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+         foreach (VssWMFileDescriptor fileDescriptor in m_fileDescriptors)
+         {
+            if (fileDescriptor.Path == null)
+               continue;
+
+            string directory = NormalizeDirectory(fileDescriptor.Path);
+            if (directory.Length == 0 || IsBelowAny(directory, recursiveDirectories) || !startDirectories.Add(directory))
+               continue;
+
+            state.Add(new WorkItem(directory, GetSnapshotPath(directory + "\\"), recursiveDirectories.Contains(directory)));
+         }
+
+         if (state.Pending == 0)
+            state.Finish();
+
+         Thread[] threads = new Thread[m_degreeOfParallelism - 1];
+         for (int i = 0; i < threads.Length; i++)
+         {
+            threads[i] = new Thread(() => Walk(state));
+            threads[i].IsBackground = true;
+            threads[i].Start();
+         }
+
+         Walk(state);
+
+         foreach (Thread thread in threads)
+            thread.Join();
+
+         if (state.Exception != null)
+            throw ExceptionHelper.Rethrow(state.Exception);
+
+         // The walk may have finished without reading a directory after the token was canceled.
+         state.CancellationToken.ThrowIfCancellationRequested();
+
+         VssFileManifestEntry[] entries = state.Entries.ToArray();
+         Array.Sort(entries, (x, y) => StringComparer.OrdinalIgnoreCase.Compare(x.Path, y.Path));
+
+         string[] inaccessibleDirectories = state.InaccessibleDirectories.ToArray();
+         Array.Sort(inaccessibleDirectories, StringComparer.OrdinalIgnoreCase);
+
+         return new VssFileManifest(new ReadOnlyCollection<string>(m_components.ToArray()), entries, inaccessibleDirectories);
+      }
+
+      private static string NormalizeDirectory(string path)
+      {
+         return Environment.ExpandEnvironmentVariables(path).Replace('/', '\\').TrimEnd('\\');
+      }
+
+      private static bool IsBelowAny(string directory, HashSet<string> directories)
+      {
+         for (int index = directory.LastIndexOf('\\'); index > 0; index = directory.LastIndexOf('\\', index - 1))
+         {
+            if (directories.Contains(directory.Substring(0, index)))
+               return true;
+         }
+
+         return false;
+      }
+
+      private void Walk(WalkState state)
+      {
+         List<VssFileManifestEntry> entries = new List<VssFileManifestEntry>();
+         List<string> inaccessibleDirectories = new List<string>();
+         List<FileInfo> files = new List<FileInfo>();
+         List<string> fileNames = new List<string>();
+
+         try
+         {
+            for (;;)
+            {
+               // Idle threads block until an item is queued or the walk has finished. The semaphore is released once per
+               // queued item, so an item can always be taken after waiting, unless the walk has finished or failed.
+               state.Available.Wait();
+
+               WorkItem item;
+               if (Interlocked.CompareExchange(ref state.Exception, null, null) != null || !state.Queue.TryTake(out item))
+                  break;
+
+               try
+               {
+                  state.CancellationToken.ThrowIfCancellationRequested();
+
+                  if (!ReadDirectory(state, item, files, fileNames))
+                  {
+                     inaccessibleDirectories.Add(item.Path);
+                     continue;
+                  }
+
+                  int[] matches = state.Matcher.FindMatchIndices(item.Path, fileNames);
+                  for (int i = 0; i < matches.Length; i++)
+                  {
+                     if (matches[i] < 0)
+                        continue;
+
+                     try
+                     {
+                        entries.Add(new VssFileManifestEntry(item.Path + "\\" + fileNames[i], files[i].Length, files[i].LastWriteTimeUtc, m_fileDescriptorComponents[matches[i]]));
+                     }
+                     catch (IOException)
+                     {
+                        // The file was removed after the directory was read.
+                     }
+                  }
+               }
+               finally
+               {
+                  // Subdirectories have been added before the item is completed, so the count only drops to zero when all work is done.
+                  if (Interlocked.Decrement(ref state.Pending) == 0)
+                     state.Finish();
+               }
+            }
+         }
+         catch (Exception ex)
+         {
+            Interlocked.CompareExchange(ref state.Exception, ex, null);
+
+            // Make the other threads stop.
+            state.Finish();
+         }
+
+         lock (state)
+         {
+            state.Entries.AddRange(entries);
+            state.InaccessibleDirectories.AddRange(inaccessibleDirectories);
+         }
+      }
+
+      // Reads the files of the directory of item into files and fileNames, and adds its subdirectories to the queue if
+      // the item is recursive. Returns false if the directory exists but cannot be read.
+      private static bool ReadDirectory(WalkState state, WorkItem item, List<FileInfo> files, List<string> fileNames)
+      {
+         files.Clear();
+         fileNames.Clear();
+
+         FileSystemInfo[] infos;
+         try
+         {
+            infos = new DirectoryInfo(item.SnapshotPath).GetFileSystemInfos();
+         }
+         catch (DirectoryNotFoundException)
+         {
+            return true;
+         }
+         catch (UnauthorizedAccessException)
+         {
+            return false;
+         }
+         catch (IOException)
+         {
+            return false;
+         }
+
+         foreach (FileSystemInfo info in infos)
+         {
+            FileAttributes attributes;
+            try
+            {
+               attributes = info.Attributes;
+            }
+            catch (IOException)
+            {
+               continue;
+            }
+
+            if ((attributes & FileAttributes.Directory) == 0)
+            {
+               files.Add((FileInfo)info);
+               fileNames.Add(info.Name);
+            }
+            else if (item.IsRecursive && (attributes & FileAttributes.ReparsePoint) == 0)
+            {
+               state.Add(new WorkItem(item.Path + "\\" + info.Name, info.FullName, true));
+            }
+         }
+
+         return true;
+      }
+
+      #endregion
+
+      #region Nested Types
+
+      private sealed class WorkItem
+      {
+         public WorkItem(string path, string snapshotPath, bool isRecursive)
+         {
+            Path = path;
+            SnapshotPath = snapshotPath;
+            IsRecursive = isRecursive;
+         }
+
+         // The path of the directory on the original volume, without a trailing backslash.
+         public string Path { get; private set; }
+         public string SnapshotPath { get; private set; }
+
+         // True if the subdirectories of the directory must be walked as well.
+         public bool IsRecursive { get; private set; }
+      }
+
+      private sealed class WalkState : IDisposable
+      {
+         // ConcurrentBag keeps the items added by a thread in a list local to that thread, from which other threads
+         // only take items when their own list is empty.
+         public readonly ConcurrentBag<WorkItem> Queue = new ConcurrentBag<WorkItem>();
+         public readonly List<VssFileManifestEntry> Entries = new List<VssFileManifestEntry>();
+         public readonly List<string> InaccessibleDirectories = new List<string>();
+         public readonly SemaphoreSlim Available = new SemaphoreSlim(0);
+         public readonly VssFileSpecificationMatcher Matcher;
+         public readonly CancellationToken CancellationToken;
+         public int Pending;
+         public Exception Exception;
+         private readonly int m_threadCount;
+
+         public WalkState(VssFileSpecificationMatcher matcher, int threadCount, CancellationToken cancellationToken)
+         {
+            Matcher = matcher;
+            m_threadCount = threadCount;
+            CancellationToken = cancellationToken;
+         }
+
+         public void Add(WorkItem item)
+         {
+            Interlocked.Increment(ref Pending);
+            Queue.Add(item);
+            Available.Release();
+         }
+
+         // Wakes all threads, which find the queue empty or the exception set, and return.
+         public void Finish()
+         {
+            Available.Release(m_threadCount);
+         }
+
+         public void Dispose()
+         {
+            Available.Dispose();
+         }
+      }
+
+      #endregion
+   }
+}
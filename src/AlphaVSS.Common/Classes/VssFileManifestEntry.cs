@@ -0,0 +1,51 @@
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssFileManifestEntry"/> class describes a file of a <see cref="VssFileManifest"/>.
+   /// </summary>
+   [Serializable]
+   public class VssFileManifestEntry
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssFileManifestEntry"/> class.
+      /// </summary>
+      /// <param name="path">The full path of the file on the original volume.</param>
+      /// <param name="length">The size of the file, in bytes.</param>
+      /// <param name="lastWriteTimeUtc">The time the file was last written to, in coordinated universal time.</param>
+      /// <param name="componentId">The id of the component owning the file.</param>
+      public VssFileManifestEntry(string path, long length, DateTime lastWriteTimeUtc, int componentId)
+      {
+         Path = path;
+         Length = length;
+         LastWriteTimeUtc = lastWriteTimeUtc;
+         ComponentId = componentId;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the full path of the file on the original volume.
+      /// </summary>
+      /// <remarks>Use <see cref="VssFileManifestBuilder.GetSnapshotPath"/> to obtain the path of the file in the shadow copy.</remarks>
+      public string Path { get; private set; }
+
+      /// <summary>
+      /// Gets the size of the file, in bytes.
+      /// </summary>
+      public long Length { get; private set; }
+
+      /// <summary>
+      /// Gets the time the file was last written to, in coordinated universal time.
+      /// </summary>
+      public DateTime LastWriteTimeUtc { get; private set; }
+
+      /// <summary>
+      /// Gets the id of the component owning the file, which is its index in <see cref="VssFileManifest.Components"/>.
+      /// </summary>
+      public int ComponentId { get; private set; }
+
+      #endregion
+   }
+}
@@ -0,0 +1,523 @@
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssFileSpecificationMatcher"/> class determines whether files are described by any of a set of
+   ///     <see cref="VssWMFileDescriptor"/> instances, such as the files of the components of a writer.
+   /// </summary>
+   /// <remarks>
+   ///     <para>
+   ///         A file is described by a file descriptor if it resides in the directory specified by <see cref="VssWMFileDescriptor.Path"/>
+   ///         (or, if <see cref="VssWMFileDescriptor.IsRecursive"/> is <see langword="true"/>, in any of its subdirectories), and its name
+   ///         matches <see cref="VssWMFileDescriptor.FileSpecification"/>. The file specification may contain the DOS wildcards <c>*</c>
+   ///         and <c>?</c>; as with the Windows file system functions, <c>*.*</c> matches all file names, a pattern ending in <c>.*</c>
+   ///         also matches names without an extension, and a pattern ending in a dot, such as <c>*.</c>, matches names without an extension
+   ///         only. Paths and names are compared without regard to case.
+   ///     </para>
+   ///     <para>
+   ///         Environment variables in the paths of the file descriptors are expanded once, when the matcher is created. The directories of
+   ///         all file descriptors are combined into a single radix tree, so that a path is matched in a single pass in which every edge of
+   ///         the tree is compared once, after which only the file specifications of the directories containing the file
+   ///         are evaluated. Matching a path that uses backslashes as separators does not allocate memory. To match all files of a directory,
+   ///         use <see cref="FindMatches"/>, which only determines the relevant file specifications once.
+   ///     </para>
+   ///     <para>
+   ///         The tree is not modified once the matcher has been created, so a matcher can be shared by the threads of a file scan.
+   ///     </para>
+   /// </remarks>
+   [Serializable]
+   public sealed class VssFileSpecificationMatcher
+   {
+      #region Private Fields
+
+      private readonly VssWMFileDescriptor[] m_fileDescriptors;
+      private readonly DirectoryNode m_root = new DirectoryNode();
+
+      #endregion
+
+      #region Constructor
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssFileSpecificationMatcher"/> class.
+      /// </summary>
+      /// <param name="fileDescriptors">The file descriptors to match files against.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="fileDescriptors"/> is <see langword="null"/>.</exception>
+      public VssFileSpecificationMatcher(IEnumerable<VssWMFileDescriptor> fileDescriptors)
+      {
+         if (fileDescriptors == null)
+            throw new ArgumentNullException("fileDescriptors");
+
+         m_fileDescriptors = new List<VssWMFileDescriptor>(fileDescriptors).ToArray();
+
+         for (int index = 0; index < m_fileDescriptors.Length; index++)
+         {
+            VssWMFileDescriptor descriptor = m_fileDescriptors[index];
+            if (descriptor == null)
+               throw new ArgumentException("The sequence of file descriptors contains a null reference.", "fileDescriptors");
+
+            string directory = NormalizeDirectory(descriptor.Path);
+            if (directory.Length == 0 || descriptor.FileSpecification == null)
+               continue;
+
+            DirectoryNode node = m_root.Add(directory, 0);
+            FilePattern pattern = new FilePattern(index, descriptor.FileSpecification);
+            if (descriptor.IsRecursive)
+               node.RecursivePatterns.Add(pattern);
+            else
+               node.Patterns.Add(pattern);
+         }
+      }
+
+      #endregion
+
+      #region Public Properties
+
+      /// <summary>
+      /// Gets the file descriptors that files are matched against.
+      /// </summary>
+      public IList<VssWMFileDescriptor> FileDescriptors
+      {
+         get
+         {
+            return Array.AsReadOnly(m_fileDescriptors);
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Determines whether a file is described by any of the file descriptors of this matcher.
+      /// </summary>
+      /// <param name="path">The full path of the file.</param>
+      /// <returns><see langword="true"/> if the file is described by at least one of the file descriptors; otherwise <see langword="false"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="path"/> is <see langword="null"/>.</exception>
+      public bool IsMatch(string path)
+      {
+         return Match(path, true) >= 0;
+      }
+
+      /// <summary>
+      /// Finds the first of the file descriptors of this matcher that describes a file.
+      /// </summary>
+      /// <param name="path">The full path of the file.</param>
+      /// <returns>The matching file descriptor that occurs first in <see cref="FileDescriptors"/>, or <see langword="null"/> if no file descriptor describes the file.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="path"/> is <see langword="null"/>.</exception>
+      public VssWMFileDescriptor FindMatch(string path)
+      {
+         int index = FindMatchIndex(path);
+         return index < 0 ? null : m_fileDescriptors[index];
+      }
+
+      /// <summary>
+      /// Finds, for each of a number of files in the same directory, the first of the file descriptors of this matcher that describes the file.
+      /// </summary>
+      /// <param name="directory">The full path of the directory containing the files.</param>
+      /// <param name="fileNames">The names of the files, without a directory.</param>
+      /// <returns>
+      /// An array containing, for each element of <paramref name="fileNames"/>, the matching file descriptor that occurs first in
+      /// <see cref="FileDescriptors"/>, or <see langword="null"/> if no file descriptor describes the file.
+      /// </returns>
+      /// <exception cref="ArgumentNullException"><paramref name="directory"/> or <paramref name="fileNames"/> is <see langword="null"/>, or <paramref name="fileNames"/> contains a <see langword="null"/> reference.</exception>
+      public VssWMFileDescriptor[] FindMatches(string directory, IList<string> fileNames)
+      {
+         int[] indices = FindMatchIndices(directory, fileNames);
+
+         VssWMFileDescriptor[] result = new VssWMFileDescriptor[indices.Length];
+         for (int i = 0; i < indices.Length; i++)
+         {
+            if (indices[i] >= 0)
+               result[i] = m_fileDescriptors[indices[i]];
+         }
+
+         return result;
+      }
+
+      #endregion
+
+      #region Internal Methods
+
+      // Returns the index of the first file descriptor describing path, or -1.
+      internal int FindMatchIndex(string path)
+      {
+         return Match(path, false);
+      }
+
+      // Returns the index of the first file descriptor describing each of the files, or -1.
+      internal int[] FindMatchIndices(string directory, IList<string> fileNames)
+      {
+         if (directory == null)
+            throw new ArgumentNullException("directory");
+
+         if (fileNames == null)
+            throw new ArgumentNullException("fileNames");
+
+         string path = directory.Replace('/', '\\').TrimEnd('\\') + "\\";
+
+         // Collect the patterns of the directory and the recursive patterns of its ancestors.
+         List<FilePattern> patterns = new List<FilePattern>();
+         int position = 0;
+         DirectoryNode node = m_root;
+         while (true)
+         {
+            if (node.HasPatterns && path[position] == '\\')
+            {
+               if (position == path.Length - 1)
+                  patterns.AddRange(node.Patterns);
+
+               patterns.AddRange(node.RecursivePatterns);
+            }
+
+            node = node.GetChild(ToUpper(path[position]));
+            if (node == null || position + node.Label.Length >= path.Length || !EqualsUpper(path, position, node.Label))
+               break;
+
+            position += node.Label.Length;
+         }
+
+         patterns.Sort((x, y) => x.Index.CompareTo(y.Index));
+
+         int[] result = new int[fileNames.Count];
+         for (int i = 0; i < result.Length; i++)
+         {
+            string fileName = fileNames[i];
+            if (fileName == null)
+               throw new ArgumentNullException("fileNames", "The list of file names contains a null reference.");
+
+            result[i] = -1;
+            foreach (FilePattern pattern in patterns)
+            {
+               if (fileName.Length > 0 && pattern.IsMatch(fileName, 0))
+               {
+                  result[i] = pattern.Index;
+                  break;
+               }
+            }
+         }
+
+         return result;
+      }
+
+      #endregion
+
+      #region Private Methods
+
+      private int Match(string path, bool matchAny)
+      {
+         if (path == null)
+            throw new ArgumentNullException("path");
+
+         if (path.IndexOf('/') >= 0)
+            path = path.Replace('/', '\\');
+
+         int nameStart = path.LastIndexOf('\\') + 1;
+         if (nameStart == 0 || nameStart == path.Length)
+            return -1;
+
+         int result = -1;
+         int position = 0;
+         DirectoryNode node = m_root;
+         while (true)
+         {
+            // A directory of a file descriptor matches if the path continues with a separator.
+            if (node.HasPatterns && path[position] == '\\')
+            {
+               if (position == nameStart - 1)
+                  result = MatchPatterns(node.Patterns, path, nameStart, result, matchAny);
+
+               if (result < 0 || !matchAny)
+                  result = MatchPatterns(node.RecursivePatterns, path, nameStart, result, matchAny);
+
+               if (result >= 0 && matchAny)
+                  return result;
+            }
+
+            node = node.GetChild(ToUpper(path[position]));
+            if (node == null || position + node.Label.Length >= nameStart ||
+                !EqualsUpper(path, position, node.Label))
+               return result;
+
+            position += node.Label.Length;
+         }
+      }
+
+      private static int MatchPatterns(List<FilePattern> patterns, string path, int nameStart, int result, bool matchAny)
+      {
+         foreach (FilePattern pattern in patterns)
+         {
+            if (result >= 0 && pattern.Index >= result)
+               break;
+
+            if (pattern.IsMatch(path, nameStart))
+            {
+               result = pattern.Index;
+               if (matchAny)
+                  break;
+            }
+         }
+
+         return result;
+      }
+
+      private static char ToUpper(char c)
+      {
+         if (c < 0x80)
+            return (c >= 'a' && c <= 'z') ? (char)(c - ('a' - 'A')) : c;
+
+         return Char.ToUpperInvariant(c);
+      }
+
+      // Determines whether the characters of str starting at offset, converted to upper case, equal upper, which
+      // must be in upper case. The caller must ensure that str is long enough. The labels and patterns compared
+      // are usually short, so comparing the characters directly is faster than a call to String.Compare.
+      private static bool EqualsUpper(string str, int offset, string upper)
+      {
+         for (int i = 0; i < upper.Length; i++)
+         {
+            char c = str[offset + i];
+            if (c != upper[i] && ToUpper(c) != upper[i])
+               return false;
+         }
+
+         return true;
+      }
+
+      private static string NormalizeDirectory(string path)
+      {
+         if (path == null)
+            return String.Empty;
+
+         return Environment.ExpandEnvironmentVariables(path).Replace('/', '\\').TrimEnd('\\').ToUpperInvariant();
+      }
+
+      #endregion
+
+      #region Nested Types
+
+      // A node of a radix tree of upper case directory paths. The path of a node is the concatenation of the labels
+      // of the nodes on the path from the root, and the labels of the children of a node start with distinct characters.
+      [Serializable]
+      private sealed class DirectoryNode
+      {
+         private char[] m_keys = new char[0];
+         private DirectoryNode[] m_children = new DirectoryNode[0];
+
+         public DirectoryNode()
+            : this(String.Empty)
+         {
+         }
+
+         private DirectoryNode(string label)
+         {
+            Label = label;
+            Patterns = new List<FilePattern>();
+            RecursivePatterns = new List<FilePattern>();
+         }
+
+         public string Label { get; private set; }
+
+         public bool HasPatterns { get; private set; }
+
+         // Patterns are added in ascending order of their index.
+         public List<FilePattern> Patterns { get; private set; }
+         public List<FilePattern> RecursivePatterns { get; private set; }
+
+         public DirectoryNode GetChild(char key)
+         {
+            // Nodes rarely have more than a few children, so a linear search is faster than a hash lookup.
+            for (int i = 0; i < m_keys.Length; i++)
+            {
+               if (m_keys[i] == key)
+                  return m_children[i];
+            }
+
+            return null;
+         }
+
+         // Returns the node for path, the characters of which up to start are the path of this node,
+         // creating it if necessary. The returned node is marked as having patterns.
+         public DirectoryNode Add(string path, int start)
+         {
+            if (start == path.Length)
+            {
+               HasPatterns = true;
+               return this;
+            }
+
+            DirectoryNode child = GetChild(path[start]);
+            if (child == null)
+            {
+               child = new DirectoryNode(path.Substring(start));
+               AddChild(child);
+               return child.Add(path, path.Length);
+            }
+
+            int common = 0;
+            while (common < child.Label.Length && start + common < path.Length && child.Label[common] == path[start + common])
+               common++;
+
+            if (common < child.Label.Length)
+            {
+               // Split the child, so that the common part of its label becomes a node of its own.
+               DirectoryNode split = new DirectoryNode(child.Label.Substring(0, common));
+               child.Label = child.Label.Substring(common);
+               split.AddChild(child);
+               m_children[Array.IndexOf(m_children, child)] = split;
+               child = split;
+            }
+
+            return child.Add(path, start + common);
+         }
+
+         private void AddChild(DirectoryNode child)
+         {
+            Array.Resize(ref m_keys, m_keys.Length + 1);
+            Array.Resize(ref m_children, m_children.Length + 1);
+            m_keys[m_keys.Length - 1] = child.Label[0];
+            m_children[m_children.Length - 1] = child;
+         }
+      }
+
+      private enum PatternKind
+      {
+         Any,
+         Literal,
+         Prefix,
+         Suffix,
+         Wildcard
+      }
+
+      // A file specification, converted to upper case and classified so that the common forms
+      // ("*", "name.ext", "name*" and "*.ext") are matched by a single comparison.
+      [Serializable]
+      private sealed class FilePattern
+      {
+         private readonly string m_pattern;
+         private readonly PatternKind m_kind;
+
+         // For patterns ending in ".*", the pattern without that suffix, which matches names without an extension.
+         private readonly FilePattern m_withoutExtension;
+
+         // Whether the pattern ended in a dot and contains no other dot, such as "*." and "NAME.", in which
+         // case it only matches names without an extension.
+         private readonly bool m_noExtension;
+
+         public FilePattern(int index, string specification)
+            : this(index, specification.ToUpperInvariant(), true)
+         {
+         }
+
+         private FilePattern(int index, string pattern, bool allowWithoutExtension)
+         {
+            Index = index;
+
+            if (pattern.Length > 1 && pattern[pattern.Length - 1] == '.')
+            {
+               pattern = pattern.TrimEnd('.');
+               m_noExtension = pattern.IndexOf('.') < 0;
+            }
+
+            // Consecutive asterisks are equivalent to a single asterisk, and so is "*.*".
+            while (pattern.Contains("**"))
+               pattern = pattern.Replace("**", "*");
+
+            if (pattern == "*.*")
+               pattern = "*";
+
+            int wildcards = pattern.IndexOfAny(s_wildcards);
+            int lastWildcard = pattern.LastIndexOfAny(s_wildcards);
+
+            if (pattern == "*")
+               m_kind = PatternKind.Any;
+            else if (wildcards < 0)
+               m_kind = PatternKind.Literal;
+            else if (wildcards == pattern.Length - 1 && pattern[wildcards] == '*')
+               m_kind = PatternKind.Prefix;
+            else if (lastWildcard == 0 && pattern[0] == '*')
+               m_kind = PatternKind.Suffix;
+            else
+               m_kind = PatternKind.Wildcard;
+
+            m_pattern = m_kind == PatternKind.Prefix ? pattern.Substring(0, pattern.Length - 1) : m_kind == PatternKind.Suffix ? pattern.Substring(1) : pattern;
+
+            if (allowWithoutExtension && pattern.Length > 2 && pattern.EndsWith(".*", StringComparison.Ordinal))
+               m_withoutExtension = new FilePattern(index, pattern.Substring(0, pattern.Length - 2), false);
+         }
+
+         public int Index { get; private set; }
+
+         public bool IsMatch(string path, int nameStart)
+         {
+            if (m_withoutExtension != null && path.IndexOf('.', nameStart) < 0)
+               return m_withoutExtension.IsMatch(path, nameStart);
+
+            if (m_noExtension && path.IndexOf('.', nameStart) >= 0)
+               return false;
+
+            int nameLength = path.Length - nameStart;
+            switch (m_kind)
+            {
+               case PatternKind.Any:
+                  return true;
+
+               case PatternKind.Literal:
+                  return nameLength == m_pattern.Length && EqualsUpper(path, nameStart, m_pattern);
+
+               case PatternKind.Prefix:
+                  return nameLength >= m_pattern.Length && EqualsUpper(path, nameStart, m_pattern);
+
+               case PatternKind.Suffix:
+                  return nameLength >= m_pattern.Length && EqualsUpper(path, path.Length - m_pattern.Length, m_pattern);
+
+               default:
+                  return IsWildcardMatch(path, nameStart);
+            }
+         }
+
+         // Matches the name against the pattern, backtracking only to the most recent asterisk, which
+         // is sufficient since an asterisk matches any sequence of characters.
+         private bool IsWildcardMatch(string path, int nameStart)
+         {
+            int p = 0;
+            int n = nameStart;
+            int starPattern = -1;
+            int starName = 0;
+
+            while (n < path.Length)
+            {
+               if (p < m_pattern.Length && m_pattern[p] == '*')
+               {
+                  starPattern = p++;
+                  starName = n;
+               }
+               else if (p < m_pattern.Length && (m_pattern[p] == '?' || m_pattern[p] == ToUpper(path[n])))
+               {
+                  p++;
+                  n++;
+               }
+               else if (starPattern >= 0)
+               {
+                  p = starPattern + 1;
+                  n = ++starName;
+               }
+               else
+               {
+                  return false;
+               }
+            }
+
+            while (p < m_pattern.Length && m_pattern[p] == '*')
+               p++;
+
+            return p == m_pattern.Length;
+         }
+
+         private static readonly char[] s_wildcards = new char[] { '*', '?' };
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,789 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Text;
+using System.Xml;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssMetadataIndex"/> class is an index of the writers, components and files described by a writer metadata document
+   ///     or a backup components document, allowing these documents to be queried without a VSS session.
+   /// </summary>
+   /// <remarks>
+   ///     <para>
+   ///         A writer metadata document is the document returned by <see cref="IVssExamineWriterMetadata.SaveAsXml()"/>, and a backup components
+   ///         document is the document returned by <see cref="IVssBackupComponents.SaveAsXml()"/>. The document is read in a single forward-only pass,
+   ///         so the document text is never held in memory as a whole. Writer metadata documents embedded in a backup components document are
+   ///         indexed as well.
+   ///     </para>
+   ///     <para>
+   ///         An index can be saved to a compact binary form by <see cref="Save"/>, in which every distinct string is stored only once, and loaded
+   ///         again by <see cref="Load"/> without parsing the original document. <see cref="Load"/> reads the whole saved index into memory; the
+   ///         saved form is not laid out to be queried in place.
+   ///     </para>
+   ///     <para>
+   ///         Components are kept sorted by logical path, so lookups by logical path are binary searches, and grouped by writer instance.
+   ///     </para>
+   /// </remarks>
+   public sealed class VssMetadataIndex
+   {
+      #region Private Constants
+
+      // "AVSSMDX1" in little endian byte order.
+      private const long FileMagic = 0x3158444D53535641;
+      private const int FileFormatVersion = 1;
+
+      private static readonly StringComparer s_pathComparer = StringComparer.OrdinalIgnoreCase;
+      private static readonly IList<VssMetadataIndexComponent> s_noComponents = Array.AsReadOnly(new VssMetadataIndexComponent[0]);
+
+      #endregion
+
+      #region Private Fields
+
+      private readonly IList<VssMetadataIndexWriter> m_writers;
+
+      // Sorted by logical path, then by component name, using s_pathComparer.
+      private readonly VssMetadataIndexComponent[] m_components;
+      private readonly IList<VssMetadataIndexComponent> m_readOnlyComponents;
+
+      // The components of each writer instance, in the order of m_components.
+      private readonly Dictionary<Guid, IList<VssMetadataIndexComponent>> m_componentsByInstance;
+
+      #endregion
+
+      #region Constructors
+
+      private VssMetadataIndex(bool isBackupComponentsDocument, VssBackupType backupType, List<VssMetadataIndexWriter> writers, List<VssMetadataIndexComponent> components)
+      {
+         IsBackupComponentsDocument = isBackupComponentsDocument;
+         BackupType = backupType;
+         m_writers = writers.AsReadOnly();
+
+         m_components = components.ToArray();
+         Array.Sort(m_components, CompareComponents);
+         m_readOnlyComponents = Array.AsReadOnly(m_components);
+
+         Dictionary<Guid, List<VssMetadataIndexComponent>> byInstance = new Dictionary<Guid, List<VssMetadataIndexComponent>>();
+         foreach (VssMetadataIndexComponent component in m_components)
+         {
+            List<VssMetadataIndexComponent> list;
+            if (!byInstance.TryGetValue(component.InstanceId, out list))
+            {
+               list = new List<VssMetadataIndexComponent>();
+               byInstance.Add(component.InstanceId, list);
+            }
+
+            list.Add(component);
+         }
+
+         m_componentsByInstance = new Dictionary<Guid, IList<VssMetadataIndexComponent>>(byInstance.Count);
+         foreach (KeyValuePair<Guid, List<VssMetadataIndexComponent>> pair in byInstance)
+            m_componentsByInstance.Add(pair.Key, pair.Value.AsReadOnly());
+      }
+
+      #endregion
+
+      #region Public Properties
+
+      /// <summary>
+      /// Gets a value indicating whether the indexed document is a backup components document.
+      /// </summary>
+      /// <value><see langword="true"/> if the indexed document is a backup components document; <see langword="false"/> if it is a writer metadata document.</value>
+      public bool IsBackupComponentsDocument { get; private set; }
+
+      /// <summary>
+      /// Gets the type of the backup described by a backup components document.
+      /// </summary>
+      /// <value>The type of backup, or <see cref="VssBackupType.Undefined"/> if the document does not specify it.</value>
+      public VssBackupType BackupType { get; private set; }
+
+      /// <summary>
+      /// Gets the writers described by the document.
+      /// </summary>
+      public IList<VssMetadataIndexWriter> Writers
+      {
+         get
+         {
+            return m_writers;
+         }
+      }
+
+      /// <summary>
+      /// Gets all components described by the document, ordered by logical path and component name.
+      /// </summary>
+      public IList<VssMetadataIndexComponent> Components
+      {
+         get
+         {
+            return m_readOnlyComponents;
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Builds an index of the specified writer metadata or backup components document.
+      /// </summary>
+      /// <param name="xml">The text of the document.</param>
+      /// <returns>The index of the document.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="xml"/> is <see langword="null"/>.</exception>
+      /// <exception cref="XmlException">The document is not well formed.</exception>
+      /// <exception cref="FormatException">The document contains an invalid value.</exception>
+      public static VssMetadataIndex Parse(string xml)
+      {
+         if (xml == null)
+            throw new ArgumentNullException("xml");
+
+         using (StringReader reader = new StringReader(xml))
+         {
+            return Parse(reader);
+         }
+      }
+
+      /// <summary>
+      /// Builds an index of the writer metadata or backup components document read from the specified reader.
+      /// </summary>
+      /// <param name="reader">The reader to read the document from. The reader is not closed by this method.</param>
+      /// <returns>The index of the document.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="reader"/> is <see langword="null"/>.</exception>
+      /// <exception cref="XmlException">The document is not well formed.</exception>
+      /// <exception cref="FormatException">The document contains an invalid value.</exception>
+      public static VssMetadataIndex Parse(TextReader reader)
+      {
+         if (reader == null)
+            throw new ArgumentNullException("reader");
+
+         using (XmlReader xmlReader = XmlReader.Create(reader, CreateReaderSettings()))
+         {
+            return Parse(xmlReader);
+         }
+      }
+
+      /// <summary>
+      /// Builds an index of the writer metadata or backup components document read from the specified stream.
+      /// </summary>
+      /// <param name="stream">The stream to read the document from. The encoding of the document is detected from the stream. The stream is not closed by this method.</param>
+      /// <returns>The index of the document.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="stream"/> is <see langword="null"/>.</exception>
+      /// <exception cref="XmlException">The document is not well formed.</exception>
+      /// <exception cref="FormatException">The document contains an invalid value.</exception>
+      public static VssMetadataIndex Parse(Stream stream)
+      {
+         if (stream == null)
+            throw new ArgumentNullException("stream");
+
+         using (XmlReader xmlReader = XmlReader.Create(stream, CreateReaderSettings()))
+         {
+            return Parse(xmlReader);
+         }
+      }
+
+      /// <summary>
+      /// Gets the components with the specified logical path.
+      /// </summary>
+      /// <param name="logicalPath">The logical path of the components. <see langword="null"/> and the empty string both denote components without a logical path. The comparison is case insensitive and ignores trailing backslashes.</param>
+      /// <returns>The components with the specified logical path, ordered by component name.</returns>
+      public IList<VssMetadataIndexComponent> GetComponents(string logicalPath)
+      {
+         logicalPath = NormalizeLogicalPath(logicalPath);
+
+         List<VssMetadataIndexComponent> result = new List<VssMetadataIndexComponent>();
+         for (int i = LowerBound(logicalPath); i < m_components.Length && s_pathComparer.Equals(GetLogicalPath(m_components[i]), logicalPath); i++)
+            result.Add(m_components[i]);
+
+         return result;
+      }
+
+      /// <summary>
+      /// Gets the component with the specified logical path and name.
+      /// </summary>
+      /// <param name="logicalPath">The logical path of the component, or <see langword="null"/> if the component has no logical path. The comparison is case insensitive and ignores trailing backslashes.</param>
+      /// <param name="componentName">The name of the component. The comparison is case insensitive.</param>
+      /// <returns>The first component with the specified logical path and name, or <see langword="null"/> if there is no such component.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="componentName"/> is <see langword="null"/>.</exception>
+      public VssMetadataIndexComponent FindComponent(string logicalPath, string componentName)
+      {
+         if (componentName == null)
+            throw new ArgumentNullException("componentName");
+
+         logicalPath = NormalizeLogicalPath(logicalPath);
+
+         for (int i = LowerBound(logicalPath); i < m_components.Length && s_pathComparer.Equals(GetLogicalPath(m_components[i]), logicalPath); i++)
+         {
+            int cmp = s_pathComparer.Compare(m_components[i].ComponentName, componentName);
+            if (cmp == 0)
+               return m_components[i];
+            if (cmp > 0)
+               break;
+         }
+
+         return null;
+      }
+
+      /// <summary>
+      /// Gets the components whose logical path is equal to or below the specified logical path.
+      /// </summary>
+      /// <param name="logicalPath">The logical path. The comparison is case insensitive and ignores trailing backslashes.</param>
+      /// <returns>
+      ///     The components whose logical path is <paramref name="logicalPath"/>, or starts with <paramref name="logicalPath"/> followed by
+      ///     a backslash, ordered by logical path and component name.
+      /// </returns>
+      /// <exception cref="ArgumentNullException"><paramref name="logicalPath"/> is <see langword="null"/>.</exception>
+      public IList<VssMetadataIndexComponent> GetComponentsUnder(string logicalPath)
+      {
+         if (logicalPath == null)
+            throw new ArgumentNullException("logicalPath");
+
+         logicalPath = NormalizeLogicalPath(logicalPath);
+
+         // All logical paths starting with the prefix form a contiguous range of the sorted components.
+         List<VssMetadataIndexComponent> result = new List<VssMetadataIndexComponent>();
+         for (int i = LowerBound(logicalPath); i < m_components.Length; i++)
+         {
+            string path = GetLogicalPath(m_components[i]);
+            if (!path.StartsWith(logicalPath, StringComparison.OrdinalIgnoreCase))
+               break;
+
+            if (path.Length == logicalPath.Length || logicalPath.Length == 0 || path[logicalPath.Length] == '\\')
+               result.Add(m_components[i]);
+         }
+
+         return result;
+      }
+
+      /// <summary>
+      /// Gets the components of the specified writer instance.
+      /// </summary>
+      /// <param name="instanceId">The instance id of the writer.</param>
+      /// <returns>A read-only list of the components of the writer instance, ordered by logical path and component name.</returns>
+      public IList<VssMetadataIndexComponent> GetComponentsForWriter(Guid instanceId)
+      {
+         IList<VssMetadataIndexComponent> result;
+         if (!m_componentsByInstance.TryGetValue(instanceId, out result))
+            return s_noComponents;
+
+         return result;
+      }
+
+      /// <summary>
+      /// Saves the index to the specified stream in a compact binary form that can be read by <see cref="Load"/>.
+      /// </summary>
+      /// <param name="stream">The stream to write the index to. The stream is not closed by this method.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="stream"/> is <see langword="null"/>.</exception>
+      public void Save(Stream stream)
+      {
+         if (stream == null)
+            throw new ArgumentNullException("stream");
+
+         // Collect the distinct strings first, so that records can refer to them by index.
+         Dictionary<string, int> stringIndex = new Dictionary<string, int>(StringComparer.Ordinal);
+         List<string> strings = new List<string>();
+
+         foreach (VssMetadataIndexWriter w in m_writers)
+         {
+            AddString(stringIndex, strings, w.WriterName);
+            AddString(stringIndex, strings, w.InstanceName);
+         }
+
+         foreach (VssMetadataIndexComponent component in m_components)
+         {
+            AddString(stringIndex, strings, component.LogicalPath);
+            AddString(stringIndex, strings, component.ComponentName);
+            AddString(stringIndex, strings, component.Caption);
+            AddString(stringIndex, strings, component.BackupStamp);
+            AddString(stringIndex, strings, component.PreviousBackupStamp);
+            AddFileStrings(stringIndex, strings, component.Files);
+            AddFileStrings(stringIndex, strings, component.DatabaseFiles);
+            AddFileStrings(stringIndex, strings, component.DatabaseLogFiles);
+         }
+
+         BinaryWriter writer = new BinaryWriter(stream, Encoding.UTF8);
+
+         writer.Write(FileMagic);
+         writer.Write(FileFormatVersion);
+         writer.Write(IsBackupComponentsDocument);
+         writer.Write((int)BackupType);
+
+         writer.Write(strings.Count);
+         foreach (string s in strings)
+            writer.Write(s);
+
+         writer.Write(m_writers.Count);
+         foreach (VssMetadataIndexWriter w in m_writers)
+         {
+            writer.Write(w.InstanceId.ToByteArray());
+            writer.Write(w.WriterId.ToByteArray());
+            WriteString(writer, stringIndex, w.WriterName);
+            WriteString(writer, stringIndex, w.InstanceName);
+         }
+
+         writer.Write(m_components.Length);
+         foreach (VssMetadataIndexComponent component in m_components)
+         {
+            writer.Write(component.InstanceId.ToByteArray());
+            writer.Write(component.WriterId.ToByteArray());
+            writer.Write((int)component.ComponentType);
+            WriteString(writer, stringIndex, component.LogicalPath);
+            WriteString(writer, stringIndex, component.ComponentName);
+            WriteString(writer, stringIndex, component.Caption);
+            writer.Write((sbyte)(component.BackupSucceeded.HasValue ? (component.BackupSucceeded.Value ? 1 : 0) : -1));
+            WriteString(writer, stringIndex, component.BackupStamp);
+            WriteString(writer, stringIndex, component.PreviousBackupStamp);
+            WriteFiles(writer, stringIndex, component.Files);
+            WriteFiles(writer, stringIndex, component.DatabaseFiles);
+            WriteFiles(writer, stringIndex, component.DatabaseLogFiles);
+         }
+
+         writer.Flush();
+      }
+
+      /// <summary>
+      /// Loads an index saved by <see cref="Save"/> from the specified stream.
+      /// </summary>
+      /// <param name="stream">The stream to read the index from. The stream is not closed by this method.</param>
+      /// <returns>The loaded index.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="stream"/> is <see langword="null"/>.</exception>
+      /// <exception cref="InvalidDataException">The stream does not contain a valid index.</exception>
+      public static VssMetadataIndex Load(Stream stream)
+      {
+         if (stream == null)
+            throw new ArgumentNullException("stream");
+
+         BinaryReader reader = new BinaryReader(stream, Encoding.UTF8);
+         try
+         {
+            if (reader.ReadInt64() != FileMagic)
+               throw new InvalidDataException("The stream does not contain a VSS metadata index.");
+
+            int version = reader.ReadInt32();
+            if (version != FileFormatVersion)
+               throw new InvalidDataException(String.Format(CultureInfo.CurrentCulture, "Unsupported VSS metadata index format version {0}.", version));
+
+            bool isBackupComponentsDocument = reader.ReadBoolean();
+            VssBackupType backupType = (VssBackupType)reader.ReadInt32();
+
+            string[] strings = new string[ReadCount(reader)];
+            for (int i = 0; i < strings.Length; i++)
+               strings[i] = reader.ReadString();
+
+            int writerCount = ReadCount(reader);
+            List<VssMetadataIndexWriter> writers = new List<VssMetadataIndexWriter>(writerCount);
+            for (int i = 0; i < writerCount; i++)
+            {
+               Guid instanceId = new Guid(reader.ReadBytes(16));
+               Guid writerId = new Guid(reader.ReadBytes(16));
+               writers.Add(new VssMetadataIndexWriter(instanceId, writerId, ReadString(reader, strings), ReadString(reader, strings)));
+            }
+
+            int componentCount = ReadCount(reader);
+            List<VssMetadataIndexComponent> components = new List<VssMetadataIndexComponent>(componentCount);
+            for (int i = 0; i < componentCount; i++)
+            {
+               Guid instanceId = new Guid(reader.ReadBytes(16));
+               Guid writerId = new Guid(reader.ReadBytes(16));
+               VssComponentType componentType = (VssComponentType)reader.ReadInt32();
+               string logicalPath = ReadString(reader, strings);
+               string componentName = ReadString(reader, strings);
+               string caption = ReadString(reader, strings);
+               sbyte succeeded = reader.ReadSByte();
+               string backupStamp = ReadString(reader, strings);
+               string previousBackupStamp = ReadString(reader, strings);
+               IList<VssWMFileDescriptor> files = ReadFiles(reader, strings);
+               IList<VssWMFileDescriptor> databaseFiles = ReadFiles(reader, strings);
+               IList<VssWMFileDescriptor> databaseLogFiles = ReadFiles(reader, strings);
+
+               components.Add(new VssMetadataIndexComponent(instanceId, writerId, componentType, logicalPath, componentName, caption,
+                  succeeded < 0 ? (bool?)null : succeeded != 0, backupStamp, previousBackupStamp, files, databaseFiles, databaseLogFiles));
+            }
+
+            return new VssMetadataIndex(isBackupComponentsDocument, backupType, writers, components);
+         }
+         catch (EndOfStreamException ex)
+         {
+            throw new InvalidDataException("The VSS metadata index is truncated.", ex);
+         }
+      }
+
+      #endregion
+
+      #region Parsing
+
+      private static XmlReaderSettings CreateReaderSettings()
+      {
+         XmlReaderSettings settings = new XmlReaderSettings();
+         settings.CloseInput = false;
+         settings.DtdProcessing = DtdProcessing.Prohibit;
+         settings.IgnoreComments = true;
+         settings.IgnoreProcessingInstructions = true;
+         settings.IgnoreWhitespace = true;
+         settings.XmlResolver = null;
+         return settings;
+      }
+
+      private static VssMetadataIndex Parse(XmlReader reader)
+      {
+         bool isBackupComponentsDocument = false;
+         VssBackupType backupType = VssBackupType.Undefined;
+
+         List<VssMetadataIndexWriter> writers = new List<VssMetadataIndexWriter>();
+         Dictionary<Guid, int> writerIndex = new Dictionary<Guid, int>();
+         List<VssMetadataIndexComponent> components = new List<VssMetadataIndexComponent>();
+
+         // The writer and component whose elements are currently open, along with the depth of
+         // their elements, or -1 if there is no such element.
+         Guid instanceId = Guid.Empty;
+         Guid writerId = Guid.Empty;
+         int writerDepth = -1;
+         ComponentBuilder component = null;
+         int componentDepth = -1;
+
+         while (reader.Read())
+         {
+            if (reader.NodeType == XmlNodeType.EndElement)
+            {
+               if (reader.Depth == componentDepth)
+               {
+                  components.Add(component.ToComponent());
+                  component = null;
+                  componentDepth = -1;
+               }
+               else if (reader.Depth == writerDepth)
+               {
+                  instanceId = Guid.Empty;
+                  writerId = Guid.Empty;
+                  writerDepth = -1;
+               }
+
+               continue;
+            }
+
+            if (reader.NodeType != XmlNodeType.Element)
+               continue;
+
+            switch (reader.LocalName)
+            {
+               case "BACKUP_COMPONENTS":
+                  if (reader.Depth == 0)
+                  {
+                     isBackupComponentsDocument = true;
+                     backupType = ParseEnum(reader.GetAttribute("backupType"), VssBackupType.Undefined);
+                  }
+                  break;
+
+               case "WRITER_METADATA":
+                  instanceId = Guid.Empty;
+                  writerId = Guid.Empty;
+                  writerDepth = reader.IsEmptyElement ? -1 : reader.Depth;
+                  break;
+
+               case "IDENTIFICATION":
+                  instanceId = ParseGuid(reader.GetAttribute("instanceId"));
+                  writerId = ParseGuid(reader.GetAttribute("writerId"));
+                  AddWriter(writers, writerIndex, new VssMetadataIndexWriter(instanceId, writerId, reader.GetAttribute("friendlyName"), reader.GetAttribute("instanceName")));
+                  break;
+
+               case "WRITER_COMPONENTS":
+                  instanceId = ParseGuid(reader.GetAttribute("instanceId"));
+                  writerId = ParseGuid(reader.GetAttribute("writerId"));
+                  writerDepth = reader.IsEmptyElement ? -1 : reader.Depth;
+                  AddWriter(writers, writerIndex, new VssMetadataIndexWriter(instanceId, writerId, null, null));
+                  break;
+
+               case "DATABASE":
+               case "FILE_GROUP":
+               case "COMPONENT":
+                  if (component != null)
+                     break;
+
+                  component = new ComponentBuilder(reader, instanceId, writerId);
+                  if (reader.IsEmptyElement)
+                  {
+                     components.Add(component.ToComponent());
+                     component = null;
+                  }
+                  else
+                  {
+                     componentDepth = reader.Depth;
+                  }
+                  break;
+
+               case "FILE_LIST":
+                  if (component != null)
+                     component.Files.Add(ParseFileDescriptor(reader));
+                  break;
+
+               case "DATABASE_FILES":
+                  if (component != null)
+                     component.DatabaseFiles.Add(ParseFileDescriptor(reader));
+                  break;
+
+               case "DATABASE_LOGFILES":
+                  if (component != null)
+                     component.DatabaseLogFiles.Add(ParseFileDescriptor(reader));
+                  break;
+            }
+         }
+
+         return new VssMetadataIndex(isBackupComponentsDocument, backupType, writers, components);
+      }
+
+      private static void AddWriter(List<VssMetadataIndexWriter> writers, Dictionary<Guid, int> writerIndex, VssMetadataIndexWriter writer)
+      {
+         // A writer may be described both by its metadata and by its components; the entry with a name wins.
+         int index;
+         if (!writerIndex.TryGetValue(writer.InstanceId, out index))
+         {
+            writerIndex.Add(writer.InstanceId, writers.Count);
+            writers.Add(writer);
+         }
+         else if (writers[index].WriterName == null && writer.WriterName != null)
+         {
+            writers[index] = writer;
+         }
+      }
+
+      private static VssWMFileDescriptor ParseFileDescriptor(XmlReader reader)
+      {
+         return new VssWMFileDescriptor(
+            reader.GetAttribute("alternatePath"),
+            (VssFileSpecificationBackupType)ParseInt32(reader.GetAttribute("filespecBackupType"), 0),
+            reader.GetAttribute("filespec"),
+            reader.GetAttribute("path"),
+            ParseBoolean(reader.GetAttribute("recursive")) == true);
+      }
+
+      private static Guid ParseGuid(string value)
+      {
+         if (String.IsNullOrEmpty(value))
+            return Guid.Empty;
+
+         return new Guid(value);
+      }
+
+      private static bool? ParseBoolean(string value)
+      {
+         if (value == null)
+            return null;
+
+         if (value == "yes" || value == "true" || value == "1")
+            return true;
+
+         if (value == "no" || value == "false" || value == "0")
+            return false;
+
+         throw new FormatException(String.Format(CultureInfo.CurrentCulture, "\"{0}\" is not a valid boolean value.", value));
+      }
+
+      private static int ParseInt32(string value, int defaultValue)
+      {
+         if (String.IsNullOrEmpty(value))
+            return defaultValue;
+
+         if (value.StartsWith("0x", StringComparison.OrdinalIgnoreCase))
+            return Int32.Parse(value.Substring(2), NumberStyles.AllowHexSpecifier, CultureInfo.InvariantCulture);
+
+         return Int32.Parse(value, NumberStyles.Integer, CultureInfo.InvariantCulture);
+      }
+
+      private static T ParseEnum<T>(string value, T defaultValue) where T : struct
+      {
+         T result;
+         if (value == null || !Enum.TryParse<T>(value, true, out result))
+            return defaultValue;
+
+         return result;
+      }
+
+      // Collects the attributes and files of a component while its element is being read.
+      private sealed class ComponentBuilder
+      {
+         private readonly Guid m_instanceId;
+         private readonly Guid m_writerId;
+         private readonly VssComponentType m_componentType;
+         private readonly string m_logicalPath;
+         private readonly string m_componentName;
+         private readonly string m_caption;
+         private readonly bool? m_backupSucceeded;
+         private readonly string m_backupStamp;
+         private readonly string m_previousBackupStamp;
+
+         public ComponentBuilder(XmlReader reader, Guid instanceId, Guid writerId)
+         {
+            m_instanceId = instanceId;
+            m_writerId = writerId;
+
+            switch (reader.LocalName)
+            {
+               case "DATABASE":
+                  m_componentType = VssComponentType.Database;
+                  break;
+               case "FILE_GROUP":
+                  m_componentType = VssComponentType.FileGroup;
+                  break;
+               default:
+                  m_componentType = ParseEnum(reader.GetAttribute("componentType"), VssComponentType.Undefined);
+                  break;
+            }
+
+            m_logicalPath = reader.GetAttribute("logicalPath");
+            m_componentName = reader.GetAttribute("componentName");
+            m_caption = reader.GetAttribute("caption");
+            m_backupSucceeded = ParseBoolean(reader.GetAttribute("backupSucceeded"));
+            m_backupStamp = reader.GetAttribute("backupStamp");
+            m_previousBackupStamp = reader.GetAttribute("previousBackupStamp");
+
+            Files = new List<VssWMFileDescriptor>();
+            DatabaseFiles = new List<VssWMFileDescriptor>();
+            DatabaseLogFiles = new List<VssWMFileDescriptor>();
+         }
+
+         public List<VssWMFileDescriptor> Files { get; private set; }
+         public List<VssWMFileDescriptor> DatabaseFiles { get; private set; }
+         public List<VssWMFileDescriptor> DatabaseLogFiles { get; private set; }
+
+         public VssMetadataIndexComponent ToComponent()
+         {
+            return new VssMetadataIndexComponent(m_instanceId, m_writerId, m_componentType, m_logicalPath, m_componentName, m_caption,
+               m_backupSucceeded, m_backupStamp, m_previousBackupStamp, ToReadOnly(Files), ToReadOnly(DatabaseFiles), ToReadOnly(DatabaseLogFiles));
+         }
+
+         private static IList<VssWMFileDescriptor> ToReadOnly(List<VssWMFileDescriptor> files)
+         {
+            return files.Count == 0 ? null : files.AsReadOnly();
+         }
+      }
+
+      #endregion
+
+      #region Lookup
+
+      // Logical paths are compared without trailing backslashes, which writers are not consistent about. The same normalization
+      // is applied to the logical paths of the components, which are sorted by it, and to the logical paths looked up.
+      private static string NormalizeLogicalPath(string logicalPath)
+      {
+         if (logicalPath == null)
+            return String.Empty;
+
+         return logicalPath.TrimEnd('\\');
+      }
+
+      private static string GetLogicalPath(VssMetadataIndexComponent component)
+      {
+         return NormalizeLogicalPath(component.LogicalPath);
+      }
+
+      private static int CompareComponents(VssMetadataIndexComponent x, VssMetadataIndexComponent y)
+      {
+         int result = s_pathComparer.Compare(GetLogicalPath(x), GetLogicalPath(y));
+         if (result != 0)
+            return result;
+
+         return s_pathComparer.Compare(x.ComponentName, y.ComponentName);
+      }
+
+      // Returns the index of the first component whose logical path is not less than logicalPath.
+      private int LowerBound(string logicalPath)
+      {
+         int lo = 0;
+         int hi = m_components.Length;
+         while (lo < hi)
+         {
+            int mid = lo + (hi - lo) / 2;
+            if (s_pathComparer.Compare(GetLogicalPath(m_components[mid]), logicalPath) < 0)
+               lo = mid + 1;
+            else
+               hi = mid;
+         }
+
+         return lo;
+      }
+
+      #endregion
+
+      #region Serialization
+
+      private static void AddString(Dictionary<string, int> stringIndex, List<string> strings, string value)
+      {
+         if (value != null && !stringIndex.ContainsKey(value))
+         {
+            stringIndex.Add(value, strings.Count);
+            strings.Add(value);
+         }
+      }
+
+      private static void AddFileStrings(Dictionary<string, int> stringIndex, List<string> strings, IList<VssWMFileDescriptor> files)
+      {
+         foreach (VssWMFileDescriptor file in files)
+         {
+            AddString(stringIndex, strings, file.AlternateLocation);
+            AddString(stringIndex, strings, file.FileSpecification);
+            AddString(stringIndex, strings, file.Path);
+         }
+      }
+
+      private static void WriteString(BinaryWriter writer, Dictionary<string, int> stringIndex, string value)
+      {
+         writer.Write(value == null ? -1 : stringIndex[value]);
+      }
+
+      private static void WriteFiles(BinaryWriter writer, Dictionary<string, int> stringIndex, IList<VssWMFileDescriptor> files)
+      {
+         writer.Write(files.Count);
+         foreach (VssWMFileDescriptor file in files)
+         {
+            WriteString(writer, stringIndex, file.AlternateLocation);
+            writer.Write((int)file.BackupTypeMask);
+            WriteString(writer, stringIndex, file.FileSpecification);
+            WriteString(writer, stringIndex, file.Path);
+            writer.Write(file.IsRecursive);
+         }
+      }
+
+      private static int ReadCount(BinaryReader reader)
+      {
+         int count = reader.ReadInt32();
+         if (count < 0)
+            throw new InvalidDataException("The VSS metadata index is corrupt.");
+
+         return count;
+      }
+
+      private static string ReadString(BinaryReader reader, string[] strings)
+      {
+         int index = reader.ReadInt32();
+         if (index == -1)
+            return null;
+
+         if (index < 0 || index >= strings.Length)
+            throw new InvalidDataException("The VSS metadata index is corrupt.");
+
+         return strings[index];
+      }
+
+      private static IList<VssWMFileDescriptor> ReadFiles(BinaryReader reader, string[] strings)
+      {
+         int count = ReadCount(reader);
+         if (count == 0)
+            return null;
+
+         VssWMFileDescriptor[] files = new VssWMFileDescriptor[count];
+         for (int i = 0; i < count; i++)
+         {
+            string alternateLocation = ReadString(reader, strings);
+            VssFileSpecificationBackupType backupTypeMask = (VssFileSpecificationBackupType)reader.ReadInt32();
+            string fileSpecification = ReadString(reader, strings);
+            string path = ReadString(reader, strings);
+            bool isRecursive = reader.ReadBoolean();
+            files[i] = new VssWMFileDescriptor(alternateLocation, backupTypeMask, fileSpecification, path, isRecursive);
+         }
+
+         return Array.AsReadOnly(files);
+      }
+
+      #endregion
+   }
+}
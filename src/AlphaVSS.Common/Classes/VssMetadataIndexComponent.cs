@@ -0,0 +1,118 @@
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssMetadataIndexComponent"/> class describes a component found in a document indexed by a <see cref="VssMetadataIndex"/>.
+   /// </summary>
+   /// <remarks>
+   ///     Components read from a writer metadata document describe the files of the component, while components read from a backup
+   ///     components document describe the outcome of the backup of the component. Members that are not specified by the document
+   ///     the component was read from are <see langword="null"/> or empty.
+   /// </remarks>
+   [Serializable]
+   public class VssMetadataIndexComponent
+   {
+      private static readonly IList<VssWMFileDescriptor> s_noFiles = Array.AsReadOnly(new VssWMFileDescriptor[0]);
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssMetadataIndexComponent"/> class.
+      /// </summary>
+      /// <param name="instanceId">The instance id of the writer owning the component.</param>
+      /// <param name="writerId">The class id of the writer owning the component.</param>
+      /// <param name="componentType">The type of the component.</param>
+      /// <param name="logicalPath">The logical path of the component.</param>
+      /// <param name="componentName">The name of the component.</param>
+      /// <param name="caption">The caption of the component.</param>
+      /// <param name="backupSucceeded">Whether the backup of the component succeeded, or <see langword="null"/> if the document does not specify it.</param>
+      /// <param name="backupStamp">The backup stamp of the component.</param>
+      /// <param name="previousBackupStamp">The backup stamp of the previous backup of the component.</param>
+      /// <param name="files">The file descriptors of the files of the component.</param>
+      /// <param name="databaseFiles">The file descriptors of the database files of the component.</param>
+      /// <param name="databaseLogFiles">The file descriptors of the database log files of the component.</param>
+      public VssMetadataIndexComponent(Guid instanceId, Guid writerId, VssComponentType componentType, string logicalPath, string componentName,
+         string caption, bool? backupSucceeded, string backupStamp, string previousBackupStamp,
+         IList<VssWMFileDescriptor> files, IList<VssWMFileDescriptor> databaseFiles, IList<VssWMFileDescriptor> databaseLogFiles)
+      {
+         InstanceId = instanceId;
+         WriterId = writerId;
+         ComponentType = componentType;
+         LogicalPath = logicalPath;
+         ComponentName = componentName;
+         Caption = caption;
+         BackupSucceeded = backupSucceeded;
+         BackupStamp = backupStamp;
+         PreviousBackupStamp = previousBackupStamp;
+         Files = files ?? s_noFiles;
+         DatabaseFiles = databaseFiles ?? s_noFiles;
+         DatabaseLogFiles = databaseLogFiles ?? s_noFiles;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the instance id of the writer owning the component.
+      /// </summary>
+      public Guid InstanceId { get; private set; }
+
+      /// <summary>
+      /// Gets the class id of the writer owning the component.
+      /// </summary>
+      public Guid WriterId { get; private set; }
+
+      /// <summary>
+      /// Gets the type of the component.
+      /// </summary>
+      public VssComponentType ComponentType { get; private set; }
+
+      /// <summary>
+      /// Gets the logical path of the component.
+      /// </summary>
+      /// <value>The logical path of the component, or <see langword="null"/> if the component has no logical path.</value>
+      public string LogicalPath { get; private set; }
+
+      /// <summary>
+      /// Gets the name of the component.
+      /// </summary>
+      public string ComponentName { get; private set; }
+
+      /// <summary>
+      /// Gets the caption of the component.
+      /// </summary>
+      public string Caption { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the backup of the component succeeded.
+      /// </summary>
+      /// <value>The backup status of the component, or <see langword="null"/> if the document does not specify it.</value>
+      public bool? BackupSucceeded { get; private set; }
+
+      /// <summary>
+      /// Gets the backup stamp of the component.
+      /// </summary>
+      public string BackupStamp { get; private set; }
+
+      /// <summary>
+      /// Gets the backup stamp of the backup that the backup of the component was based on.
+      /// </summary>
+      public string PreviousBackupStamp { get; private set; }
+
+      /// <summary>
+      /// Gets the file descriptors of the files of the component (the file list of a file group).
+      /// </summary>
+      public IList<VssWMFileDescriptor> Files { get; private set; }
+
+      /// <summary>
+      /// Gets the file descriptors of the database files of the component.
+      /// </summary>
+      public IList<VssWMFileDescriptor> DatabaseFiles { get; private set; }
+
+      /// <summary>
+      /// Gets the file descriptors of the database log files of the component.
+      /// </summary>
+      public IList<VssWMFileDescriptor> DatabaseLogFiles { get; private set; }
+
+      #endregion
+   }
+}
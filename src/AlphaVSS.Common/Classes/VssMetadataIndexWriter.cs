@@ -0,0 +1,52 @@
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssMetadataIndexWriter"/> class describes a writer found in a document indexed by a <see cref="VssMetadataIndex"/>.
+   /// </summary>
+   [Serializable]
+   public class VssMetadataIndexWriter
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssMetadataIndexWriter"/> class.
+      /// </summary>
+      /// <param name="instanceId">The writer instance id.</param>
+      /// <param name="writerId">The writer class id.</param>
+      /// <param name="writerName">The name of the writer, or <see langword="null"/> if the document does not specify it.</param>
+      /// <param name="instanceName">The name of the writer instance, or <see langword="null"/> if the document does not specify it.</param>
+      public VssMetadataIndexWriter(Guid instanceId, Guid writerId, string writerName, string instanceName)
+      {
+         InstanceId = instanceId;
+         WriterId = writerId;
+         WriterName = writerName;
+         InstanceName = instanceName;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the instance id of the writer.
+      /// </summary>
+      public Guid InstanceId { get; private set; }
+
+      /// <summary>
+      /// Gets the class id of the writer.
+      /// </summary>
+      public Guid WriterId { get; private set; }
+
+      /// <summary>
+      /// Gets the name of the writer.
+      /// </summary>
+      /// <value>The name of the writer, or <see langword="null"/> if the document does not specify it.</value>
+      public string WriterName { get; private set; }
+
+      /// <summary>
+      /// Gets the name of the writer instance.
+      /// </summary>
+      /// <value>The name of the writer instance, or <see langword="null"/> if the document does not specify it.</value>
+      public string InstanceName { get; private set; }
+
+      #endregion
+   }
+}
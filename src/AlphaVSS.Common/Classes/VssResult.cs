@@ -0,0 +1,154 @@
+using System;
+using System.Globalization;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssResult"/> structure contains the outcome of a call to one of the <c>Try</c> methods of
+   ///     <see cref="IVssBackupComponents"/>, such as <see cref="IVssBackupComponents.TryGetSnapshotProperties"/>.
+   /// </summary>
+   /// <remarks>
+   ///     The <c>Try</c> methods report an error returned by VSS through a <see cref="VssResult"/> instead of throwing an exception.
+   ///     This avoids the cost of creating and throwing an exception when failures are expected, for example when checking whether a
+   ///     large number of volumes are supported, or when looking up shadow copies that may have been deleted.
+   /// </remarks>
+   [Serializable]
+   public struct VssResult : IEquatable<VssResult>
+   {
+      #region Private Fields
+
+      private readonly VssError m_error;
+
+      #endregion
+
+      #region Constructor
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssResult"/> structure.
+      /// </summary>
+      /// <param name="error">The code returned by VSS.</param>
+      public VssResult(VssError error)
+      {
+         m_error = error;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets a <see cref="VssResult"/> indicating that the operation succeeded.
+      /// </summary>
+      public static VssResult Success
+      {
+         get
+         {
+            return new VssResult(VssError.Success);
+         }
+      }
+
+      /// <summary>
+      /// Gets the code returned by VSS.
+      /// </summary>
+      /// <value>The code returned by VSS, which is <see cref="VssError.Success"/> or another success code if the operation succeeded.</value>
+      public VssError Error
+      {
+         get
+         {
+            return m_error;
+         }
+      }
+
+      /// <summary>
+      /// Gets a value indicating whether the operation succeeded.
+      /// </summary>
+      /// <value><see langword="true"/> if <see cref="Error"/> is a success code; otherwise, <see langword="false"/>.</value>
+      public bool Succeeded
+      {
+         get
+         {
+            return ((uint)m_error & 0x80000000) == 0;
+         }
+      }
+
+      /// <summary>
+      /// Gets a value indicating whether the operation failed.
+      /// </summary>
+      /// <value><see langword="true"/> if <see cref="Error"/> is an error code; otherwise, <see langword="false"/>.</value>
+      public bool Failed
+      {
+         get
+         {
+            return !Succeeded;
+         }
+      }
+
+      #endregion
+
+      #region Methods
+
+      /// <summary>
+      /// Indicates whether this instance and a specified object are equal.
+      /// </summary>
+      /// <param name="obj">Another object to compare to.</param>
+      /// <returns>
+      /// 	<see langword="true"/> if <paramref name="obj"/> and this instance are the same type and represent the same value; otherwise, <see langword="false"/>.
+      /// </returns>
+      public override bool Equals(object obj)
+      {
+         return obj is VssResult && Equals((VssResult)obj);
+      }
+
+      /// <summary>
+      /// Indicates whether this instance and another <see cref="VssResult"/> are equal.
+      /// </summary>
+      /// <param name="other">The <see cref="VssResult"/> to compare to.</param>
+      /// <returns><see langword="true"/> if both instances contain the same code; otherwise, <see langword="false"/>.</returns>
+      public bool Equals(VssResult other)
+      {
+         return m_error == other.m_error;
+      }
+
+      /// <summary>
+      /// Returns the hash code for this instance.
+      /// </summary>
+      /// <returns>A 32-bit signed integer that is the hash code for this instance.</returns>
+      public override int GetHashCode()
+      {
+         return m_error.GetHashCode();
+      }
+
+      /// <summary>
+      /// Returns a <see cref="System.String"/> that represents this instance.
+      /// </summary>
+      /// <returns>A <see cref="System.String"/> that represents this instance.</returns>
+      public override string ToString()
+      {
+         return String.Format(CultureInfo.InvariantCulture, "{0} (0x{1:X8})", m_error, (uint)m_error);
+      }
+
+      /// <summary>
+      /// Implements the operator ==.
+      /// </summary>
+      /// <param name="left">The left operand.</param>
+      /// <param name="right">The right operand.</param>
+      /// <returns><see langword="true"/> if both operands contain the same code; otherwise, <see langword="false"/>.</returns>
+      public static bool operator ==(VssResult left, VssResult right)
+      {
+         return left.Equals(right);
+      }
+
+      /// <summary>
+      /// Implements the operator !=.
+      /// </summary>
+      /// <param name="left">The left operand.</param>
+      /// <param name="right">The right operand.</param>
+      /// <returns><see langword="true"/> if the operands contain different codes; otherwise, <see langword="false"/>.</returns>
+      public static bool operator !=(VssResult left, VssResult right)
+      {
+         return !left.Equals(right);
+      }
+
+      #endregion
+   }
+}
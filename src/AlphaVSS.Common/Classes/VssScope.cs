@@ -0,0 +1,230 @@
+using System;
+using System.Collections.Generic;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssScope"/> class owns the VSS objects created while it is the current scope of a thread, and disposes them
+   ///     all when the scope is disposed.
+   /// </summary>
+   /// <remarks>
+   ///     <para>
+   ///         Every object that wraps a native VSS object, such as <see cref="IVssExamineWriterMetadata"/>, <see cref="IVssWMComponent"/>,
+   ///         <see cref="IVssWriterComponents"/>, <see cref="IVssComponent"/> and <see cref="IVssAsyncResult"/>, has a finalizer that releases
+   ///         the native object if the wrapper is not disposed. Walking the writer metadata of a system creates thousands of such objects,
+   ///         which survive at least one garbage collection because of their finalizers. Objects created while a scope is current are
+   ///         registered with the scope instead, and their finalizers are suppressed.
+   ///     </para>
+   ///     <para>
+   ///         A new scope becomes the current scope of the thread that creates it. When the scope is disposed, the innermost undisposed
+   ///         scope that was current before it becomes current again, even if scopes are disposed out of order or on another thread.
+   ///         Objects created by an object that belongs to a scope, such as the components of an <see cref="IVssExamineWriterMetadata"/>,
+   ///         belong to the same scope, even if they are created on another thread.
+   ///     </para>
+   ///     <para>
+   ///         The scope keeps the objects registered with it alive until it is disposed, so a scope should not be kept open longer than
+   ///         the objects are needed. Objects may still be disposed individually before the scope is disposed, which removes them from
+   ///         the scope. A scope that is never disposed does not release the native objects registered with it.
+   ///     </para>
+   /// </remarks>
+   /// <example>
+   ///     <code>
+   ///     using (VssScope scope = new VssScope())
+   ///     {
+   ///        foreach (IVssExamineWriterMetadata writer in backupComponents.WriterMetadata)
+   ///        {
+   ///           // ...
+   ///        }
+   ///     }
+   ///     </code>
+   /// </example>
+   public sealed class VssScope : IDisposable
+   {
+      #region Private Fields
+
+      [ThreadStatic]
+      private static VssScope s_current;
+
+      private readonly VssScope m_previous;
+      private readonly object m_lock = new object();
+      private LinkedList<IDisposable> m_objects = new LinkedList<IDisposable>();
+      private Dictionary<IDisposable, LinkedListNode<IDisposable>> m_nodes = new Dictionary<IDisposable, LinkedListNode<IDisposable>>();
+      private int m_totalCount;
+      private volatile bool m_isDisposed;
+
+      #endregion
+
+      #region Constructor
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssScope"/> class, and makes it the current scope of the calling thread.
+      /// </summary>
+      public VssScope()
+      {
+         m_previous = Current;
+         s_current = this;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the current scope of the calling thread.
+      /// </summary>
+      /// <value>The innermost undisposed scope created by the calling thread, or <see langword="null"/> if there is none.</value>
+      public static VssScope Current
+      {
+         get
+         {
+            // A scope may be disposed while it is not the innermost scope of its thread, or on another thread, in which case
+            // it is skipped here rather than when it is disposed.
+            VssScope scope = s_current;
+            while (scope != null && scope.m_isDisposed)
+               scope = scope.m_previous;
+
+            s_current = scope;
+            return scope;
+         }
+      }
+
+      /// <summary>
+      /// Gets the number of objects currently owned by this scope.
+      /// </summary>
+      /// <value>The number of registered objects that have neither been removed nor disposed individually.</value>
+      public int Count
+      {
+         get
+         {
+            lock (m_lock)
+            {
+               return m_objects == null ? 0 : m_objects.Count;
+            }
+         }
+      }
+
+      /// <summary>
+      /// Gets the total number of objects that have been registered with this scope, including those already released.
+      /// </summary>
+      public int TotalCount
+      {
+         get
+         {
+            lock (m_lock)
+            {
+               return m_totalCount;
+            }
+         }
+      }
+
+      #endregion
+
+      #region Methods
+
+      /// <summary>
+      /// Registers an object to be disposed when this scope is disposed.
+      /// </summary>
+      /// <param name="obj">The object to register.</param>
+      /// <remarks>
+      ///     <para>
+      ///         This method is called by the objects that wrap native VSS objects when they are created, but may also be used to register
+      ///         other objects whose lifetime should end with the scope. Objects are disposed in the reverse order of their registration.
+      ///     </para>
+      ///     <para>
+      ///         Registering an object that is already owned by the scope has no effect.
+      ///     </para>
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="obj"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ObjectDisposedException">The scope has been disposed.</exception>
+      public void Add(IDisposable obj)
+      {
+         if (obj == null)
+            throw new ArgumentNullException("obj");
+
+         lock (m_lock)
+         {
+            if (m_objects == null)
+               throw new ObjectDisposedException(GetType().FullName);
+
+            if (m_nodes.ContainsKey(obj))
+               return;
+
+            m_nodes.Add(obj, m_objects.AddLast(obj));
+            m_totalCount++;
+         }
+      }
+
+      /// <summary>
+      /// Removes an object from this scope without disposing it.
+      /// </summary>
+      /// <param name="obj">The object to remove.</param>
+      /// <returns><see langword="true"/> if the object was owned by the scope and has been removed; otherwise <see langword="false"/>.</returns>
+      /// <remarks>
+      ///     The objects that wrap native VSS objects call this method when they are disposed individually, so that the scope does
+      ///     not keep them alive. <see langword="false"/> is returned if the scope has already been disposed.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="obj"/> is <see langword="null"/>.</exception>
+      public bool Remove(IDisposable obj)
+      {
+         if (obj == null)
+            throw new ArgumentNullException("obj");
+
+         lock (m_lock)
+         {
+            LinkedListNode<IDisposable> node;
+            if (m_nodes == null || !m_nodes.TryGetValue(obj, out node))
+               return false;
+
+            m_nodes.Remove(obj);
+            m_objects.Remove(node);
+            return true;
+         }
+      }
+
+      /// <summary>
+      /// Disposes all objects owned by this scope, and stops it from being the current scope of the thread that created it.
+      /// </summary>
+      /// <remarks>
+      ///     All objects are disposed even if disposing one of them throws an exception; the first such exception is rethrown
+      ///     after all objects have been disposed.
+      /// </remarks>
+      public void Dispose()
+      {
+         LinkedList<IDisposable> objects;
+         lock (m_lock)
+         {
+            objects = m_objects;
+            m_objects = null;
+            m_nodes = null;
+         }
+
+         if (objects == null)
+            return;
+
+         m_isDisposed = true;
+
+         // Only the current scope of the calling thread can be unlinked here; the others skip this scope when they are next read.
+         if (s_current == this)
+            s_current = Current;
+
+         Exception error = null;
+         for (LinkedListNode<IDisposable> node = objects.Last; node != null; node = node.Previous)
+         {
+            try
+            {
+               node.Value.Dispose();
+            }
+            catch (Exception ex)
+            {
+               if (error == null)
+                  error = ex;
+            }
+         }
+
+         if (error != null)
+            throw ExceptionHelper.Rethrow(error);
+      }
+
+      #endregion
+   }
+}
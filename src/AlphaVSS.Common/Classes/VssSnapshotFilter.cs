@@ -0,0 +1,118 @@
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     Specifies criteria that shadow copies must match to be returned from
+   ///     <see cref="IVssBackupComponents.QuerySnapshots(VssSnapshotFilter)"/> or <see cref="IVssBackupComponents.EnumerateSnapshots(VssSnapshotFilter)"/>.
+   /// </summary>
+   /// <remarks>
+   ///     <para>
+   ///         All criteria that are set must match for a shadow copy to be included in the result. A filter with no criteria set matches every
+   ///         shadow copy.
+   ///     </para>
+   ///     <para>
+   ///         The filter is evaluated on the native shadow copy properties returned by VSS, before any managed objects are created for
+   ///         a shadow copy, so shadow copies that do not match the filter incur no managed allocations.
+   ///     </para>
+   /// </remarks>
+   [Serializable]
+   public class VssSnapshotFilter
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSnapshotFilter"/> class that matches all shadow copies.
+      /// </summary>
+      public VssSnapshotFilter()
+      {
+      }
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSnapshotFilter"/> class that matches the shadow copies of the specified shadow copy set.
+      /// </summary>
+      /// <param name="snapshotSetId">The identifier of the shadow copy set.</param>
+      public VssSnapshotFilter(Guid snapshotSetId)
+      {
+         SnapshotSetId = snapshotSetId;
+      }
+
+      #region Public Properties
+
+      /// <summary>
+      ///     Gets or sets the identifier of the shadow copy set that matching shadow copies must belong to, or <see langword="null"/>
+      ///     to match shadow copies of any set.
+      /// </summary>
+      public Guid? SnapshotSetId { get; set; }
+
+      /// <summary>
+      ///     Gets or sets the name of the original volume that matching shadow copies must have been created from, or <see langword="null"/>
+      ///     to match shadow copies of any volume.
+      /// </summary>
+      /// <remarks>
+      ///     The comparison is an ordinal, case-insensitive comparison against <see cref="VssSnapshotProperties.OriginalVolumeName"/>, which
+      ///     is a volume GUID path such as <c>\\?\Volume{...}\</c>.
+      /// </remarks>
+      public string OriginalVolumeName { get; set; }
+
+      /// <summary>
+      ///     Gets or sets the identifier of the provider that matching shadow copies must have been created by, or <see langword="null"/>
+      ///     to match shadow copies from any provider.
+      /// </summary>
+      public Guid? ProviderId { get; set; }
+
+      /// <summary>
+      ///     Gets or sets the attributes that must all be set on matching shadow copies. The default value,
+      ///     in which no flags are set, places no restriction on the attributes.
+      /// </summary>
+      public VssVolumeSnapshotAttributes RequiredAttributes { get; set; }
+
+      /// <summary>
+      ///     Gets or sets the earliest creation time (inclusive) of matching shadow copies, or <see langword="null"/> to place no lower bound
+      ///     on the creation time.
+      /// </summary>
+      public DateTime? CreatedAfter { get; set; }
+
+      /// <summary>
+      ///     Gets or sets the latest creation time (exclusive) of matching shadow copies, or <see langword="null"/> to place no upper bound
+      ///     on the creation time.
+      /// </summary>
+      public DateTime? CreatedBefore { get; set; }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Determines whether the specified shadow copy matches this filter.
+      /// </summary>
+      /// <param name="snapshot">The shadow copy properties to test.</param>
+      /// <returns><see langword="true"/> if <paramref name="snapshot"/> matches all criteria of this filter; otherwise <see langword="false"/>.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="snapshot"/> is <see langword="null"/>.</exception>
+      public bool IsMatch(VssSnapshotProperties snapshot)
+      {
+         if (snapshot == null)
+            throw new ArgumentNullException("snapshot");
+
+         if (SnapshotSetId.HasValue && snapshot.SnapshotSetId != SnapshotSetId.Value)
+            return false;
+
+         if (ProviderId.HasValue && snapshot.ProviderId != ProviderId.Value)
+            return false;
+
+         if ((snapshot.SnapshotAttributes & RequiredAttributes) != RequiredAttributes)
+            return false;
+
+         if (CreatedAfter.HasValue && snapshot.CreationTimestamp.ToFileTime() < CreatedAfter.Value.ToFileTime())
+            return false;
+
+         if (CreatedBefore.HasValue && snapshot.CreationTimestamp.ToFileTime() >= CreatedBefore.Value.ToFileTime())
+            return false;
+
+         if (OriginalVolumeName != null && !String.Equals(snapshot.OriginalVolumeName, OriginalVolumeName, StringComparison.OrdinalIgnoreCase))
+            return false;
+
+         return true;
+      }
+
+      #endregion
+   }
+}
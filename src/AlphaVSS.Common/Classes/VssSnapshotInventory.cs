@@ -0,0 +1,1183 @@
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssSnapshotInventory"/> class maintains a persistent, memory-mapped index of the shadow copies in the system,
+   ///     allowing shadow copies to be looked up by identifier, volume or shadow copy set without creating a VSS session.
+   /// </summary>
+   /// <remarks>
+   ///     <para>
+   ///         The inventory is stored in a single file containing fixed-size shadow copy records, hash indexes on the shadow copy identifier,
+   ///         the original volume name and the shadow copy set identifier, and a hashed table of the strings referenced by the records, in
+   ///         which every distinct string is stored only once. All lookups are performed directly on the mapped file, so opening an
+   ///         inventory does not read its contents.
+   ///     </para>
+   ///     <para>
+   ///         The inventory is kept up to date by calling <see cref="M:Alphaleonis.Win32.Vss.VssSnapshotInventory.Refresh"/> with the result of
+   ///         a live shadow copy query. The refresh compares the live shadow copies with the stored records and rewrites only the records
+   ///         of shadow copies that have been added, changed or removed. The file is grown and compacted automatically when needed.
+   ///     </para>
+   ///     <para>
+   ///         The inventory does not depend on the platform specific assembly and may be populated from any source of
+   ///         <see cref="VssSnapshotProperties"/> instances. All members of this class are thread safe, but an inventory file
+   ///         may only be opened by a single <see cref="VssSnapshotInventory"/> instance at a time.
+   ///     </para>
+   /// </remarks>
+   public sealed class VssSnapshotInventory : IDisposable
+   {
+      #region Private Constants
+
+      // "AVSSINV1" in little endian byte order.
+      private const long FileMagic = 0x31564E4953535641;
+      private const int FileFormatVersion = 2;
+
+      private const int MinimumRecordCapacity = 64;
+      private const int MinimumStringTableCapacity = 16384;
+
+      // The number of string fields in a record.
+      private const int StringsPerRecord = 6;
+
+      // Header layout.
+      private const int HeaderSize = 128;
+      private const int HeaderMagic = 0;
+      private const int HeaderVersion = 8;
+      private const int HeaderRecordCapacity = 12;
+      private const int HeaderRecordCount = 16;
+      private const int HeaderHighWaterMark = 20;
+      private const int HeaderFreeListHead = 24;
+      private const int HeaderBucketCount = 28;
+      private const int HeaderIdTombstones = 32;
+      private const int HeaderVolumeCount = 36;
+      private const int HeaderStringTableCapacity = 40;
+      private const int HeaderStringTableLength = 44;
+      private const int HeaderLastRefreshTime = 48;
+      private const int HeaderDirty = 56;
+      private const int HeaderStringBucketCount = 60;
+      private const int HeaderStringCount = 64;
+      private const int HeaderSetCount = 68;
+
+      // Record layout. String fields hold the offset of the string in the string table, or -1 for null.
+      private const int RecordSize = 128;
+      private const int RecordState = 0;
+      private const int RecordNextInVolume = 4;
+      private const int RecordPrevInVolume = 8;
+      private const int RecordVolumeKey = 12;
+      private const int RecordSnapshotId = 16;
+      private const int RecordSnapshotSetId = 32;
+      private const int RecordProviderId = 48;
+      private const int RecordSnapshotsCount = 64;
+      private const int RecordCreationTimestamp = 72;
+      private const int RecordAttributes = 80;
+      private const int RecordStatus = 84;
+      private const int RecordSnapshotDeviceObject = 88;
+      private const int RecordOriginalVolumeName = 92;
+      private const int RecordOriginatingMachine = 96;
+      private const int RecordServiceMachine = 100;
+      private const int RecordExposedName = 104;
+      private const int RecordExposedPath = 108;
+      private const int RecordNextInSet = 112;
+      private const int RecordPrevInSet = 116;
+
+      private const int RecordStateFree = 0;
+      private const int RecordStateUsed = 1;
+
+      // Entries of the identifier index hold the record slot + 1, zero for an empty bucket or -1 for a deleted entry.
+      private const int IdEntryEmpty = 0;
+      private const int IdEntryDeleted = -1;
+
+      // Entries of the volume index are pairs of (volume key + 1, first record slot), or zero for an empty bucket. The volume key
+      // is the offset of the volume name in the string table.
+      private const int VolumeEntrySize = 8;
+
+      // Entries of the set index and the string index hold the first record slot of the set or the offset of the string
+      // in the string table, plus one, or zero for an empty bucket.
+      private const int SetEntrySize = 4;
+      private const int StringEntrySize = 4;
+
+      #endregion
+
+      #region Private Fields
+
+      private readonly object m_syncRoot = new object();
+      private readonly string m_path;
+
+      private MemoryMappedFile m_file;
+      private MemoryMappedViewAccessor m_view;
+
+      private int m_recordCapacity;
+      private int m_bucketCount;
+      private int m_stringBucketCount;
+      private int m_stringTableCapacity;
+      private long m_idIndexOffset;
+      private long m_volumeIndexOffset;
+      private long m_setIndexOffset;
+      private long m_stringIndexOffset;
+      private long m_stringTableOffset;
+
+      // Buffer used to read strings from the string table.
+      private char[] m_chars = new char[256];
+
+      #endregion
+
+      #region Constructors
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSnapshotInventory"/> class, opening the specified inventory file or creating
+      /// a new, empty inventory if the file does not exist.
+      /// </summary>
+      /// <param name="path">The path of the inventory file.</param>
+      /// <remarks>
+      ///     If the file was left in an inconsistent state, for instance because the process was terminated during a refresh, or was
+      ///     written by a different version of this class, the inventory is reset and will be repopulated by the next call to
+      ///     <see cref="M:Alphaleonis.Win32.Vss.VssSnapshotInventory.Refresh"/>.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="path"/> is <see langword="null"/>.</exception>
+      /// <exception cref="InvalidDataException">The file exists but is not a shadow copy inventory file.</exception>
+      /// <exception cref="IOException">An I/O error occurred while opening or creating the file.</exception>
+      public VssSnapshotInventory(string path)
+      {
+         if (path == null)
+            throw new ArgumentNullException("path");
+
+         m_path = Path.GetFullPath(path);
+
+         if (!File.Exists(m_path))
+            CreateFile(m_path, MinimumRecordCapacity, GetBucketCount(MinimumRecordCapacity * StringsPerRecord), MinimumStringTableCapacity);
+
+         OpenMap(m_path);
+
+         if (m_view.ReadInt32(HeaderVersion) != FileFormatVersion || m_view.ReadInt32(HeaderDirty) != 0)
+         {
+            CloseMap();
+            CreateFile(m_path, MinimumRecordCapacity, GetBucketCount(MinimumRecordCapacity * StringsPerRecord), MinimumStringTableCapacity);
+            OpenMap(m_path);
+         }
+      }
+
+      #endregion
+
+      #region Public Properties
+
+      /// <summary>
+      /// Gets the full path of the inventory file.
+      /// </summary>
+      public string FilePath
+      {
+         get
+         {
+            return m_path;
+         }
+      }
+
+      /// <summary>
+      /// Gets the number of shadow copies in the inventory.
+      /// </summary>
+      /// <exception cref="ObjectDisposedException">The inventory has been disposed.</exception>
+      public int Count
+      {
+         get
+         {
+            lock (m_syncRoot)
+            {
+               ThrowIfDisposed();
+               return m_view.ReadInt32(HeaderRecordCount);
+            }
+         }
+      }
+
+      /// <summary>
+      /// Gets the time (in UTC) of the last completed refresh of the inventory, or <see langword="null"/> if the inventory
+      /// has never been refreshed.
+      /// </summary>
+      /// <exception cref="ObjectDisposedException">The inventory has been disposed.</exception>
+      public DateTime? LastRefreshTime
+      {
+         get
+         {
+            lock (m_syncRoot)
+            {
+               ThrowIfDisposed();
+               long value = m_view.ReadInt64(HeaderLastRefreshTime);
+               if (value == 0)
+                  return null;
+
+               return DateTime.FromBinary(value);
+            }
+         }
+      }
+
+      #endregion
+
+      #region Public Methods
+
+      /// <summary>
+      /// Updates the inventory to match the shadow copies currently in the system, as returned by
+      /// <see cref="IVssBackupComponents.EnumerateSnapshots()"/>.
+      /// </summary>
+      /// <param name="backupComponents">An initialized backup components object used to query the shadow copies.</param>
+      /// <returns>A <see cref="VssSnapshotInventoryRefreshResult"/> describing the changes applied to the inventory.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="backupComponents"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ObjectDisposedException">The inventory has been disposed.</exception>
+      /// <exception cref="IOException">An I/O error occurred while growing the inventory file.</exception>
+      public VssSnapshotInventoryRefreshResult Refresh(IVssBackupComponents backupComponents)
+      {
+         if (backupComponents == null)
+            throw new ArgumentNullException("backupComponents");
+
+         return Refresh(backupComponents.EnumerateSnapshots());
+      }
+
+      /// <summary>
+      /// Updates the inventory to match the specified set of shadow copies.
+      /// </summary>
+      /// <param name="snapshots">The complete set of shadow copies currently in the system.</param>
+      /// <returns>A <see cref="VssSnapshotInventoryRefreshResult"/> describing the changes applied to the inventory.</returns>
+      /// <remarks>
+      ///     Records of shadow copies not contained in <paramref name="snapshots"/> are removed from the inventory. Only the records of shadow
+      ///     copies that were added or whose properties have changed are written; the records of all other shadow copies are left untouched.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="snapshots"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException"><paramref name="snapshots"/> contains a <see langword="null"/> element.</exception>
+      /// <exception cref="ObjectDisposedException">The inventory has been disposed.</exception>
+      /// <exception cref="IOException">An I/O error occurred while growing the inventory file.</exception>
+      public VssSnapshotInventoryRefreshResult Refresh(IEnumerable<VssSnapshotProperties> snapshots)
+      {
+         if (snapshots == null)
+            throw new ArgumentNullException("snapshots");
+
+         // Complete the (possibly lazy) query before touching the file, so that a failing query leaves the inventory unchanged.
+         List<VssSnapshotProperties> live = new List<VssSnapshotProperties>(snapshots);
+         HashSet<Guid> liveIds = new HashSet<Guid>();
+         foreach (VssSnapshotProperties snapshot in live)
+         {
+            if (snapshot == null)
+               throw new ArgumentException("The sequence of shadow copies must not contain null elements.", "snapshots");
+
+            liveIds.Add(snapshot.SnapshotId);
+         }
+
+         lock (m_syncRoot)
+         {
+            ThrowIfDisposed();
+
+            int added = 0;
+            int updated = 0;
+            int removed = 0;
+            int unchanged = 0;
+
+            m_view.Write(HeaderDirty, 1);
+            m_view.Flush();
+
+            int highWaterMark = m_view.ReadInt32(HeaderHighWaterMark);
+            for (int slot = 0; slot < highWaterMark; slot++)
+            {
+               if (m_view.ReadInt32(RecordOffset(slot) + RecordState) == RecordStateUsed && !liveIds.Contains(ReadGuid(RecordOffset(slot) + RecordSnapshotId)))
+               {
+                  RemoveRecord(slot);
+                  removed++;
+               }
+            }
+
+            foreach (VssSnapshotProperties snapshot in live)
+            {
+               int slot = FindSlot(snapshot.SnapshotId);
+               if (slot >= 0 && RecordEquals(slot, snapshot))
+               {
+                  unchanged++;
+                  continue;
+               }
+
+               EnsureCapacity(slot >= 0 ? 0 : 1, GetRequiredStringTableSpace(snapshot));
+
+               if (slot >= 0)
+               {
+                  // EnsureCapacity may have rebuilt the file, moving the record.
+                  UpdateRecord(FindSlot(snapshot.SnapshotId), snapshot);
+                  updated++;
+               }
+               else
+               {
+                  InsertRecord(snapshot);
+                  added++;
+               }
+            }
+
+            m_view.Write(HeaderLastRefreshTime, DateTime.UtcNow.ToBinary());
+            m_view.Flush();
+            m_view.Write(HeaderDirty, 0);
+            m_view.Flush();
+
+            return new VssSnapshotInventoryRefreshResult(added, updated, removed, unchanged);
+         }
+      }
+
+      /// <summary>
+      /// Finds the shadow copy with the specified identifier.
+      /// </summary>
+      /// <param name="snapshotId">The identifier of the shadow copy.</param>
+      /// <returns>The properties of the shadow copy, or <see langword="null"/> if the inventory contains no shadow copy with the specified identifier.</returns>
+      /// <exception cref="ObjectDisposedException">The inventory has been disposed.</exception>
+      public VssSnapshotProperties FindSnapshot(Guid snapshotId)
+      {
+         lock (m_syncRoot)
+         {
+            ThrowIfDisposed();
+            int slot = FindSlot(snapshotId);
+            return slot >= 0 ? ReadRecord(slot) : null;
+         }
+      }
+
+      /// <summary>
+      /// Gets the shadow copies of the specified volume.
+      /// </summary>
+      /// <param name="originalVolumeName">The name of the original volume. The comparison is ordinal and case-insensitive.</param>
+      /// <returns>A list containing the properties of the shadow copies of the volume, which is empty if there are none.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="originalVolumeName"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ObjectDisposedException">The inventory has been disposed.</exception>
+      public IList<VssSnapshotProperties> GetSnapshotsForVolume(string originalVolumeName)
+      {
+         if (originalVolumeName == null)
+            throw new ArgumentNullException("originalVolumeName");
+
+         lock (m_syncRoot)
+         {
+            ThrowIfDisposed();
+
+            List<VssSnapshotProperties> result = new List<VssSnapshotProperties>();
+            long entry = FindVolumeEntry(originalVolumeName);
+            if (entry >= 0)
+            {
+               for (int slot = m_view.ReadInt32(entry + 4); slot >= 0; slot = m_view.ReadInt32(RecordOffset(slot) + RecordNextInVolume))
+                  result.Add(ReadRecord(slot));
+            }
+
+            return result;
+         }
+      }
+
+      /// <summary>
+      /// Gets the shadow copies belonging to the specified shadow copy set.
+      /// </summary>
+      /// <param name="snapshotSetId">The identifier of the shadow copy set.</param>
+      /// <returns>A list containing the properties of the shadow copies in the set, which is empty if there are none.</returns>
+      /// <exception cref="ObjectDisposedException">The inventory has been disposed.</exception>
+      public IList<VssSnapshotProperties> GetSnapshotsForSet(Guid snapshotSetId)
+      {
+         lock (m_syncRoot)
+         {
+            ThrowIfDisposed();
+
+            List<VssSnapshotProperties> result = new List<VssSnapshotProperties>();
+            long entry = FindSetEntry(snapshotSetId);
+            if (entry >= 0)
+            {
+               for (int slot = m_view.ReadInt32(entry) - 1; slot >= 0; slot = m_view.ReadInt32(RecordOffset(slot) + RecordNextInSet))
+                  result.Add(ReadRecord(slot));
+            }
+
+            return result;
+         }
+      }
+
+      /// <summary>
+      /// Gets all shadow copies in the inventory.
+      /// </summary>
+      /// <returns>A list containing the properties of all shadow copies in the inventory.</returns>
+      /// <exception cref="ObjectDisposedException">The inventory has been disposed.</exception>
+      public IList<VssSnapshotProperties> GetSnapshots()
+      {
+         lock (m_syncRoot)
+         {
+            ThrowIfDisposed();
+            return ReadAllRecords();
+         }
+      }
+
+      /// <summary>
+      /// Flushes and closes the inventory file.
+      /// </summary>
+      public void Dispose()
+      {
+         lock (m_syncRoot)
+         {
+            CloseMap();
+         }
+      }
+
+      #endregion
+
+      #region File Management
+
+      private static void CreateFile(string path, int recordCapacity, int stringBucketCount, int stringTableCapacity)
+      {
+         int bucketCount = GetBucketCount(recordCapacity);
+         long length = HeaderSize + (long)recordCapacity * RecordSize + (long)bucketCount * (4 + VolumeEntrySize + SetEntrySize)
+            + (long)stringBucketCount * StringEntrySize + stringTableCapacity;
+
+         using (FileStream stream = new FileStream(path, FileMode.Create, FileAccess.ReadWrite, FileShare.None))
+         {
+            stream.SetLength(length);
+
+            BinaryWriter writer = new BinaryWriter(stream);
+            writer.Write(FileMagic);
+            writer.Write(FileFormatVersion);
+            writer.Write(recordCapacity);
+            writer.Write(0);                    // Record count
+            writer.Write(0);                    // High water mark
+            writer.Write(-1);                   // Free list head
+            writer.Write(bucketCount);
+            writer.Write(0);                    // Identifier index tombstones
+            writer.Write(0);                    // Volume count
+            writer.Write(stringTableCapacity);
+            writer.Write(0);                    // String table length
+            writer.Write(0L);                   // Last refresh time
+            writer.Write(0);                    // Dirty
+            writer.Write(stringBucketCount);
+            writer.Write(0);                    // String count
+            writer.Write(0);                    // Set count
+            writer.Flush();
+         }
+      }
+
+      private void OpenMap(string path)
+      {
+         m_file = MemoryMappedFile.CreateFromFile(path, FileMode.Open, null, 0, MemoryMappedFileAccess.ReadWrite);
+         m_view = m_file.CreateViewAccessor();
+
+         // A file written by a different version is only checked for its magic number here; the constructor resets it.
+         if (m_view.Capacity < HeaderSize || m_view.ReadInt64(HeaderMagic) != FileMagic)
+         {
+            CloseMap();
+            throw new InvalidDataException(String.Format(CultureInfo.CurrentCulture, "The file \"{0}\" is not a shadow copy inventory file.", path));
+         }
+
+         m_recordCapacity = m_view.ReadInt32(HeaderRecordCapacity);
+         m_bucketCount = m_view.ReadInt32(HeaderBucketCount);
+         m_stringBucketCount = m_view.ReadInt32(HeaderStringBucketCount);
+         m_stringTableCapacity = m_view.ReadInt32(HeaderStringTableCapacity);
+         m_idIndexOffset = HeaderSize + (long)m_recordCapacity * RecordSize;
+         m_volumeIndexOffset = m_idIndexOffset + (long)m_bucketCount * 4;
+         m_setIndexOffset = m_volumeIndexOffset + (long)m_bucketCount * VolumeEntrySize;
+         m_stringIndexOffset = m_setIndexOffset + (long)m_bucketCount * SetEntrySize;
+         m_stringTableOffset = m_stringIndexOffset + (long)m_stringBucketCount * StringEntrySize;
+      }
+
+      private void CloseMap()
+      {
+         if (m_view != null)
+         {
+            m_view.Flush();
+            m_view.Dispose();
+            m_view = null;
+         }
+
+         if (m_file != null)
+         {
+            m_file.Dispose();
+            m_file = null;
+         }
+      }
+
+      private void EnsureCapacity(int additionalRecords, int additionalStringSpace)
+      {
+         int recordCount = m_view.ReadInt32(HeaderRecordCount);
+         int volumeCount = m_view.ReadInt32(HeaderVolumeCount);
+
+         if (recordCount + additionalRecords > m_recordCapacity
+            || volumeCount + additionalRecords > m_bucketCount / 2
+            || m_view.ReadInt32(HeaderStringCount) + StringsPerRecord > m_stringBucketCount / 2
+            || m_view.ReadInt32(HeaderStringTableLength) + additionalStringSpace > m_stringTableCapacity)
+         {
+            Rebuild(recordCount + additionalRecords, additionalStringSpace);
+         }
+         else if (recordCount + additionalRecords + m_view.ReadInt32(HeaderIdTombstones) > m_bucketCount / 4 * 3)
+         {
+            RebuildIdIndex();
+         }
+      }
+
+      // Writes the live records to a new, compacted file with room for at least the specified number of records
+      // and additional string space, and replaces the current file with it.
+      private void Rebuild(int requiredRecords, int additionalStringSpace)
+      {
+         IList<VssSnapshotProperties> records = ReadAllRecords();
+         long lastRefreshTime = m_view.ReadInt64(HeaderLastRefreshTime);
+         int dirty = m_view.ReadInt32(HeaderDirty);
+
+         HashSet<string> strings = new HashSet<string>(StringComparer.Ordinal);
+         int stringTableLength = 0;
+         foreach (VssSnapshotProperties record in records)
+         {
+            foreach (string value in GetStrings(record))
+            {
+               if (value != null && strings.Add(value))
+                  stringTableLength += GetStringEntrySize(value.Length);
+            }
+         }
+
+         int recordCapacity = m_recordCapacity;
+         while (recordCapacity < requiredRecords)
+            recordCapacity *= 2;
+
+         int stringBucketCount = GetBucketCount(Math.Max(2 * (strings.Count + StringsPerRecord), recordCapacity * StringsPerRecord));
+         int stringTableCapacity = Math.Max(MinimumStringTableCapacity, (stringTableLength + additionalStringSpace) * 2);
+
+         string tempPath = m_path + ".tmp";
+         CloseMap();
+         try
+         {
+            CreateFile(tempPath, recordCapacity, stringBucketCount, stringTableCapacity);
+            OpenMap(tempPath);
+
+            foreach (VssSnapshotProperties record in records)
+               InsertRecord(record);
+
+            m_view.Write(HeaderLastRefreshTime, lastRefreshTime);
+            m_view.Write(HeaderDirty, dirty);
+            CloseMap();
+
+            File.Replace(tempPath, m_path, null);
+         }
+         finally
+         {
+            if (m_view != null)
+               CloseMap();
+
+            OpenMap(m_path);
+         }
+      }
+
+      private void RebuildIdIndex()
+      {
+         for (int bucket = 0; bucket < m_bucketCount; bucket++)
+            m_view.Write(m_idIndexOffset + (long)bucket * 4, IdEntryEmpty);
+
+         m_view.Write(HeaderIdTombstones, 0);
+
+         int highWaterMark = m_view.ReadInt32(HeaderHighWaterMark);
+         for (int slot = 0; slot < highWaterMark; slot++)
+         {
+            long record = RecordOffset(slot);
+            if (m_view.ReadInt32(record + RecordState) == RecordStateUsed)
+               InsertId(ReadGuid(record + RecordSnapshotId), slot);
+         }
+      }
+
+      private void ThrowIfDisposed()
+      {
+         if (m_view == null)
+            throw new ObjectDisposedException(GetType().FullName);
+      }
+
+      #endregion
+
+      #region Records
+
+      private static long RecordOffset(int slot)
+      {
+         return HeaderSize + (long)slot * RecordSize;
+      }
+
+      private void InsertRecord(VssSnapshotProperties snapshot)
+      {
+         int slot = m_view.ReadInt32(HeaderFreeListHead);
+         if (slot >= 0)
+         {
+            m_view.Write(HeaderFreeListHead, m_view.ReadInt32(RecordOffset(slot) + RecordNextInVolume));
+         }
+         else
+         {
+            slot = m_view.ReadInt32(HeaderHighWaterMark);
+            m_view.Write(HeaderHighWaterMark, slot + 1);
+         }
+
+         WriteRecord(slot, snapshot);
+         InsertId(snapshot.SnapshotId, slot);
+         LinkVolume(slot, snapshot.OriginalVolumeName);
+         LinkSet(slot);
+         m_view.Write(HeaderRecordCount, m_view.ReadInt32(HeaderRecordCount) + 1);
+      }
+
+      private void UpdateRecord(int slot, VssSnapshotProperties snapshot)
+      {
+         UnlinkVolume(slot);
+         UnlinkSet(slot);
+         WriteRecord(slot, snapshot);
+         LinkVolume(slot, snapshot.OriginalVolumeName);
+         LinkSet(slot);
+      }
+
+      private void RemoveRecord(int slot)
+      {
+         long record = RecordOffset(slot);
+
+         RemoveId(ReadGuid(record + RecordSnapshotId));
+         UnlinkVolume(slot);
+         UnlinkSet(slot);
+
+         m_view.Write(record + RecordState, RecordStateFree);
+         m_view.Write(record + RecordNextInVolume, m_view.ReadInt32(HeaderFreeListHead));
+         m_view.Write(HeaderFreeListHead, slot);
+         m_view.Write(HeaderRecordCount, m_view.ReadInt32(HeaderRecordCount) - 1);
+      }
+
+      private void WriteRecord(int slot, VssSnapshotProperties snapshot)
+      {
+         long record = RecordOffset(slot);
+
+         WriteGuid(record + RecordSnapshotId, snapshot.SnapshotId);
+         WriteGuid(record + RecordSnapshotSetId, snapshot.SnapshotSetId);
+         WriteGuid(record + RecordProviderId, snapshot.ProviderId);
+         m_view.Write(record + RecordSnapshotsCount, snapshot.SnapshotsCount);
+         m_view.Write(record + RecordCreationTimestamp, snapshot.CreationTimestamp.ToBinary());
+         m_view.Write(record + RecordAttributes, (int)snapshot.SnapshotAttributes);
+         m_view.Write(record + RecordStatus, (int)snapshot.Status);
+         m_view.Write(record + RecordSnapshotDeviceObject, InternString(snapshot.SnapshotDeviceObject));
+         m_view.Write(record + RecordOriginalVolumeName, InternString(snapshot.OriginalVolumeName));
+         m_view.Write(record + RecordOriginatingMachine, InternString(snapshot.OriginatingMachine));
+         m_view.Write(record + RecordServiceMachine, InternString(snapshot.ServiceMachine));
+         m_view.Write(record + RecordExposedName, InternString(snapshot.ExposedName));
+         m_view.Write(record + RecordExposedPath, InternString(snapshot.ExposedPath));
+         m_view.Write(record + RecordState, RecordStateUsed);
+      }
+
+      private VssSnapshotProperties ReadRecord(int slot)
+      {
+         long record = RecordOffset(slot);
+
+         return new VssSnapshotProperties(
+            ReadGuid(record + RecordSnapshotId),
+            ReadGuid(record + RecordSnapshotSetId),
+            m_view.ReadInt64(record + RecordSnapshotsCount),
+            ReadString(record + RecordSnapshotDeviceObject),
+            ReadString(record + RecordOriginalVolumeName),
+            ReadString(record + RecordOriginatingMachine),
+            ReadString(record + RecordServiceMachine),
+            ReadString(record + RecordExposedName),
+            ReadString(record + RecordExposedPath),
+            ReadGuid(record + RecordProviderId),
+            (VssVolumeSnapshotAttributes)m_view.ReadInt32(record + RecordAttributes),
+            DateTime.FromBinary(m_view.ReadInt64(record + RecordCreationTimestamp)),
+            (VssSnapshotState)m_view.ReadInt32(record + RecordStatus));
+      }
+
+      private IList<VssSnapshotProperties> ReadAllRecords()
+      {
+         List<VssSnapshotProperties> result = new List<VssSnapshotProperties>(m_view.ReadInt32(HeaderRecordCount));
+         int highWaterMark = m_view.ReadInt32(HeaderHighWaterMark);
+         for (int slot = 0; slot < highWaterMark; slot++)
+         {
+            if (m_view.ReadInt32(RecordOffset(slot) + RecordState) == RecordStateUsed)
+               result.Add(ReadRecord(slot));
+         }
+
+         return result;
+      }
+
+      private bool RecordEquals(int slot, VssSnapshotProperties snapshot)
+      {
+         long record = RecordOffset(slot);
+
+         return ReadGuid(record + RecordSnapshotSetId) == snapshot.SnapshotSetId
+            && ReadGuid(record + RecordProviderId) == snapshot.ProviderId
+            && m_view.ReadInt64(record + RecordSnapshotsCount) == snapshot.SnapshotsCount
+            && m_view.ReadInt64(record + RecordCreationTimestamp) == snapshot.CreationTimestamp.ToBinary()
+            && m_view.ReadInt32(record + RecordAttributes) == (int)snapshot.SnapshotAttributes
+            && m_view.ReadInt32(record + RecordStatus) == (int)snapshot.Status
+            && StringFieldEquals(record + RecordSnapshotDeviceObject, snapshot.SnapshotDeviceObject)
+            && StringFieldEquals(record + RecordOriginalVolumeName, snapshot.OriginalVolumeName)
+            && StringFieldEquals(record + RecordOriginatingMachine, snapshot.OriginatingMachine)
+            && StringFieldEquals(record + RecordServiceMachine, snapshot.ServiceMachine)
+            && StringFieldEquals(record + RecordExposedName, snapshot.ExposedName)
+            && StringFieldEquals(record + RecordExposedPath, snapshot.ExposedPath);
+      }
+
+      private Guid ReadGuid(long position)
+      {
+         Guid value;
+         m_view.Read(position, out value);
+         return value;
+      }
+
+      private void WriteGuid(long position, Guid value)
+      {
+         m_view.Write(position, ref value);
+      }
+
+      #endregion
+
+      #region Identifier Index
+
+      private static int GetBucketCount(int recordCapacity)
+      {
+         int bucketCount = 16;
+         while (bucketCount < recordCapacity * 2)
+            bucketCount *= 2;
+         return bucketCount;
+      }
+
+      private static int GetHash(Guid value)
+      {
+         byte[] bytes = value.ToByteArray();
+         uint hash = 0;
+         for (int i = 0; i < bytes.Length; i += 4)
+            hash = Mix(hash ^ BitConverter.ToUInt32(bytes, i));
+         return (int)(hash & 0x7FFFFFFF);
+      }
+
+      private static uint Mix(uint value)
+      {
+         value ^= value >> 16;
+         value *= 0x85EBCA6B;
+         value ^= value >> 13;
+         value *= 0xC2B2AE35;
+         value ^= value >> 16;
+         return value;
+      }
+
+      // Returns the position of the identifier index entry for the specified snapshot, or -1 if there is none.
+      private long FindIdEntry(Guid snapshotId)
+      {
+         int mask = m_bucketCount - 1;
+         int bucket = GetHash(snapshotId) & mask;
+         for (int probe = 0; probe < m_bucketCount; probe++, bucket = (bucket + 1) & mask)
+         {
+            long entry = m_idIndexOffset + (long)bucket * 4;
+            int value = m_view.ReadInt32(entry);
+            if (value == IdEntryEmpty)
+               break;
+
+            if (value != IdEntryDeleted && ReadGuid(RecordOffset(value - 1) + RecordSnapshotId) == snapshotId)
+               return entry;
+         }
+
+         return -1;
+      }
+
+      private int FindSlot(Guid snapshotId)
+      {
+         long entry = FindIdEntry(snapshotId);
+         return entry >= 0 ? m_view.ReadInt32(entry) - 1 : -1;
+      }
+
+      private void InsertId(Guid snapshotId, int slot)
+      {
+         int mask = m_bucketCount - 1;
+         int bucket = GetHash(snapshotId) & mask;
+         while (true)
+         {
+            long entry = m_idIndexOffset + (long)bucket * 4;
+            int value = m_view.ReadInt32(entry);
+            if (value == IdEntryEmpty || value == IdEntryDeleted)
+            {
+               if (value == IdEntryDeleted)
+                  m_view.Write(HeaderIdTombstones, m_view.ReadInt32(HeaderIdTombstones) - 1);
+
+               m_view.Write(entry, slot + 1);
+               return;
+            }
+
+            bucket = (bucket + 1) & mask;
+         }
+      }
+
+      private void RemoveId(Guid snapshotId)
+      {
+         long entry = FindIdEntry(snapshotId);
+         if (entry >= 0)
+         {
+            m_view.Write(entry, IdEntryDeleted);
+            m_view.Write(HeaderIdTombstones, m_view.ReadInt32(HeaderIdTombstones) + 1);
+         }
+      }
+
+      #endregion
+
+      #region Volume Index
+
+      // Returns the position of the volume index entry for the specified volume name, or -1 if there is none.
+      private long FindVolumeEntry(string originalVolumeName)
+      {
+         int mask = m_bucketCount - 1;
+         int bucket = GetStringHash(originalVolumeName, true) & mask;
+         for (int probe = 0; probe < m_bucketCount; probe++, bucket = (bucket + 1) & mask)
+         {
+            long entry = m_volumeIndexOffset + (long)bucket * VolumeEntrySize;
+            int value = m_view.ReadInt32(entry);
+            if (value == 0)
+               break;
+
+            if (StringEquals(value - 1, originalVolumeName, true))
+               return entry;
+         }
+
+         return -1;
+      }
+
+      // Returns the position of the volume index entry for the specified volume key.
+      private long FindVolumeEntry(int volumeKey)
+      {
+         int mask = m_bucketCount - 1;
+         int bucket = GetStringHash(volumeKey, true) & mask;
+         while (m_view.ReadInt32(m_volumeIndexOffset + (long)bucket * VolumeEntrySize) != volumeKey + 1)
+            bucket = (bucket + 1) & mask;
+
+         return m_volumeIndexOffset + (long)bucket * VolumeEntrySize;
+      }
+
+      private void LinkVolume(int slot, string originalVolumeName)
+      {
+         long record = RecordOffset(slot);
+
+         if (originalVolumeName == null)
+         {
+            m_view.Write(record + RecordVolumeKey, -1);
+            m_view.Write(record + RecordNextInVolume, -1);
+            m_view.Write(record + RecordPrevInVolume, -1);
+            return;
+         }
+
+         // Volume names differing only in case share a single chain, keyed by the first spelling encountered.
+         long entry = FindVolumeEntry(originalVolumeName);
+         if (entry < 0)
+         {
+            int volumeKey = InternString(originalVolumeName);
+            int mask = m_bucketCount - 1;
+            int bucket = GetStringHash(originalVolumeName, true) & mask;
+            while (m_view.ReadInt32(m_volumeIndexOffset + (long)bucket * VolumeEntrySize) != 0)
+               bucket = (bucket + 1) & mask;
+
+            entry = m_volumeIndexOffset + (long)bucket * VolumeEntrySize;
+            m_view.Write(entry, volumeKey + 1);
+            m_view.Write(entry + 4, -1);
+            m_view.Write(HeaderVolumeCount, m_view.ReadInt32(HeaderVolumeCount) + 1);
+         }
+
+         int head = m_view.ReadInt32(entry + 4);
+
+         m_view.Write(record + RecordVolumeKey, m_view.ReadInt32(entry) - 1);
+         m_view.Write(record + RecordNextInVolume, head);
+         m_view.Write(record + RecordPrevInVolume, -1);
+         if (head >= 0)
+            m_view.Write(RecordOffset(head) + RecordPrevInVolume, slot);
+         m_view.Write(entry + 4, slot);
+      }
+
+      private void UnlinkVolume(int slot)
+      {
+         long record = RecordOffset(slot);
+         int volumeKey = m_view.ReadInt32(record + RecordVolumeKey);
+         if (volumeKey < 0)
+            return;
+
+         int next = m_view.ReadInt32(record + RecordNextInVolume);
+         int prev = m_view.ReadInt32(record + RecordPrevInVolume);
+
+         if (prev >= 0)
+         {
+            m_view.Write(RecordOffset(prev) + RecordNextInVolume, next);
+         }
+         else if (next >= 0)
+         {
+            m_view.Write(FindVolumeEntry(volumeKey) + 4, next);
+         }
+         else
+         {
+            // This was the last shadow copy of the volume.
+            RemoveVolumeEntry(FindVolumeEntry(volumeKey));
+            m_view.Write(HeaderVolumeCount, m_view.ReadInt32(HeaderVolumeCount) - 1);
+         }
+
+         if (next >= 0)
+            m_view.Write(RecordOffset(next) + RecordPrevInVolume, prev);
+
+         m_view.Write(record + RecordVolumeKey, -1);
+         m_view.Write(record + RecordNextInVolume, -1);
+         m_view.Write(record + RecordPrevInVolume, -1);
+      }
+
+      // Removes an entry from the volume index, moving back the entries following it in its probe sequence
+      // so that no tombstone is needed.
+      private void RemoveVolumeEntry(long entry)
+      {
+         int mask = m_bucketCount - 1;
+         int hole = (int)((entry - m_volumeIndexOffset) / VolumeEntrySize);
+         for (int bucket = (hole + 1) & mask; ; bucket = (bucket + 1) & mask)
+         {
+            long current = m_volumeIndexOffset + (long)bucket * VolumeEntrySize;
+            int value = m_view.ReadInt32(current);
+            if (value == 0)
+               break;
+
+            int home = GetStringHash(value - 1, true) & mask;
+            if (((bucket - home) & mask) >= ((bucket - hole) & mask))
+            {
+               long target = m_volumeIndexOffset + (long)hole * VolumeEntrySize;
+               m_view.Write(target, value);
+               m_view.Write(target + 4, m_view.ReadInt32(current + 4));
+               hole = bucket;
+            }
+         }
+
+         long empty = m_volumeIndexOffset + (long)hole * VolumeEntrySize;
+         m_view.Write(empty, 0);
+         m_view.Write(empty + 4, 0);
+      }
+
+      #endregion
+
+      #region Set Index
+
+      // Returns the position of the set index entry for the specified shadow copy set, or -1 if there is none.
+      private long FindSetEntry(Guid snapshotSetId)
+      {
+         int mask = m_bucketCount - 1;
+         int bucket = GetHash(snapshotSetId) & mask;
+         for (int probe = 0; probe < m_bucketCount; probe++, bucket = (bucket + 1) & mask)
+         {
+            long entry = m_setIndexOffset + (long)bucket * SetEntrySize;
+            int value = m_view.ReadInt32(entry);
+            if (value == 0)
+               break;
+
+            if (ReadGuid(RecordOffset(value - 1) + RecordSnapshotSetId) == snapshotSetId)
+               return entry;
+         }
+
+         return -1;
+      }
+
+      private void LinkSet(int slot)
+      {
+         long record = RecordOffset(slot);
+         Guid snapshotSetId = ReadGuid(record + RecordSnapshotSetId);
+
+         long entry = FindSetEntry(snapshotSetId);
+         int head = -1;
+         if (entry >= 0)
+         {
+            head = m_view.ReadInt32(entry) - 1;
+            m_view.Write(RecordOffset(head) + RecordPrevInSet, slot);
+         }
+         else
+         {
+            int mask = m_bucketCount - 1;
+            int bucket = GetHash(snapshotSetId) & mask;
+            while (m_view.ReadInt32(m_setIndexOffset + (long)bucket * SetEntrySize) != 0)
+               bucket = (bucket + 1) & mask;
+
+            entry = m_setIndexOffset + (long)bucket * SetEntrySize;
+            m_view.Write(HeaderSetCount, m_view.ReadInt32(HeaderSetCount) + 1);
+         }
+
+         m_view.Write(record + RecordNextInSet, head);
+         m_view.Write(record + RecordPrevInSet, -1);
+         m_view.Write(entry, slot + 1);
+      }
+
+      // Must be called before the shadow copy set identifier of the record is overwritten.
+      private void UnlinkSet(int slot)
+      {
+         long record = RecordOffset(slot);
+         int next = m_view.ReadInt32(record + RecordNextInSet);
+         int prev = m_view.ReadInt32(record + RecordPrevInSet);
+
+         if (prev >= 0)
+         {
+            m_view.Write(RecordOffset(prev) + RecordNextInSet, next);
+         }
+         else
+         {
+            long entry = FindSetEntry(ReadGuid(record + RecordSnapshotSetId));
+            if (next >= 0)
+            {
+               m_view.Write(entry, next + 1);
+            }
+            else
+            {
+               RemoveSetEntry(entry);
+               m_view.Write(HeaderSetCount, m_view.ReadInt32(HeaderSetCount) - 1);
+            }
+         }
+
+         if (next >= 0)
+            m_view.Write(RecordOffset(next) + RecordPrevInSet, prev);
+
+         m_view.Write(record + RecordNextInSet, -1);
+         m_view.Write(record + RecordPrevInSet, -1);
+      }
+
+      // Removes an entry from the set index in the same way as RemoveVolumeEntry.
+      private void RemoveSetEntry(long entry)
+      {
+         int mask = m_bucketCount - 1;
+         int hole = (int)((entry - m_setIndexOffset) / SetEntrySize);
+         for (int bucket = (hole + 1) & mask; ; bucket = (bucket + 1) & mask)
+         {
+            long current = m_setIndexOffset + (long)bucket * SetEntrySize;
+            int value = m_view.ReadInt32(current);
+            if (value == 0)
+               break;
+
+            int home = GetHash(ReadGuid(RecordOffset(value - 1) + RecordSnapshotSetId)) & mask;
+            if (((bucket - home) & mask) >= ((bucket - hole) & mask))
+            {
+               m_view.Write(m_setIndexOffset + (long)hole * SetEntrySize, value);
+               hole = bucket;
+            }
+         }
+
+         m_view.Write(m_setIndexOffset + (long)hole * SetEntrySize, 0);
+      }
+
+      #endregion
+
+      #region String Table
+
+      private static int GetStringEntrySize(int length)
+      {
+         return 4 + ((length * 2 + 3) & ~3);
+      }
+
+      private static IEnumerable<string> GetStrings(VssSnapshotProperties snapshot)
+      {
+         yield return snapshot.SnapshotDeviceObject;
+         yield return snapshot.OriginalVolumeName;
+         yield return snapshot.OriginatingMachine;
+         yield return snapshot.ServiceMachine;
+         yield return snapshot.ExposedName;
+         yield return snapshot.ExposedPath;
+      }
+
+      private int GetRequiredStringTableSpace(VssSnapshotProperties snapshot)
+      {
+         int size = 0;
+         foreach (string value in GetStrings(snapshot))
+         {
+            if (value != null && FindString(value) < 0)
+               size += GetStringEntrySize(value.Length);
+         }
+
+         return size;
+      }
+
+      // Hashes the characters of a string using FNV-1a, optionally ignoring case.
+      private static int GetStringHash(char[] chars, int length, bool ignoreCase)
+      {
+         uint hash = 2166136261;
+         for (int i = 0; i < length; i++)
+            hash = (hash ^ (ignoreCase ? Char.ToUpperInvariant(chars[i]) : chars[i])) * 16777619;
+         return (int)(Mix(hash) & 0x7FFFFFFF);
+      }
+
+      private static int GetStringHash(string value, bool ignoreCase)
+      {
+         uint hash = 2166136261;
+         for (int i = 0; i < value.Length; i++)
+            hash = (hash ^ (ignoreCase ? Char.ToUpperInvariant(value[i]) : value[i])) * 16777619;
+         return (int)(Mix(hash) & 0x7FFFFFFF);
+      }
+
+      private int GetStringHash(int offset, bool ignoreCase)
+      {
+         int length = ReadChars(offset);
+         return GetStringHash(m_chars, length, ignoreCase);
+      }
+
+      // Reads the characters of the string at the specified offset of the string table into m_chars, and returns its length.
+      private int ReadChars(int offset)
+      {
+         int length = m_view.ReadInt32(m_stringTableOffset + offset);
+         if (m_chars.Length < length)
+            m_chars = new char[Math.Max(length, m_chars.Length * 2)];
+
+         m_view.ReadArray(m_stringTableOffset + offset + 4, m_chars, 0, length);
+         return length;
+      }
+
+      private bool StringEquals(int offset, string value, bool ignoreCase)
+      {
+         if (m_view.ReadInt32(m_stringTableOffset + offset) != value.Length)
+            return false;
+
+         ReadChars(offset);
+         for (int i = 0; i < value.Length; i++)
+         {
+            char stored = m_chars[i];
+            if (stored != value[i] && (!ignoreCase || Char.ToUpperInvariant(stored) != Char.ToUpperInvariant(value[i])))
+               return false;
+         }
+
+         return true;
+      }
+
+      private bool StringFieldEquals(long position, string value)
+      {
+         int offset = m_view.ReadInt32(position);
+         if (offset < 0 || value == null)
+            return offset < 0 && value == null;
+
+         return StringEquals(offset, value, false);
+      }
+
+      // Returns the offset of the specified string in the string table, or -1 if it is not stored.
+      private int FindString(string value)
+      {
+         int mask = m_stringBucketCount - 1;
+         int bucket = GetStringHash(value, false) & mask;
+         for (int probe = 0; probe < m_stringBucketCount; probe++, bucket = (bucket + 1) & mask)
+         {
+            int entry = m_view.ReadInt32(m_stringIndexOffset + (long)bucket * StringEntrySize);
+            if (entry == 0)
+               break;
+
+            if (StringEquals(entry - 1, value, false))
+               return entry - 1;
+         }
+
+         return -1;
+      }
+
+      private int InternString(string value)
+      {
+         if (value == null)
+            return -1;
+
+         int offset = FindString(value);
+         if (offset >= 0)
+            return offset;
+
+         offset = m_view.ReadInt32(HeaderStringTableLength);
+         char[] chars = value.ToCharArray();
+         m_view.Write(m_stringTableOffset + offset, chars.Length);
+         m_view.WriteArray(m_stringTableOffset + offset + 4, chars, 0, chars.Length);
+         m_view.Write(HeaderStringTableLength, offset + GetStringEntrySize(chars.Length));
+
+         int mask = m_stringBucketCount - 1;
+         int bucket = GetStringHash(chars, chars.Length, false) & mask;
+         while (m_view.ReadInt32(m_stringIndexOffset + (long)bucket * StringEntrySize) != 0)
+            bucket = (bucket + 1) & mask;
+
+         m_view.Write(m_stringIndexOffset + (long)bucket * StringEntrySize, offset + 1);
+         m_view.Write(HeaderStringCount, m_view.ReadInt32(HeaderStringCount) + 1);
+         return offset;
+      }
+
+      private string ReadString(long position)
+      {
+         int offset = m_view.ReadInt32(position);
+         if (offset < 0)
+            return null;
+
+         int length = ReadChars(offset);
+         return new string(m_chars, 0, length);
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,62 @@
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssSnapshotInventoryRefreshResult"/> class describes the changes applied to a <see cref="VssSnapshotInventory"/>
+   ///     by a call to <see cref="M:Alphaleonis.Win32.Vss.VssSnapshotInventory.Refresh"/>.
+   /// </summary>
+   [Serializable]
+   public class VssSnapshotInventoryRefreshResult
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSnapshotInventoryRefreshResult"/> class.
+      /// </summary>
+      /// <param name="added">The number of shadow copies added to the inventory.</param>
+      /// <param name="updated">The number of shadow copies whose record was rewritten.</param>
+      /// <param name="removed">The number of shadow copies removed from the inventory.</param>
+      /// <param name="unchanged">The number of shadow copies whose record was left untouched.</param>
+      public VssSnapshotInventoryRefreshResult(int added, int updated, int removed, int unchanged)
+      {
+         Added = added;
+         Updated = updated;
+         Removed = removed;
+         Unchanged = unchanged;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the number of shadow copies that were not present in the inventory and have been added to it.
+      /// </summary>
+      public int Added { get; private set; }
+
+      /// <summary>
+      /// Gets the number of shadow copies whose properties had changed and whose record has been rewritten.
+      /// </summary>
+      public int Updated { get; private set; }
+
+      /// <summary>
+      /// Gets the number of shadow copies that no longer exist and have been removed from the inventory.
+      /// </summary>
+      public int Removed { get; private set; }
+
+      /// <summary>
+      /// Gets the number of shadow copies whose record was already up to date.
+      /// </summary>
+      public int Unchanged { get; private set; }
+
+      /// <summary>
+      /// Gets a value indicating whether the refresh modified the inventory.
+      /// </summary>
+      public bool HasChanges
+      {
+         get
+         {
+            return Added != 0 || Updated != 0 || Removed != 0;
+         }
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,93 @@
+using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssSnapshotOrchestrationResult"/> class contains the shadow copy sets created by
+   ///     <see cref="VssSnapshotOrchestrator.CreateSnapshots(IEnumerable{string})"/>.
+   /// </summary>
+   /// <remarks>
+   ///     Disposing the result disposes the sessions of all shadow copy sets, which deletes any non-persistent shadow copies.
+   /// </remarks>
+   public sealed class VssSnapshotOrchestrationResult : IDisposable
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSnapshotOrchestrationResult"/> class.
+      /// </summary>
+      /// <param name="sets">The shadow copy sets created, in the order in which they were created.</param>
+      /// <param name="splitCount">The number of times a shadow copy set was split because the provider rejected a volume.</param>
+      /// <param name="maximumVolumesPerSet">The maximum number of volumes per shadow copy set in effect at the end of the operation.</param>
+      /// <param name="elapsed">The total time spent creating the shadow copy sets.</param>
+      public VssSnapshotOrchestrationResult(IList<VssSnapshotSetResult> sets, int splitCount, int maximumVolumesPerSet, TimeSpan elapsed)
+      {
+         if (sets == null)
+            throw new ArgumentNullException("sets");
+
+         Sets = new ReadOnlyCollection<VssSnapshotSetResult>(sets);
+         SplitCount = splitCount;
+         MaximumVolumesPerSet = maximumVolumesPerSet;
+         Elapsed = elapsed;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the shadow copy sets created, in the order in which they were created.
+      /// </summary>
+      public ReadOnlyCollection<VssSnapshotSetResult> Sets { get; private set; }
+
+      /// <summary>
+      /// Gets the number of times a shadow copy set was split because the provider returned
+      /// <see cref="VssError.MaximumNumberOfVolumesReached"/> before the configured maximum number of volumes was reached.
+      /// </summary>
+      public int SplitCount { get; private set; }
+
+      /// <summary>
+      /// Gets the maximum number of volumes per shadow copy set in effect at the end of the operation.
+      /// </summary>
+      /// <value>
+      ///     <see cref="VssSnapshotOrchestrator.MaximumVolumesPerSet"/>, or the lower limit detected if a shadow copy set was split.
+      /// </value>
+      public int MaximumVolumesPerSet { get; private set; }
+
+      /// <summary>
+      /// Gets the total time spent creating the shadow copy sets.
+      /// </summary>
+      public TimeSpan Elapsed { get; private set; }
+
+      #endregion
+
+      #region Methods
+
+      /// <summary>
+      /// Disposes the sessions of all shadow copy sets.
+      /// </summary>
+      /// <remarks>
+      ///     All sessions are disposed even if disposing one of them throws an exception; the first such exception is rethrown
+      ///     after all sessions have been disposed.
+      /// </remarks>
+      public void Dispose()
+      {
+         Exception error = null;
+         for (int i = Sets.Count - 1; i >= 0; i--)
+         {
+            try
+            {
+               Sets[i].Session.Dispose();
+            }
+            catch (Exception ex)
+            {
+               if (error == null)
+                  error = ex;
+            }
+         }
+
+         if (error != null)
+            throw ExceptionHelper.Rethrow(error);
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,687 @@
+using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Diagnostics;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssSnapshotOrchestrator"/> class creates shadow copies of a large number of volumes by partitioning them into
+   ///     several shadow copy sets, which are created one after the other.
+   /// </summary>
+   /// <remarks>
+   ///     <para>
+   ///         A single shadow copy set can contain at most 64 volumes, and some providers support fewer. All volumes in a set are frozen
+   ///         together, so large sets also lengthen the time writers and volumes are frozen. The orchestrator partitions the volumes
+   ///         into sets of at most <see cref="MaximumVolumesPerSet"/> volumes, whose estimated freeze time does not exceed
+   ///         <see cref="FreezeBudget"/>. Volumes that share a writer, as registered by <see cref="AddWriterAffinity(IEnumerable{IVssExamineWriterMetadata})"/>
+   ///         or <see cref="AddAffinityGroup"/>, are always placed in the same set, so that the data of each writer is shadow copied
+   ///         consistently.
+   ///     </para>
+   ///     <para>
+   ///         Each set is created by its own <see cref="IVssSnapshotSetSession"/>, obtained from the session factory passed to the
+   ///         constructor. If a provider rejects a volume with <see cref="VssMaximumNumberOfVolumesReachedException"/> before the set
+   ///         reaches <see cref="MaximumVolumesPerSet"/> volumes, the set is aborted, and the remaining volumes are partitioned again
+   ///         using the number of volumes the provider accepted as the limit.
+   ///     </para>
+   ///     <para>
+   ///         Only one shadow copy set can be created at a time, so the sets are created one after the other. If
+   ///         <see cref="PipelineInitialization"/> is <see langword="true"/>, the session of the next set is created and gathers the
+   ///         writer metadata while the current set is being created.
+   ///     </para>
+   ///     <para>
+   ///         The sessions are created by the session factory, and used, on the thread that calls <see cref="CreateSnapshots(IEnumerable{string})"/>.
+   ///         Only <see cref="IVssSnapshotSetSession.Initialize"/> of a pipelined session runs on a thread pool thread, which belongs
+   ///         to the multithreaded apartment (MTA). Since the native VSS objects are not marshaled between apartments, pipelining is
+   ///         only used if the calling thread also belongs to the MTA; on a single-threaded apartment (STA) thread, every session is
+   ///         initialized on the calling thread.
+   ///     </para>
+   /// </remarks>
+   /// <example>
+   ///     <code>
+   ///     IVssImplementation vss = VssUtils.LoadImplementation();
+   ///     VssSnapshotOrchestrator orchestrator = new VssSnapshotOrchestrator(
+   ///        () => new VssBackupComponentsSnapshotSetSession(vss.CreateVssBackupComponents(), VssSnapshotContext.Backup, VssBackupType.Full));
+   ///     orchestrator.FreezeBudget = TimeSpan.FromSeconds(10);
+   ///     orchestrator.FreezeTimeEstimator = volume => TimeSpan.FromSeconds(1);
+   ///
+   ///     using (VssSnapshotOrchestrationResult result = orchestrator.CreateSnapshots(volumes))
+   ///     {
+   ///        foreach (VssSnapshotSetResult set in result.Sets)
+   ///        {
+   ///           // ...
+   ///        }
+   ///     }
+   ///     </code>
+   /// </example>
+   public class VssSnapshotOrchestrator
+   {
+      #region Constants
+
+      /// <summary>
+      /// The maximum number of volumes in a shadow copy set supported by VSS.
+      /// </summary>
+      public const int DefaultMaximumVolumesPerSet = 64;
+
+      #endregion
+
+      #region Private Fields
+
+      private readonly Func<IVssSnapshotSetSession> m_sessionFactory;
+      private readonly List<string[]> m_affinityGroups = new List<string[]>();
+      private int m_maximumVolumesPerSet = DefaultMaximumVolumesPerSet;
+      private TimeSpan m_freezeBudget = TimeSpan.MaxValue;
+
+      #endregion
+
+      #region Constructor
+
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSnapshotOrchestrator"/> class.
+      /// </summary>
+      /// <param name="sessionFactory">A function creating a new, uninitialized session for each shadow copy set.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="sessionFactory"/> is <see langword="null"/>.</exception>
+      public VssSnapshotOrchestrator(Func<IVssSnapshotSetSession> sessionFactory)
+      {
+         if (sessionFactory == null)
+            throw new ArgumentNullException("sessionFactory");
+
+         m_sessionFactory = sessionFactory;
+         PipelineInitialization = true;
+      }
+
+      #endregion
+
+      #region Properties
+
+      /// <summary>
+      /// Gets or sets the provider used to create the shadow copies.
+      /// </summary>
+      /// <value>The identifier of the provider, or <see cref="Guid.Empty"/> to use the default provider. The default is <see cref="Guid.Empty"/>.</value>
+      public Guid ProviderId { get; set; }
+
+      /// <summary>
+      /// Gets or sets the maximum number of volumes in a shadow copy set.
+      /// </summary>
+      /// <value>The maximum number of volumes in a shadow copy set. The default is <see cref="DefaultMaximumVolumesPerSet"/>.</value>
+      /// <exception cref="ArgumentOutOfRangeException">The value is less than one.</exception>
+      public int MaximumVolumesPerSet
+      {
+         get
+         {
+            return m_maximumVolumesPerSet;
+         }
+
+         set
+         {
+            if (value < 1)
+               throw new ArgumentOutOfRangeException("value", value, "The maximum number of volumes per shadow copy set must be at least one.");
+
+            m_maximumVolumesPerSet = value;
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the maximum estimated freeze time of a shadow copy set.
+      /// </summary>
+      /// <value>
+      ///     The maximum sum of the estimated freeze times of the volumes in a shadow copy set. The default is <see cref="TimeSpan.MaxValue"/>,
+      ///     which does not limit the size of the sets.
+      /// </value>
+      /// <remarks>
+      ///     A group of volumes that must be placed in the same set is placed in a set of its own if its estimated freeze time exceeds
+      ///     the budget.
+      /// </remarks>
+      /// <exception cref="ArgumentOutOfRangeException">The value is not positive.</exception>
+      public TimeSpan FreezeBudget
+      {
+         get
+         {
+            return m_freezeBudget;
+         }
+
+         set
+         {
+            if (value <= TimeSpan.Zero)
+               throw new ArgumentOutOfRangeException("value", value, "The freeze budget must be positive.");
+
+            m_freezeBudget = value;
+         }
+      }
+
+      /// <summary>
+      /// Gets or sets the function used to estimate the freeze time of a volume.
+      /// </summary>
+      /// <value>
+      ///     A function returning the estimated freeze time of the specified volume, or <see langword="null"/> to estimate the freeze
+      ///     time of every volume as zero. The default is <see langword="null"/>.
+      /// </value>
+      public Func<string, TimeSpan> FreezeTimeEstimator { get; set; }
+
+      /// <summary>
+      /// Gets or sets a value indicating whether the session of the next shadow copy set is initialized while the current set is
+      /// being created.
+      /// </summary>
+      /// <value><see langword="true"/> to initialize the next session in the background; otherwise, <see langword="false"/>. The default is <see langword="true"/>.</value>
+      /// <remarks>
+      ///     The setting has no effect when <see cref="CreateSnapshots(IEnumerable{string})"/> is called on a single-threaded apartment thread.
+      /// </remarks>
+      public bool PipelineInitialization { get; set; }
+
+      #endregion
+
+      #region Affinity
+
+      /// <summary>
+      /// Specifies that the specified volumes must be placed in the same shadow copy set.
+      /// </summary>
+      /// <param name="volumes">The volumes to keep together. Volumes that are not shadow copied are ignored.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="volumes"/> is <see langword="null"/>.</exception>
+      public void AddAffinityGroup(IEnumerable<string> volumes)
+      {
+         if (volumes == null)
+            throw new ArgumentNullException("volumes");
+
+         string[] group = volumes.Where(volume => !String.IsNullOrEmpty(volume)).Select(NormalizeVolumeName).ToArray();
+         if (group.Length > 1)
+            m_affinityGroups.Add(group);
+      }
+
+      /// <summary>
+      /// Specifies that the volumes containing the files of each writer must be placed in the same shadow copy set.
+      /// </summary>
+      /// <param name="writers">The gathered writer metadata.</param>
+      /// <remarks>
+      ///     The volume of a file is determined from the root of its path, after expanding environment variables. Use
+      ///     <see cref="AddWriterAffinity(IEnumerable{IVssExamineWriterMetadata}, Func{string, string})"/> if the files of a writer
+      ///     may be located on volumes mounted in a folder.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="writers"/> is <see langword="null"/>.</exception>
+      public void AddWriterAffinity(IEnumerable<IVssExamineWriterMetadata> writers)
+      {
+         AddWriterAffinity(writers, GetPathRoot);
+      }
+
+      /// <summary>
+      /// Specifies that the volumes containing the files of each writer must be placed in the same shadow copy set.
+      /// </summary>
+      /// <param name="writers">The gathered writer metadata.</param>
+      /// <param name="volumeResolver">
+      ///     A function returning the volume containing the specified path, or <see langword="null"/> if the volume cannot be determined.
+      /// </param>
+      /// <exception cref="ArgumentNullException"><paramref name="writers"/> or <paramref name="volumeResolver"/> is <see langword="null"/>.</exception>
+      public void AddWriterAffinity(IEnumerable<IVssExamineWriterMetadata> writers, Func<string, string> volumeResolver)
+      {
+         if (writers == null)
+            throw new ArgumentNullException("writers");
+
+         if (volumeResolver == null)
+            throw new ArgumentNullException("volumeResolver");
+
+         foreach (IVssExamineWriterMetadata writer in writers)
+         {
+            HashSet<string> volumes = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+            foreach (IVssWMComponent component in writer.Components)
+            {
+               AddVolumes(volumes, component.Files, volumeResolver);
+               AddVolumes(volumes, component.DatabaseFiles, volumeResolver);
+               AddVolumes(volumes, component.DatabaseLogFiles, volumeResolver);
+            }
+
+            if (volumes.Count > 1)
+               m_affinityGroups.Add(volumes.ToArray());
+         }
+      }
+
+      /// <summary>
+      /// Removes all affinity groups.
+      /// </summary>
+      public void ClearAffinity()
+      {
+         m_affinityGroups.Clear();
+      }
+
+      #endregion
+
+      #region Methods
+
+      /// <summary>
+      /// Partitions the specified volumes into shadow copy sets, without creating any shadow copies.
+      /// </summary>
+      /// <param name="volumes">The volumes to shadow copy.</param>
+      /// <returns>The volumes of each shadow copy set, in the order in which the sets would be created.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="volumes"/> is <see langword="null"/>.</exception>
+      /// <exception cref="InvalidOperationException">A group of volumes that must be placed in the same set contains more than <see cref="MaximumVolumesPerSet"/> volumes.</exception>
+      public ReadOnlyCollection<ReadOnlyCollection<string>> Plan(IEnumerable<string> volumes)
+      {
+         if (volumes == null)
+            throw new ArgumentNullException("volumes");
+
+         return new ReadOnlyCollection<ReadOnlyCollection<string>>(
+            Partition(GetDistinctVolumes(volumes), m_maximumVolumesPerSet).Select(set => new ReadOnlyCollection<string>(set)).ToList());
+      }
+
+      /// <summary>
+      /// Creates shadow copies of the specified volumes.
+      /// </summary>
+      /// <param name="volumes">The volumes to shadow copy.</param>
+      /// <returns>The shadow copy sets created. The result must be disposed when the shadow copies are no longer needed.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="volumes"/> is <see langword="null"/>.</exception>
+      /// <exception cref="InvalidOperationException">A group of volumes that must be placed in the same set contains more volumes than a shadow copy set can contain.</exception>
+      /// <exception cref="VssException">The creation of a shadow copy set failed.</exception>
+      /// <remarks>
+      ///     If the creation of any shadow copy set fails, the sessions of all sets, including those already created, are aborted and
+      ///     disposed before the exception is rethrown, so no shadow copies are left behind. Exceptions thrown while cleaning up are
+      ///     ignored, so that they do not hide the original failure.
+      /// </remarks>
+      public VssSnapshotOrchestrationResult CreateSnapshots(IEnumerable<string> volumes)
+      {
+         return CreateSnapshots(volumes, CancellationToken.None);
+      }
+
+      /// <summary>
+      /// Creates shadow copies of the specified volumes.
+      /// </summary>
+      /// <param name="volumes">The volumes to shadow copy.</param>
+      /// <param name="cancellationToken">The token to monitor for cancellation requests. It is checked before each shadow copy set is started.</param>
+      /// <returns>The shadow copy sets created. The result must be disposed when the shadow copies are no longer needed.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="volumes"/> is <see langword="null"/>.</exception>
+      /// <exception cref="InvalidOperationException">A group of volumes that must be placed in the same set contains more volumes than a shadow copy set can contain.</exception>
+      /// <exception cref="VssException">The creation of a shadow copy set failed.</exception>
+      /// <exception cref="OperationCanceledException">The operation was canceled.</exception>
+      /// <remarks>
+      ///     If the creation of any shadow copy set fails, the sessions of all sets, including those already created, are aborted and
+      ///     disposed before the exception is rethrown, so no shadow copies are left behind. Exceptions thrown while cleaning up are
+      ///     ignored, so that they do not hide the original failure.
+      /// </remarks>
+      public VssSnapshotOrchestrationResult CreateSnapshots(IEnumerable<string> volumes, CancellationToken cancellationToken)
+      {
+         if (volumes == null)
+            throw new ArgumentNullException("volumes");
+
+         Stopwatch total = Stopwatch.StartNew();
+         int limit = m_maximumVolumesPerSet;
+         List<List<string>> sets = Partition(GetDistinctVolumes(volumes), limit);
+         List<VssSnapshotSetResult> results = new List<VssSnapshotSetResult>(sets.Count);
+         bool pipeline = PipelineInitialization && Thread.CurrentThread.GetApartmentState() != ApartmentState.STA;
+         PendingSession pending = null;
+         IVssSnapshotSetSession session = null;
+         int splitCount = 0;
+
+         try
+         {
+            int index = 0;
+            while (index < sets.Count)
+            {
+               cancellationToken.ThrowIfCancellationRequested();
+
+               List<string> set = sets[index];
+
+               Stopwatch watch = Stopwatch.StartNew();
+               InitializedSession initialized;
+               if (pending != null)
+               {
+                  PendingSession current = pending;
+                  pending = null;
+                  initialized = EndInitialize(current);
+               }
+               else
+               {
+                  initialized = Initialize();
+               }
+
+               session = initialized.Session;
+               TimeSpan waitTime = watch.Elapsed;
+
+               watch.Restart();
+               Guid snapshotSetId = session.StartSnapshotSet();
+               List<Guid> snapshotIds = new List<Guid>(set.Count);
+               bool full = false;
+               foreach (string volume in set)
+               {
+                  try
+                  {
+                     snapshotIds.Add(session.AddToSnapshotSet(volume, ProviderId));
+                  }
+                  catch (VssMaximumNumberOfVolumesReachedException)
+                  {
+                     if (snapshotIds.Count == 0)
+                        throw;
+
+                     full = true;
+                     break;
+                  }
+               }
+
+               if (full)
+               {
+                  // The provider supports fewer volumes than expected. Discard this set, and partition the remaining
+                  // volumes again using the number of volumes the provider accepted as the new limit.
+                  session.AbortBackup();
+                  IVssSnapshotSetSession rejected = session;
+                  session = null;
+                  rejected.Dispose();
+
+                  limit = snapshotIds.Count;
+                  List<string> remaining = sets.Skip(index).SelectMany(s => s).ToList();
+                  sets.RemoveRange(index, sets.Count - index);
+                  sets.AddRange(Partition(remaining, limit));
+                  splitCount++;
+                  continue;
+               }
+
+               session.PrepareForBackup();
+               TimeSpan preparationTime = watch.Elapsed;
+
+               if (pipeline && index + 1 < sets.Count)
+                  pending = BeginInitialize();
+
+               watch.Restart();
+               session.DoSnapshotSet();
+               TimeSpan snapshotTime = watch.Elapsed;
+
+               results.Add(new VssSnapshotSetResult(session, snapshotSetId, set, snapshotIds, EstimateFreezeTime(set),
+                  initialized.Elapsed, waitTime, preparationTime, snapshotTime));
+               session = null;
+               index++;
+            }
+         }
+         catch
+         {
+            if (session != null)
+               AbortAndDispose(session);
+
+            if (pending != null)
+               DisposePending(pending);
+
+            for (int i = results.Count - 1; i >= 0; i--)
+               AbortAndDispose(results[i].Session);
+
+            throw;
+         }
+
+         return new VssSnapshotOrchestrationResult(results, splitCount, limit, total.Elapsed);
+      }
+
+      #endregion
+
+      #region Private Members
+
+      private sealed class InitializedSession
+      {
+         public InitializedSession(IVssSnapshotSetSession session, TimeSpan elapsed)
+         {
+            Session = session;
+            Elapsed = elapsed;
+         }
+
+         public IVssSnapshotSetSession Session { get; private set; }
+
+         public TimeSpan Elapsed { get; private set; }
+      }
+
+      private sealed class PendingSession
+      {
+         public PendingSession(IVssSnapshotSetSession session, Task<TimeSpan> initialization)
+         {
+            Session = session;
+            Initialization = initialization;
+         }
+
+         public IVssSnapshotSetSession Session { get; private set; }
+
+         // Completes with the time spent creating and initializing the session.
+         public Task<TimeSpan> Initialization { get; private set; }
+      }
+
+      // Creates and initializes a session on the calling thread.
+      private InitializedSession Initialize()
+      {
+         Stopwatch watch = Stopwatch.StartNew();
+         IVssSnapshotSetSession session = m_sessionFactory();
+         try
+         {
+            session.Initialize();
+         }
+         catch
+         {
+            DisposeQuietly(session);
+            throw;
+         }
+
+         return new InitializedSession(session, watch.Elapsed);
+      }
+
+      // Creates a session on the calling thread, and initializes it on a thread pool thread.
+      private PendingSession BeginInitialize()
+      {
+         Stopwatch watch = Stopwatch.StartNew();
+         IVssSnapshotSetSession session = m_sessionFactory();
+         try
+         {
+            return new PendingSession(session, Task.Factory.StartNew(() =>
+               {
+                  session.Initialize();
+                  return watch.Elapsed;
+               }, CancellationToken.None, TaskCreationOptions.LongRunning, TaskScheduler.Default));
+         }
+         catch
+         {
+            DisposeQuietly(session);
+            throw;
+         }
+      }
+
+      private static InitializedSession EndInitialize(PendingSession pending)
+      {
+         TimeSpan elapsed;
+         try
+         {
+            elapsed = pending.Initialization.Result;
+         }
+         catch (AggregateException ex)
+         {
+            DisposeQuietly(pending.Session);
+            throw ExceptionHelper.Rethrow(ex.InnerException);
+         }
+
+         return new InitializedSession(pending.Session, elapsed);
+      }
+
+      // The cleanup helpers below ignore all exceptions, since they are only called while another exception is propagating.
+
+      private static void DisposePending(PendingSession pending)
+      {
+         // The session must not be disposed while it is being initialized on another thread.
+         try
+         {
+            pending.Initialization.Wait();
+         }
+         catch (Exception)
+         {
+         }
+
+         DisposeQuietly(pending.Session);
+      }
+
+      private static void AbortAndDispose(IVssSnapshotSetSession session)
+      {
+         try
+         {
+            session.AbortBackup();
+         }
+         catch (Exception)
+         {
+         }
+
+         DisposeQuietly(session);
+      }
+
+      private static void DisposeQuietly(IVssSnapshotSetSession session)
+      {
+         try
+         {
+            session.Dispose();
+         }
+         catch (Exception)
+         {
+         }
+      }
+
+      private List<string> GetDistinctVolumes(IEnumerable<string> volumes)
+      {
+         List<string> result = new List<string>();
+         HashSet<string> seen = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+         foreach (string volume in volumes)
+         {
+            if (String.IsNullOrEmpty(volume))
+               throw new ArgumentException("The volume names must not be null or empty.", "volumes");
+
+            string name = NormalizeVolumeName(volume);
+            if (seen.Add(name))
+               result.Add(name);
+         }
+
+         return result;
+      }
+
+      // Partitions the volumes into sets using first-fit decreasing on the affinity groups, keeping the volumes of each set in
+      // the order in which they were specified.
+      private List<List<string>> Partition(IList<string> volumes, int limit)
+      {
+         Dictionary<string, int> indexes = new Dictionary<string, int>(StringComparer.OrdinalIgnoreCase);
+         for (int i = 0; i < volumes.Count; i++)
+            indexes.Add(volumes[i], i);
+
+         int[] parents = Enumerable.Range(0, volumes.Count).ToArray();
+         foreach (string[] group in m_affinityGroups)
+         {
+            int first = -1;
+            foreach (string volume in group)
+            {
+               int index;
+               if (!indexes.TryGetValue(volume, out index))
+                  continue;
+
+               if (first == -1)
+                  first = index;
+               else
+                  Union(parents, first, index);
+            }
+         }
+
+         List<List<int>> groups = Enumerable.Range(0, volumes.Count)
+            .GroupBy(i => Find(parents, i))
+            .Select(g => g.ToList())
+            .OrderByDescending(g => g.Count)
+            .ToList();
+
+         List<List<int>> sets = new List<List<int>>();
+         List<TimeSpan> setFreezeTimes = new List<TimeSpan>();
+         foreach (List<int> group in groups)
+         {
+            if (group.Count > limit)
+               throw new InvalidOperationException(String.Format(CultureInfo.CurrentCulture,
+                  "The volumes {0} must be placed in the same shadow copy set, which can contain at most {1} volumes.",
+                  String.Join(", ", group.Select(i => volumes[i])), limit));
+
+            TimeSpan freezeTime = EstimateFreezeTime(group.Select(i => volumes[i]));
+            int target = -1;
+            for (int i = 0; i < sets.Count; i++)
+            {
+               if (sets[i].Count + group.Count <= limit && freezeTime <= m_freezeBudget - setFreezeTimes[i])
+               {
+                  target = i;
+                  break;
+               }
+            }
+
+            if (target == -1)
+            {
+               sets.Add(new List<int>());
+               setFreezeTimes.Add(TimeSpan.Zero);
+               target = sets.Count - 1;
+            }
+
+            sets[target].AddRange(group);
+            setFreezeTimes[target] += freezeTime;
+         }
+
+         return sets
+            .Select(set => set.OrderBy(i => i).ToList())
+            .OrderBy(set => set[0])
+            .Select(set => set.Select(i => volumes[i]).ToList())
+            .ToList();
+      }
+
+      private TimeSpan EstimateFreezeTime(IEnumerable<string> volumes)
+      {
+         Func<string, TimeSpan> estimator = FreezeTimeEstimator;
+         if (estimator == null)
+            return TimeSpan.Zero;
+
+         TimeSpan result = TimeSpan.Zero;
+         foreach (string volume in volumes)
+            result += estimator(volume);
+
+         return result;
+      }
+
+      private static int Find(int[] parents, int index)
+      {
+         while (parents[index] != index)
+         {
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+         }
+
+         return index;
+      }
+
+      private static void Union(int[] parents, int first, int second)
+      {
+         int firstRoot = Find(parents, first);
+         int secondRoot = Find(parents, second);
+         if (firstRoot != secondRoot)
+            parents[Math.Max(firstRoot, secondRoot)] = Math.Min(firstRoot, secondRoot);
+      }
+
+      private static void AddVolumes(HashSet<string> volumes, IEnumerable<VssWMFileDescriptor> files, Func<string, string> volumeResolver)
+      {
+         foreach (VssWMFileDescriptor file in files)
+         {
+            if (String.IsNullOrEmpty(file.Path))
+               continue;
+
+            string volume = volumeResolver(file.Path);
+            if (!String.IsNullOrEmpty(volume))
+               volumes.Add(NormalizeVolumeName(volume));
+         }
+      }
+
+      private static string GetPathRoot(string path)
+      {
+         try
+         {
+            return Path.GetPathRoot(Environment.ExpandEnvironmentVariables(path));
+         }
+         catch (ArgumentException)
+         {
+            return null;
+         }
+      }
+
+      private static string NormalizeVolumeName(string volume)
+      {
+         volume = volume.Trim();
+         return volume.EndsWith("\\", StringComparison.Ordinal) ? volume : volume + "\\";
+      }
+
+      #endregion
+   }
+}
@@ -0,0 +1,105 @@
+using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssSnapshotSetResult"/> class contains the shadow copies and the timing of a single shadow copy set created by a
+   ///     <see cref="VssSnapshotOrchestrator"/>.
+   /// </summary>
+   public class VssSnapshotSetResult
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssSnapshotSetResult"/> class.
+      /// </summary>
+      /// <param name="session">The session that created the shadow copy set.</param>
+      /// <param name="snapshotSetId">The identifier of the shadow copy set.</param>
+      /// <param name="volumes">The volumes in the shadow copy set.</param>
+      /// <param name="snapshotIds">The identifiers of the shadow copies of the volumes, in the same order as <paramref name="volumes"/>.</param>
+      /// <param name="estimatedFreezeTime">The estimated freeze time of the volumes in the shadow copy set.</param>
+      /// <param name="initializationTime">The time spent creating and initializing the session.</param>
+      /// <param name="waitTime">The time spent waiting for the initialization of the session to complete.</param>
+      /// <param name="preparationTime">The time spent starting the shadow copy set, adding the volumes and preparing the writers.</param>
+      /// <param name="snapshotTime">The time spent creating the shadow copies.</param>
+      public VssSnapshotSetResult(IVssSnapshotSetSession session, Guid snapshotSetId, IList<string> volumes, IList<Guid> snapshotIds,
+         TimeSpan estimatedFreezeTime, TimeSpan initializationTime, TimeSpan waitTime, TimeSpan preparationTime, TimeSpan snapshotTime)
+      {
+         if (session == null)
+            throw new ArgumentNullException("session");
+
+         if (volumes == null)
+            throw new ArgumentNullException("volumes");
+
+         if (snapshotIds == null)
+            throw new ArgumentNullException("snapshotIds");
+
+         Session = session;
+         SnapshotSetId = snapshotSetId;
+         Volumes = new ReadOnlyCollection<string>(volumes);
+         SnapshotIds = new ReadOnlyCollection<Guid>(snapshotIds);
+         EstimatedFreezeTime = estimatedFreezeTime;
+         InitializationTime = initializationTime;
+         WaitTime = waitTime;
+         PreparationTime = preparationTime;
+         SnapshotTime = snapshotTime;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the session that created the shadow copy set.
+      /// </summary>
+      /// <remarks>
+      ///     The session must be kept alive for as long as the shadow copies are used, since disposing it deletes any non-persistent
+      ///     shadow copies it created.
+      /// </remarks>
+      public IVssSnapshotSetSession Session { get; private set; }
+
+      /// <summary>
+      /// Gets the identifier of the shadow copy set.
+      /// </summary>
+      public Guid SnapshotSetId { get; private set; }
+
+      /// <summary>
+      /// Gets the volumes in the shadow copy set.
+      /// </summary>
+      public ReadOnlyCollection<string> Volumes { get; private set; }
+
+      /// <summary>
+      /// Gets the identifiers of the shadow copies of the volumes, in the same order as <see cref="Volumes"/>.
+      /// </summary>
+      public ReadOnlyCollection<Guid> SnapshotIds { get; private set; }
+
+      /// <summary>
+      /// Gets the estimated freeze time of the volumes in the shadow copy set.
+      /// </summary>
+      public TimeSpan EstimatedFreezeTime { get; private set; }
+
+      /// <summary>
+      /// Gets the time spent creating the session and gathering the writer metadata.
+      /// </summary>
+      /// <remarks>
+      ///     If the initialization is pipelined, this time overlaps with the creation of the previous shadow copy set, and only
+      ///     <see cref="WaitTime"/> adds to the total time.
+      /// </remarks>
+      public TimeSpan InitializationTime { get; private set; }
+
+      /// <summary>
+      /// Gets the time spent waiting for the initialization of the session to complete.
+      /// </summary>
+      public TimeSpan WaitTime { get; private set; }
+
+      /// <summary>
+      /// Gets the time spent starting the shadow copy set, adding the volumes and preparing the writers.
+      /// </summary>
+      public TimeSpan PreparationTime { get; private set; }
+
+      /// <summary>
+      /// Gets the time spent creating the shadow copies, which includes the time the writers and volumes were frozen.
+      /// </summary>
+      public TimeSpan SnapshotTime { get; private set; }
+
+      #endregion
+   }
+}
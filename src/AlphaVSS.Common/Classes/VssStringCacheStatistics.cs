@@ -0,0 +1,73 @@
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssStringCacheStatistics"/> class contains the counters of the string cache of an <see cref="IVssBackupComponents"/>
+   ///     instance, as returned by <see cref="IVssBackupComponents.StringCacheStatistics"/>.
+   /// </summary>
+   [Serializable]
+   public class VssStringCacheStatistics
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssStringCacheStatistics"/> class.
+      /// </summary>
+      /// <param name="capacity">The maximum number of strings held by the cache.</param>
+      /// <param name="count">The number of strings currently held by the cache.</param>
+      /// <param name="lookups">The number of strings looked up in the cache.</param>
+      /// <param name="hits">The number of lookups that returned a cached string.</param>
+      /// <param name="bytesSaved">The number of bytes of character data that were not allocated because of cache hits.</param>
+      public VssStringCacheStatistics(int capacity, int count, long lookups, long hits, long bytesSaved)
+      {
+         Capacity = capacity;
+         Count = count;
+         Lookups = lookups;
+         Hits = hits;
+         BytesSaved = bytesSaved;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the maximum number of strings held by the cache.
+      /// </summary>
+      public int Capacity { get; private set; }
+
+      /// <summary>
+      /// Gets the number of strings currently held by the cache.
+      /// </summary>
+      public int Count { get; private set; }
+
+      /// <summary>
+      /// Gets the number of native strings that were looked up in the cache while being converted.
+      /// </summary>
+      public long Lookups { get; private set; }
+
+      /// <summary>
+      /// Gets the number of lookups that returned a previously converted string.
+      /// </summary>
+      public long Hits { get; private set; }
+
+      /// <summary>
+      /// Gets the fraction of lookups that returned a previously converted string.
+      /// </summary>
+      /// <value>A value between 0 and 1, or 0 if no lookups have been made.</value>
+      public double HitRate
+      {
+         get
+         {
+            return Lookups == 0 ? 0.0 : (double)Hits / Lookups;
+         }
+      }
+
+      /// <summary>
+      /// Gets the number of bytes of character data that did not have to be allocated because a cached string was returned.
+      /// </summary>
+      /// <remarks>
+      ///     This value does not include the per-object overhead of the strings that were not allocated.
+      /// </remarks>
+      public long BytesSaved { get; private set; }
+
+      #endregion
+   }
+}
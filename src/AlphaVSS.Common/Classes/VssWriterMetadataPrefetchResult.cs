@@ -0,0 +1,56 @@
+using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssWriterMetadataPrefetchResult"/> class contains the writer metadata retrieved by
+   ///     <see cref="IVssBackupComponents.PrefetchWriterMetadata(int)"/>, together with timing information for each writer.
+   /// </summary>
+   public class VssWriterMetadataPrefetchResult
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssWriterMetadataPrefetchResult"/> class.
+      /// </summary>
+      /// <param name="writerMetadata">The fully retrieved metadata of the writers.</param>
+      /// <param name="timings">The timing information for each writer, in the same order as <paramref name="writerMetadata"/>.</param>
+      /// <param name="elapsed">The total time spent retrieving the metadata.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="writerMetadata"/> or <paramref name="timings"/> is <see langword="null"/>.</exception>
+      public VssWriterMetadataPrefetchResult(IList<IVssExamineWriterMetadata> writerMetadata, IList<VssWriterMetadataTiming> timings, TimeSpan elapsed)
+      {
+         if (writerMetadata == null)
+            throw new ArgumentNullException("writerMetadata");
+
+         if (timings == null)
+            throw new ArgumentNullException("timings");
+
+         WriterMetadata = new ReadOnlyCollection<IVssExamineWriterMetadata>(writerMetadata);
+         Timings = new ReadOnlyCollection<VssWriterMetadataTiming>(timings);
+         Elapsed = elapsed;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the metadata of the writers. All components, file descriptors and dependencies of each writer have already been retrieved,
+      /// so accessing them does not involve any further calls to VSS.
+      /// </summary>
+      /// <remarks>
+      ///     The caller is responsible for disposing the <see cref="IVssExamineWriterMetadata"/> instances in this list.
+      /// </remarks>
+      public IList<IVssExamineWriterMetadata> WriterMetadata { get; private set; }
+
+      /// <summary>
+      /// Gets the timing information for each writer, in the same order as <see cref="WriterMetadata"/>.
+      /// </summary>
+      public IList<VssWriterMetadataTiming> Timings { get; private set; }
+
+      /// <summary>
+      /// Gets the total time spent retrieving the metadata of all writers.
+      /// </summary>
+      public TimeSpan Elapsed { get; private set; }
+
+      #endregion
+   }
+}
@@ -0,0 +1,66 @@
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssWriterMetadataTiming"/> class contains the time spent retrieving the complete metadata of a single writer
+   ///     by <see cref="IVssBackupComponents.PrefetchWriterMetadata(int)"/>.
+   /// </summary>
+   [Serializable]
+   public class VssWriterMetadataTiming
+   {
+      /// <summary>
+      /// Initializes a new instance of the <see cref="VssWriterMetadataTiming"/> class.
+      /// </summary>
+      /// <param name="instanceId">The writer instance id.</param>
+      /// <param name="writerId">The writer class id.</param>
+      /// <param name="writerName">Name of the writer.</param>
+      /// <param name="componentCount">The number of components of the writer.</param>
+      /// <param name="fileDescriptorCount">The number of file descriptors retrieved for the writer.</param>
+      /// <param name="elapsed">The time spent retrieving the metadata of the writer.</param>
+      public VssWriterMetadataTiming(Guid instanceId, Guid writerId, string writerName, int componentCount, int fileDescriptorCount, TimeSpan elapsed)
+      {
+         InstanceId = instanceId;
+         WriterId = writerId;
+         WriterName = writerName;
+         ComponentCount = componentCount;
+         FileDescriptorCount = fileDescriptorCount;
+         Elapsed = elapsed;
+      }
+
+      #region Properties
+
+      /// <summary>
+      /// Gets the instance id of the writer.
+      /// </summary>
+      public Guid InstanceId { get; private set; }
+
+      /// <summary>
+      /// Gets the class id of the writer.
+      /// </summary>
+      public Guid WriterId { get; private set; }
+
+      /// <summary>
+      /// Gets the name of the writer.
+      /// </summary>
+      public string WriterName { get; private set; }
+
+      /// <summary>
+      /// Gets the number of components of the writer.
+      /// </summary>
+      public int ComponentCount { get; private set; }
+
+      /// <summary>
+      /// Gets the total number of file descriptors (component files, database files, log files, excluded files and alternate
+      /// location mappings) retrieved for the writer.
+      /// </summary>
+      public int FileDescriptorCount { get; private set; }
+
+      /// <summary>
+      /// Gets the time spent retrieving the metadata of the writer.
+      /// </summary>
+      public TimeSpan Elapsed { get; private set; }
+
+      #endregion
+   }
+}
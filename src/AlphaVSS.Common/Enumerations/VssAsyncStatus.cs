@@ -0,0 +1,15 @@
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>The <see cref="VssAsyncStatus"/> enumeration describes the status of an asynchronous VSS operation as reported by the VSS framework.</summary>
+   public enum VssAsyncStatus
+   {
+      /// <summary><para>The operation is still in progress.</para></summary>
+      Pending = 0,
+      /// <summary><para>The operation has completed successfully.</para></summary>
+      Finished = 1,
+      /// <summary><para>The operation has been canceled.</para></summary>
+      Canceled = 2,
+      /// <summary><para>The operation has failed, or its status could not be determined.</para></summary>
+      Failed = 3,
+   }
+}
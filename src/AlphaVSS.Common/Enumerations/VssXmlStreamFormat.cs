@@ -0,0 +1,16 @@
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="VssXmlStreamFormat"/> enumeration specifies how an XML document, such as a Backup Components Document or
+   ///     a Writer Metadata Document, is encoded when it is written to or read from a stream.
+   /// </summary>
+   public enum VssXmlStreamFormat
+   {
+      /// <summary><para>The document is encoded as UTF-16 (little endian) preceded by a byte order mark, which is the encoding used by VSS itself.</para></summary>
+      Unicode = 0,
+      /// <summary><para>The document is encoded as UTF-8 without a byte order mark.</para></summary>
+      Utf8 = 1,
+      /// <summary><para>The document is encoded as UTF-8 without a byte order mark and compressed using the GZip format.</para></summary>
+      Utf8GZip = 2,
+   }
+}
@@ -13,6 +13,45 @@ namespace Alphaleonis.Win32.Vss
       /// <summary>
       /// Cancels an incomplete asynchronous operation.
       /// </summary>
+      /// <remarks>
+      ///     Cancellation is a request to VSS. If the operation is canceled, the corresponding <c>End</c> method throws an
+      ///     <see cref="OperationCanceledException"/>. Some operations cannot be canceled at all stages, in which case they complete normally.
+      ///     Calling this method on an operation that has already completed has no effect.
+      /// </remarks>
+      /// <exception cref="ObjectDisposedException">The <see cref="IVssAsyncResult"/> has been disposed.</exception>
       void Cancel();
+
+      /// <summary>
+      /// Occurs when the status of the operation changes, and periodically while the operation is pending.
+      /// </summary>
+      /// <remarks>
+      ///     <para>
+      ///         The status of the operation is sampled by a background thread shared by all asynchronous VSS operations. An event is raised
+      ///         whenever a sample reports a status different from the previous one, including the final sample that completes the
+      ///         operation. While the status is unchanged, the event is raised at most once per <see cref="ProgressInterval"/>.
+      ///     </para>
+      ///     <para>
+      ///         The event is raised on a thread pool thread, in the order in which the status was sampled, so the final event may be raised
+      ///         after the operation has been marked as completed. Exceptions thrown by event handlers are ignored.
+      ///     </para>
+      /// </remarks>
+      event EventHandler<VssAsyncProgressEventArgs> ProgressChanged;
+
+      /// <summary>
+      /// Gets or sets the minimum interval between two <see cref="ProgressChanged"/> events reporting an unchanged status.
+      /// </summary>
+      /// <value>The sampling interval. The default is one second.</value>
+      /// <remarks>
+      ///     The status is sampled at the pace of the background polling, so events may be raised somewhat later than this interval
+      ///     prescribes, but never earlier.
+      /// </remarks>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      TimeSpan ProgressInterval { get; set; }
+
+      /// <summary>
+      /// Gets a record of the timing of the operation so far.
+      /// </summary>
+      /// <value>A <see cref="VssAsyncTiming"/> instance describing the start time, the time of the first sample of the status and the completion time of the operation.</value>
+      VssAsyncTiming Timing { get; }
    }
 }
@@ -2,6 +2,7 @@
 
 using System;
 using System.Collections.Generic;
+using System.IO;
 
 namespace Alphaleonis.Win32.Vss
 {
@@ -264,6 +265,22 @@ namespace Alphaleonis.Win32.Vss
       /// <exception cref="VssUnexpectedProviderErrorException">The provider returned an unexpected error code.</exception>        
       Guid AddToSnapshotSet(string volumeName);
 
+      /// <summary>
+      ///     The <see cref="TryAddToSnapshotSet"/> method adds an original volume to the shadow copy set, reporting an error returned by
+      ///     VSS instead of throwing an exception.
+      /// </summary>
+      /// <param name="volumeName">String containing the name of the volume to be shadow copied, in one of the formats accepted by 
+      /// <see cref="AddToSnapshotSet(string, Guid)"/>.</param>
+      /// <param name="providerId">The provider to be used. <see cref="Guid.Empty"/> can be used, in which case the default provider will be used.</param>
+      /// <param name="snapshotId">When this method returns, contains the identifier of the added shadow copy if the operation succeeded,
+      /// or <see cref="Guid.Empty"/> otherwise.</param>
+      /// <returns>
+      ///     A <see cref="VssResult"/> containing the code returned by VSS, for example <see cref="VssError.MaximumNumberOfVolumesReached"/>
+      ///     if the shadow copy set is full.
+      /// </returns>
+      /// <exception cref="ArgumentNullException"><paramref name="volumeName" /> is <see langword="null"/>.</exception>
+      VssResult TryAddToSnapshotSet(string volumeName, Guid providerId, out Guid snapshotId);
+
       /// <summary>
       /// This method causes VSS to generate a <b>BackupComplete</b> event, which signals writers that the backup 
       /// process has completed. 
@@ -345,6 +362,19 @@ namespace Alphaleonis.Win32.Vss
       /// <exception cref="VssUnexpectedProviderErrorException">Unexpected provider error. The error code is logged in the error log.</exception>
       void DeleteSnapshot(Guid snapshotId, bool forceDelete);
 
+      /// <summary>
+      ///     The <see cref="TryDeleteSnapshot"/> method deletes a shadow copy, reporting an error returned by VSS instead of throwing 
+      ///     an exception.
+      /// </summary>
+      /// <param name="snapshotId">Identifier of the shadow copy to be deleted.</param>
+      /// <param name="forceDelete">If the value of this parameter is <see langword="true"/>, the provider will do everything possible to delete the shadow copy. If it is <see langword="false"/>, no additional effort will be made.</param>
+      /// <returns>
+      ///     A <see cref="VssResult"/> containing the code returned by VSS, for example <see cref="VssError.ObjectNotFound"/> if the
+      ///     shadow copy does not exist.
+      /// </returns>
+      /// <seealso cref="DeleteSnapshot"/>
+      VssResult TryDeleteSnapshot(Guid snapshotId, bool forceDelete);
+
       /// <summary>
       ///		The <c>DeleteSnapshotSet</c> method deletes a shadow copy set including any shadow copies in that set.
       /// </summary>
@@ -674,6 +704,20 @@ namespace Alphaleonis.Win32.Vss
       /// <exception cref="VssUnexpectedProviderErrorException">Unexpected provider error. The error code is logged in the error log.</exception>
       VssSnapshotProperties GetSnapshotProperties(Guid snapshotId);
 
+      /// <summary>
+      ///     The <see cref="TryGetSnapshotProperties"/> method gets the properties of the specified shadow copy, reporting an error 
+      ///     returned by VSS instead of throwing an exception.
+      /// </summary>
+      /// <param name="snapshotId">The identifier of the shadow copy.</param>
+      /// <param name="properties">When this method returns, contains the properties of the shadow copy if the operation succeeded, 
+      /// or <see langword="null"/> otherwise.</param>
+      /// <returns>
+      ///     A <see cref="VssResult"/> containing the code returned by VSS, for example <see cref="VssError.ObjectNotFound"/> if the
+      ///     shadow copy does not exist.
+      /// </returns>
+      /// <seealso cref="GetSnapshotProperties"/>
+      VssResult TryGetSnapshotProperties(Guid snapshotId, out VssSnapshotProperties properties);
+
       /// <summary>
       ///     A read-only list containing information about the components of each writer that has been stored in a requester's Backup Components Document.
       /// </summary>
@@ -750,6 +794,51 @@ namespace Alphaleonis.Win32.Vss
       /// <exception cref="VssObjectNotFoundException">The specified shadow copy does not exist.</exception>
       IList<IVssExamineWriterMetadata> WriterMetadata { get; }
 
+      /// <summary>
+      ///     Retrieves the complete metadata of all writers, using one worker thread per processor.
+      /// </summary>
+      /// <returns>A <see cref="VssWriterMetadataPrefetchResult"/> containing the metadata of the writers and the time spent on each writer.</returns>
+      /// <remarks>
+      ///     This is equivalent to calling <see cref="PrefetchWriterMetadata(int)"/> with <see cref="Environment.ProcessorCount"/> as the
+      ///     maximum degree of parallelism.
+      /// </remarks>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>
+      /// <exception cref="VssInvalidXmlDocumentException">The XML document is not valid. Check the event log for details.</exception>
+      VssWriterMetadataPrefetchResult PrefetchWriterMetadata();
+
+      /// <summary>
+      ///     Retrieves the complete metadata of all writers, distributing the writers across a bounded number of worker threads.
+      /// </summary>
+      /// <param name="maxDegreeOfParallelism">The maximum number of worker threads used to retrieve the metadata.</param>
+      /// <returns>A <see cref="VssWriterMetadataPrefetchResult"/> containing the metadata of the writers and the time spent on each writer.</returns>
+      /// <remarks>
+      /// 	<para>
+      /// 		The <see cref="IVssExamineWriterMetadata"/> instances available from <see cref="WriterMetadata"/> retrieve their components,
+      /// 		and the files and dependencies of each component, from VSS the first time they are accessed. For writers with many components
+      /// 		this results in a large number of calls that are made serially by the consumer of the metadata.
+      /// 	</para>
+      /// 	<para>
+      /// 		This method instead retrieves all of this information up front: the components, file descriptors, dependencies, excluded files,
+      /// 		restore method and alternate location mappings of every writer. The writers are processed in parallel on up to
+      /// 		<paramref name="maxDegreeOfParallelism"/> multithreaded apartment (MTA) threads, and the time spent on each writer is recorded
+      /// 		in <see cref="VssWriterMetadataPrefetchResult.Timings"/>. Once retrieved, the metadata does not change, and reading it involves
+      /// 		no further calls to VSS.
+      /// 	</para>
+      /// 	<para>
+      /// 		The caller should run in a multithreaded apartment, and is responsible for disposing the returned <see cref="IVssExamineWriterMetadata"/> instances.
+      /// 		A requester must call the asynchronous operation <see cref="IVssBackupComponents.GatherWriterMetadata"/> and wait for it
+      /// 		to complete prior to calling this method.
+      /// 	</para>
+      /// </remarks>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="maxDegreeOfParallelism"/> is less than one.</exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>
+      /// <exception cref="VssInvalidXmlDocumentException">The XML document is not valid. Check the event log for details.</exception>
+      VssWriterMetadataPrefetchResult PrefetchWriterMetadata(int maxDegreeOfParallelism);
+
       /// <summary>
       ///     A read-only list containing the status of the writers.
       /// </summary>
@@ -770,6 +859,31 @@ namespace Alphaleonis.Win32.Vss
       /// <exception cref="VssObjectNotFoundException">The specified shadow copy does not exist.</exception>
       IList<VssWriterStatusInfo> WriterStatus { get; }
 
+      /// <summary>
+      ///     Retrieves the status of all writers in a single pass.
+      /// </summary>
+      /// <returns>
+      ///     A read-only list containing a <see cref="VssWriterStatusInfo"/> instance for each writer that returned its status. Unlike
+      ///     <see cref="WriterStatus"/>, the returned list is a copy that remains valid after the <see cref="IVssBackupComponents"/> from
+      ///     which it was obtained has been disposed.
+      /// </returns>
+      /// <remarks>
+      ///     <para>
+      ///         A requester must call the asynchronous operation <see cref="IVssBackupComponents.GatherWriterStatus"/> and wait for it to
+      ///         complete prior to calling <see cref="QueryWriterStatus"/>.
+      ///     </para>
+      ///     <para>
+      ///         The number of writers is queried only once, so retrieving the status of <c>N</c> writers takes <c>N + 1</c> calls to VSS,
+      ///         whereas enumerating <see cref="WriterStatus"/> queries the number of writers again for every element. Prefer this method
+      ///         when the status of every writer is inspected.
+      ///     </para>
+      /// </remarks>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>
+      /// <exception cref="VssObjectNotFoundException">The specified shadow copy does not exist.</exception>
+      IList<VssWriterStatusInfo> QueryWriterStatus();
+
       /// <summary>
       ///     The ImportSnapshots method imports shadow copies transported from a different machine.
       /// </summary>
@@ -828,7 +942,7 @@ namespace Alphaleonis.Win32.Vss
       /// <param name="xml">
       /// 	<para>
       /// 		During imports of transported shadow copies, this parameter must be the original document generated when creating the saved 
-      /// 		shadow copy and saved using <see cref="SaveAsXml"/>. 
+      /// 		shadow copy and saved using <see cref="SaveAsXml()"/>. 
       /// 	</para>
       /// 	<para>
       /// 		This parameter may be <see langword="null"/>
@@ -836,7 +950,7 @@ namespace Alphaleonis.Win32.Vss
       /// </param>
       /// <remarks>
       /// 	The XML document supplied to this method initializes the <see cref="IVssBackupComponents"/> object with metadata previously stored by 
-      /// 	a call to <see cref="SaveAsXml"/>. Users should not tamper with this metadata document.
+      /// 	a call to <see cref="SaveAsXml()"/>. Users should not tamper with this metadata document.
       /// </remarks>
       /// <exception cref="UnauthorizedAccessException">The caller does not have sufficient backup privileges or is not an administrator.</exception>
       /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
@@ -846,15 +960,15 @@ namespace Alphaleonis.Win32.Vss
       void InitializeForBackup(string xml);
 
       /// <summary>
-      ///		The <see cref="InitializeForRestore"/> method initializes the IIVssBackupComponents interface in preparation for a restore operation.
+      ///		The <see cref="InitializeForRestore(string)"/> method initializes the IIVssBackupComponents interface in preparation for a restore operation.
       /// </summary>
       /// <param name="xml">
       ///		XML string containing the Backup Components Document generated by a backup operation and saved by 
-      ///		<see cref="SaveAsXml"/>.
+      ///		<see cref="SaveAsXml()"/>.
       /// </param>
       /// <remarks>
       /// 	The XML document supplied to this method initializes the <see cref="IVssBackupComponents"/> object with metadata previously stored by a call to 
-      /// 	<see cref="SaveAsXml"/>. Users should not tamper with this metadata document.
+      /// 	<see cref="SaveAsXml()"/>. Users should not tamper with this metadata document.
       /// </remarks>
       /// <exception cref="ArgumentNullException"><paramref name="xml" /> is <see langword="null"/></exception>
       /// <exception cref="UnauthorizedAccessException">The caller does not have sufficient backup privileges or is not an administrator.</exception>
@@ -864,6 +978,36 @@ namespace Alphaleonis.Win32.Vss
       /// <exception cref="VssInvalidXmlDocumentException">The load operation of the specified XML document failed.</exception>
       void InitializeForRestore(string xml);
 
+      /// <summary>
+      ///		Initializes the <see cref="IVssBackupComponents"/> object in preparation for a restore operation, reading the Backup Components Document
+      ///		from a stream.
+      /// </summary>
+      /// <param name="stream">
+      ///		The stream to read the Backup Components Document from, as written by <see cref="SaveAsXml(Stream, VssXmlStreamFormat)"/>. The document
+      ///		is read from the current position to the end of the stream. The stream is not closed by this method.
+      /// </param>
+      /// <param name="format">The format in which the document was written to <paramref name="stream"/>.</param>
+      /// <remarks>
+      /// 	<para>
+      /// 		This method is equivalent to <see cref="InitializeForRestore(string)"/>, but reads the document in chunks directly into the
+      /// 		buffer passed to VSS instead of requiring the entire document to be loaded into a <see cref="String"/> first.
+      /// 	</para>
+      /// 	<para>
+      /// 		When <paramref name="format"/> is <see cref="VssXmlStreamFormat.Unicode"/> or <see cref="VssXmlStreamFormat.Utf8"/>, a byte order mark
+      /// 		at the start of the document takes precedence over the specified format.
+      /// 	</para>
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="stream" /> is <see langword="null"/></exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="format" /> is not a valid <see cref="VssXmlStreamFormat"/> value.</exception>
+      /// <exception cref="IOException">An I/O error occurred while reading from <paramref name="stream"/>.</exception>
+      /// <exception cref="InvalidDataException"><paramref name="format" /> is <see cref="VssXmlStreamFormat.Utf8GZip"/> and the stream does not contain valid GZip data.</exception>
+      /// <exception cref="UnauthorizedAccessException">The caller does not have sufficient backup privileges or is not an administrator.</exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>		
+      /// <exception cref="VssInvalidXmlDocumentException">The load operation of the specified XML document failed.</exception>
+      void InitializeForRestore(Stream stream, VssXmlStreamFormat format);
+
       /// <summary>
       /// 	The <c>IsVolumeSupported</c> method determines whether the specified provider supports shadow copies on the specified volume.
       /// </summary>
@@ -926,6 +1070,37 @@ namespace Alphaleonis.Win32.Vss
       /// <exception cref="VssObjectNotFoundException">The specified volume was not found or was not available.</exception>
       bool IsVolumeSupported(string volumeName);
 
+      /// <summary>
+      ///     The <see cref="TryIsVolumeSupported(string, Guid, out bool)"/> method determines whether the specified provider supports 
+      ///     shadow copies on the specified volume, reporting an error returned by VSS instead of throwing an exception.
+      /// </summary>
+      /// <param name="volumeName">Name of the volume, in one of the formats accepted by <see cref="IsVolumeSupported(string, Guid)"/>.</param>
+      /// <param name="providerId">
+      /// 	Provider identifier. If the value is <see cref="Guid.Empty"/>, the method checks whether any provider supports the volume.
+      /// </param>
+      /// <param name="supported">When this method returns, contains <see langword="true"/> if the operation succeeded and shadow copies 
+      /// are supported on the specified volume; otherwise, <see langword="false"/>.</param>
+      /// <returns>
+      ///     A <see cref="VssResult"/> containing the code returned by VSS, for example <see cref="VssError.ObjectNotFound"/> if the
+      ///     volume was not found or was not available.
+      /// </returns>
+      /// <exception cref="ArgumentNullException"><paramref name="volumeName" /> is <see langword="null"/>.</exception>
+      VssResult TryIsVolumeSupported(string volumeName, Guid providerId, out bool supported);
+
+      /// <summary>
+      ///     The <see cref="TryIsVolumeSupported(string, out bool)"/> method determines whether any provider supports shadow copies on 
+      ///     the specified volume, reporting an error returned by VSS instead of throwing an exception.
+      /// </summary>
+      /// <param name="volumeName">Name of the volume, in one of the formats accepted by <see cref="IsVolumeSupported(string)"/>.</param>
+      /// <param name="supported">When this method returns, contains <see langword="true"/> if the operation succeeded and shadow copies 
+      /// are supported on the specified volume; otherwise, <see langword="false"/>.</param>
+      /// <returns>
+      ///     A <see cref="VssResult"/> containing the code returned by VSS, for example <see cref="VssError.ObjectNotFound"/> if the
+      ///     volume was not found or was not available.
+      /// </returns>
+      /// <exception cref="ArgumentNullException"><paramref name="volumeName" /> is <see langword="null"/>.</exception>
+      VssResult TryIsVolumeSupported(string volumeName, out bool supported);
+
       /// <summary>
       ///	The <see cref="PostRestore"/> method will cause VSS to generate a <c>PostRestore</c> event, signaling writers that the current 
       ///	restore operation has finished.
@@ -1097,6 +1272,86 @@ namespace Alphaleonis.Win32.Vss
       /// <exception cref="VssUnexpectedProviderErrorException">Unexpected provider error. The error code is logged in the error log.</exception>		
       IEnumerable<VssSnapshotProperties> QuerySnapshots();
 
+      /// <summary>
+      ///     The <see cref="EnumerateSnapshots"/> method queries the completed shadow copies in the system that reside in the current context,
+      ///     converting each shadow copy only as the enumeration advances.
+      /// </summary>
+      /// <returns>
+      ///     A lazily evaluated sequence of <see cref="VssSnapshotProperties"/> objects representing the requested information. Each call to
+      ///     <see cref="IEnumerable{T}.GetEnumerator"/> issues a new query.
+      /// </returns>
+      /// <remarks>
+      ///     <para>
+      ///         Unlike <see cref="QuerySnapshots"/>, this method does not build a list of all shadow copies before returning. The underlying
+      ///         VSS enumerator is kept open while the sequence is being enumerated, and is released when the enumerator is disposed, which
+      ///         happens automatically when a <c>foreach</c> loop completes or is exited early. This keeps memory usage independent of the
+      ///         number of shadow copies, and makes it cheap to stop after the first match.
+      ///     </para>
+      ///     <para>
+      ///         The same restrictions as for <see cref="QuerySnapshots"/> apply. Errors reported by VSS are thrown when the sequence
+      ///         is enumerated rather than when this method is called.
+      ///     </para>
+      /// </remarks>
+      /// <exception cref="ArgumentException">One of the parameter values is not valid.</exception>
+      /// <exception cref="UnauthorizedAccessException">The caller is not an administrator or a backup operator.</exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>
+      /// <exception cref="VssObjectNotFoundException">The queried object is not found.</exception>
+      /// <exception cref="VssProviderVetoException">Expected provider error. The provider logged the error in the event log.</exception>
+      /// <exception cref="VssUnexpectedProviderErrorException">Unexpected provider error. The error code is logged in the error log.</exception>
+      IEnumerable<VssSnapshotProperties> EnumerateSnapshots();
+
+      /// <summary>
+      ///     The <see cref="QuerySnapshots(VssSnapshotFilter)"/> method queries the completed shadow copies in the system that reside in the current context
+      ///     and match the specified filter.
+      /// </summary>
+      /// <param name="filter">The criteria that the returned shadow copies must match.</param>
+      /// <returns>A list of <see cref="VssSnapshotProperties"/> objects representing the shadow copies matching <paramref name="filter"/>.</returns>
+      /// <remarks>
+      ///     <para>
+      ///         The filter is evaluated on the native shadow copy properties as they are returned from VSS. Shadow copies that do not
+      ///         match are released immediately and never converted to managed objects, which makes this method considerably cheaper than
+      ///         filtering the result of <see cref="QuerySnapshots()"/> on systems with a large number of shadow copies.
+      ///     </para>
+      ///     <para>
+      ///         The same restrictions as for <see cref="QuerySnapshots()"/> apply.
+      ///     </para>
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="filter"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException">One of the parameter values is not valid.</exception>
+      /// <exception cref="UnauthorizedAccessException">The caller is not an administrator or a backup operator.</exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>
+      /// <exception cref="VssObjectNotFoundException">The queried object is not found.</exception>
+      /// <exception cref="VssProviderVetoException">Expected provider error. The provider logged the error in the event log.</exception>
+      /// <exception cref="VssUnexpectedProviderErrorException">Unexpected provider error. The error code is logged in the error log.</exception>
+      IEnumerable<VssSnapshotProperties> QuerySnapshots(VssSnapshotFilter filter);
+
+      /// <summary>
+      ///     The <see cref="EnumerateSnapshots(VssSnapshotFilter)"/> method queries the completed shadow copies in the system that reside in the current
+      ///     context and match the specified filter, converting each matching shadow copy only as the enumeration advances.
+      /// </summary>
+      /// <param name="filter">The criteria that the returned shadow copies must match.</param>
+      /// <returns>
+      ///     A lazily evaluated sequence of <see cref="VssSnapshotProperties"/> objects representing the shadow copies matching <paramref name="filter"/>.
+      /// </returns>
+      /// <remarks>
+      ///     This method combines the streaming behavior of <see cref="EnumerateSnapshots()"/> with the native filtering of
+      ///     <see cref="QuerySnapshots(VssSnapshotFilter)"/>. The filter is captured each time an enumeration is started.
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="filter"/> is <see langword="null"/>.</exception>
+      /// <exception cref="ArgumentException">One of the parameter values is not valid.</exception>
+      /// <exception cref="UnauthorizedAccessException">The caller is not an administrator or a backup operator.</exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>
+      /// <exception cref="VssObjectNotFoundException">The queried object is not found.</exception>
+      /// <exception cref="VssProviderVetoException">Expected provider error. The provider logged the error in the event log.</exception>
+      /// <exception cref="VssUnexpectedProviderErrorException">Unexpected provider error. The error code is logged in the error log.</exception>
+      IEnumerable<VssSnapshotProperties> EnumerateSnapshots(VssSnapshotFilter filter);
+
       /// <summary>
       /// 	The <see cref="QueryProviders"/> method queries providers on the system. 
       /// 	The method can be called only during backup operations.
@@ -1118,6 +1373,54 @@ namespace Alphaleonis.Win32.Vss
       /// <exception cref="VssUnexpectedProviderErrorException">Unexpected provider error. The error code is logged in the error log.</exception>
       IEnumerable<VssProviderProperties> QueryProviders();
 
+      /// <summary>
+      ///     Gets or sets the number of objects requested from VSS in each round trip when enumerating the results of
+      ///     <see cref="QuerySnapshots"/> and <see cref="QueryProviders"/>.
+      /// </summary>
+      /// <value>
+      ///     The maximum number of objects fetched per call to the underlying enumerator, or zero to let the
+      ///     implementation choose the batch size. The default value is zero.
+      /// </value>
+      /// <remarks>
+      ///     When set to zero, the first batch is small and the batch size grows for as long as the enumerator keeps
+      ///     returning full batches, which keeps the number of calls low on systems with a large number of shadow copies
+      ///     without over-allocating for small result sets. Values larger than the maximum supported batch size are
+      ///     silently reduced to that maximum.
+      /// </remarks>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      int EnumerationBatchSize { get; set; }
+
+      /// <summary>
+      ///     Gets or sets the maximum number of strings held by the string cache used when converting the names and paths
+      ///     returned by VSS to managed strings.
+      /// </summary>
+      /// <value>
+      ///     The maximum number of cached strings, or zero to disable the cache. The default value is zero.
+      /// </value>
+      /// <remarks>
+      ///     <para>
+      ///         Writer metadata, writer components and shadow copy properties repeat the same logical paths, component names, writer
+      ///         names and volume names many times. With the cache enabled, these are converted to a single shared <see cref="String"/>
+      ///         instance per distinct value instead of a new instance each time they are retrieved. Only objects retrieved after the
+      ///         cache has been enabled use it.
+      ///     </para>
+      ///     <para>
+      ///         The capacity is rounded up to a power of two. When the cache is full, a new string replaces a previously cached string
+      ///         with the same hash slot. Setting this property discards the current cache and its statistics. The cache is released
+      ///         when this instance is disposed.
+      ///     </para>
+      /// </remarks>
+      /// <exception cref="ArgumentOutOfRangeException">The value is negative.</exception>
+      int StringCacheCapacity { get; set; }
+
+      /// <summary>
+      ///     Gets the counters of the string cache enabled by <see cref="StringCacheCapacity"/>.
+      /// </summary>
+      /// <value>
+      ///     The statistics of the string cache, or <see langword="null"/> if the cache is disabled.
+      /// </value>
+      VssStringCacheStatistics StringCacheStatistics { get; }
+
       /// <summary>
       /// The <see cref="BeginQueryRevertStatus"/> method begins an asynchronous operation to determine the status of the revert operation. The 
       /// returned <see cref="IVssAsyncResult"/> can be used to determine the outcome of the operation.
@@ -1198,15 +1501,40 @@ namespace Alphaleonis.Win32.Vss
       /// 	<para>For a typical backup operation, SaveAsXml should not be called until after both writers and the requester are finished modifying the Backup Components Document.</para>
       /// 	<para>Writers can continue to modify the Backup Components Document until their successful return from handling the PostSnapshot event (CVssWriter::OnPostSnapshot), or equivalently upon the completion of <see cref="DoSnapshotSet"/>.</para>
       /// 	<para>Requesters will need to continue to modify the Backup Components Document as the backup progresses. In particular, a requester will store a component-by-component record of the success or failure of the backup through calls to the <see cref="SetBackupSucceeded"/> method.</para>
-      /// 	<para>Once the requester has finished modifying the Backup Components Document, the requester should use <see cref="SaveAsXml"/> to save a copy of the document to the backup media.</para>
+      /// 	<para>Once the requester has finished modifying the Backup Components Document, the requester should use <see cref="SaveAsXml()"/> to save a copy of the document to the backup media.</para>
       /// 	<para>A Backup Components Document can be saved at earlier points in the life cycle of a backup operation, for instance, to support the generation of transportable shadow copies to be handled on remote machines.</para>
-      /// 	<para>However, <see cref="SaveAsXml"/> should never be called prior to <see cref="PrepareForBackup"/>, because the Backup Components Document will not have been filled by the requester and the writers.</para>
+      /// 	<para>However, <see cref="SaveAsXml()"/> should never be called prior to <see cref="PrepareForBackup"/>, because the Backup Components Document will not have been filled by the requester and the writers.</para>
       /// </remarks>
       /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
       /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
       /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>		
       string SaveAsXml();
 
+      /// <summary>
+      /// 	Saves the Backup Components Document containing a requester's state information to a stream.
+      /// </summary>
+      /// <param name="stream">The stream to write the Backup Components Document to. The stream is not closed by this method.</param>
+      /// <param name="format">The format in which to write the document.</param>
+      /// <remarks>
+      /// 	<para>
+      /// 		This method is equivalent to <see cref="SaveAsXml()"/>, but encodes the document returned by VSS in chunks directly into
+      /// 		<paramref name="stream"/>, without creating a <see cref="String"/> holding the entire document. This considerably reduces
+      /// 		the memory used when saving the large documents produced by backups of many components.
+      /// 	</para>
+      /// 	<para>
+      /// 		A document written using <see cref="VssXmlStreamFormat.Unicode"/> is identical to a file written by passing the result of
+      /// 		<see cref="SaveAsXml()"/> to <see cref="File.WriteAllText(string, string, System.Text.Encoding)"/> with <see cref="System.Text.Encoding.Unicode"/>.
+      /// 	</para>
+      /// 	<para>The same restrictions on when the document may be saved apply as for <see cref="SaveAsXml()"/>.</para>
+      /// </remarks>
+      /// <exception cref="ArgumentNullException"><paramref name="stream" /> is <see langword="null"/></exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="format" /> is not a valid <see cref="VssXmlStreamFormat"/> value.</exception>
+      /// <exception cref="IOException">An I/O error occurred while writing to <paramref name="stream"/>.</exception>
+      /// <exception cref="OutOfMemoryException">Out of memory or other system resources.</exception>
+      /// <exception cref="SystemException">Unexpected VSS system error. The error code is logged in the event log.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>		
+      void SaveAsXml(Stream stream, VssXmlStreamFormat format);
+
       /// <summary>
       ///		The <b>SetAdditionalRestores</b> method is used by a requester during incremental or differential restore operations to indicate 
       ///     to writers that a given component will require additional restore operations to completely retrieve it.
@@ -2137,7 +2465,7 @@ namespace Alphaleonis.Win32.Vss
       ///			<item><description>There is no hardware provider that supports the operation.</description></item>
       ///			<item><description>The requester did not successfully add any volumes to the recovery set.</description></item>
       ///			<item><description>The method was called in WinPE or in Safe mode.</description></item>
-      ///			<item><description>he caller did not call the <see cref="InitializeForRestore"/> method before calling this method.</description></item>
+      ///			<item><description>he caller did not call the <see cref="InitializeForRestore(string)"/> method before calling this method.</description></item>
       ///		</list>
       /// </exception>
       /// <exception cref="VssLegacyProviderException">This version of the hardware provider does not support this operation.</exception>
@@ -2193,7 +2521,7 @@ namespace Alphaleonis.Win32.Vss
       ///			<item><description>There is no hardware provider that supports the operation.</description></item>
       ///			<item><description>The requester did not successfully add any volumes to the recovery set.</description></item>
       ///			<item><description>The method was called in WinPE or in Safe mode.</description></item>
-      ///			<item><description>he caller did not call the <see cref="InitializeForRestore"/> method before calling this method.</description></item>
+      ///			<item><description>he caller did not call the <see cref="InitializeForRestore(string)"/> method before calling this method.</description></item>
       ///		</list>
       /// </exception>
       /// <exception cref="VssLegacyProviderException">This version of the hardware provider does not support this operation.</exception>
@@ -329,6 +329,46 @@ namespace Alphaleonis.Win32.Vss
 
       #endregion
 
+      #region Snapshot
+
+      /// <summary>
+      ///     Reads the values of all scalar properties and the number of elements of all lists of this component in a single pass.
+      /// </summary>
+      /// <returns>
+      ///     An immutable <see cref="VssComponentSnapshot"/> containing the values of the properties of this component.
+      /// </returns>
+      /// <remarks>
+      ///     <para>
+      ///         Every property of <see cref="IVssComponent"/> makes a separate call to VSS each time it is read, and
+      ///         <see cref="RollForwardType"/> and <see cref="RollForwardRestorePoint"/> each make the same call. The values are read
+      ///         on the first call to this method; subsequent calls return the same instance without calling VSS.
+      ///     </para>
+      ///     <para>
+      ///         The values are read again on the next call after they may have changed, that is after one of the setters of this
+      ///         component has been called, or after the backup components document this component was obtained from has been
+      ///         modified, for instance by <see cref="IVssBackupComponents.SetBackupSucceeded"/> or
+      ///         <see cref="IVssBackupComponents.SetBackupOptions"/>.
+      ///     </para>
+      ///     <para>
+      ///         Unlike <see cref="Failure"/>, reading the snapshot does not throw if the failure information of the component cannot be
+      ///         read. <see cref="VssComponentSnapshot.Failure"/> is <see langword="null"/> instead.
+      ///     </para>
+      /// </remarks>
+      /// <exception cref="ObjectDisposedException">The component has been disposed.</exception>
+      /// <exception cref="VssBadStateException">The backup components object is not initialized, this method has been called during a restore operation, or this method has not been called within the correct sequence.</exception>
+      VssComponentSnapshot GetSnapshot();
+
+      /// <summary>
+      ///     Gets the number of calls to VSS that were avoided by reading the values of this component through
+      ///     <see cref="GetSnapshot"/> rather than through the individual properties.
+      /// </summary>
+      /// <value>
+      ///     The number of calls to VSS saved by <see cref="GetSnapshot"/>, or 0 if it has not been called.
+      /// </value>
+      long SnapshotCallsSaved { get; }
+
+      #endregion
+
 #if false // These methods may only be called by writers, only supporting requesters for now so these are not included.
         void SetPrepareForBackupFailureMsg(string message);
         void SetPostSnapshotFailureMsg(string message);
@@ -1,6 +1,7 @@
 
 using System;
 using System.Collections.Generic;
+using System.IO;
 
 namespace Alphaleonis.Win32.Vss
 {
@@ -15,7 +16,7 @@ namespace Alphaleonis.Win32.Vss
    public interface IVssExamineWriterMetadata : IDisposable
    {
       /// <summary>
-      /// The <see cref="LoadFromXml"/> method loads an XML document that contains a writer's metadata document into a
+      /// The <see cref="LoadFromXml(string)"/> method loads an XML document that contains a writer's metadata document into a
       /// <see cref="IVssExamineWriterMetadata"/> instance.
       /// </summary>
       /// <param name="xml">String that contains an XML document that represents a writer's metadata document.</param>
@@ -24,12 +25,36 @@ namespace Alphaleonis.Win32.Vss
       bool LoadFromXml(string xml);
 
       /// <summary>
-      /// The <see cref="SaveAsXml"/> method saves the Writer Metadata Document that contains a writer's state information to a specified string. 
+      /// Loads a writer's metadata document from a stream into a <see cref="IVssExamineWriterMetadata"/> instance.
+      /// </summary>
+      /// <param name="stream">The stream to read the document from, as written by <see cref="SaveAsXml(Stream, VssXmlStreamFormat)"/>.
+      /// The document is read from the current position to the end of the stream. The stream is not closed by this method.</param>
+      /// <param name="format">The format in which the document was written to <paramref name="stream"/>.</param>
+      /// <returns><see langword="true" /> if the XML document was successfully loaded, or <see langword="false"/> if the XML document could not
+      /// be loaded.</returns>
+      /// <exception cref="ArgumentNullException"><paramref name="stream" /> is <see langword="null"/></exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="format" /> is not a valid <see cref="VssXmlStreamFormat"/> value.</exception>
+      /// <exception cref="IOException">An I/O error occurred while reading from <paramref name="stream"/>.</exception>
+      bool LoadFromXml(Stream stream, VssXmlStreamFormat format);
+
+      /// <summary>
+      /// The <see cref="SaveAsXml()"/> method saves the Writer Metadata Document that contains a writer's state information to a specified string. 
       /// This string can be saved as part of a backup operation.
       /// </summary>
       /// <returns>The Writer Metadata Document that contains a writer's state information.</returns>
       string SaveAsXml();
 
+      /// <summary>
+      /// Saves the Writer Metadata Document that contains a writer's state information to a stream, without creating a
+      /// <see cref="String"/> holding the entire document.
+      /// </summary>
+      /// <param name="stream">The stream to write the document to. The stream is not closed by this method.</param>
+      /// <param name="format">The format in which to write the document.</param>
+      /// <exception cref="ArgumentNullException"><paramref name="stream" /> is <see langword="null"/></exception>
+      /// <exception cref="ArgumentOutOfRangeException"><paramref name="format" /> is not a valid <see cref="VssXmlStreamFormat"/> value.</exception>
+      /// <exception cref="IOException">An I/O error occurred while writing to <paramref name="stream"/>.</exception>
+      void SaveAsXml(Stream stream, VssXmlStreamFormat format);
+
       /// <summary>
       /// The <see cref="BackupSchema"/> is examined by a requester to determine from the 
       /// Writer Metadata Document the types of backup operations that a given writer can participate in.
@@ -114,7 +114,7 @@ namespace Alphaleonis.Win32.Vss
       /// <param name="xml">A string containing a Writer Metadata Document with which to initialize the returned <see cref="IVssExamineWriterMetadata"/> object.</param>
       /// <remarks>
       /// 	This method attempts to load the returned <see cref="IVssExamineWriterMetadata"/> object with metadata previously stored by a call to 
-      /// 	<see cref="IVssExamineWriterMetadata.SaveAsXml"/>. Users should not tamper with this metadata document.
+      /// 	<see cref="IVssExamineWriterMetadata.SaveAsXml()"/>. Users should not tamper with this metadata document.
       /// </remarks>
       /// <returns>a <see cref="IVssExamineWriterMetadata"/> instance initialized with the specified XML document.</returns>
       IVssExamineWriterMetadata CreateVssExamineWriterMetadata(string xml);
@@ -0,0 +1,71 @@
+using System;
+
+namespace Alphaleonis.Win32.Vss
+{
+   /// <summary>
+   ///     The <see cref="IVssSnapshotSetSession"/> interface represents the backup session used by a <see cref="VssSnapshotOrchestrator"/>
+   ///     to create a single shadow copy set.
+   /// </summary>
+   /// <remarks>
+   ///     <para>
+   ///         Each shadow copy set created by a <see cref="VssSnapshotOrchestrator"/> is created by its own session, since a backup
+   ///         components object can only create a single shadow copy set. The session must be kept alive for as long as the shadow
+   ///         copies are used, since disposing it deletes any non-persistent shadow copies it created.
+   ///     </para>
+   ///     <para>
+   ///         <see cref="VssBackupComponentsSnapshotSetSession"/> implements this interface on top of an <see cref="IVssBackupComponents"/>
+   ///         instance. Other implementations may be used to test the orchestration against a simulated backend.
+   ///     </para>
+   ///     <para>
+   ///         The methods of a session are always called in the order in which they are declared, except <see cref="AbortBackup"/>, which
+   ///         may be called after any of them. They are never called concurrently.
+   ///     </para>
+   ///     <para>
+   ///         A session is created, and all of its methods except <see cref="Initialize"/> are called, on the thread that called
+   ///         <see cref="VssSnapshotOrchestrator.CreateSnapshots(System.Collections.Generic.IEnumerable{string})"/>. If
+   ///         <see cref="VssSnapshotOrchestrator.PipelineInitialization"/> is enabled and that thread belongs to the multithreaded
+   ///         apartment, <see cref="Initialize"/> may be called on a thread pool thread, which also belongs to the multithreaded
+   ///         apartment. A session created on a single-threaded apartment thread is always initialized on that thread.
+   ///     </para>
+   /// </remarks>
+   public interface IVssSnapshotSetSession : IDisposable
+   {
+      /// <summary>
+      /// Initializes the session for backup and gathers the writer metadata.
+      /// </summary>
+      void Initialize();
+
+      /// <summary>
+      /// Creates a new, empty shadow copy set.
+      /// </summary>
+      /// <returns>The identifier of the created shadow copy set.</returns>
+      Guid StartSnapshotSet();
+
+      /// <summary>
+      /// Adds an original volume to the shadow copy set.
+      /// </summary>
+      /// <param name="volumeName">The name of the volume to be shadow copied.</param>
+      /// <param name="providerId">The provider to be used, or <see cref="Guid.Empty"/> to use the default provider.</param>
+      /// <returns>The identifier of the added shadow copy.</returns>
+      /// <exception cref="VssMaximumNumberOfVolumesReachedException">
+      ///     The shadow copy set is full. The orchestrator splits the set when this exception is thrown for any volume but the first.
+      /// </exception>
+      /// <exception cref="VssException">The volume could not be added, as reported by <see cref="IVssBackupComponents.AddToSnapshotSet(string, Guid)"/>.</exception>
+      Guid AddToSnapshotSet(string volumeName, Guid providerId);
+
+      /// <summary>
+      /// Notifies the writers to prepare for the backup.
+      /// </summary>
+      void PrepareForBackup();
+
+      /// <summary>
+      /// Creates the shadow copies of the volumes in the shadow copy set.
+      /// </summary>
+      void DoSnapshotSet();
+
+      /// <summary>
+      /// Aborts the backup, deleting any shadow copies created by the session.
+      /// </summary>
+      void AbortBackup();
+   }
+}
@@ -0,0 +1,11 @@
+#include "Stdafx.h"
+
+using namespace System;
+using namespace System::Reflection;
+using namespace System::Runtime::InteropServices;
+
+[assembly:AssemblyTitleAttribute("AlphaVSS.Platform.Tests")];
+[assembly:AssemblyDescriptionAttribute("Unit tests for the platform specific part of AlphaVSS")];
+[assembly:AssemblyCultureAttribute("")];
+
+[assembly:ComVisible(false)];
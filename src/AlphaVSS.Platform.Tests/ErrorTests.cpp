@@ -0,0 +1,104 @@
+#include "Stdafx.h"
+
+using namespace System;
+using namespace System::Diagnostics;
+using namespace Microsoft::VisualStudio::TestTools::UnitTesting;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   namespace
+   {
+      int CallCount = 0;
+
+      // Stands in for a call to VSS, failing every other call like IsVolumeSupported does on a machine
+      // where half of the volumes queried are not supported.
+      __declspec(noinline) HRESULT Call(int i)
+      {
+         CallCount++;
+         return (i & 1) != 0 ? VSS_E_VOLUME_NOT_SUPPORTED : S_OK;
+      }
+
+      bool CheckedCall(int i)
+      {
+         try
+         {
+            CheckCom(Call(i));
+            return true;
+         }
+         catch (VssVolumeNotSupportedException^)
+         {
+            return false;
+         }
+      }
+
+      bool TryCall(int i)
+      {
+         VssResult result((VssError)Call(i));
+         return result.Succeeded;
+      }
+   }
+
+   [TestClass]
+   public ref class ErrorTests
+   {
+   public:
+      property Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ TestContext
+      {
+         Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ get() { return m_testContext; }
+         void set(Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ value) { m_testContext = value; }
+      }
+
+      [TestMethod]
+      void CheckCom_FailedCall_ThrowsMappedExceptionAfterSingleCall()
+      {
+         CallCount = 0;
+         try
+         {
+            CheckCom(Call(1));
+            Assert::Fail("Expected VssVolumeNotSupportedException.");
+         }
+         catch (VssVolumeNotSupportedException^)
+         {
+         }
+
+         Assert::AreEqual(1, CallCount);
+      }
+
+      [TestMethod]
+      void VssResult_FailedCall_ReportsError()
+      {
+         VssResult result((VssError)Call(1));
+
+         Assert::IsTrue(result.Failed);
+         Assert::AreEqual(VssError::VolumeNotSupported, result.Error);
+         Assert::IsTrue(VssResult((VssError)Call(0)).Succeeded);
+      }
+
+      [TestMethod, TestCategory("Benchmark")]
+      void Benchmark_HalfOfCallsFailing()
+      {
+         const int iterations = 20000;
+         int succeeded = 0;
+
+         Stopwatch^ stopwatch = Stopwatch::StartNew();
+         for (int i = 0; i < iterations; i++)
+            if (CheckedCall(i))
+               succeeded++;
+         double checkCom = stopwatch->Elapsed.TotalMilliseconds * 1000 / iterations;
+
+         stopwatch->Restart();
+         for (int i = 0; i < iterations; i++)
+            if (TryCall(i))
+               succeeded++;
+         double vssResult = stopwatch->Elapsed.TotalMilliseconds * 1000 / iterations;
+
+         TestContext->WriteLine("50% failures: CheckCom with try/catch {0:F3} us per call, VssResult {1:F3} us per call ({2:F0}x)",
+            checkCom, vssResult, checkCom / vssResult);
+         Assert::AreEqual(iterations, succeeded);
+      }
+
+   private:
+      Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ m_testContext;
+   };
+}
+} } }
@@ -0,0 +1,100 @@
+#pragma once
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   //
+   // An IVssEnumObject returning Count snapshot objects, whose snapshot ids carry their position in
+   // Data1. Counts the calls to Next and, if FailAt is set, fails the call to Next that would return
+   // the object at that position with FailureCode.
+   //
+   class MockVssEnumObject : public IVssEnumObject
+   {
+   public:
+      MockVssEnumObject(ULONG count)
+         : Count(count), FailAt(ULONG_MAX), FailureCode(E_FAIL), NextCalls(0), m_position(0), m_refCount(1)
+      {
+      }
+
+      static VSS_ID SnapshotIdAt(ULONG position)
+      {
+         VSS_ID id = { position, 0x1234, 0x5678, { 0, 1, 2, 3, 4, 5, 6, 7 } };
+         return id;
+      }
+
+      ULONG RefCount() const { return m_refCount; }
+
+      STDMETHODIMP QueryInterface(REFIID riid, void **ppvObject)
+      {
+         if (ppvObject == 0)
+            return E_POINTER;
+
+         if (riid != IID_IUnknown && riid != IID_IVssEnumObject)
+         {
+            *ppvObject = 0;
+            return E_NOINTERFACE;
+         }
+
+         *ppvObject = this;
+         AddRef();
+         return S_OK;
+      }
+
+      STDMETHODIMP_(ULONG) AddRef()
+      {
+         return ++m_refCount;
+      }
+
+      // The mock is owned by the test, so it is not deleted when the last reference is released.
+      STDMETHODIMP_(ULONG) Release()
+      {
+         return --m_refCount;
+      }
+
+      STDMETHODIMP Next(ULONG celt, VSS_OBJECT_PROP *rgelt, ULONG *pceltFetched)
+      {
+         NextCalls++;
+         *pceltFetched = 0;
+
+         if (FailAt >= m_position && FailAt < m_position + celt)
+            return FailureCode;
+
+         while (*pceltFetched < celt && m_position < Count)
+         {
+            VSS_OBJECT_PROP &prop = rgelt[(*pceltFetched)++];
+            ZeroMemory(&prop, sizeof(prop));
+            prop.Type = VSS_OBJECT_SNAPSHOT;
+            prop.Obj.Snap.m_SnapshotId = SnapshotIdAt(m_position++);
+         }
+
+         return *pceltFetched == celt ? S_OK : S_FALSE;
+      }
+
+      STDMETHODIMP Skip(ULONG celt)
+      {
+         m_position = min(m_position + celt, Count);
+         return S_OK;
+      }
+
+      STDMETHODIMP Reset()
+      {
+         m_position = 0;
+         return S_OK;
+      }
+
+      STDMETHODIMP Clone(IVssEnumObject **ppenum)
+      {
+         *ppenum = 0;
+         return E_NOTIMPL;
+      }
+
+      ULONG Count;
+      ULONG FailAt;
+      HRESULT FailureCode;
+      ULONG NextCalls;
+
+   private:
+      ULONG m_position;
+      ULONG m_refCount;
+   };
+}
+} } }
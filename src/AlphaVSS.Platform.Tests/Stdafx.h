@@ -0,0 +1,22 @@
+#pragma once
+
+//
+// Replaces the Stdafx.h of AlphaVSS.Platform for the library sources compiled into the tests. Only the
+// headers those sources need are included, so that the declarations of the wrapper classes that are
+// not compiled into the tests do not end up in this assembly.
+//
+
+#include "Config.h"
+
+#include <windows.h>
+#include <winbase.h>
+
+#include <vss.h>
+#include <vsWriter.h>
+#include <vsBackup.h>
+
+#include "Utils.h"
+#include "Macros.h"
+#include "Error.h"
+
+#include <atlbase.h>
@@ -0,0 +1,127 @@
+#include "Stdafx.h"
+
+using namespace System;
+using namespace System::Diagnostics;
+using namespace System::Runtime::InteropServices;
+using namespace Microsoft::VisualStudio::TestTools::UnitTesting;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   namespace
+   {
+      // Stands in for the COM call receiving the string, so that the conversions are not optimized away.
+      __declspec(noinline) size_t Consume(const wchar_t *str)
+      {
+         return str == 0 ? 0 : str[0];
+      }
+
+      size_t PinMStrConversion(String^ str)
+      {
+         PinMStr(pwsz, str);
+         return Consume(pwsz);
+      }
+
+      size_t HGlobalConversion(String^ str)
+      {
+         IntPtr ptr = Marshal::StringToHGlobalUni(str);
+         size_t result = Consume((const wchar_t *)ptr.ToPointer());
+         Marshal::FreeHGlobal(ptr);
+         return result;
+      }
+
+      size_t AutoMBStrConversion(String^ str)
+      {
+         return Consume(AutoMBStr(str));
+      }
+   }
+
+   [TestClass]
+   public ref class StringMarshalingTests
+   {
+   public:
+      property Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ TestContext
+      {
+         Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ get() { return m_testContext; }
+         void set(Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ value) { m_testContext = value; }
+      }
+
+      [TestMethod]
+      void PinMStr_String_PointsToCharactersOfString()
+      {
+         String^ str = L"\\\\?\\Volume{00000000-0000-0000-0000-000000000000}\\";
+         PinMStr(pwsz, str);
+
+         Assert::AreEqual(str, gcnew String(pwsz));
+         Assert::AreEqual(0, (int)pwsz[str->Length]);
+      }
+
+      [TestMethod]
+      void PinMStr_Null_IsNull()
+      {
+         PinMStr(pwsz, (String^)nullptr);
+
+         Assert::IsTrue(pwsz == 0);
+      }
+
+      [TestMethod]
+      void NoNullPinMStr_Null_ThrowsArgumentNullException()
+      {
+         String^ volumeName = nullptr;
+         try
+         {
+            NoNullPinMStr(pwszVolumeName, volumeName);
+            Assert::Fail("Expected ArgumentNullException.");
+         }
+         catch (ArgumentNullException^ ex)
+         {
+            Assert::AreEqual("volumeName", ex->ParamName);
+         }
+      }
+
+      [TestMethod]
+      void AutoMBStr_String_IsLengthPrefixedBStr()
+      {
+         String^ str = gcnew String(L'x', 5000);
+         AutoMBStr bstr(str);
+
+         Assert::AreEqual((UINT)str->Length, ::SysStringLen(bstr));
+         Assert::AreEqual(str, Marshal::PtrToStringBSTR(IntPtr((BSTR)bstr)));
+      }
+
+      [TestMethod, TestCategory("Benchmark")]
+      void Benchmark_StringConversions()
+      {
+         const int iterations = 200000;
+         array<int>^ lengths = { 3, 50, 260, 4096 };
+
+         for each (int length in lengths)
+         {
+            String^ str = gcnew String(L'a', length);
+            size_t sink = 0;
+
+            Stopwatch^ stopwatch = Stopwatch::StartNew();
+            for (int i = 0; i < iterations; i++)
+               sink += PinMStrConversion(str);
+            double pin = stopwatch->Elapsed.TotalMilliseconds * 1000000 / iterations;
+
+            stopwatch->Restart();
+            for (int i = 0; i < iterations; i++)
+               sink += HGlobalConversion(str);
+            double hglobal = stopwatch->Elapsed.TotalMilliseconds * 1000000 / iterations;
+
+            stopwatch->Restart();
+            for (int i = 0; i < iterations; i++)
+               sink += AutoMBStrConversion(str);
+            double bstr = stopwatch->Elapsed.TotalMilliseconds * 1000000 / iterations;
+
+            TestContext->WriteLine("{0,5} characters: PinMStr {1:F1} ns, StringToHGlobalUni {2:F1} ns, AutoMBStr (StringToBSTR) {3:F1} ns",
+               length, pin, hglobal, bstr);
+            Assert::AreEqual((size_t)3 * iterations * L'a', sink);
+         }
+      }
+
+   private:
+      Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ m_testContext;
+   };
+}
+} } }
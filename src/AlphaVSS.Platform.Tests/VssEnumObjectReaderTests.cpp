@@ -0,0 +1,162 @@
+#include "Stdafx.h"
+
+#include "VssEnumObjectReader.h"
+#include "MockVssEnumObject.h"
+
+using namespace System;
+using namespace System::Diagnostics;
+using namespace Microsoft::VisualStudio::TestTools::UnitTesting;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   namespace
+   {
+      const ULONG ObjectCount = 10000;
+   }
+
+   [TestClass]
+   public ref class VssEnumObjectReaderTests
+   {
+   public:
+      property Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ TestContext
+      {
+         Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ get() { return m_testContext; }
+         void set(Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ value) { m_testContext = value; }
+      }
+
+      [TestMethod]
+      void Next_AdaptiveBatchSize_DoublesBlockUntilMaxBatchSize()
+      {
+         MockVssEnumObject mock(ObjectCount);
+         {
+            VssEnumObjectReader reader(&mock, 0);
+            Assert::AreEqual(ObjectCount, ReadAll(reader));
+
+            // Blocks of 16, 32, 64, 128, 256 and 512 objects return the first 1008 objects, the remaining
+            // 8992 take eight full blocks of 1024 objects and a last, partial block that ends the enumeration.
+            Assert::AreEqual(15u, reader.FetchCount());
+            Assert::AreEqual(reader.FetchCount(), mock.NextCalls);
+         }
+         Assert::AreEqual(0u, mock.RefCount());
+      }
+
+      [TestMethod]
+      void Next_FixedBatchSizeDividingCount_StopsAfterEmptyBlock()
+      {
+         MockVssEnumObject mock(ObjectCount);
+         VssEnumObjectReader reader(&mock, 100);
+
+         Assert::AreEqual(ObjectCount, ReadAll(reader));
+         Assert::AreEqual(101u, reader.FetchCount());
+         Assert::IsTrue(reader.Next() == 0);
+         Assert::AreEqual(101u, reader.FetchCount());
+      }
+
+      [TestMethod]
+      void Next_BatchSizeAboveMaximum_IsLimitedToMaxBatchSize()
+      {
+         MockVssEnumObject mock(ObjectCount);
+         VssEnumObjectReader reader(&mock, 100000);
+
+         Assert::AreEqual(ObjectCount, ReadAll(reader));
+         Assert::AreEqual((ObjectCount + VssEnumObjectReader::MaxBatchSize - 1) / VssEnumObjectReader::MaxBatchSize, reader.FetchCount());
+      }
+
+      [TestMethod]
+      void Next_EmptyEnumeration_ReturnsNullAfterOneCall()
+      {
+         MockVssEnumObject mock(0);
+         VssEnumObjectReader reader(&mock, 0);
+
+         Assert::IsTrue(reader.Next() == 0);
+         Assert::IsTrue(reader.Next() == 0);
+         Assert::AreEqual(1u, reader.FetchCount());
+      }
+
+      [TestMethod]
+      void Next_EnumeratorFails_ThrowsMappedExceptionAndEndsEnumeration()
+      {
+         MockVssEnumObject mock(ObjectCount);
+         mock.FailAt = 100;
+         mock.FailureCode = VSS_E_BAD_STATE;
+         VssEnumObjectReader reader(&mock, 0);
+
+         ULONG read = 0;
+         try
+         {
+            while (reader.Next() != 0)
+               read++;
+
+            Assert::Fail("Expected VssBadStateException.");
+         }
+         catch (VssBadStateException^)
+         {
+         }
+
+         // The blocks of 16 and 32 objects succeed, the block of 64 objects starting at position 48 fails.
+         Assert::AreEqual(48u, read);
+         Assert::AreEqual(3u, reader.FetchCount());
+         Assert::IsTrue(reader.Next() == 0);
+         Assert::AreEqual(3u, mock.NextCalls);
+      }
+
+      [TestMethod]
+      void Destructor_EnumerationNotCompleted_ReleasesEnumerator()
+      {
+         MockVssEnumObject mock(ObjectCount);
+         {
+            VssEnumObjectReader reader(&mock, 0);
+            Assert::IsTrue(reader.Next() != 0);
+         }
+         Assert::AreEqual(0u, mock.RefCount());
+      }
+
+      [TestMethod, TestCategory("Benchmark")]
+      void Benchmark_Next_10000Objects()
+      {
+         const int iterations = 50;
+         array<ULONG>^ batchSizes = { 1, 16, 128, VssEnumObjectReader::MaxBatchSize, 0 };
+
+         for each (ULONG batchSize in batchSizes)
+         {
+            ULONG fetchCount = 0;
+            Stopwatch^ stopwatch = Stopwatch::StartNew();
+            for (int i = 0; i < iterations; i++)
+            {
+               MockVssEnumObject mock(ObjectCount);
+               VssEnumObjectReader reader(&mock, batchSize);
+               Assert::AreEqual(ObjectCount, ReadAll(reader));
+               fetchCount = reader.FetchCount();
+            }
+            stopwatch->Stop();
+
+            String^ name = batchSize == 0 ? gcnew String(L"adaptive") : batchSize.ToString();
+            TestContext->WriteLine("Batch size {0}: {1} calls to IVssEnumObject::Next, {2:F3} ms per enumeration",
+               name, fetchCount, stopwatch->Elapsed.TotalMilliseconds / iterations);
+
+            if (batchSize == 0)
+               Assert::IsTrue(fetchCount < ObjectCount / VssEnumObjectReader::AdaptiveInitialBatchSize);
+         }
+      }
+
+   private:
+      Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ m_testContext;
+
+      // Reads the remaining objects, checking that they are returned in the order of the enumeration.
+      static ULONG ReadAll(VssEnumObjectReader &reader)
+      {
+         ULONG count = 0;
+         VSS_OBJECT_PROP *prop;
+         while ((prop = reader.Next()) != 0)
+         {
+            if (prop->Obj.Snap.m_SnapshotId != MockVssEnumObject::SnapshotIdAt(count))
+               Assert::Fail("Object {0} was returned out of order.", count);
+
+            VssEnumObjectReader::FreeObjectProp(*prop);
+            count++;
+         }
+         return count;
+      }
+   };
+}
+} } }
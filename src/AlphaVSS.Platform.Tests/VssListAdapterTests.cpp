@@ -0,0 +1,187 @@
+#include "Stdafx.h"
+
+#include "VssListAdapter.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Diagnostics;
+using namespace Microsoft::VisualStudio::TestTools::UnitTesting;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss { namespace Tests
+{
+   namespace
+   {
+      const int ElementCount = 1000;
+   }
+
+   //
+   // A list of Count boxed integers that counts the calls to Count and GetItem, each of which stands in
+   // for a call to VSS.
+   //
+   ref class CountingList sealed : VssListAdapter<Object^>
+   {
+   public:
+      CountingList(int count)
+         : CountCalls(0), ItemCalls(0), m_items(gcnew array<Object^>(count))
+      {
+         for (int i = 0; i < count; i++)
+            m_items[i] = i;
+      }
+
+      property int Count
+      {
+         virtual int get() override
+         {
+            CountCalls++;
+            return m_items->Length;
+         }
+      }
+
+      property int Calls
+      {
+         int get() { return CountCalls + ItemCalls; }
+      }
+
+      void ResetCalls()
+      {
+         CountCalls = 0;
+         ItemCalls = 0;
+      }
+
+      int CountCalls;
+      int ItemCalls;
+
+   protected:
+      virtual Object^ GetItem(int index) override
+      {
+         ItemCalls++;
+         return m_items[index];
+      }
+
+   private:
+      array<Object^>^ m_items;
+   };
+
+   [TestClass]
+   public ref class VssListAdapterTests
+   {
+   public:
+      property Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ TestContext
+      {
+         Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ get() { return m_testContext; }
+         void set(Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ value) { m_testContext = value; }
+      }
+
+      [TestMethod]
+      void Enumerate_FullPass_ReadsCountOnce()
+      {
+         CountingList^ list = gcnew CountingList(ElementCount);
+
+         Assert::AreEqual(ElementCount, Enumerate(list));
+         Assert::AreEqual(1, list->CountCalls);
+         Assert::AreEqual(ElementCount, list->ItemCalls);
+      }
+
+      [TestMethod]
+      void CopyTo_FullPass_ReadsCountOnce()
+      {
+         CountingList^ list = gcnew CountingList(ElementCount);
+         array<Object^>^ result = gcnew array<Object^>(ElementCount + 1);
+
+         ((IList<Object^>^)list)->CopyTo(result, 1);
+         Assert::AreEqual(ElementCount - 1, safe_cast<int>(result[ElementCount]));
+         Assert::AreEqual(ElementCount + 1, list->Calls);
+      }
+
+      [TestMethod]
+      void Indexer_FullPass_ChecksCountForEveryElement()
+      {
+         CountingList^ list = gcnew CountingList(ElementCount);
+
+         Assert::AreEqual(ElementCount, Index(list));
+         Assert::AreEqual(ElementCount + 1, list->CountCalls);
+         Assert::AreEqual(ElementCount, list->ItemCalls);
+      }
+
+      [TestMethod]
+      void MoveNext_ListInvalidated_ThrowsInvalidOperationException()
+      {
+         CountingList^ list = gcnew CountingList(ElementCount);
+         IEnumerator<Object^>^ enumerator = ((IList<Object^>^)list)->GetEnumerator();
+         Assert::IsTrue(enumerator->MoveNext());
+
+         list->Invalidate();
+         try
+         {
+            enumerator->MoveNext();
+            Assert::Fail("Expected InvalidOperationException.");
+         }
+         catch (InvalidOperationException^)
+         {
+         }
+      }
+
+      [TestMethod, TestCategory("Benchmark")]
+      void Benchmark_FullPass_1000Elements()
+      {
+         const int iterations = 1000;
+         CountingList^ list = gcnew CountingList(ElementCount);
+
+         array<String^>^ names = { L"foreach", L"CopyTo", L"indexer" };
+         for (int pattern = 0; pattern < names->Length; pattern++)
+         {
+            list->ResetCalls();
+            Stopwatch^ stopwatch = Stopwatch::StartNew();
+            for (int i = 0; i < iterations; i++)
+            {
+               switch (pattern)
+               {
+               case 0: Enumerate(list); break;
+               case 1: CopyTo(list); break;
+               default: Index(list); break;
+               }
+            }
+            stopwatch->Stop();
+
+            TestContext->WriteLine("{0}: {1} calls to VSS per pass, {2:F3} us per pass",
+               names[pattern], list->Calls / iterations, stopwatch->Elapsed.TotalMilliseconds * 1000 / iterations);
+         }
+      }
+
+   private:
+      Microsoft::VisualStudio::TestTools::UnitTesting::TestContext^ m_testContext;
+
+      // Each pass goes through IList<T>, as callers of the wrappers do.
+      static int Enumerate(IList<Object^>^ list)
+      {
+         int count = 0;
+         for each (Object^ item in list)
+         {
+            if (safe_cast<int>(item) != count)
+               Assert::Fail("Element {0} was returned out of order.", count);
+            count++;
+         }
+         return count;
+      }
+
+      // Sizes the array through Count, as callers do, so a pass takes one call more than CopyTo itself.
+      static array<Object^>^ CopyTo(IList<Object^>^ list)
+      {
+         array<Object^>^ result = gcnew array<Object^>(list->Count);
+         list->CopyTo(result, 0);
+         return result;
+      }
+
+      static int Index(IList<Object^>^ list)
+      {
+         int count = list->Count;
+         for (int i = 0; i < count; i++)
+         {
+            if (safe_cast<int>(list[i]) != i)
+               Assert::Fail("Element {0} was returned out of order.", i);
+         }
+         return count;
+      }
+   };
+}
+} } }
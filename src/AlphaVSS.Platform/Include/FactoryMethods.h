@@ -4,6 +4,7 @@
 #include "Config.h"
 #include "Macros.h"
 #include "Error.h"
+#include "VssStringCache.h"
 
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
 #include <VsMgmt.h>
@@ -11,12 +12,13 @@
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
-   VssWMFileDescriptor^ CreateVssWMFileDescriptor(IVssWMFiledesc *vssWMFiledesc);
+   // The optional cache is used to convert the strings of the created objects.
+   VssWMFileDescriptor^ CreateVssWMFileDescriptor(IVssWMFiledesc *vssWMFiledesc, VssStringCache^ cache = nullptr);
    VssProviderProperties^ CreateVssProviderProperties(VSS_PROVIDER_PROP *pProp);
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WIN2003
-   VssWMDependency^ CreateVssWMDependency(IVssWMDependency *dependency);
+   VssWMDependency^ CreateVssWMDependency(IVssWMDependency *dependency, VssStringCache^ cache = nullptr);
 #endif	
-   VssSnapshotProperties^ CreateVssSnapshotProperties(VSS_SNAPSHOT_PROP *prop);
+   VssSnapshotProperties^ CreateVssSnapshotProperties(VSS_SNAPSHOT_PROP *prop, VssStringCache^ cache = nullptr);
 
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
    VssVolumeProtectionInfo^ CreateVssVolumeProtectionInfo(VSS_VOLUME_PROTECTION_INFO *info);
@@ -29,7 +29,7 @@
    HRESULT hrInternal = ErrorCode;									\
    if (FAILED(hrInternal))											\
    {																\
-   ThrowException( ErrorCode );	\
+   ThrowException( hrInternal );	\
    }																\
 }	
 
@@ -37,26 +37,55 @@
 // Helper definitions for restricting strings managed by AutoPtr subclasses
 // to not be allowed to be null.
 //
-#define NoNullAutoMStr(arg)  NoNullAutoStrImpl(arg, #arg, AutoMStr)
 #define NoNullAutoMBStr(arg) NoNullAutoStrImpl(arg, #arg, AutoMBStr)
 #define NoNullAutoStrImpl(arg, name, type) NoNull<type>(arg, L##name)
 
+//
+// Declares var as a VSS_PWSZ pointing to the characters of the managed string arg, which
+// stays pinned until var goes out of scope. var is NULL if arg is null. The characters are
+// not copied, so var must only be passed as an input string that the callee does not modify
+// or retain.
+//
+#define PinMStr(var, arg) pin_ptr<const wchar_t> var##Pin = PtrToStringChars(arg); \
+   VSS_PWSZ var = const_cast<VSS_PWSZ>(static_cast<const wchar_t *>(var##Pin))
+#define NoNullPinMStr(var, arg) NoNullPinMStrImpl(var, arg, #arg)
+#define NoNullPinMStrImpl(var, arg, name) PinMStr(var, NoNullString(arg, L##name))
+
 #define UnsupportedOs() throw gcnew UnsupportedOperatingSystemException(Alphaleonis::Win32::Vss::Resources::LocalizedStrings::RequestedOperationUnsupportedByOS)
 
+//
+// Defines the bitmask in which the accessors defined by DEFINE_EX_INTERFACE_ACCESSOR
+// record which "Ex" interfaces have already been queried for. Must be used once in
+// every class that uses DEFINE_EX_INTERFACE_ACCESSOR. Being a managed field, the
+// bitmask is zero-initialized.
+//
+#define DEFINE_EX_INTERFACE_PROBES() \
+   unsigned int m_exInterfaceProbes;
+
 //
 // Defines an instance variable and accessor methods to an "Ex" interface
 // of a class. The accessor methods will be named GetXXX and RequireXXX where 
 // XXX is the name of the interface. GetXXX may return NULL if the QueryInterface
 // method fails, while RequireXXX will call UnsupportedOs() if the method fails.
 //
-#define DEFINE_EX_INTERFACE_ACCESSOR(interfaceName, baseInstance)		\
+// QueryInterface is called at most once per object and interface: probeBit, which
+// must be unique within the class, is set in the bitmask defined by 
+// DEFINE_EX_INTERFACE_PROBES once the interface has been queried for, so that an 
+// interface that is not supported is not queried for again. A bit lost to a race 
+// between threads only causes the interface to be queried for again.
+//
+#define DEFINE_EX_INTERFACE_ACCESSOR(interfaceName, baseInstance, probeBit)		\
    interfaceName *m_##interfaceName;			\
    interfaceName *Get##interfaceName()			\
    {											\
    if (m_##interfaceName == 0)				\
       {										\
+      if ((m_exInterfaceProbes & (1u << (probeBit))) != 0) \
+      return 0;			    \
       void *ifc = 0;						\
-      if (FAILED((baseInstance)->QueryInterface(IID_##interfaceName, &ifc))) \
+      HRESULT hrProbe = (baseInstance)->QueryInterface(IID_##interfaceName, &ifc); \
+      m_exInterfaceProbes |= (1u << (probeBit)); \
+      if (FAILED(hrProbe)) \
       return 0;			    \
       m_##interfaceName = (interfaceName *)ifc; \
       }										\
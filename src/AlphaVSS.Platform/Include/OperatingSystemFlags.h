@@ -0,0 +1,39 @@
+#pragma once
+
+using namespace System;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   //
+   // The operating system version gates used by the wrappers, evaluated once when the class
+   // is first used instead of on every call through OperatingSystemInfo. Require throws the
+   // same exception as the OperatingSystemInfo::Require methods.
+   //
+   private ref class OperatingSystemFlags abstract sealed
+   {
+   public:
+      static initonly bool IsWindowsServer2003OrLater;
+      static initonly bool IsWindowsServer2003SP1OrLater;
+      static initonly bool IsWindowsServer2008OrLater;
+      static initonly bool IsServer2003SP1OrLater;
+      static initonly bool IsServer2003SP1OrClientVistaSP1OrLater;
+
+      static void Require(bool supported)
+      {
+         if (!supported)
+            throw gcnew UnsupportedOperatingSystemException();
+      }
+
+   private:
+      static OperatingSystemFlags()
+      {
+         IsWindowsServer2003OrLater = OperatingSystemInfo::IsAtLeast(OSVersionName::WindowsServer2003);
+         IsWindowsServer2003SP1OrLater = OperatingSystemInfo::IsAtLeast(OSVersionName::WindowsServer2003, 1);
+         IsWindowsServer2008OrLater = OperatingSystemInfo::IsAtLeast(OSVersionName::WindowsServer2008);
+         IsServer2003SP1OrLater = OperatingSystemInfo::IsServer && IsWindowsServer2003SP1OrLater;
+         IsServer2003SP1OrClientVistaSP1OrLater = OperatingSystemInfo::IsServer 
+            ? IsWindowsServer2003SP1OrLater 
+            : OperatingSystemInfo::IsAtLeast(OSVersionName::WindowsVista, 1);
+      }
+   };
+}}}
@@ -14,6 +14,7 @@
 #include "Utils.h"
 #include "Macros.h"
 #include "Error.h"
+#include "OperatingSystemFlags.h"
 
 #include "FactoryMethods.h"
 
@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <vcclr.h>
+
 using namespace System;
 
 
@@ -20,12 +22,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          guid.Data4[ 6 ], guid.Data4[ 7 ] );
    }
 
-   // Convert from System::Guid to VSS_ID
+   // Convert from System::Guid to VSS_ID. System::Guid is blittable and has the same
+   // layout as GUID, so the value is simply reinterpreted.
    inline VSS_ID ToVssId( System::Guid guid ) 
    {
-      array<Byte>^ guidData = guid.ToByteArray();
-      pin_ptr<Byte> data = &(guidData[ 0 ]);
-
+      pin_ptr<System::Guid> data = &guid;
       return *(_GUID *)data;
    }
 
@@ -61,6 +62,54 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
 
 
+   //
+   // Lifetime scopes
+   //
+
+   // Registers a newly created wrapper with a VssScope, which then disposes it together with
+   // the other objects of the scope. The finalizer of the wrapper is suppressed, since the
+   // scope releases the native object. Nothing is done if scope is null.
+   inline void AttachToScope(VssScope^ scope, IDisposable^ obj)
+   {
+      if (scope == nullptr)
+         return;
+
+      try
+      {
+         scope->Add(obj);
+      }
+      catch (...)
+      {
+         delete obj;
+         throw;
+      }
+
+      GC::SuppressFinalize(obj);
+   }
+
+   // Removes a wrapper that is disposed individually from the VssScope it was registered with,
+   // so that the scope does not keep it alive. Nothing is done if scope is null.
+   inline void DetachFromScope(VssScope^ scope, IDisposable^ obj)
+   {
+      if (scope != nullptr)
+         scope->Remove(obj);
+   }
+
+
+
+   //
+   // Exceptions
+   //
+
+   // Rethrows an exception caught on another thread without replacing its stack trace.
+   // See ExceptionHelper.Rethrow in AlphaVSS.Common, which does the work for both assemblies.
+   inline void Rethrow(Exception^ ex)
+   {
+      throw ExceptionHelper::Rethrow(ex);
+   }
+
+
+
    //
    // Simple string conversion functions (unmanaged to managed)
    //
@@ -134,7 +183,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    };
 
    // 
-   // Helper class for management of BSTR strings originating as System::String
+   // Helper class for management of BSTR strings originating as System::String.
+   // Only used for parameters that are declared as BSTR, which the callee may inspect
+   // with SysStringLen; VSS_PWSZ and LPCWSTR parameters use PinMStr instead.
    //
    class AutoMBStr : public AutoPtr<BSTR, MarshalFreeBSTRDeleter>
    {
@@ -154,14 +205,14 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    };
 
 
-   // 
-   // Helper class for management of wchar_t* strings, originating as managed strings (System::String)
-   //
-   struct AutoMStr : public AutoPtr<wchar_t *, MarshalFreeHGlobalDeleter>
+   // Returns str, or throws an ArgumentNullException naming the argument if str is null.
+   // Used by NoNullPinMStr.
+   inline String^ NoNullString(String^ str, const wchar_t *name)
    {
-      AutoMStr(String^ str) : AutoPtr( str == nullptr ? 0 : (wchar_t *)System::Runtime::InteropServices::Marshal::StringToHGlobalUni(str).ToPointer()) { }
-      operator VSS_PWSZ(){ return (VSS_PWSZ)ptr(); }
-   };
+      if (str == nullptr)
+         throw gcnew ArgumentNullException(gcnew String(name));
+      return str;
+   }
 
    // 
    // Helper class for forbidding null-pointers to be stored in the AutoPtr classes.
@@ -185,28 +236,34 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    //
    // Helper class for managing an array of VSS_ID objects, originating from
-   // a managed array of Guid objects.
+   // a managed array of Guid objects. Arrays of up to InlineCapacity ids are
+   // stored in the object itself, so no memory is allocated for them.
    //
    class VssIds
    {
    public:
+      static const int InlineCapacity = 32;
+
       VssIds(array<System::Guid> ^ guids)
-         : m_ids(0)
+         : m_ids(m_inline)
       {
          if (guids == nullptr)
             throw gcnew ArgumentNullException();
 
-         m_ids = new VSS_ID[guids->Length];
+         if (guids->Length > InlineCapacity)
+            m_ids = new VSS_ID[guids->Length];
 
-         for (int i = 0; i < guids->Length; i++)
+         if (guids->Length > 0)
          {
-            m_ids[i] = ToVssId(guids[i]);
+            pin_ptr<System::Guid> data = &guids[0];
+            memcpy(m_ids, data, guids->Length * sizeof(VSS_ID));
          }
       }
 
       ~VssIds()
       {
-         delete [] m_ids;
+         if (m_ids != m_inline)
+            delete [] m_ids;
       }
 
       (operator VSS_ID *)()
@@ -215,7 +272,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       }
 
    private:
+      VssIds(const VssIds &);
+      VssIds &operator=(const VssIds &);
+
       VSS_ID *m_ids;
+      VSS_ID m_inline[InlineCapacity];
    };
 
 
@@ -0,0 +1,46 @@
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Threading;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   ref class VssAsyncResult;
+
+   //
+   // Drives all outstanding VssAsyncResult instances of the process from a single dedicated
+   // background thread, so that a pending VSS operation never occupies a thread of its own.
+   //
+   // The thread polls every pending operation with IVssAsync::QueryStatus. If no operation
+   // completed during a pass, the interval before the next pass is doubled, starting at
+   // InitialPollInterval, up to MaxPollInterval. The interval is reset whenever a new operation
+   // is registered. When only a single operation is outstanding, the thread sleeps in
+   // IVssAsync::Wait with a short timeout instead (on targets that support a timeout), so
+   // that the completion of the operation is observed without delay.
+   //
+   // The thread is created on the first registration and is idle while no operation is pending.
+   //
+   private ref class VssAsyncPoller abstract sealed
+   {
+   public:
+      static const int InitialPollInterval = 10;
+      static const int MaxPollInterval = 250;
+      static const int MaxWaitTimeout = 50;
+
+      // Adds an operation to the set of operations being polled.
+      static void Register(VssAsyncResult^ result);
+
+      // Forces an immediate polling pass, e.g. after an operation has been cancelled.
+      static void Wake();
+
+   private:
+      static VssAsyncPoller();
+      static void Run();
+
+      static Object^ s_lock;
+      static List<VssAsyncResult^>^ s_incoming;
+      static AutoResetEvent^ s_wakeup;
+      static Thread^ s_thread;
+   };
+}}}
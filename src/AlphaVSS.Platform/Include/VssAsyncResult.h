@@ -16,10 +16,33 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       int m_isComplete;
       ManualResetEvent^ m_asyncWaitHandle;
       ::IVssAsync *m_vssAsync;
+      VssScope^ m_scope;
       Exception^ m_exception;
 
+      // Progress and timing state, updated by Sample() and guarded by m_sampleLock. Times are
+      // measured in Stopwatch ticks of m_stopwatch; a negative value means "not yet observed".
+      Object^ m_sampleLock;
+      System::Diagnostics::Stopwatch^ m_stopwatch;
+      DateTime m_startTime;
+      VssAsyncStatus m_status;
+      int m_sampleCount;
+      Int64 m_firstSampleTicks;
+      Int64 m_completionTicks;
+      Int64 m_lastProgressTicks;
+      Int64 m_progressInterval;
+
+      // Progress events not yet raised, and whether a thread pool work item is raising them. Both
+      // are guarded by m_sampleLock.
+      Queue<VssAsyncProgressEventArgs^>^ m_progressEvents;
+      bool m_dispatchingProgress;
+
       VssAsyncResult(::IVssAsync *vssAsync, AsyncCallback^ userCallback, Object^ asyncState);
-      void WaitForAsyncCompletion(Object^ state);
+      void Complete(Exception^ exception);
+      void InvokeCallback(Object^ state);
+      void Sample(VssAsyncStatus status);
+      void RaiseProgressChanged(Object^ state);
+      static VssAsyncStatus ToStatus(HRESULT hrResult);
+      static TimeSpan ToTimeSpan(Int64 stopwatchTicks);
    public:
       /// <summary>Destructor.</summary>
       ~VssAsyncResult();
@@ -32,9 +55,21 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       property WaitHandle^ AsyncWaitHandle { virtual WaitHandle^ get(); }
       property bool IsCompleted { virtual bool get(); }
       virtual void Cancel();
+      virtual event EventHandler<VssAsyncProgressEventArgs^>^ ProgressChanged;
+      property TimeSpan ProgressInterval { virtual TimeSpan get(); virtual void set(TimeSpan value); }
+      property VssAsyncTiming^ Timing { virtual VssAsyncTiming^ get(); }
    internal:
       void EndInvoke();
 
+      // Called by VssAsyncPoller. Queries the status of the operation, first waiting for at most
+      // waitTimeout milliseconds if waitTimeout is not zero, and completes the operation if it is
+      // no longer pending. Returns true if the operation has been completed.
+      bool Poll(int waitTimeout);
+
+      // Called by VssAsyncPoller if Poll throws an exception. Completes the operation with the
+      // exception, unless it has already been completed.
+      void Fail(Exception^ exception);
+
       static VssAsyncResult^ Create(::IVssAsync *vssAsync, AsyncCallback^ userCallback, Object^ asyncState);
    };
 }}}
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include "VssWriterComponents.h"
 #include "VssExamineWriterMetadata.h"
+#include "VssEnumObjectReader.h"
+#include "VssSnapshotPredicate.h"
 #include "Macros.h"
 
 using namespace System;
@@ -28,6 +30,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
       virtual Guid AddToSnapshotSet(String^ volumeName, Guid providerId);
       virtual Guid AddToSnapshotSet(String^ volumeName);
+      virtual VssResult TryAddToSnapshotSet(String^ volumeName, Guid providerId, [System::Runtime::InteropServices::Out] Guid% snapshotId);
 
       virtual void BackupComplete();
       virtual IVssAsyncResult^ BeginBackupComplete(AsyncCallback^ userCallback, Object^ stateObject);
@@ -40,6 +43,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       virtual void EndBreakSnapshotSet(IAsyncResult ^asyncResult);      
 
       virtual void DeleteSnapshot(Guid snapshotId, bool forceDelete);
+      virtual VssResult TryDeleteSnapshot(Guid snapshotId, bool forceDelete);
       virtual int DeleteSnapshotSet(Guid snapshotSetId, bool forceDelete);
 
       virtual void DisableWriterClasses(array<Guid> ^ writerClassIds);
@@ -63,9 +67,13 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       virtual void EndGatherWriterStatus(IAsyncResult ^asyncResult);      
 
       virtual VssSnapshotProperties^ GetSnapshotProperties(Guid snapshotId);
+      virtual VssResult TryGetSnapshotProperties(Guid snapshotId, [System::Runtime::InteropServices::Out] VssSnapshotProperties^% properties);
       property IList<IVssWriterComponents^>^ WriterComponents { virtual IList<IVssWriterComponents^>^ get(); }
       property IList<IVssExamineWriterMetadata^>^ WriterMetadata { virtual IList<IVssExamineWriterMetadata^>^ get(); }
+      virtual VssWriterMetadataPrefetchResult^ PrefetchWriterMetadata();
+      virtual VssWriterMetadataPrefetchResult^ PrefetchWriterMetadata(int maxDegreeOfParallelism);
       property IList<VssWriterStatusInfo^>^ WriterStatus { virtual IList<VssWriterStatusInfo^>^ get(); }
+      virtual IList<VssWriterStatusInfo^>^ QueryWriterStatus();
       
       virtual void ImportSnapshots();
       virtual IVssAsyncResult^ BeginImportSnapshots(AsyncCallback^ userCallback, Object^ stateObject);
@@ -73,8 +81,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
       virtual void InitializeForBackup(String^ xml);
       virtual void InitializeForRestore(String^ xml);
+      virtual void InitializeForRestore(System::IO::Stream^ stream, VssXmlStreamFormat format);
       virtual bool IsVolumeSupported(String^ volumeName, Guid providerId);
       virtual bool IsVolumeSupported(String^ volumeName);
+      virtual VssResult TryIsVolumeSupported(String^ volumeName, Guid providerId, [System::Runtime::InteropServices::Out] bool% supported);
+      virtual VssResult TryIsVolumeSupported(String^ volumeName, [System::Runtime::InteropServices::Out] bool% supported);
       
       virtual void PostRestore();
       virtual IVssAsyncResult^ BeginPostRestore(AsyncCallback^ userCallback, Object^ stateObject);
@@ -90,7 +101,13 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       virtual void EndPreRestore(IAsyncResult ^asyncResult);      
 
       virtual System::Collections::Generic::IEnumerable<VssSnapshotProperties^> ^QuerySnapshots();
+      virtual System::Collections::Generic::IEnumerable<VssSnapshotProperties^> ^QuerySnapshots(VssSnapshotFilter^ filter);
+      virtual System::Collections::Generic::IEnumerable<VssSnapshotProperties^> ^EnumerateSnapshots();
+      virtual System::Collections::Generic::IEnumerable<VssSnapshotProperties^> ^EnumerateSnapshots(VssSnapshotFilter^ filter);
       virtual System::Collections::Generic::IEnumerable<VssProviderProperties^> ^QueryProviders();
+      property int EnumerationBatchSize { virtual int get(); virtual void set(int value); }
+      property int StringCacheCapacity { virtual int get(); virtual void set(int value); }
+      property VssStringCacheStatistics^ StringCacheStatistics { virtual VssStringCacheStatistics^ get(); }
       
       virtual IVssAsyncResult^ BeginQueryRevertStatus(String^ volumeName, AsyncCallback^ userCallback, Object^ stateObject);
       virtual void EndQueryRevertStatus(IAsyncResult ^asyncResult);      
@@ -98,6 +115,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
       virtual void RevertToSnapshot(Guid snapshotId, bool forceDismount);
       virtual String^ SaveAsXml();
+      virtual void SaveAsXml(System::IO::Stream^ stream, VssXmlStreamFormat format);
       virtual void SetAdditionalRestores(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, bool additionalResources);
       virtual void SetAuthoritativeRestore(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, bool isAuthorative);
       virtual void SetBackupOptions(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ backupOptions);
@@ -130,23 +148,29 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    private:
       ::IVssBackupComponents *m_backup;
 
+      DEFINE_EX_INTERFACE_PROBES()
+
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WIN2003
-      DEFINE_EX_INTERFACE_ACCESSOR(IVssBackupComponentsEx, m_backup)
+      DEFINE_EX_INTERFACE_ACCESSOR(IVssBackupComponentsEx, m_backup, 0)
 #endif
 
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      DEFINE_EX_INTERFACE_ACCESSOR(IVssBackupComponentsEx2, m_backup)
-      DEFINE_EX_INTERFACE_ACCESSOR(IVssBackupComponentsEx3, m_backup)
-      DEFINE_EX_INTERFACE_ACCESSOR(IVssBackupComponentsEx4, m_backup)
+      DEFINE_EX_INTERFACE_ACCESSOR(IVssBackupComponentsEx2, m_backup, 1)
+      DEFINE_EX_INTERFACE_ACCESSOR(IVssBackupComponentsEx3, m_backup, 2)
+      DEFINE_EX_INTERFACE_ACCESSOR(IVssBackupComponentsEx4, m_backup, 3)
 #endif
 
+      VssWriterStatusInfo^ GetWriterStatusInfo(UINT index);
+      void InvalidateWriterLists();
+
       ref class WriterMetadataList : VssListAdapter<IVssExamineWriterMetadata^>
       {
       public:
          WriterMetadataList(VssBackupComponents^ backupComponents);
 
          property int Count { virtual int get() override; }
-         property IVssExamineWriterMetadata^ default[int] { virtual IVssExamineWriterMetadata^ get(int index) override; }
+      protected:
+         virtual IVssExamineWriterMetadata^ GetItem(int index) override;
       private:
          VssBackupComponents^ m_backupComponents;
       };
@@ -158,7 +182,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          WriterComponentsList(VssBackupComponents^ backupComponents);
 
          property int Count { virtual int get() override; }
-         property IVssWriterComponents^ default[int] { virtual IVssWriterComponents^ get(int index) override; }
+      protected:
+         virtual IVssWriterComponents^ GetItem(int index) override;
       private:
          VssBackupComponents^ m_backupComponents;
       };
@@ -169,14 +194,69 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          WriterStatusList(VssBackupComponents^ backupComponents);
 
          property int Count { virtual int get() override; }
-         property VssWriterStatusInfo^ default[int] { virtual VssWriterStatusInfo^ get(int index) override; }
+      protected:
+         virtual VssWriterStatusInfo^ GetItem(int index) override;
       private:
          VssBackupComponents^ m_backupComponents;
       };
 
+      // Materializes the metadata of a set of writers. Run() may be executed concurrently
+      // by several threads, each of which picks the next unprocessed writer until all
+      // writers have been processed or an error occurs. The threads call the native
+      // interfaces of the writers directly, so they must all be in the multithreaded
+      // apartment in which the interfaces were obtained.
+      ref class WriterMetadataPrefetcher sealed
+      {
+      public:
+         WriterMetadataPrefetcher(array<IVssExamineWriterMetadata^>^ writerMetadata);
+
+         void Run();
+
+         property array<VssWriterMetadataTiming^>^ Timings { array<VssWriterMetadataTiming^>^ get(); }
+         property Exception^ Error { Exception^ get(); }
+      private:
+         array<IVssExamineWriterMetadata^>^ m_writerMetadata;
+         array<VssWriterMetadataTiming^>^ m_timings;
+         int m_next;
+         Exception^ m_error;
+      };
+
+      ref class SnapshotEnumerable sealed : IEnumerable<VssSnapshotProperties^>
+      {
+      public:
+         SnapshotEnumerable(VssBackupComponents^ backupComponents, VssSnapshotFilter^ filter);
+
+         virtual IEnumerator<VssSnapshotProperties^>^ GetEnumerator();
+         virtual System::Collections::IEnumerator^ GetEnumeratorNG() = System::Collections::IEnumerable::GetEnumerator;
+      private:
+         ref class Enumerator sealed : IEnumerator<VssSnapshotProperties^>
+         {
+         public:
+            Enumerator(VssEnumObjectReader *reader, VssSnapshotPredicate *predicate, VssStringCache^ stringCache);
+            ~Enumerator();
+            !Enumerator();
+
+            virtual bool MoveNext();
+            virtual void Reset();
+
+            property Object^ CurrentObject { virtual Object^ get() = System::Collections::IEnumerator::Current::get; }
+            property VssSnapshotProperties^ Current { virtual VssSnapshotProperties^ get(); }
+         private:
+            VssEnumObjectReader *m_reader;
+            VssSnapshotPredicate *m_predicate;
+            VssSnapshotProperties^ m_current;
+            VssStringCache^ m_stringCache;
+         };
+
+         VssBackupComponents^ m_backupComponents;
+         VssSnapshotFilter^ m_filter;
+      };
+
       WriterMetadataList^ m_writerMetadata;
       WriterComponentsList^ m_writerComponents;
       WriterStatusList^ m_writerStatus;
+      int m_enumerationBatchSize;
+      VssStringCache^ m_stringCache;
    };
 
 
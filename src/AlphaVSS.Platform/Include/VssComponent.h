@@ -52,18 +52,38 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       // 
       property VssComponentFailure^ Failure { virtual VssComponentFailure^ get(); virtual void set(VssComponentFailure^ value); }
 
+      virtual VssComponentSnapshot^ GetSnapshot();
+      property Int64 SnapshotCallsSaved { virtual Int64 get(); }
+
    internal:
-      static VssComponent^ Adopt(::IVssComponent *vssWriterComponents);
+      static VssComponent^ Adopt(::IVssComponent *vssWriterComponents, VssStringCache^ stringCache, VssScope^ scope, VssListAdapter<IVssWriterComponents^>^ owner);
+
+      property bool IsDisposed { bool get(); }
    private:
-      VssComponent(::IVssComponent *vssWriterComponents);
+      VssComponent(::IVssComponent *vssWriterComponents, VssStringCache^ stringCache, VssScope^ scope, VssListAdapter<IVssWriterComponents^>^ owner);
+      VssComponentSnapshot^ ReadSnapshot();
+
+      // The number of native calls made when every value of a snapshot is read through the individual properties.
+      static const int IndividualSnapshotCallCount = 27;
+
       ::IVssComponent *m_vssComponent;
+      VssStringCache^ m_stringCache;
+      VssScope^ m_scope;
+      // The writer components list the component was obtained through. A snapshot read at an earlier version of
+      // that list is stale, since the backup components document has been modified since.
+      VssListAdapter<IVssWriterComponents^>^ m_owner;
+      VssComponentSnapshot^ m_snapshot;
+      int m_snapshotVersion;
+      Int64 m_snapshotCallsSaved;
+
+      DEFINE_EX_INTERFACE_PROBES()
 
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      DEFINE_EX_INTERFACE_ACCESSOR(IVssComponentEx, m_vssComponent)
+      DEFINE_EX_INTERFACE_ACCESSOR(IVssComponentEx, m_vssComponent, 0)
 #endif
 
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      DEFINE_EX_INTERFACE_ACCESSOR(IVssComponentEx2, m_vssComponent)
+      DEFINE_EX_INTERFACE_ACCESSOR(IVssComponentEx2, m_vssComponent, 1)
 #endif
 
 
@@ -73,7 +93,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          DirectedTargetList(VssComponent^ component);
 
          property int Count { virtual int get() override; }
-         property VssDirectedTargetInfo^ default[int] { virtual VssDirectedTargetInfo^ get(int index) override; }
+      protected:
+         virtual VssDirectedTargetInfo^ GetItem(int index) override;
       private:
          VssComponent^ m_component;
       };
@@ -84,7 +105,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          NewTargetList(VssComponent^ component);
 
          property int Count { virtual int get() override; }
-         property VssWMFileDescriptor^ default[int] { virtual VssWMFileDescriptor^ get(int index) override; }
+      protected:
+         virtual VssWMFileDescriptor^ GetItem(int index) override;
       private:
          VssComponent^ m_component;
       };
@@ -95,7 +117,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          AlternateLocationMappingList(VssComponent^ component);
 
          property int Count { virtual int get() override; }
-         property VssWMFileDescriptor^ default[int] { virtual VssWMFileDescriptor^ get(int index) override; }
+      protected:
+         virtual VssWMFileDescriptor^ GetItem(int index) override;
       private:
          VssComponent^ m_component;
       };
@@ -106,7 +129,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          PartialFileList(VssComponent^ component);
 
          property int Count { virtual int get() override; }
-         property VssPartialFileInfo^ default[int] { virtual VssPartialFileInfo^ get(int index) override; }
+      protected:
+         virtual VssPartialFileInfo^ GetItem(int index) override;
       private:
          VssComponent^ m_component;
       };
@@ -118,7 +142,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          DifferencedFileList(VssComponent^ component);
 
          property int Count { virtual int get() override; }
-         property VssDifferencedFileInfo^ default[int] { virtual VssDifferencedFileInfo^ get(int index) override; }
+      protected:
+         virtual VssDifferencedFileInfo^ GetItem(int index) override;
       private:
          VssComponent^ m_component;
       };
@@ -130,7 +155,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          RestoreSubcomponentList(VssComponent^ component);
 
          property int Count { virtual int get() override; }
-         property VssRestoreSubcomponentInfo^ default[int] { virtual VssRestoreSubcomponentInfo^ get(int index) override; }
+      protected:
+         virtual VssRestoreSubcomponentInfo^ GetItem(int index) override;
       private:
          VssComponent^ m_component;
       };
@@ -44,12 +44,14 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       VssDifferentialSoftwareSnapshotManagement(::IVssDifferentialSoftwareSnapshotMgmt *pMgmt);
    private:
       ::IVssDifferentialSoftwareSnapshotMgmt *m_mgmt;
+      DEFINE_EX_INTERFACE_PROBES()
+
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      DEFINE_EX_INTERFACE_ACCESSOR(IVssDifferentialSoftwareSnapshotMgmt2, m_mgmt);
+      DEFINE_EX_INTERFACE_ACCESSOR(IVssDifferentialSoftwareSnapshotMgmt2, m_mgmt, 0);
 #endif
 
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      DEFINE_EX_INTERFACE_ACCESSOR(IVssDifferentialSoftwareSnapshotMgmt3, m_mgmt);
+      DEFINE_EX_INTERFACE_ACCESSOR(IVssDifferentialSoftwareSnapshotMgmt3, m_mgmt, 1);
 #endif
 
    };
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vss.h>
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   //
+   // Reads VSS_OBJECT_PROP structures from an IVssEnumObject in blocks, so that
+   // a single call to IVssEnumObject::Next retrieves many objects. The native
+   // buffer receiving the objects is allocated once and reused for every block.
+   //
+   // A batch size of zero selects the adaptive mode, in which the first block
+   // is small (most queries return only a handful of objects) and the block size is
+   // doubled every time the enumerator fills a complete block, up to MaxBatchSize.
+   //
+   // Ownership of the members of each VSS_OBJECT_PROP returned by Next() is transferred
+   // to the caller (typically to CreateVssSnapshotProperties or CreateVssProviderProperties
+   // which free them). Any objects fetched but not yet returned when the reader is destroyed
+   // are freed by the reader, as is the enumerator itself.
+   //
+   class VssEnumObjectReader
+   {
+   public:
+      static const ULONG AdaptiveInitialBatchSize = 16;
+      static const ULONG MaxBatchSize = 1024;
+
+      // Takes ownership of pEnum.
+      VssEnumObjectReader(IVssEnumObject *pEnum, ULONG batchSize);
+      ~VssEnumObjectReader();
+
+      // Returns a pointer to the next object of the enumeration, or NULL if there are
+      // no more objects. The pointer remains valid until the next call to Next().
+      VSS_OBJECT_PROP *Next();
+
+      // The number of calls made to IVssEnumObject::Next so far. Used by the tests to verify
+      // how many round trips an enumeration takes.
+      ULONG FetchCount() const { return m_fetchCount; }
+
+      // Frees the members of a VSS_OBJECT_PROP structure.
+      static void FreeObjectProp(VSS_OBJECT_PROP &prop);
+
+   private:
+      VssEnumObjectReader(const VssEnumObjectReader &);
+      VssEnumObjectReader &operator=(const VssEnumObjectReader &);
+
+      bool Fill();
+
+      IVssEnumObject *m_pEnum;
+      VSS_OBJECT_PROP *m_buffer;
+      ULONG m_capacity;
+      ULONG m_batchSize;
+      bool m_adaptive;
+      ULONG m_fetched;
+      ULONG m_position;
+      ULONG m_fetchCount;
+      bool m_exhausted;
+   };
+}
+} }
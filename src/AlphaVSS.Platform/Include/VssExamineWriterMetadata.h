@@ -19,7 +19,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       !VssExamineWriterMetadata();
 
       virtual bool LoadFromXml(String^ xml);
+      virtual bool LoadFromXml(System::IO::Stream^ stream, VssXmlStreamFormat format);
       virtual String^ SaveAsXml();
+      virtual void SaveAsXml(System::IO::Stream^ stream, VssXmlStreamFormat format);
       property VssBackupSchema BackupSchema { virtual VssBackupSchema get(); }
 
       property IList<VssWMFileDescriptor^>^ AlternateLocationMappings { virtual IList<VssWMFileDescriptor^>^ get(); }
@@ -43,20 +45,30 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       property IList<VssWMFileDescriptor^>^ ExcludeFromSnapshotFiles { virtual IList<VssWMFileDescriptor^>^ get(); }
    internal:
       [SecurityPermission(SecurityAction::LinkDemand)]
-      static IVssExamineWriterMetadata^ Adopt(::IVssExamineWriterMetadata *ewm);
+      static IVssExamineWriterMetadata^ Adopt(::IVssExamineWriterMetadata *ewm, VssStringCache^ stringCache);
+
+      // Retrieves all lazily loaded data of the writer and its components, returning the
+      // number of file descriptors retrieved.
+      int Materialize();
    private:
-      VssExamineWriterMetadata(::IVssExamineWriterMetadata *examineWriterMetadata);
+      VssExamineWriterMetadata(::IVssExamineWriterMetadata *examineWriterMetadata, VssStringCache^ stringCache, VssScope^ scope);
       ::IVssExamineWriterMetadata *mExamineWriterMetadata;
+      VssStringCache^ m_stringCache;
+      VssScope^ m_scope;
+
+      DEFINE_EX_INTERFACE_PROBES()
 
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WIN2003
-      DEFINE_EX_INTERFACE_ACCESSOR(IVssExamineWriterMetadataEx, mExamineWriterMetadata);
+      DEFINE_EX_INTERFACE_ACCESSOR(IVssExamineWriterMetadataEx, mExamineWriterMetadata, 0);
 #endif
 
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      DEFINE_EX_INTERFACE_ACCESSOR(IVssExamineWriterMetadataEx2, mExamineWriterMetadata);
+      DEFINE_EX_INTERFACE_ACCESSOR(IVssExamineWriterMetadataEx2, mExamineWriterMetadata, 1);
 #endif
 
       void Initialize();
+      bool LoadFromXmlResult(HRESULT hr);
+      System::Version^ ReadVersion();
 
       Guid m_instanceId;
       Guid m_writerId;
@@ -3,7 +3,22 @@
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
-
+	//
+	// Base class of the read-only lists that are backed by a native VSS object.
+	//
+	// Subclasses implement Count and GetItem, each of which makes a call to VSS. The indexer
+	// checks the index against Count before calling GetItem, so a loop over the indexer of a list
+	// of N elements takes 2N + 1 calls even if it reads Count only once. Enumerators, CopyTo, Contains
+	// and IndexOf read Count once and then call GetItem for each element, so a full pass takes
+	// N + 1 calls.
+	//
+	// The enumerator is a class rather than a struct. The lists are only handed out as IList<T>,
+	// so foreach binds to IEnumerable<T>::GetEnumerator and a struct enumerator would be boxed
+	// anyway.
+	//
+	// The owner of a list calls Invalidate whenever the native collection may have changed. 
+	// Enumerators created before that throw InvalidOperationException, like those of List<T>.
+	//
 	generic<typename T> 
 	private ref class VssListAdapter abstract : System::Collections::Generic::IList<T>, MarshalByRefObject
 	{
@@ -31,17 +46,27 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		
 		property T default[int] 
 		{
-			virtual T get (int index) abstract;
+			virtual T get (int index) sealed;
 			virtual void set (int index, T value);
 		};
 
+	internal:
+		void Invalidate();
+
+		// Changes whenever Invalidate is called.
+		property int Version { int get(); }
+
 	protected:
+		VssListAdapter();
+
+		// Returns the element at the specified index, which the caller has checked against Count.
+		virtual T GetItem(int index) abstract;
+
 		ref class Enumerator sealed : System::Collections::Generic::IEnumerator<T>
 		{
 		public:
 			Enumerator(VssListAdapter<T>^ list);
 			~Enumerator();
-			!Enumerator();
 
 			virtual bool MoveNext();
 			virtual void Reset();
@@ -56,8 +81,16 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 				virtual T get(); 
 			}
 		private:
+			void CheckVersion();
+
 			VssListAdapter<T>^ m_list;
+			int m_version;
+			int m_count;
 			int m_index;
+			T m_current;
 		};
+
+	private:
+		int m_version;
 	};
 } } }
@@ -20,8 +20,10 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    private:
       ::IVssSnapshotMgmt *m_snapshotMgmt;
 
+      DEFINE_EX_INTERFACE_PROBES()
+
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      DEFINE_EX_INTERFACE_ACCESSOR(IVssSnapshotMgmt2, m_snapshotMgmt)
+      DEFINE_EX_INTERFACE_ACCESSOR(IVssSnapshotMgmt2, m_snapshotMgmt, 0)
 #endif
    };
 
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vss.h>
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   //
+   // Native form of a VssSnapshotFilter, evaluated directly on the VSS_SNAPSHOT_PROP
+   // structures returned by VSS so that snapshots that do not match can be freed
+   // without creating any managed objects for them.
+   //
+   class VssSnapshotPredicate
+   {
+   public:
+      VssSnapshotPredicate(VssSnapshotFilter^ filter);
+      ~VssSnapshotPredicate();
+
+      bool Matches(const VSS_SNAPSHOT_PROP &prop) const;
+
+   private:
+      VssSnapshotPredicate(const VssSnapshotPredicate &);
+      VssSnapshotPredicate &operator=(const VssSnapshotPredicate &);
+
+      bool m_hasSnapshotSetId;
+      VSS_ID m_snapshotSetId;
+      bool m_hasProviderId;
+      VSS_ID m_providerId;
+      LONG m_requiredAttributes;
+      bool m_hasCreatedAfter;
+      VSS_TIMESTAMP m_createdAfter;
+      bool m_hasCreatedBefore;
+      VSS_TIMESTAMP m_createdBefore;
+      wchar_t *m_originalVolumeName;
+   };
+}
+} }
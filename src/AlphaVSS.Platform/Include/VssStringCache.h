@@ -0,0 +1,50 @@
+#pragma once
+
+using namespace System;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   //
+   // A bounded cache of managed strings, used to convert the names and paths returned by VSS
+   // so that repeated occurrences of the same value share a single System::String instance.
+   //
+   // The cache is a direct-mapped table indexed by a hash of the string contents; a string
+   // whose slot is occupied by a different string replaces it. Lookups and insertions are
+   // lock-free, so a cache can be shared by objects used from different threads. Strings
+   // longer than MaxLength are never cached.
+   //
+   // The static FromBStr and FromPwsz helpers accept a null cache, in which case they simply
+   // convert the string. They map a null pointer to the same value as FromBStr(BSTR) and
+   // gcnew String(const wchar_t *) respectively.
+   //
+   private ref class VssStringCache sealed
+   {
+   public:
+      static const int MaxLength = 1024;
+
+      VssStringCache(int capacity);
+
+      String^ Intern(const wchar_t *str, int length);
+
+      // Drops all cached strings. Subsequent lookups convert strings without caching them.
+      void Release();
+
+      property int Capacity { int get(); }
+      VssStringCacheStatistics^ GetStatistics();
+
+      static String^ FromBStr(VssStringCache^ cache, BSTR str);
+      static String^ FromPwsz(VssStringCache^ cache, const wchar_t *str);
+
+   private:
+      array<String^>^ m_entries;
+      int m_capacity;
+
+      // The number of occupied slots. Updated with Interlocked and read with VolatileRead, since
+      // Intern may run on several threads at once. An Intern that races with Release may still
+      // count a slot of the released table.
+      int m_count;
+      Int64 m_lookups;
+      Int64 m_hits;
+      Int64 m_bytesSaved;
+   };
+}}}
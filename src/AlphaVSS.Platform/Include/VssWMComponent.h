@@ -28,10 +28,16 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       property IList<VssWMFileDescriptor^>^ DatabaseLogFiles { virtual IList<VssWMFileDescriptor^>^ get(); }
       property IList<VssWMDependency^>^ Dependencies { virtual IList<VssWMDependency^>^ get(); }
    internal:
-      static VssWMComponent^ Adopt(::IVssWMComponent *component);
+      static VssWMComponent^ Adopt(::IVssWMComponent *component, VssStringCache^ stringCache, VssScope^ scope);
+
+      // Retrieves the files and dependencies of the component and releases the native
+      // component, returning the number of file descriptors retrieved.
+      int Materialize();
    private:
-      VssWMComponent(::IVssWMComponent *component);
+      VssWMComponent(::IVssWMComponent *component, VssStringCache^ stringCache, VssScope^ scope);
       ::IVssWMComponent *m_component;
+      VssStringCache^ m_stringCache;
+      VssScope^ m_scope;
 
       VssComponentType m_type;
       String^ m_logicalPath;
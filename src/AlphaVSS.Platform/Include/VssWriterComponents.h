@@ -18,10 +18,14 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		property Guid WriterId { virtual Guid get(); }
 
 	internal:
-		static VssWriterComponents^ Adopt(IVssWriterComponentsExt *vssWriterComponents);
+		static VssWriterComponents^ Adopt(IVssWriterComponentsExt *vssWriterComponents, VssStringCache^ stringCache, VssListAdapter<IVssWriterComponents^>^ owner);
 	private:
-		VssWriterComponents(IVssWriterComponentsExt *vssWriterComponents);
+		VssWriterComponents(IVssWriterComponentsExt *vssWriterComponents, VssStringCache^ stringCache, VssScope^ scope, VssListAdapter<IVssWriterComponents^>^ owner);
 		IVssWriterComponentsExt *mVssWriterComponents;
+		VssStringCache^ m_stringCache;
+		VssScope^ m_scope;
+		// The list this object was obtained from, which is invalidated whenever the backup components document is modified.
+		VssListAdapter<IVssWriterComponents^>^ m_owner;
 
 		ref class ComponentList sealed : VssListAdapter<IVssComponent^>
 		{
@@ -29,9 +33,14 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 			ComponentList(VssWriterComponents^ component);
 
 			property int Count { virtual int get() override; }
-			property IVssComponent^ default[int] { virtual IVssComponent^ get(int index) override; }
+		protected:
+			virtual IVssComponent^ GetItem(int index) override;
 		private:
 			VssWriterComponents^ mWriterComponents;
+
+			// The wrappers created so far, so that reading an element repeatedly does not register
+			// a new wrapper with the scope every time.
+			array<VssComponent^>^ m_items;
 		};
 
 		ComponentList^ m_components;
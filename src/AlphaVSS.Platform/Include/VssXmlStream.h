@@ -0,0 +1,34 @@
+#pragma once
+
+using namespace System;
+using namespace System::IO;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   //
+   // Transfers the XML documents exchanged with VSS (Backup Components Documents and Writer
+   // Metadata Documents) between a BSTR and a stream in fixed size chunks, so that the
+   // document never needs to exist as a System::String. Depending on the VssXmlStreamFormat,
+   // the document is transcoded to UTF-8 and compressed on the fly.
+   //
+   private ref class VssXmlStream abstract sealed
+   {
+   public:
+      // Writes the document in xml to stream. The stream is flushed but not closed.
+      static void Write(BSTR xml, Stream^ stream, VssXmlStreamFormat format);
+
+      // Reads a document from the current position of stream to its end. The returned BSTR
+      // must be freed by the caller, typically by assigning it to an AutoBStr.
+      static BSTR Read(Stream^ stream, VssXmlStreamFormat format);
+
+      // Throws if stream is null or format is not a defined VssXmlStreamFormat. Callers that
+      // obtain the document from VSS first use this to fail before making the COM call.
+      static void ValidateArguments(Stream^ stream, VssXmlStreamFormat format);
+
+   private:
+      // The number of characters transcoded per chunk.
+      static const int ChunkSize = 16384;
+
+      static Text::Encoding^ GetEncoding(VssXmlStreamFormat format);
+   };
+}}}
@@ -2,46 +2,222 @@
 
 #include <StdAfx.h>
 #include "VssAsyncResult.h"
+#include "VssAsyncPoller.h"
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
    VssAsyncResult::VssAsyncResult(::IVssAsync *vssAsync, AsyncCallback^ userCallback, Object^ asyncState)
-      : m_isComplete(0), m_asyncCallback(userCallback), m_asyncState(asyncState), m_asyncWaitHandle(nullptr), m_vssAsync(vssAsync), m_exception(nullptr)
+      : m_isComplete(0), m_asyncCallback(userCallback), m_asyncState(asyncState), m_asyncWaitHandle(nullptr), m_vssAsync(vssAsync), m_exception(nullptr),
+        m_sampleLock(gcnew Object()), m_status(VssAsyncStatus::Pending), m_sampleCount(0), m_firstSampleTicks(-1), m_completionTicks(-1),
+        m_lastProgressTicks(0), m_progressInterval(TimeSpan::TicksPerSecond),
+        m_progressEvents(gcnew Queue<VssAsyncProgressEventArgs^>()), m_dispatchingProgress(false)
    {
-      if (!ThreadPool::QueueUserWorkItem(gcnew WaitCallback(this, &VssAsyncResult::WaitForAsyncCompletion)))
+      m_startTime = DateTime::UtcNow;
+      m_stopwatch = System::Diagnostics::Stopwatch::StartNew();
+
+      // The poller holds a reference to this instance until the operation completes.
+      VssAsyncPoller::Register(this);
+   }
+
+   bool VssAsyncResult::Poll(int waitTimeout)
+   {
+      HRESULT hrResult = S_OK;
+      bool disposed = false;
+
+      Monitor::Enter(this);
+      try
+      {
+         if (m_vssAsync == 0)
+         {
+            disposed = true;
+         }
+         else
+         {
+#if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
+            // The outcome of the wait is determined by QueryStatus below.
+            if (waitTimeout > 0)
+               m_vssAsync->Wait(waitTimeout);
+#endif
+            HRESULT hr = m_vssAsync->QueryStatus(&hrResult, NULL);
+            if (FAILED(hr))
+               hrResult = hr;
+         }
+      }
+      finally
       {
-         throw gcnew Exception(L"ThreadPool::QueueUserWorkItem failed.");
+         Monitor::Exit(this);
       }
+
+      VssAsyncStatus status = disposed ? VssAsyncStatus::Failed : ToStatus(hrResult);
+      Sample(status);
+
+      if (status == VssAsyncStatus::Pending)
+         return false;
+
+      if (disposed)
+         Complete(gcnew ObjectDisposedException(GetType()->FullName));
+      else if (FAILED(hrResult))
+         Complete(GetExceptionForHr(hrResult));
+      else if (hrResult == VSS_S_ASYNC_CANCELLED)
+         Complete(gcnew OperationCanceledException());
+      else
+         Complete(nullptr);
+
+      return true;
    }
 
-   void VssAsyncResult::WaitForAsyncCompletion(Object^ state)
+   void VssAsyncResult::Sample(VssAsyncStatus status)
    {
-      HRESULT hrResult;
-      
-      hrResult = m_vssAsync->Wait();
+      Int64 elapsed = m_stopwatch->ElapsedTicks;
+      bool dispatch = false;
 
-      int prevState = Interlocked::Exchange(m_isComplete, -1);
+      Monitor::Enter(m_sampleLock);
+      try
+      {
+         VssAsyncStatus previousStatus = m_status;
+         m_status = status;
+         m_sampleCount++;
 
-      if (prevState != 0)
-         throw gcnew InvalidOperationException("WaitForAsyncCompletion can only be called once.");
+         // Recorded on the first poll, whatever its result.
+         if (m_firstSampleTicks < 0)
+            m_firstSampleTicks = elapsed;
+
+         if (status != VssAsyncStatus::Pending && m_completionTicks < 0)
+            m_completionTicks = elapsed;
 
-      if (SUCCEEDED(hrResult))
+         if (status != previousStatus || ToTimeSpan(elapsed - m_lastProgressTicks).Ticks >= Interlocked::Read(m_progressInterval))
+         {
+            m_lastProgressTicks = elapsed;
+            m_progressEvents->Enqueue(gcnew VssAsyncProgressEventArgs(status, previousStatus, ToTimeSpan(elapsed)));
+            if (!m_dispatchingProgress)
+            {
+               m_dispatchingProgress = true;
+               dispatch = true;
+            }
+         }
+      }
+      finally
       {
-         HRESULT hr = m_vssAsync->QueryStatus(&hrResult, NULL);
-         if (FAILED(hr))
-            hrResult = hr;
+         Monitor::Exit(m_sampleLock);
       }
 
-      if (FAILED(hrResult))
-         m_exception = GetExceptionForHr(hrResult);
+      // The event is not raised on the poller thread, since a slow or failing handler would stall the
+      // completion of this and all other operations. At most one work item raises the events of an
+      // operation at any time, so handlers see them in the order in which they were sampled.
+      if (dispatch)
+         ThreadPool::QueueUserWorkItem(gcnew WaitCallback(this, &VssAsyncResult::RaiseProgressChanged));
+   }
+
+   void VssAsyncResult::RaiseProgressChanged(Object^ state)
+   {
+      for (;;)
+      {
+         VssAsyncProgressEventArgs^ e;
+
+         Monitor::Enter(m_sampleLock);
+         try
+         {
+            if (m_progressEvents->Count == 0)
+            {
+               m_dispatchingProgress = false;
+               return;
+            }
+
+            e = m_progressEvents->Dequeue();
+         }
+         finally
+         {
+            Monitor::Exit(m_sampleLock);
+         }
+
+         try
+         {
+            ProgressChanged(this, e);
+         }
+         catch (Exception^)
+         {
+            // There is no caller to report the exception to, and an unhandled exception on a thread
+            // pool thread would terminate the process. The remaining events are still raised.
+         }
+      }
+   }
+
+   VssAsyncStatus VssAsyncResult::ToStatus(HRESULT hrResult)
+   {
+      if (hrResult == VSS_S_ASYNC_PENDING)
+         return VssAsyncStatus::Pending;
       else if (hrResult == VSS_S_ASYNC_CANCELLED)
-         m_exception = gcnew OperationCanceledException();
+         return VssAsyncStatus::Canceled;
+      else if (FAILED(hrResult))
+         return VssAsyncStatus::Failed;
+      else
+         return VssAsyncStatus::Finished;
+   }
+
+   TimeSpan VssAsyncResult::ToTimeSpan(Int64 stopwatchTicks)
+   {
+      return TimeSpan::FromTicks((Int64)(stopwatchTicks * ((double)TimeSpan::TicksPerSecond / System::Diagnostics::Stopwatch::Frequency)));
+   }
+
+   TimeSpan VssAsyncResult::ProgressInterval::get()
+   {
+      return TimeSpan::FromTicks(Interlocked::Read(m_progressInterval));
+   }
+
+   void VssAsyncResult::ProgressInterval::set(TimeSpan value)
+   {
+      if (value < TimeSpan::Zero)
+         throw gcnew ArgumentOutOfRangeException("value", "The progress interval must not be negative.");
+
+      Interlocked::Exchange(m_progressInterval, value.Ticks);
+   }
+
+   VssAsyncTiming^ VssAsyncResult::Timing::get()
+   {
+      Monitor::Enter(m_sampleLock);
+      try
+      {
+         return gcnew VssAsyncTiming(m_startTime,
+            m_firstSampleTicks < 0 ? Nullable<TimeSpan>() : Nullable<TimeSpan>(ToTimeSpan(m_firstSampleTicks)),
+            m_completionTicks < 0 ? Nullable<TimeSpan>() : Nullable<TimeSpan>(ToTimeSpan(m_completionTicks)),
+            m_status, m_sampleCount);
+      }
+      finally
+      {
+         Monitor::Exit(m_sampleLock);
+      }
+   }
+
+   void VssAsyncResult::Complete(Exception^ exception)
+   {
+      // The exception must be set before the operation is marked as completed, since EndInvoke
+      // does not wait for operations that are already completed.
+      m_exception = exception;
+
+      int prevState = Interlocked::Exchange(m_isComplete, -1);
+      if (prevState != 0)
+         throw gcnew InvalidOperationException("Complete can only be called once.");
 
       if (m_asyncWaitHandle != nullptr)
          m_asyncWaitHandle->Set();
 
+      // The callback is not invoked on the poller thread, since a callback that blocks (for instance
+      // by waiting for another VSS operation) would stall the completion of all other operations.
       if (m_asyncCallback != nullptr)
-         m_asyncCallback(this);
+         ThreadPool::QueueUserWorkItem(gcnew WaitCallback(this, &VssAsyncResult::InvokeCallback));
+   }
+
+   void VssAsyncResult::Fail(Exception^ exception)
+   {
+      // Operations are only completed on the poller thread, so the operation cannot be completed
+      // concurrently.
+      if (!IsCompleted)
+         Complete(exception);
+   }
+
+   void VssAsyncResult::InvokeCallback(Object^ state)
+   {
+      m_asyncCallback(this);
    }
 
    void VssAsyncResult::EndInvoke()
@@ -98,20 +274,35 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    VssAsyncResult^ VssAsyncResult::Create(::IVssAsync *vssAsync, AsyncCallback^ userCallback, Object^ asyncState)
    {
+      VssScope^ scope = VssScope::Current;
+      VssAsyncResult^ result;
       try
       {
-         return gcnew VssAsyncResult(vssAsync, userCallback, asyncState);
+         result = gcnew VssAsyncResult(vssAsync, userCallback, asyncState);
       }
       catch (...)
       {
          vssAsync->Release();
          throw;
       }
+
+      result->m_scope = scope;
+      AttachToScope(scope, result);
+      return result;
    }
 
    VssAsyncResult::~VssAsyncResult()
    {
-      this->!VssAsyncResult();
+      DetachFromScope(m_scope, this);
+      Monitor::Enter(this);
+      try
+      {
+         this->!VssAsyncResult();
+      }
+      finally
+      {
+         Monitor::Exit(this);
+      }
    }
 
    VssAsyncResult::!VssAsyncResult()
@@ -125,5 +316,24 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssAsyncResult::Cancel()
    {
+      Monitor::Enter(this);
+      try
+      {
+         if (m_vssAsync == 0)
+            throw gcnew ObjectDisposedException(GetType()->FullName);
+
+         if (IsCompleted)
+            return;
+
+         // VSS_S_ASYNC_FINISHED and VSS_S_ASYNC_CANCELLED are success codes, so an operation that
+         // completes concurrently does not cause an exception here.
+         CheckCom(m_vssAsync->Cancel());
+      }
+      finally
+      {
+         Monitor::Exit(this);
+      }
+
+      VssAsyncPoller::Wake();
    }
 }}}
\ No newline at end of file
@@ -7,7 +7,7 @@
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
-   VssWMFileDescriptor^ CreateVssWMFileDescriptor(IVssWMFiledesc *vssWMFiledesc)
+   VssWMFileDescriptor^ CreateVssWMFileDescriptor(IVssWMFiledesc *vssWMFiledesc, VssStringCache^ cache)
    {
       try
       {
@@ -25,7 +25,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          bool bRecursive;
          CheckCom(vssWMFiledesc->GetRecursive(&bRecursive));
 
-         return gcnew VssWMFileDescriptor(bstrAlternateLocation, (VssFileSpecificationBackupType)dwTypeMask, bstrFilespec, bstrPath, bRecursive);
+         return gcnew VssWMFileDescriptor(VssStringCache::FromBStr(cache, bstrAlternateLocation), (VssFileSpecificationBackupType)dwTypeMask,
+            VssStringCache::FromBStr(cache, bstrFilespec), VssStringCache::FromBStr(cache, bstrPath), bRecursive);
       }
       finally
       {
@@ -55,7 +56,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    }
 
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WIN2003
-   VssWMDependency^ CreateVssWMDependency(IVssWMDependency *dependency)		
+   VssWMDependency^ CreateVssWMDependency(IVssWMDependency *dependency, VssStringCache^ cache)
    {
       try
       {
@@ -68,7 +69,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
          AutoBStr componentName;
          CheckCom(dependency->GetComponentName(&componentName));
 
-         return gcnew VssWMDependency(ToGuid(id), logicalPath, componentName);
+         return gcnew VssWMDependency(ToGuid(id), VssStringCache::FromBStr(cache, logicalPath), VssStringCache::FromBStr(cache, componentName));
       }
       finally 
       {
@@ -77,7 +78,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    }
 #endif
 
-   VssSnapshotProperties^ CreateVssSnapshotProperties(VSS_SNAPSHOT_PROP *prop)
+   VssSnapshotProperties^ CreateVssSnapshotProperties(VSS_SNAPSHOT_PROP *prop, VssStringCache^ cache)
    {
       try
       {
@@ -85,12 +86,12 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
             ToGuid(prop->m_SnapshotId),
             ToGuid(prop->m_SnapshotSetId),
             prop->m_lSnapshotsCount,
-            gcnew String(prop->m_pwszSnapshotDeviceObject),
-            gcnew String(prop->m_pwszOriginalVolumeName),
-            gcnew String(prop->m_pwszOriginatingMachine),
-            gcnew String(prop->m_pwszServiceMachine),
-            gcnew String(prop->m_pwszExposedName),
-            gcnew String(prop->m_pwszExposedPath),
+            VssStringCache::FromPwsz(cache, prop->m_pwszSnapshotDeviceObject),
+            VssStringCache::FromPwsz(cache, prop->m_pwszOriginalVolumeName),
+            VssStringCache::FromPwsz(cache, prop->m_pwszOriginatingMachine),
+            VssStringCache::FromPwsz(cache, prop->m_pwszServiceMachine),
+            VssStringCache::FromPwsz(cache, prop->m_pwszExposedName),
+            VssStringCache::FromPwsz(cache, prop->m_pwszExposedPath),
             ToGuid(prop->m_ProviderId),
             (VssVolumeSnapshotAttributes)prop->m_lSnapshotAttributes,
             ToDateTime(prop->m_tsCreationTimestamp),
@@ -0,0 +1,113 @@
+#include "StdAfx.h"
+
+#include "VssAsyncPoller.h"
+#include "VssAsyncResult.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   static VssAsyncPoller::VssAsyncPoller()
+   {
+      s_lock = gcnew Object();
+      s_incoming = gcnew List<VssAsyncResult^>();
+      s_wakeup = gcnew AutoResetEvent(false);
+      s_thread = nullptr;
+   }
+
+   void VssAsyncPoller::Register(VssAsyncResult^ result)
+   {
+      Monitor::Enter(s_lock);
+      try
+      {
+         s_incoming->Add(result);
+
+         if (s_thread == nullptr)
+         {
+            Thread^ thread = gcnew Thread(gcnew ThreadStart(&VssAsyncPoller::Run));
+            thread->Name = "AlphaVSS async completion";
+            thread->IsBackground = true;
+            thread->SetApartmentState(ApartmentState::MTA);
+            thread->Start();
+            s_thread = thread;
+         }
+      }
+      finally
+      {
+         Monitor::Exit(s_lock);
+      }
+
+      s_wakeup->Set();
+   }
+
+   void VssAsyncPoller::Wake()
+   {
+      s_wakeup->Set();
+   }
+
+   void VssAsyncPoller::Run()
+   {
+      // Only accessed from this thread.
+      List<VssAsyncResult^>^ pending = gcnew List<VssAsyncResult^>();
+      int interval = InitialPollInterval;
+
+      for (;;)
+      {
+         if (pending->Count == 0)
+            s_wakeup->WaitOne();
+
+         Monitor::Enter(s_lock);
+         try
+         {
+            if (s_incoming->Count > 0)
+            {
+               pending->AddRange(s_incoming);
+               s_incoming->Clear();
+               interval = InitialPollInterval;
+            }
+         }
+         finally
+         {
+            Monitor::Exit(s_lock);
+         }
+
+         int waitTimeout = pending->Count == 1 ? Math::Min(interval, (int)MaxWaitTimeout) : 0;
+         bool progress = false;
+
+         for (int i = pending->Count - 1; i >= 0; i--)
+         {
+            bool completed;
+            try
+            {
+               completed = pending[i]->Poll(waitTimeout);
+            }
+            catch (Exception^ ex)
+            {
+               // An exception must not terminate the poller thread, since that would leave all other
+               // operations pending forever. The operation that failed is completed with the exception.
+               pending[i]->Fail(ex);
+               completed = true;
+            }
+
+            if (completed)
+            {
+               pending->RemoveAt(i);
+               progress = true;
+            }
+         }
+
+         if (pending->Count == 0 || progress)
+         {
+            interval = InitialPollInterval;
+            continue;
+         }
+
+#if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
+         // The single pending operation has already been waited for in IVssAsync::Wait.
+         if (waitTimeout == 0)
+            s_wakeup->WaitOne(interval);
+#else
+         s_wakeup->WaitOne(interval);
+#endif
+         interval = Math::Min(interval * 2, (int)MaxPollInterval);
+      }
+   }
+}}}
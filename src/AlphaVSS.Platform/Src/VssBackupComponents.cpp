@@ -4,6 +4,8 @@
 #include "VsBackup.h"
 #include "VssBackupComponents.h"
 #include "VssAsyncResult.h"
+#include "VssEnumObjectReader.h"
+#include "VssXmlStream.h"
 
 #include "Utils.h"
 #include "Macros.h"
@@ -26,8 +28,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 #endif
       m_writerMetadata(nullptr),
       m_writerComponents(nullptr),
-      m_writerStatus(nullptr)
-
+      m_writerStatus(nullptr),
+      m_enumerationBatchSize(0),
+      m_stringCache(nullptr)
    {
       m_writerMetadata = gcnew WriterMetadataList(this);
       m_writerComponents = gcnew WriterComponentsList(this);
@@ -39,11 +42,18 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    VssBackupComponents::~VssBackupComponents()
    {
+      InvalidateWriterLists();
       this->!VssBackupComponents();
    }
 
    VssBackupComponents::!VssBackupComponents()
    {
+      if (m_stringCache != nullptr)
+      {
+         m_stringCache->Release();
+         m_stringCache = nullptr;
+      }
+
       if (m_backup != 0)
       {
          m_backup->Release();
@@ -78,30 +88,46 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::AbortBackup()
    {
+      InvalidateWriterLists();
       CheckCom(m_backup->AbortBackup());
    }
 
    void VssBackupComponents::AddAlternativeLocationMapping(Guid writerId, VssComponentType componentType, String ^ logicalPath, String ^ componentName, String ^ path, String ^ filespec, bool recursive, String ^ destination)
    {
+      InvalidateWriterLists();
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      NoNullPinMStr(pwszPath, path);
+      NoNullPinMStr(pwszFilespec, filespec);
+      NoNullPinMStr(pwszDestination, destination);
       CheckCom(m_backup->AddAlternativeLocationMapping(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, 
-         AutoMStr(logicalPath), NoNullAutoMStr(componentName), NoNullAutoMStr(path),
-         NoNullAutoMStr(filespec), recursive, NoNullAutoMStr(destination)));
+         pwszLogicalPath, pwszComponentName, pwszPath,
+         pwszFilespec, recursive, pwszDestination));
    }
 
    void VssBackupComponents::AddComponent(Guid instanceId, Guid writerId, VssComponentType componentType, String ^ logicalPath, String ^ componentName)
    {
+      InvalidateWriterLists();
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
       CheckCom(m_backup->AddComponent(ToVssId(instanceId), ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, 
-         AutoMStr(logicalPath), NoNullAutoMStr(componentName)));
+         pwszLogicalPath, pwszComponentName));
    }
 
    void VssBackupComponents::AddNewTarget(Guid writerId, VssComponentType componentType, String ^ logicalPath, String ^ componentName, String ^ path, String ^ fileName, bool recursive, String ^ alternatePath)
    {
+      InvalidateWriterLists();
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WIN2003
-      OperatingSystemInfo::RequireAtLeast(OSVersionName::WindowsServer2003);		
+      OperatingSystemFlags::Require(OperatingSystemFlags::IsWindowsServer2003OrLater);		
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      NoNullPinMStr(pwszPath, path);
+      NoNullPinMStr(pwszFileName, fileName);
+      NoNullPinMStr(pwszAlternatePath, alternatePath);
       CheckCom(m_backup->AddNewTarget(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType,
-         AutoMStr(logicalPath), NoNullAutoMStr(componentName),
-         NoNullAutoMStr(path), NoNullAutoMStr(fileName),
-         recursive, NoNullAutoMStr(alternatePath)));
+         pwszLogicalPath, pwszComponentName,
+         pwszPath, pwszFileName,
+         recursive, pwszAlternatePath));
 #else
       UnsupportedOs();
 #endif
@@ -109,31 +135,48 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::AddRestoreSubcomponent(Guid writerId, VssComponentType componentType, String^ logicalPath, String ^componentName, String^ subcomponentLogicalPath, String^ subcomponentName)
    {
+      InvalidateWriterLists();
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      NoNullPinMStr(pwszSubcomponentLogicalPath, subcomponentLogicalPath);
+      NoNullPinMStr(pwszSubcomponentName, subcomponentName);
       CheckCom(m_backup->AddRestoreSubcomponent(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType,
-         AutoMStr(logicalPath),
-         NoNullAutoMStr(componentName),
-         NoNullAutoMStr(subcomponentLogicalPath),
-         NoNullAutoMStr(subcomponentName),
+         pwszLogicalPath,
+         pwszComponentName,
+         pwszSubcomponentLogicalPath,
+         pwszSubcomponentName,
          false));
    }
 
    Guid VssBackupComponents::AddToSnapshotSet(String ^ volumeName, Guid providerId)
    {
       VSS_ID idSnapshot;
-      CheckCom(m_backup->AddToSnapshotSet(NoNullAutoMStr(volumeName), ToVssId(providerId), &idSnapshot));
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      CheckCom(m_backup->AddToSnapshotSet(pwszVolumeName, ToVssId(providerId), &idSnapshot));
       return ToGuid(idSnapshot);
    }
 
    Guid VssBackupComponents::AddToSnapshotSet(String^ volumeName)
    {
       VSS_ID idSnapshot;
-      CheckCom(m_backup->AddToSnapshotSet(NoNullAutoMStr(volumeName), ToVssId(Guid::Empty), &idSnapshot));
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      CheckCom(m_backup->AddToSnapshotSet(pwszVolumeName, ToVssId(Guid::Empty), &idSnapshot));
       return ToGuid(idSnapshot);
    }
 
+   VssResult VssBackupComponents::TryAddToSnapshotSet(String^ volumeName, Guid providerId, Guid% snapshotId)
+   {
+      VSS_ID idSnapshot;
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      HRESULT hr = m_backup->AddToSnapshotSet(pwszVolumeName, ToVssId(providerId), &idSnapshot);
+      snapshotId = SUCCEEDED(hr) ? ToGuid(idSnapshot) : Guid::Empty;
+      return VssResult((VssError)hr);
+   }
+
    [SecurityPermissionAttribute(SecurityAction::LinkDemand)]
    void VssBackupComponents::BackupComplete()
    {
+      InvalidateWriterLists();
       ::IVssAsync *pAsync;
       CheckCom(m_backup->BackupComplete(&pAsync));      
       WaitCheckAndReleaseVssAsyncOperation(pAsync);
@@ -141,6 +184,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    IVssAsyncResult^ VssBackupComponents::BeginBackupComplete(AsyncCallback^ userCallback, Object^ stateObject)
    {
+      InvalidateWriterLists();
       ::IVssAsync *pAsync;
       CheckCom(m_backup->BackupComplete(&pAsync));
       return VssAsyncResult::Create(pAsync, userCallback, stateObject);
@@ -148,6 +192,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::EndBackupComplete(IAsyncResult^ asyncResult)
    {
+      InvalidateWriterLists();
       VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
       result->EndInvoke();
    }
@@ -192,6 +237,13 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       CheckCom(m_backup->DeleteSnapshots(ToVssId(snapshotId), VSS_OBJECT_SNAPSHOT, forceDelete, &lDeletedSnapshots, &nonDeletedSnapshotID));
    }
 
+   VssResult VssBackupComponents::TryDeleteSnapshot(Guid snapshotId, bool forceDelete)
+   {
+      LONG lDeletedSnapshots;
+      VSS_ID nonDeletedSnapshotID;
+      return VssResult((VssError)m_backup->DeleteSnapshots(ToVssId(snapshotId), VSS_OBJECT_SNAPSHOT, forceDelete, &lDeletedSnapshots, &nonDeletedSnapshotID));
+   }
+
    int VssBackupComponents::DeleteSnapshotSet(Guid snapshotSetId, bool forceDelete)
    {
       LONG lDeletedSnapshots;
@@ -208,16 +260,19 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::DisableWriterClasses(array<Guid> ^ writerClassIds)
    {
+      InvalidateWriterLists();
       CheckCom(m_backup->DisableWriterClasses(VssIds(writerClassIds), writerClassIds->Length));
    }
 
    void VssBackupComponents::DisableWriterInstances(array<Guid> ^ writerInstanceIds)
    {
+      InvalidateWriterLists();
       CheckCom(m_backup->DisableWriterInstances(VssIds(writerInstanceIds), writerInstanceIds->Length));
    }
 
    void VssBackupComponents::DoSnapshotSet()
    {
+      InvalidateWriterLists();
       ::IVssAsync *vssAsync;
       CheckCom(m_backup->DoSnapshotSet(&vssAsync));
       WaitCheckAndReleaseVssAsyncOperation(vssAsync);
@@ -226,6 +281,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    IVssAsyncResult^ VssBackupComponents::BeginDoSnapshotSet(AsyncCallback^ userCallback, Object^ stateObject)
    {
+      InvalidateWriterLists();
       ::IVssAsync *pAsync;
       CheckCom(m_backup->DoSnapshotSet(&pAsync));
       return VssAsyncResult::Create(pAsync, userCallback, stateObject);
@@ -233,37 +289,44 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::EndDoSnapshotSet(IAsyncResult^ asyncResult)
    {
+      InvalidateWriterLists();
       VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
       result->EndInvoke();
    }
 
    void VssBackupComponents::EnableWriterClasses(array<Guid> ^ writerClassIds)
    {
+      InvalidateWriterLists();
       CheckCom(m_backup->EnableWriterClasses(VssIds(writerClassIds), writerClassIds->Length));
    }
 
    String^ VssBackupComponents::ExposeSnapshot(Guid snapshotId, String ^ pathFromRoot, VssVolumeSnapshotAttributes attributes, String ^ expose)
    {
       AutoPwsz pwszExposed;
+      PinMStr(pwszPathFromRoot, pathFromRoot);
+      PinMStr(pwszExpose, expose);
 
-      CheckCom(m_backup->ExposeSnapshot(ToVssId(snapshotId), AutoMStr(pathFromRoot), (LONG)attributes,
-         AutoMStr(expose), &pwszExposed));
+      CheckCom(m_backup->ExposeSnapshot(ToVssId(snapshotId), pwszPathFromRoot, (LONG)attributes,
+         pwszExpose, &pwszExposed));
 
       return pwszExposed;
    }
 
    void VssBackupComponents::FreeWriterMetadata()
    {
+      InvalidateWriterLists();
       CheckCom(m_backup->FreeWriterMetadata());
    }
 
    void VssBackupComponents::FreeWriterStatus()
    {
+      InvalidateWriterLists();
       CheckCom(m_backup->FreeWriterStatus());
    }
 
    void VssBackupComponents::GatherWriterMetadata()
    {
+      InvalidateWriterLists();
       ::IVssAsync *pAsync;
       CheckCom(m_backup->GatherWriterMetadata(&pAsync));
       WaitCheckAndReleaseVssAsyncOperation(pAsync);
@@ -271,6 +334,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    IVssAsyncResult^ VssBackupComponents::BeginGatherWriterMetadata(AsyncCallback^ userCallback, Object^ stateObject)
    {
+      InvalidateWriterLists();
       ::IVssAsync *pAsync;
       CheckCom(m_backup->GatherWriterMetadata(&pAsync));
       return VssAsyncResult::Create(pAsync, userCallback, stateObject);
@@ -278,12 +342,14 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::EndGatherWriterMetadata(IAsyncResult^ asyncResult)
    {
+      InvalidateWriterLists();
       VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
       result->EndInvoke();
    }
 
    void VssBackupComponents::GatherWriterStatus()
    {
+      InvalidateWriterLists();
       ::IVssAsync *pAsync;
       CheckCom(m_backup->GatherWriterStatus(&pAsync));
       WaitCheckAndReleaseVssAsyncOperation(pAsync);
@@ -291,6 +357,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    IVssAsyncResult^ VssBackupComponents::BeginGatherWriterStatus(AsyncCallback^ userCallback, Object^ stateObject)
    {
+      InvalidateWriterLists();
       ::IVssAsync *pAsync;
       CheckCom(m_backup->GatherWriterStatus(&pAsync));
       return VssAsyncResult::Create(pAsync, userCallback, stateObject);
@@ -298,6 +365,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::EndGatherWriterStatus(IAsyncResult^ asyncResult)
    {
+      InvalidateWriterLists();
       VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
       result->EndInvoke();
    }
@@ -306,7 +374,15 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    {
       VSS_SNAPSHOT_PROP prop;
       CheckCom(m_backup->GetSnapshotProperties(ToVssId(snapshotId), &prop));
-      return CreateVssSnapshotProperties(&prop);
+      return CreateVssSnapshotProperties(&prop, m_stringCache);
+   }
+
+   VssResult VssBackupComponents::TryGetSnapshotProperties(Guid snapshotId, VssSnapshotProperties^% properties)
+   {
+      VSS_SNAPSHOT_PROP prop;
+      HRESULT hr = m_backup->GetSnapshotProperties(ToVssId(snapshotId), &prop);
+      properties = SUCCEEDED(hr) ? CreateVssSnapshotProperties(&prop, m_stringCache) : nullptr;
+      return VssResult((VssError)hr);
    }
 
    VssBackupComponents::WriterStatusList::WriterStatusList(VssBackupComponents^ backupComponents)
@@ -324,14 +400,26 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       return (int)cWriters;
    }
 
-   VssWriterStatusInfo^ VssBackupComponents::WriterStatusList::default::get(int index)
+   VssWriterStatusInfo^ VssBackupComponents::WriterStatusList::GetItem(int index)
    {
-      if (index < 0 || index > Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       if (m_backupComponents->m_backup == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
+      return m_backupComponents->GetWriterStatusInfo(index);
+   }
+
+   void VssBackupComponents::InvalidateWriterLists()
+   {
+      // Any of the writer lists may change when writer metadata or status is gathered or freed, 
+      // when the backup components document is loaded or modified, or when a backup or restore
+      // step changes the state of the writers. Every method doing so calls this method first.
+      m_writerMetadata->Invalidate();
+      m_writerComponents->Invalidate();
+      m_writerStatus->Invalidate();
+   }
+
+   VssWriterStatusInfo^ VssBackupComponents::GetWriterStatusInfo(UINT index)
+   {
       VSS_ID idInstance, idWriter;
       AutoBStr bstrWriter;
       VSS_WRITER_STATE eState;
@@ -340,17 +428,31 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
       HRESULT hrApplication;
       AutoBStr bstrApplicationMessage = NULL;
-      IVssBackupComponentsEx3 *pVbc3 = m_backupComponents->GetIVssBackupComponentsEx3();
+      IVssBackupComponentsEx3 *pVbc3 = GetIVssBackupComponentsEx3();
       if (pVbc3 != NULL)
       {
          CheckCom(pVbc3->GetWriterStatusEx(index, &idInstance, &idWriter, &bstrWriter, &eState, &hrResultFailure, &hrApplication, &bstrApplicationMessage));
          return gcnew VssWriterStatusInfo(ToGuid(idInstance), ToGuid(idWriter), bstrWriter, (VssWriterState)eState, (VssError)hrResultFailure, hrApplication, bstrApplicationMessage);
       }
 #endif
-      CheckCom(m_backupComponents->m_backup->GetWriterStatus(index, &idInstance, &idWriter, &bstrWriter, &eState, &hrResultFailure));
+      CheckCom(m_backup->GetWriterStatus(index, &idInstance, &idWriter, &bstrWriter, &eState, &hrResultFailure));
       return gcnew VssWriterStatusInfo(ToGuid(idInstance), ToGuid(idWriter), bstrWriter, (VssWriterState)eState, (VssError)hrResultFailure);
    }
 
+   IList<VssWriterStatusInfo^>^ VssBackupComponents::QueryWriterStatus()
+   {
+      // One call for the count and one per writer. The Ex3 interface pointer is cached by
+      // GetIVssBackupComponentsEx3, so it is only queried for once.
+      UINT cWriters;
+      CheckCom(m_backup->GetWriterStatusCount(&cWriters));
+
+      array<VssWriterStatusInfo^>^ result = gcnew array<VssWriterStatusInfo^>(cWriters);
+      for (UINT i = 0; i < cWriters; i++)
+         result[i] = GetWriterStatusInfo(i);
+
+      return Array::AsReadOnly(result);
+   }
+
 
    VssBackupComponents::WriterComponentsList::WriterComponentsList(VssBackupComponents^ backupComponents)
       : m_backupComponents(backupComponents)
@@ -367,17 +469,14 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       return (int)cComponent;
    }
 
-   IVssWriterComponents^ VssBackupComponents::WriterComponentsList::default::get(int index)
+   IVssWriterComponents^ VssBackupComponents::WriterComponentsList::GetItem(int index)
    {
-      if (index < 0 || index > Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       if (m_backupComponents->m_backup == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
       IVssWriterComponentsExt *pWriterComponents;
       CheckCom(m_backupComponents->m_backup->GetWriterComponents(index, &pWriterComponents));
-      return VssWriterComponents::Adopt(pWriterComponents);
+      return VssWriterComponents::Adopt(pWriterComponents, m_backupComponents->m_stringCache, this);
    }
 
    VssBackupComponents::WriterMetadataList::WriterMetadataList(VssBackupComponents^ backupComponents)
@@ -395,18 +494,15 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       return (int)iCount;
    }
 
-   IVssExamineWriterMetadata^ VssBackupComponents::WriterMetadataList::default::get(int index)
+   IVssExamineWriterMetadata^ VssBackupComponents::WriterMetadataList::GetItem(int index)
    {
-      if (index < 0 || index > Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       if (m_backupComponents->m_backup == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
       VSS_ID idWriterInstance;
       ::IVssExamineWriterMetadata *ewm;
       CheckCom(m_backupComponents->m_backup->GetWriterMetadata(index, &idWriterInstance, &ewm));
-      return VssExamineWriterMetadata::Adopt(ewm);
+      return VssExamineWriterMetadata::Adopt(ewm, m_backupComponents->m_stringCache);
    }
 
    IList<IVssExamineWriterMetadata^>^ VssBackupComponents::WriterMetadata::get()
@@ -414,6 +510,119 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       return m_writerMetadata;
    }
 
+   VssWriterMetadataPrefetchResult^ VssBackupComponents::PrefetchWriterMetadata()
+   {
+      return PrefetchWriterMetadata(Environment::ProcessorCount);
+   }
+
+   VssWriterMetadataPrefetchResult^ VssBackupComponents::PrefetchWriterMetadata(int maxDegreeOfParallelism)
+   {
+      if (maxDegreeOfParallelism < 1)
+         throw gcnew ArgumentOutOfRangeException("maxDegreeOfParallelism");
+
+      System::Diagnostics::Stopwatch^ stopwatch = System::Diagnostics::Stopwatch::StartNew();
+
+      // The backup components object itself is not thread safe, so the metadata objects are
+      // obtained serially here. Only the examination of the (independent) writers is parallel.
+      UINT cWriters;
+      CheckCom(m_backup->GetWriterMetadataCount(&cWriters));
+
+      array<IVssExamineWriterMetadata^>^ writerMetadata = gcnew array<IVssExamineWriterMetadata^>(cWriters);
+      try
+      {
+         for (UINT i = 0; i < cWriters; i++)
+         {
+            VSS_ID idWriterInstance;
+            ::IVssExamineWriterMetadata *ewm;
+            CheckCom(m_backup->GetWriterMetadata(i, &idWriterInstance, &ewm));
+            writerMetadata[i] = VssExamineWriterMetadata::Adopt(ewm, m_stringCache);
+         }
+
+         // The native metadata objects obtained above are used by the worker threads without
+         // being marshaled, which is only valid if they live in the multithreaded apartment.
+         // A caller in a single-threaded apartment therefore examines the writers itself.
+         WriterMetadataPrefetcher^ prefetcher = gcnew WriterMetadataPrefetcher(writerMetadata);
+         int threadCount = Math::Min(maxDegreeOfParallelism, (int)cWriters);
+         if (System::Threading::Thread::CurrentThread->GetApartmentState() != System::Threading::ApartmentState::MTA)
+            threadCount = 1;
+
+         if (threadCount <= 1)
+         {
+            prefetcher->Run();
+         }
+         else
+         {
+            array<System::Threading::Thread^>^ threads = gcnew array<System::Threading::Thread^>(threadCount);
+            int started = 0;
+            try
+            {
+               for (; started < threadCount; started++)
+               {
+                  threads[started] = gcnew System::Threading::Thread(gcnew System::Threading::ThreadStart(prefetcher, &WriterMetadataPrefetcher::Run));
+                  threads[started]->SetApartmentState(System::Threading::ApartmentState::MTA);
+                  threads[started]->IsBackground = true;
+                  threads[started]->Start();
+               }
+            }
+            finally
+            {
+               for (int i = 0; i < started; i++)
+                  threads[i]->Join();
+            }
+         }
+
+         if (prefetcher->Error != nullptr)
+            Rethrow(prefetcher->Error);
+
+         return gcnew VssWriterMetadataPrefetchResult(writerMetadata, prefetcher->Timings, stopwatch->Elapsed);
+      }
+      catch (...)
+      {
+         for (UINT i = 0; i < cWriters; i++)
+            delete writerMetadata[i];
+         throw;
+      }
+   }
+
+   VssBackupComponents::WriterMetadataPrefetcher::WriterMetadataPrefetcher(array<IVssExamineWriterMetadata^>^ writerMetadata)
+      : m_writerMetadata(writerMetadata), m_timings(gcnew array<VssWriterMetadataTiming^>(writerMetadata->Length)), m_next(0), m_error(nullptr)
+   {
+   }
+
+   void VssBackupComponents::WriterMetadataPrefetcher::Run()
+   {
+      try
+      {
+         int index;
+         while (Error == nullptr && (index = System::Threading::Interlocked::Increment(m_next) - 1) < m_writerMetadata->Length)
+         {
+            System::Diagnostics::Stopwatch^ stopwatch = System::Diagnostics::Stopwatch::StartNew();
+            VssExamineWriterMetadata^ metadata = safe_cast<VssExamineWriterMetadata^>(m_writerMetadata[index]);
+            int descriptorCount = metadata->Materialize();
+            stopwatch->Stop();
+
+            m_timings[index] = gcnew VssWriterMetadataTiming(metadata->InstanceId, metadata->WriterId, metadata->WriterName,
+               metadata->Components->Count, descriptorCount, stopwatch->Elapsed);
+         }
+      }
+      catch (Exception^ ex)
+      {
+         // Only the first error is reported; the other threads stop at their next writer.
+         System::Threading::Interlocked::CompareExchange<Exception^>(m_error, ex, nullptr);
+      }
+   }
+
+   array<VssWriterMetadataTiming^>^ VssBackupComponents::WriterMetadataPrefetcher::Timings::get()
+   {
+      return m_timings;
+   }
+
+   Exception^ VssBackupComponents::WriterMetadataPrefetcher::Error::get()
+   {
+      // m_error is written by CompareExchange on the worker threads, so it is read the same way.
+      return System::Threading::Interlocked::CompareExchange<Exception^>(m_error, nullptr, nullptr);
+   }
+
    IList<IVssWriterComponents^>^ VssBackupComponents::WriterComponents::get()
    {
       return m_writerComponents;
@@ -447,30 +656,56 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::InitializeForBackup(String^ xml)
    {
+      InvalidateWriterLists();
       CheckCom(m_backup->InitializeForBackup(AutoMBStr(xml)));
    }
 
    void VssBackupComponents::InitializeForRestore(String^ xml)
    {
+      InvalidateWriterLists();
       CheckCom(m_backup->InitializeForRestore(NoNullAutoMBStr(xml)));
    }
 
+   void VssBackupComponents::InitializeForRestore(System::IO::Stream^ stream, VssXmlStreamFormat format)
+   {
+      InvalidateWriterLists();
+      AutoBStr bstrXML(VssXmlStream::Read(stream, format));
+      CheckCom(m_backup->InitializeForRestore(bstrXML));
+   }
+
    bool VssBackupComponents::IsVolumeSupported(String^ volumeName, Guid providerId)
    {
       BOOL eSupported;
-      CheckCom(m_backup->IsVolumeSupported(ToVssId(providerId), NoNullAutoMBStr(volumeName), &eSupported));
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      CheckCom(m_backup->IsVolumeSupported(ToVssId(providerId), pwszVolumeName, &eSupported));
       return (eSupported != 0);
    }
 
    bool VssBackupComponents::IsVolumeSupported(String^ volumeName)
    {
       BOOL eSupported;
-      CheckCom(m_backup->IsVolumeSupported(ToVssId(Guid::Empty), NoNullAutoMBStr(volumeName), &eSupported));
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      CheckCom(m_backup->IsVolumeSupported(ToVssId(Guid::Empty), pwszVolumeName, &eSupported));
       return (eSupported != 0);
    }
 
+   VssResult VssBackupComponents::TryIsVolumeSupported(String^ volumeName, Guid providerId, bool% supported)
+   {
+      BOOL eSupported;
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      HRESULT hr = m_backup->IsVolumeSupported(ToVssId(providerId), pwszVolumeName, &eSupported);
+      supported = SUCCEEDED(hr) && eSupported != 0;
+      return VssResult((VssError)hr);
+   }
+
+   VssResult VssBackupComponents::TryIsVolumeSupported(String^ volumeName, bool% supported)
+   {
+      return TryIsVolumeSupported(volumeName, Guid::Empty, supported);
+   }
+
    void VssBackupComponents::PostRestore()
    {
+      InvalidateWriterLists();
       ::IVssAsync *pAsync;
       CheckCom(m_backup->PostRestore(&pAsync));
       WaitCheckAndReleaseVssAsyncOperation(pAsync);
@@ -478,6 +713,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    IVssAsyncResult^ VssBackupComponents::BeginPostRestore(AsyncCallback^ userCallback, Object^ stateObject)
    {
+      InvalidateWriterLists();
       ::IVssAsync *pAsync;
       CheckCom(m_backup->PostRestore(&pAsync));
       return VssAsyncResult::Create(pAsync, userCallback, stateObject);
@@ -485,12 +721,14 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::EndPostRestore(IAsyncResult^ asyncResult)
    {
+      InvalidateWriterLists();
       VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
       result->EndInvoke();
    }
 
    void VssBackupComponents::PrepareForBackup()
    {
+      InvalidateWriterLists();
       ::IVssAsync *pAsync;
       CheckCom(m_backup->PrepareForBackup(&pAsync));
       WaitCheckAndReleaseVssAsyncOperation(pAsync);      
@@ -498,6 +736,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    IVssAsyncResult^ VssBackupComponents::BeginPrepareForBackup(AsyncCallback^ userCallback, Object^ stateObject)
    {
+      InvalidateWriterLists();
       ::IVssAsync *pAsync;
       CheckCom(m_backup->PrepareForBackup(&pAsync));
       return VssAsyncResult::Create(pAsync, userCallback, stateObject);
@@ -505,12 +744,14 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::EndPrepareForBackup(IAsyncResult^ asyncResult)
    {
+      InvalidateWriterLists();
       VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
       result->EndInvoke();
    }
 
    void VssBackupComponents::PreRestore()
    {
+      InvalidateWriterLists();
       ::IVssAsync *pAsync;
       CheckCom(m_backup->PreRestore(&pAsync));
       WaitCheckAndReleaseVssAsyncOperation(pAsync);      
@@ -518,6 +759,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    IVssAsyncResult^ VssBackupComponents::BeginPreRestore(AsyncCallback^ userCallback, Object^ stateObject)
    {
+      InvalidateWriterLists();
       ::IVssAsync *pAsync;
       CheckCom(m_backup->PreRestore(&pAsync));
       return VssAsyncResult::Create(pAsync, userCallback, stateObject);
@@ -525,6 +767,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::EndPreRestore(IAsyncResult^ asyncResult)
    {
+      InvalidateWriterLists();
       VssAsyncResult^ result = safe_cast<VssAsyncResult^>(asyncResult);
       result->EndInvoke();
    }
@@ -532,63 +775,214 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    IEnumerable<VssSnapshotProperties ^>^ VssBackupComponents::QuerySnapshots()
    {
       IVssEnumObject *pEnum;
-      VSS_OBJECT_PROP rgelt;
-      ULONG celtFetched = 0;
-      IList<VssSnapshotProperties^> ^list = gcnew List<VssSnapshotProperties^>();
-
       CheckCom(m_backup->Query(GUID_NULL, VSS_OBJECT_NONE, VSS_OBJECT_SNAPSHOT, &pEnum));
 
+      VssEnumObjectReader reader(pEnum, m_enumerationBatchSize);
+      List<VssSnapshotProperties^> ^list = gcnew List<VssSnapshotProperties^>();
+
+      VSS_OBJECT_PROP *pProp;
+      while ((pProp = reader.Next()) != 0)
+      {
+         // Should always be snapshot, but just in case it isn't, we simply skip it.
+         if (pProp->Type == VSS_OBJECT_SNAPSHOT)
+            list->Add(CreateVssSnapshotProperties(&pProp->Obj.Snap, m_stringCache));
+         else
+            VssEnumObjectReader::FreeObjectProp(*pProp);
+      }
+
+      return list;
+   }
+
+   IEnumerable<VssSnapshotProperties ^>^ VssBackupComponents::QuerySnapshots(VssSnapshotFilter^ filter)
+   {
+      if (filter == nullptr)
+         throw gcnew ArgumentNullException("filter");
+
+      return gcnew List<VssSnapshotProperties^>(EnumerateSnapshots(filter));
+   }
+
+   IEnumerable<VssSnapshotProperties ^>^ VssBackupComponents::EnumerateSnapshots()
+   {
+      return gcnew SnapshotEnumerable(this, nullptr);
+   }
+
+   IEnumerable<VssSnapshotProperties ^>^ VssBackupComponents::EnumerateSnapshots(VssSnapshotFilter^ filter)
+   {
+      if (filter == nullptr)
+         throw gcnew ArgumentNullException("filter");
+
+      return gcnew SnapshotEnumerable(this, filter);
+   }
+
+   VssBackupComponents::SnapshotEnumerable::SnapshotEnumerable(VssBackupComponents^ backupComponents, VssSnapshotFilter^ filter)
+      : m_backupComponents(backupComponents), m_filter(filter)
+   {
+   }
+
+   IEnumerator<VssSnapshotProperties^>^ VssBackupComponents::SnapshotEnumerable::GetEnumerator()
+   {
+      if (m_backupComponents->m_backup == 0)
+         throw gcnew ObjectDisposedException("Instance of IEnumerable used after the object creating it was disposed.");
+
+      // The filter is captured when the enumeration starts, so later changes to it
+      // do not affect an enumeration in progress.
+      VssSnapshotPredicate *predicate = 0;
+      if (m_filter != nullptr)
+         predicate = new VssSnapshotPredicate(m_filter);
+
+      VssEnumObjectReader *reader = 0;
       try
       {
-         while (true)
-         {
-            CheckCom(pEnum->Next(1, &rgelt, &celtFetched));
-            
-            if (celtFetched == 0)
-               return list;
+         IVssEnumObject *pEnum;
+         CheckCom(m_backupComponents->m_backup->Query(GUID_NULL, VSS_OBJECT_NONE, VSS_OBJECT_SNAPSHOT, &pEnum));
 
-            // Should always be snapshot, but just in case it isn't, we simply skip it.
-            if (rgelt.Type == VSS_OBJECT_SNAPSHOT)
-            {
-               list->Add(CreateVssSnapshotProperties(&rgelt.Obj.Snap));
-            }
+         try
+         {
+            reader = new VssEnumObjectReader(pEnum, m_backupComponents->m_enumerationBatchSize);
          }
+         catch (...)
+         {
+            pEnum->Release();
+            throw;
+         }
+
+         return gcnew Enumerator(reader, predicate, m_backupComponents->m_stringCache);
       }
-      finally
+      catch (...)
       {
-         pEnum->Release();
+         delete reader;
+         delete predicate;
+         throw;
       }
    }
 
-   IEnumerable<VssProviderProperties ^>^ VssBackupComponents::QueryProviders()
+   System::Collections::IEnumerator^ VssBackupComponents::SnapshotEnumerable::GetEnumeratorNG()
    {
-      IVssEnumObject *pEnum;
-      VSS_OBJECT_PROP rgelt;
-      ULONG celtFetched = 0;
-      IList<VssProviderProperties^> ^list = gcnew List<VssProviderProperties^>();
+      return GetEnumerator();
+   }
 
-      CheckCom(m_backup->Query(GUID_NULL, VSS_OBJECT_NONE, VSS_OBJECT_PROVIDER, &pEnum));
+   VssBackupComponents::SnapshotEnumerable::Enumerator::Enumerator(VssEnumObjectReader *reader, VssSnapshotPredicate *predicate, VssStringCache^ stringCache)
+      : m_reader(reader), m_predicate(predicate), m_current(nullptr), m_stringCache(stringCache)
+   {
+   }
 
-      try
+   VssBackupComponents::SnapshotEnumerable::Enumerator::~Enumerator()
+   {
+      this->!Enumerator();
+   }
+
+   VssBackupComponents::SnapshotEnumerable::Enumerator::!Enumerator()
+   {
+      // Releases the underlying IVssEnumObject along with any snapshot properties
+      // that were fetched but not yet converted.
+      if (m_reader != 0)
       {
-         while (true)
-         {
-            CheckCom(pEnum->Next(1, &rgelt, &celtFetched));
-            
-            if (celtFetched == 0)
-               return list;
+         delete m_reader;
+         m_reader = 0;
+      }
 
-            // Should always be a provider, but just in case it isn't, we simply skip it.
-            if (rgelt.Type == VSS_OBJECT_PROVIDER)
-            {
-               list->Add(CreateVssProviderProperties(&rgelt.Obj.Prov));
-            }
+      if (m_predicate != 0)
+      {
+         delete m_predicate;
+         m_predicate = 0;
+      }
+   }
+
+   bool VssBackupComponents::SnapshotEnumerable::Enumerator::MoveNext()
+   {
+      m_current = nullptr;
+
+      if (m_reader == 0)
+         return false;
+
+      VSS_OBJECT_PROP *pProp;
+      while ((pProp = m_reader->Next()) != 0)
+      {
+         // Should always be snapshot, but just in case it isn't, we simply skip it. Snapshots
+         // rejected by the filter are freed here without ever being marshalled.
+         if (pProp->Type == VSS_OBJECT_SNAPSHOT && (m_predicate == 0 || m_predicate->Matches(pProp->Obj.Snap)))
+         {
+            m_current = CreateVssSnapshotProperties(&pProp->Obj.Snap, m_stringCache);
+            return true;
          }
+
+         VssEnumObjectReader::FreeObjectProp(*pProp);
       }
-      finally
+
+      // Release the enumerator as soon as it has been exhausted.
+      this->!Enumerator();
+      return false;
+   }
+
+   void VssBackupComponents::SnapshotEnumerable::Enumerator::Reset()
+   {
+      throw gcnew NotSupportedException(L"The snapshot enumeration cannot be restarted, call GetEnumerator() again instead.");
+   }
+
+   Object^ VssBackupComponents::SnapshotEnumerable::Enumerator::CurrentObject::get()
+   {
+      return Current;
+   }
+
+   VssSnapshotProperties^ VssBackupComponents::SnapshotEnumerable::Enumerator::Current::get()
+   {
+      if (m_current == nullptr)
+         throw gcnew InvalidOperationException(L"The enumerator is not positioned on an element.");
+
+      return m_current;
+   }
+
+   IEnumerable<VssProviderProperties ^>^ VssBackupComponents::QueryProviders()
+   {
+      IVssEnumObject *pEnum;
+      CheckCom(m_backup->Query(GUID_NULL, VSS_OBJECT_NONE, VSS_OBJECT_PROVIDER, &pEnum));
+
+      VssEnumObjectReader reader(pEnum, m_enumerationBatchSize);
+      List<VssProviderProperties^> ^list = gcnew List<VssProviderProperties^>();
+
+      VSS_OBJECT_PROP *pProp;
+      while ((pProp = reader.Next()) != 0)
       {
-         pEnum->Release();
+         // Should always be a provider, but just in case it isn't, we simply skip it.
+         if (pProp->Type == VSS_OBJECT_PROVIDER)
+            list->Add(CreateVssProviderProperties(&pProp->Obj.Prov));
+         else
+            VssEnumObjectReader::FreeObjectProp(*pProp);
       }
+
+      return list;
+   }
+
+   int VssBackupComponents::EnumerationBatchSize::get()
+   {
+      return m_enumerationBatchSize;
+   }
+
+   void VssBackupComponents::EnumerationBatchSize::set(int value)
+   {
+      if (value < 0)
+         throw gcnew ArgumentOutOfRangeException("value", "The batch size must not be negative.");
+
+      m_enumerationBatchSize = value;
+   }
+
+   int VssBackupComponents::StringCacheCapacity::get()
+   {
+      return m_stringCache == nullptr ? 0 : m_stringCache->Capacity;
+   }
+
+   void VssBackupComponents::StringCacheCapacity::set(int value)
+   {
+      if (value < 0)
+         throw gcnew ArgumentOutOfRangeException("value", "The string cache capacity must not be negative.");
+
+      // Objects created before this call keep using the previous cache, so it is not released here.
+      m_stringCache = value == 0 ? nullptr : gcnew VssStringCache(value);
+   }
+
+   VssStringCacheStatistics^ VssBackupComponents::StringCacheStatistics::get()
+   {
+      return m_stringCache == nullptr ? nullptr : m_stringCache->GetStatistics();
    }
 
 
@@ -596,9 +990,10 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    IVssAsyncResult^ VssBackupComponents::BeginQueryRevertStatus(String^ volume, AsyncCallback^ userCallback, Object^ stateObject)
    {
 #if ALPHAVSS_TARGET == ALPHAVSS_TARGET_WIN2003 || ALPHAVSS_TARGET == ALPHAVSS_TARGET_WINVISTAORLATER
-      OperatingSystemInfo::RequireServerOrClientAtLeast(OSVersionName::WindowsServer2003, 1, OSVersionName::WindowsVista, 1);
+      OperatingSystemFlags::Require(OperatingSystemFlags::IsServer2003SP1OrClientVistaSP1OrLater);
       ::IVssAsync *pAsync;
-      CheckCom(m_backup->QueryRevertStatus(NoNullAutoMStr(volume), &pAsync));
+      NoNullPinMStr(pwszVolume, volume);
+      CheckCom(m_backup->QueryRevertStatus(pwszVolume, &pAsync));
       return VssAsyncResult::Create(pAsync, userCallback, stateObject);
 #else
       UnsupportedOs();
@@ -615,7 +1010,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    void VssBackupComponents::RevertToSnapshot(Guid snapshotId, bool forceDismount)
    {
 #if ALPHAVSS_TARGET == ALPHAVSS_TARGET_WIN2003 || ALPHAVSS_TARGET == ALPHAVSS_TARGET_WINVISTAORLATER
-      OperatingSystemInfo::RequireServer(OSVersionName::WindowsServer2003, 1);
+      OperatingSystemFlags::Require(OperatingSystemFlags::IsServer2003SP1OrLater);
       CheckCom(m_backup->RevertToSnapshot(ToVssId(snapshotId), forceDismount));
 #else
       UnsupportedOs();
@@ -629,15 +1024,30 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       return bstrXML;
    }
 
+   void VssBackupComponents::SaveAsXml(System::IO::Stream^ stream, VssXmlStreamFormat format)
+   {
+      VssXmlStream::ValidateArguments(stream, format);
+
+      AutoBStr bstrXML;
+      CheckCom(m_backup->SaveAsXML(&bstrXML));
+      VssXmlStream::Write(bstrXML, stream, format);
+   }
+
    void VssBackupComponents::SetAdditionalRestores(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, bool additionalResources)
    {
-      CheckCom(m_backup->SetAdditionalRestores(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), additionalResources));
+      InvalidateWriterLists();
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      CheckCom(m_backup->SetAdditionalRestores(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, pwszLogicalPath, pwszComponentName, additionalResources));
    }
 
    void VssBackupComponents::SetAuthoritativeRestore(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, bool isAuthorative)
    {
+      InvalidateWriterLists();
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      CheckCom(RequireIVssBackupComponentsEx2()->SetAuthoritativeRestore(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), isAuthorative));
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      CheckCom(RequireIVssBackupComponentsEx2()->SetAuthoritativeRestore(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, pwszLogicalPath, pwszComponentName, isAuthorative));
 #else
       UnsupportedOs();
 #endif
@@ -645,8 +1055,12 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::SetRestoreName(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ restoreName)
    {
+      InvalidateWriterLists();
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      CheckCom(RequireIVssBackupComponentsEx2()->SetRestoreName(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), NoNullAutoMStr(restoreName)));
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      NoNullPinMStr(pwszRestoreName, restoreName);
+      CheckCom(RequireIVssBackupComponentsEx2()->SetRestoreName(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, pwszLogicalPath, pwszComponentName, pwszRestoreName));
 #else
       UnsupportedOs();
 #endif
@@ -654,17 +1068,25 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::SetBackupOptions(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ backupOptions)
    {
-      CheckCom(m_backup->SetBackupOptions(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), NoNullAutoMStr(backupOptions)));
+      InvalidateWriterLists();
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      NoNullPinMStr(pwszBackupOptions, backupOptions);
+      CheckCom(m_backup->SetBackupOptions(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, pwszLogicalPath, pwszComponentName, pwszBackupOptions));
    }
 
    void VssBackupComponents::SetBackupState(bool selectComponents, bool backupBootableSystemState, VssBackupType backupType, bool partialFileSupport)
    {
+      InvalidateWriterLists();
       CheckCom(m_backup->SetBackupState(selectComponents, backupBootableSystemState, (VSS_BACKUP_TYPE)backupType, partialFileSupport));
    }
 
    void VssBackupComponents::SetBackupSucceeded(Guid instanceId, Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, bool succeeded)
    {
-      CheckCom(m_backup->SetBackupSucceeded(ToVssId(instanceId), ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), succeeded));
+      InvalidateWriterLists();
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      CheckCom(m_backup->SetBackupSucceeded(ToVssId(instanceId), ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, pwszLogicalPath, pwszComponentName, succeeded));
    }
 
    void VssBackupComponents::SetContext(VssVolumeSnapshotAttributes context)
@@ -679,19 +1101,30 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::SetFileRestoreStatus(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, VssFileRestoreStatus status)
    {
-      CheckCom(m_backup->SetFileRestoreStatus(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), (VSS_FILE_RESTORE_STATUS)status));
+      InvalidateWriterLists();
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      CheckCom(m_backup->SetFileRestoreStatus(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, pwszLogicalPath, pwszComponentName, (VSS_FILE_RESTORE_STATUS)status));
    }
 
    void VssBackupComponents::SetPreviousBackupStamp(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ previousBackupStamp)
    {
-      CheckCom(m_backup->SetPreviousBackupStamp(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), NoNullAutoMStr(previousBackupStamp)));
+      InvalidateWriterLists();
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      NoNullPinMStr(pwszPreviousBackupStamp, previousBackupStamp);
+      CheckCom(m_backup->SetPreviousBackupStamp(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, pwszLogicalPath, pwszComponentName, pwszPreviousBackupStamp));
    }
 
    void VssBackupComponents::SetRangesFilePath(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, int partialFileIndex, String^ rangesFile)
    {
+      InvalidateWriterLists();
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WIN2003
-      OperatingSystemInfo::RequireAtLeast(OSVersionName::WindowsServer2003);		
-      CheckCom(m_backup->SetRangesFilePath(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), partialFileIndex, NoNullAutoMStr(rangesFile)));
+      OperatingSystemFlags::Require(OperatingSystemFlags::IsWindowsServer2003OrLater);		
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      NoNullPinMStr(pwszRangesFile, rangesFile);
+      CheckCom(m_backup->SetRangesFilePath(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, pwszLogicalPath, pwszComponentName, partialFileIndex, pwszRangesFile));
 #else
       UnsupportedOs();
 #endif
@@ -699,13 +1132,18 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::SetRestoreOptions(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, String^ restoreOptions)
    {
-      CheckCom(m_backup->SetRestoreOptions(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), NoNullAutoMStr(restoreOptions)));
+      InvalidateWriterLists();
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      NoNullPinMStr(pwszRestoreOptions, restoreOptions);
+      CheckCom(m_backup->SetRestoreOptions(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, pwszLogicalPath, pwszComponentName, pwszRestoreOptions));
    }
 
    void VssBackupComponents::SetRestoreState(VssRestoreType restoreType)
    {
+      InvalidateWriterLists();
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WIN2003
-      OperatingSystemInfo::RequireAtLeast(OSVersionName::WindowsServer2003);		
+      OperatingSystemFlags::Require(OperatingSystemFlags::IsWindowsServer2003OrLater);		
       CheckCom(m_backup->SetRestoreState((VSS_RESTORE_TYPE)restoreType));
 #else
       UnsupportedOs();
@@ -714,8 +1152,12 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::SetRollForward(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, VssRollForwardType rollType, String^ rollForwardPoint)
    {
+      InvalidateWriterLists();
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      CheckCom(RequireIVssBackupComponentsEx2()->SetRollForward(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), (VSS_ROLLFORWARD_TYPE)rollType, NoNullAutoMStr(rollForwardPoint)));
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      NoNullPinMStr(pwszRollForwardPoint, rollForwardPoint);
+      CheckCom(RequireIVssBackupComponentsEx2()->SetRollForward(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, pwszLogicalPath, pwszComponentName, (VSS_ROLLFORWARD_TYPE)rollType, pwszRollForwardPoint));
 #else
       UnsupportedOs();
 #endif
@@ -723,14 +1165,20 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssBackupComponents::SetSelectedForRestore(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, bool selectedForRestore)
    {
-      CheckCom(m_backup->SetSelectedForRestore(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), selectedForRestore));
+      InvalidateWriterLists();
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      CheckCom(m_backup->SetSelectedForRestore(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, pwszLogicalPath, pwszComponentName, selectedForRestore));
    }
 
    void VssBackupComponents::SetSelectedForRestore(Guid writerId, VssComponentType componentType, String^ logicalPath, String^ componentName, bool selectedForRestore, Guid instanceId)
    {
+      InvalidateWriterLists();
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WIN2003
-      OperatingSystemInfo::RequireAtLeast(OSVersionName::WindowsServer2003, 1);
-      CheckCom(RequireIVssBackupComponentsEx()->SetSelectedForRestoreEx(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, AutoMStr(logicalPath), NoNullAutoMStr(componentName), selectedForRestore, ToVssId(instanceId)));
+      OperatingSystemFlags::Require(OperatingSystemFlags::IsWindowsServer2003SP1OrLater);
+      PinMStr(pwszLogicalPath, logicalPath);
+      NoNullPinMStr(pwszComponentName, componentName);
+      CheckCom(RequireIVssBackupComponentsEx()->SetSelectedForRestoreEx(ToVssId(writerId), (VSS_COMPONENT_TYPE)componentType, pwszLogicalPath, pwszComponentName, selectedForRestore, ToVssId(instanceId)));
 #else
       UnsupportedOs();
 #endif
@@ -766,7 +1214,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
     void VssBackupComponents::AddSnapshotToRecoverySet(Guid snapshotId, String^ destinationVolume)
     {
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-       CheckCom(RequireIVssBackupComponentsEx3()->AddSnapshotToRecoverySet(ToVssId(snapshotId), 0, AutoMStr(destinationVolume)));
+       PinMStr(pwszDestinationVolume, destinationVolume);
+       CheckCom(RequireIVssBackupComponentsEx3()->AddSnapshotToRecoverySet(ToVssId(snapshotId), 0, pwszDestinationVolume));
 #else
        UnsupportedOs();
 #endif
@@ -804,7 +1253,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
     {
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
        AutoPwsz pwszRootPath, pwszLogicalPrefix;
-       CheckCom(RequireIVssBackupComponentsEx4()->GetRootAndLogicalPrefixPaths(AutoMStr(filePath), &pwszRootPath, &pwszLogicalPrefix, normalizeFQDNforRootPath));
+       PinMStr(pwszFilePath, filePath);
+       CheckCom(RequireIVssBackupComponentsEx4()->GetRootAndLogicalPrefixPaths(pwszFilePath, &pwszRootPath, &pwszLogicalPrefix, normalizeFQDNforRootPath));
        return gcnew VssRootAndLogicalPrefixPaths(pwszRootPath, pwszLogicalPrefix);
 #else
        UnsupportedOs();
@@ -6,21 +6,25 @@
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
-   VssComponent^ VssComponent::Adopt(::IVssComponent *vssWriterComponents)
+   VssComponent^ VssComponent::Adopt(::IVssComponent *vssWriterComponents, VssStringCache^ stringCache, VssScope^ scope, VssListAdapter<IVssWriterComponents^>^ owner)
    {
+      VssComponent^ component;
       try
       {
-         return gcnew VssComponent(vssWriterComponents);
+         component = gcnew VssComponent(vssWriterComponents, stringCache, scope, owner);
       }
       catch (...)
       {
          vssWriterComponents->Release();
          throw;
       }
+
+      AttachToScope(scope, component);
+      return component;
    }
 
-   VssComponent::VssComponent(::IVssComponent *vssComponent)
-      : m_vssComponent(vssComponent), 
+   VssComponent::VssComponent(::IVssComponent *vssComponent, VssStringCache^ stringCache, VssScope^ scope, VssListAdapter<IVssWriterComponents^>^ owner)
+      : m_vssComponent(vssComponent), m_stringCache(stringCache), m_scope(scope), m_owner(owner), m_snapshot(nullptr), m_snapshotVersion(0), m_snapshotCallsSaved(0),
       m_alternateLocationMappings(nullptr),
       m_directedTargets(nullptr),
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WIN2003
@@ -40,8 +44,14 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       m_newTargets = gcnew NewTargetList(this);
    }
 
+   bool VssComponent::IsDisposed::get()
+   {
+      return m_vssComponent == 0;
+   }
+
    VssComponent::~VssComponent()
    {
+      DetachFromScope(m_scope, this);
       this->!VssComponent();
    }
 
@@ -66,8 +76,10 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 #if 0
    void VssComponent::AddDifferencedFilesByLastModifyTime(String ^ path, String ^ fileSpec, bool recursive, DateTime lastModifyTime)
    {
-      CheckCom(m_vssComponent->AddDifferencedFilesByLastModifyTime(NoNullAutoMStr(path), 
-         NoNullAutoMStr(fileSpec), recursive,ToFileTime(lastModifyTime)));
+      NoNullPinMStr(pwszPath, path);
+      NoNullPinMStr(pwszFileSpec, fileSpec);
+      CheckCom(m_vssComponent->AddDifferencedFilesByLastModifyTime(pwszPath, 
+         pwszFileSpec, recursive,ToFileTime(lastModifyTime)));
    }
 
    void VssComponent::AddDifferencedFilesByLastModifyTime(VssDifferencedFileInfo^ differencedFile)
@@ -77,14 +89,24 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    void VssComponent::AddDirectedTarget(String ^ sourcePath, String^ sourceFileName, String^ sourceRangeList, String^ destinationPath, String^ destinationFileName, String^ destinationRangeList)
    {
+      NoNullPinMStr(pwszSourcePath, sourcePath);
+      NoNullPinMStr(pwszSourceFileName, sourceFileName);
+      NoNullPinMStr(pwszSourceRangeList, sourceRangeList);
+      NoNullPinMStr(pwszDestinationPath, destinationPath);
+      NoNullPinMStr(pwszDestinationFileName, destinationFileName);
+      NoNullPinMStr(pwszDestinationRangeList, destinationRangeList);
       CheckCom(m_vssComponent->AddDirectedTarget(
-         NoNullAutoMStr(sourcePath), NoNullAutoMStr(sourceFileName), NoNullAutoMStr(sourceRangeList),
-         NoNullAutoMStr(destinationPath), NoNullAutoMStr(destinationFileName), NoNullAutoMStr(destinationRangeList)));
+         pwszSourcePath, pwszSourceFileName, pwszSourceRangeList,
+         pwszDestinationPath, pwszDestinationFileName, pwszDestinationRangeList));
    }
 
    void VssComponent::AddPartialFile(String^ path, String^ filename, String^ ranges, String^ metaData)
    {
-      CheckCom(m_vssComponent->AddPartialFile(NoNullAutoMStr(path), NoNullAutoMStr(filename), NoNullAutoMStr(ranges), AutoMStr(metaData)));
+      NoNullPinMStr(pwszPath, path);
+      NoNullPinMStr(pwszFilename, filename);
+      NoNullPinMStr(pwszRanges, ranges);
+      PinMStr(pwszMetaData, metaData);
+      CheckCom(m_vssComponent->AddPartialFile(pwszPath, pwszFilename, pwszRanges, pwszMetaData));
    }
 
    void VssComponent::AddDirectedTarget(VssDirectedTargetInfo ^directedTarget)
@@ -114,35 +136,46 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
       void VssComponent::SetBackupMetadata(String^ metadata)
    {
-      CheckCom(m_vssComponent->SetBackupMetadata(NoNullAutoMStr(metadata)));
+      NoNullPinMStr(pwszMetadata, metadata);
+      m_snapshot = nullptr;
+      CheckCom(m_vssComponent->SetBackupMetadata(pwszMetadata));
    }
 
    void VssComponent::SetBackupStamp(String^ stamp)
    {
-      CheckCom(m_vssComponent->SetBackupStamp(NoNullAutoMStr(stamp)));
+      NoNullPinMStr(pwszStamp, stamp);
+      m_snapshot = nullptr;
+      CheckCom(m_vssComponent->SetBackupStamp(pwszStamp));
    }
 
 
    void VssComponent::SetPostRestoreFailureMsg(String^ msg)
    {
-      CheckCom(m_vssComponent->SetPostRestoreFailureMsg(NoNullAutoMStr(msg)));
+      NoNullPinMStr(pwszMsg, msg);
+      m_snapshot = nullptr;
+      CheckCom(m_vssComponent->SetPostRestoreFailureMsg(pwszMsg));
    }
 
 
    void VssComponent::SetPreRestoreFailureMsg(String^ msg)
    {
-      CheckCom(m_vssComponent->SetPreRestoreFailureMsg(NoNullAutoMStr(msg)));
+      NoNullPinMStr(pwszMsg, msg);
+      m_snapshot = nullptr;
+      CheckCom(m_vssComponent->SetPreRestoreFailureMsg(pwszMsg));
    }
 
 
    void VssComponent::SetRestoreMetadata(String^ metadata)
    {
-      CheckCom(m_vssComponent->SetRestoreMetadata(NoNullAutoMStr(metadata)));
+      NoNullPinMStr(pwszMetadata, metadata);
+      m_snapshot = nullptr;
+      CheckCom(m_vssComponent->SetRestoreMetadata(pwszMetadata));
    }
 
 
    void VssComponent::SetRestoreTarget(VssRestoreTarget target)
    {
+      m_snapshot = nullptr;
       CheckCom(m_vssComponent->SetRestoreTarget((VSS_RESTORE_TARGET)target));
    }
 
@@ -180,7 +213,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    {
       AutoBStr str;
       CheckCom(m_vssComponent->GetComponentName(&str));
-      return str;
+      return VssStringCache::FromBStr(m_stringCache, str);
    }
 
    VssComponentType VssComponent::ComponentType::get()
@@ -201,7 +234,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    {
       AutoBStr path;
       CheckCom(m_vssComponent->GetLogicalPath(&path));
-      return path;
+      return VssStringCache::FromBStr(m_stringCache, path);
    }
 
    String^ VssComponent::PostRestoreFailureMsg::get()
@@ -301,14 +334,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       return count;
    }
 
-   VssDirectedTargetInfo^ VssComponent::DirectedTargetList::default::get(int index)
+   VssDirectedTargetInfo^ VssComponent::DirectedTargetList::GetItem(int index)
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
-      if (index < 0 || index >= Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       AutoBStr bsSourcePath, bsSourceFileName, bsSourceRangeList;
       AutoBStr bsDestPath, bsDestFileName, bsDestRangeList;
 
@@ -334,17 +364,14 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    }
 
    
-   VssWMFileDescriptor^ VssComponent::NewTargetList::default::get(int index)
+   VssWMFileDescriptor^ VssComponent::NewTargetList::GetItem(int index)
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
-      if (index < 0 || index >= Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       IVssWMFiledesc *vssWMFiledesc;
       CheckCom(m_component->m_vssComponent->GetNewTarget(index, &vssWMFiledesc));
-      return CreateVssWMFileDescriptor(vssWMFiledesc);
+      return CreateVssWMFileDescriptor(vssWMFiledesc, m_component->m_stringCache);
    }
 
    VssComponent::NewTargetList::NewTargetList(VssComponent^ component)
@@ -366,14 +393,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    }
 
    
-   VssPartialFileInfo^ VssComponent::PartialFileList::default::get(int index)
+   VssPartialFileInfo^ VssComponent::PartialFileList::GetItem(int index)
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
-      if (index < 0 || index >= Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       AutoBStr bsPath, bsFileName, bsRange, bsMetadata;
       CheckCom(m_component->m_vssComponent->GetPartialFile(index, &bsPath, &bsFileName, &bsRange, &bsMetadata));
       return gcnew VssPartialFileInfo(bsPath, bsFileName, bsRange, bsMetadata);
@@ -398,14 +422,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       return count;
    }
 
-   VssDifferencedFileInfo^ VssComponent::DifferencedFileList::default::get(int index)
+   VssDifferencedFileInfo^ VssComponent::DifferencedFileList::GetItem(int index)
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
-      if (index < 0 || index >= Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       AutoBStr bstrPath, bstrFilespec, bstrLsnString;
       BOOL bRecursive;
       FILETIME ftLastModifyTime;
@@ -433,14 +454,11 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       return count;
    }
 
-   VssRestoreSubcomponentInfo^ VssComponent::RestoreSubcomponentList::default::get(int index)
+   VssRestoreSubcomponentInfo^ VssComponent::RestoreSubcomponentList::GetItem(int index)
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
-      if (index < 0 || index >= Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       AutoBStr bsLogicalPath, bsComponentName;
       bool bRepair;
       CheckCom(m_component->m_vssComponent->GetRestoreSubcomponent(index, &bsLogicalPath, &bsComponentName, &bRepair));
@@ -467,17 +485,14 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    }
 
    
-   VssWMFileDescriptor^ VssComponent::AlternateLocationMappingList::default::get(int index)
+   VssWMFileDescriptor^ VssComponent::AlternateLocationMappingList::GetItem(int index)
    {
       if (m_component->m_vssComponent == 0)
          throw gcnew ObjectDisposedException("Instance of IList used after the object creating it was disposed.");
 
-      if (index < 0 || index >= Count)
-         throw gcnew ArgumentOutOfRangeException("index");
-
       IVssWMFiledesc *vssWMFiledesc;
       CheckCom(m_component->m_vssComponent->GetAlternateLocationMapping(index, &vssWMFiledesc));
-      return CreateVssWMFileDescriptor(vssWMFiledesc);
+      return CreateVssWMFileDescriptor(vssWMFiledesc, m_component->m_stringCache);
    }
 
    VssComponent::AlternateLocationMappingList::AlternateLocationMappingList(VssComponent^ component)
@@ -570,8 +585,121 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       if (failure == nullptr)
          return;
 
-      CheckCom(RequireIVssComponentEx2()->SetFailure(failure->ErrorCode, failure->ApplicationErrorCode, AutoMBStr(failure->ApplicationMessage), 0));      
+      PinMStr(pwszApplicationMessage, failure->ApplicationMessage);
+      m_snapshot = nullptr;
+      CheckCom(RequireIVssComponentEx2()->SetFailure(failure->ErrorCode, failure->ApplicationErrorCode, pwszApplicationMessage, 0));
 #endif
    }
+
+   VssComponentSnapshot^ VssComponent::GetSnapshot()
+   {
+      if (m_vssComponent == 0)
+         throw gcnew ObjectDisposedException("VssComponent");
+
+      // The owner's version changes when the backup components document is modified, for instance by
+      // SetBackupSucceeded or SetBackupOptions. The setters of this component discard the snapshot themselves.
+      int version = m_owner == nullptr ? 0 : m_owner->Version;
+      if (m_snapshot == nullptr || m_snapshotVersion != version)
+      {
+         m_snapshot = ReadSnapshot();
+         m_snapshotVersion = version;
+         m_snapshotCallsSaved += IndividualSnapshotCallCount - m_snapshot->NativeCallCount;
+      }
+      else
+      {
+         m_snapshotCallsSaved += IndividualSnapshotCallCount;
+      }
+
+      return m_snapshot;
+   }
+
+   Int64 VssComponent::SnapshotCallsSaved::get()
+   {
+      return m_snapshotCallsSaved;
+   }
+
+   VssComponentSnapshot^ VssComponent::ReadSnapshot()
+   {
+      int calls = 0;
+
+      bool bAdditionalRestores, bBackupSucceeded, bSelectedForRestore;
+      AutoBStr bstrBackupOptions, bstrBackupStamp, bstrComponentName, bstrLogicalPath;
+      AutoBStr bstrPostRestoreFailureMsg, bstrPreRestoreFailureMsg, bstrPreviousBackupStamp, bstrRestoreOptions;
+      VSS_COMPONENT_TYPE eComponentType;
+      VSS_FILE_RESTORE_STATUS eFileRestoreStatus;
+      VSS_RESTORE_TARGET eRestoreTarget;
+
+      CheckCom(m_vssComponent->GetAdditionalRestores(&bAdditionalRestores));
+      CheckCom(m_vssComponent->GetBackupOptions(&bstrBackupOptions));
+      CheckCom(m_vssComponent->GetBackupStamp(&bstrBackupStamp));
+      CheckCom(m_vssComponent->GetBackupSucceeded(&bBackupSucceeded));
+      CheckCom(m_vssComponent->GetComponentName(&bstrComponentName));
+      CheckCom(m_vssComponent->GetComponentType(&eComponentType));
+      CheckCom(m_vssComponent->GetFileRestoreStatus(&eFileRestoreStatus));
+      CheckCom(m_vssComponent->GetLogicalPath(&bstrLogicalPath));
+      CheckCom(m_vssComponent->GetPostRestoreFailureMsg(&bstrPostRestoreFailureMsg));
+      CheckCom(m_vssComponent->GetPreRestoreFailureMsg(&bstrPreRestoreFailureMsg));
+      CheckCom(m_vssComponent->GetPreviousBackupStamp(&bstrPreviousBackupStamp));
+      CheckCom(m_vssComponent->GetRestoreOptions(&bstrRestoreOptions));
+      CheckCom(m_vssComponent->GetRestoreTarget(&eRestoreTarget));
+      CheckCom(m_vssComponent->IsSelectedForRestore(&bSelectedForRestore));
+      calls += 14;
+
+      UINT alternateLocationMappingCount, directedTargetCount, newTargetCount, partialFileCount, restoreSubcomponentCount;
+      UINT differencedFileCount = 0;
+      CheckCom(m_vssComponent->GetAlternateLocationMappingCount(&alternateLocationMappingCount));
+      CheckCom(m_vssComponent->GetDirectedTargetCount(&directedTargetCount));
+      CheckCom(m_vssComponent->GetNewTargetCount(&newTargetCount));
+      CheckCom(m_vssComponent->GetPartialFileCount(&partialFileCount));
+      CheckCom(m_vssComponent->GetRestoreSubcomponentCount(&restoreSubcomponentCount));
+      calls += 5;
+#if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WIN2003
+      CheckCom(m_vssComponent->GetDifferencedFilesCount(&differencedFileCount));
+      calls++;
+#endif
+
+      bool bAuthoritativeRestore = false;
+      AutoBStr bstrPostSnapshotFailureMsg, bstrPrepareForBackupFailureMsg, bstrRestoreName, bstrRollForwardRestorePoint;
+      VSS_ROLLFORWARD_TYPE eRollForwardType = VSS_RF_UNDEFINED;
+      VssComponentFailure^ failure = nullptr;
+
+#if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
+      // Mirror the individual properties: a failing call leaves the value at the default that the property returns.
+      IVssComponentEx *componentEx = GetIVssComponentEx();
+      if (componentEx != 0)
+      {
+         if (FAILED(componentEx->GetAuthoritativeRestore(&bAuthoritativeRestore)))
+            bAuthoritativeRestore = false;
+         componentEx->GetPostSnapshotFailureMsg(&bstrPostSnapshotFailureMsg);
+         componentEx->GetPrepareForBackupFailureMsg(&bstrPrepareForBackupFailureMsg);
+         componentEx->GetRestoreName(&bstrRestoreName);
+         if (FAILED(componentEx->GetRollForward(&eRollForwardType, &bstrRollForwardRestorePoint)))
+            eRollForwardType = VSS_RF_UNDEFINED;
+         calls += 5;
+      }
+
+      IVssComponentEx2 *componentEx2 = GetIVssComponentEx2();
+      if (componentEx2 != 0)
+      {
+         HRESULT hr;
+         HRESULT hrApplication;
+         AutoBStr bstrApplicationMessage;
+         DWORD dwReserved;
+
+         if (SUCCEEDED(componentEx2->GetFailure(&hr, &hrApplication, &bstrApplicationMessage, &dwReserved)))
+            failure = gcnew VssComponentFailure(hr, hrApplication, bstrApplicationMessage);
+         calls++;
+      }
+#endif
+
+      return gcnew VssComponentSnapshot(bAdditionalRestores, bstrBackupOptions, bstrBackupStamp, bBackupSucceeded,
+         VssStringCache::FromBStr(m_stringCache, bstrComponentName), (VssComponentType)eComponentType,
+         (VssFileRestoreStatus)eFileRestoreStatus, VssStringCache::FromBStr(m_stringCache, bstrLogicalPath),
+         bstrPostRestoreFailureMsg, bstrPreRestoreFailureMsg, bstrPreviousBackupStamp, bstrRestoreOptions,
+         (VssRestoreTarget)eRestoreTarget, bSelectedForRestore, bAuthoritativeRestore, bstrPostSnapshotFailureMsg,
+         bstrPrepareForBackupFailureMsg, bstrRestoreName, bstrRollForwardRestorePoint, (VssRollForwardType)eRollForwardType,
+         failure, alternateLocationMappingCount, directedTargetCount, newTargetCount, partialFileCount, differencedFileCount,
+         restoreSubcomponentCount, calls);
+   }
 }
 } }
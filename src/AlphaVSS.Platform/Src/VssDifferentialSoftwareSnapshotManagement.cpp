@@ -155,12 +155,16 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
         
    void VssDifferentialSoftwareSnapshotManagement::AddDiffArea(String^ volumeName, String^ diffAreaVolumeName, Int64 maximumDiffSpace)
    {
-      CheckCom(m_mgmt->AddDiffArea(NoNullAutoMStr(volumeName), NoNullAutoMStr(diffAreaVolumeName), maximumDiffSpace));
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      NoNullPinMStr(pwszDiffAreaVolumeName, diffAreaVolumeName);
+      CheckCom(m_mgmt->AddDiffArea(pwszVolumeName, pwszDiffAreaVolumeName, maximumDiffSpace));
    }
 
     void VssDifferentialSoftwareSnapshotManagement::ChangeDiffAreaMaximumSize(String^ volumeName, String^ diffAreaVolumeName, Int64 maximumDiffSpace)
    {
-      CheckCom(m_mgmt->ChangeDiffAreaMaximumSize(NoNullAutoMStr(volumeName), NoNullAutoMStr(diffAreaVolumeName), maximumDiffSpace));
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      NoNullPinMStr(pwszDiffAreaVolumeName, diffAreaVolumeName);
+      CheckCom(m_mgmt->ChangeDiffAreaMaximumSize(pwszVolumeName, pwszDiffAreaVolumeName, maximumDiffSpace));
    }
 
     IList<VssDiffAreaProperties^>^ VssDifferentialSoftwareSnapshotManagement::QueryDiffAreasForSnapshot(Guid snapshotId)
@@ -173,21 +177,24 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
     IList<VssDiffAreaProperties^>^ VssDifferentialSoftwareSnapshotManagement::QueryDiffAreasForVolume(String^ volumeName)
    {
       IVssEnumMgmtObject *pEnum;
-      CheckCom(m_mgmt->QueryDiffAreasForVolume(NoNullAutoMStr(volumeName), &pEnum));
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      CheckCom(m_mgmt->QueryDiffAreasForVolume(pwszVolumeName, &pEnum));
       return CreateListFromEnumMgmtObject<VssDiffAreaProperties>(pEnum);
    }
 
     IList<VssDiffAreaProperties^>^ VssDifferentialSoftwareSnapshotManagement::QueryDiffAreasOnVolume(String^ volumeName)
    {
       IVssEnumMgmtObject *pEnum;
-      CheckCom(m_mgmt->QueryDiffAreasOnVolume(NoNullAutoMStr(volumeName), &pEnum));
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      CheckCom(m_mgmt->QueryDiffAreasOnVolume(pwszVolumeName, &pEnum));
       return CreateListFromEnumMgmtObject<VssDiffAreaProperties>(pEnum);
    }
 
     IList<VssDiffVolumeProperties^>^ VssDifferentialSoftwareSnapshotManagement::QueryVolumesSupportedForDiffAreas(String^ originalVolumeName)
    {
       IVssEnumMgmtObject *pEnum;
-      CheckCom(m_mgmt->QueryVolumesSupportedForDiffAreas(NoNullAutoMStr(originalVolumeName), &pEnum));
+      NoNullPinMStr(pwszOriginalVolumeName, originalVolumeName);
+      CheckCom(m_mgmt->QueryVolumesSupportedForDiffAreas(pwszOriginalVolumeName, &pEnum));
       return CreateListFromEnumMgmtObject<VssDiffVolumeProperties>(pEnum);
    }
 
@@ -200,7 +207,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
     void VssDifferentialSoftwareSnapshotManagement::ChangeDiffAreaMaximumSize(String^ volumeName, String^ diffAreaVolumeName, Int64 maximumDiffSpace, bool isVolatile)
    {
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      CheckCom(RequireIVssDifferentialSoftwareSnapshotMgmt2()->ChangeDiffAreaMaximumSizeEx(NoNullAutoMStr(volumeName), NoNullAutoMStr(diffAreaVolumeName), maximumDiffSpace, isVolatile));
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      NoNullPinMStr(pwszDiffAreaVolumeName, diffAreaVolumeName);
+      CheckCom(RequireIVssDifferentialSoftwareSnapshotMgmt2()->ChangeDiffAreaMaximumSizeEx(pwszVolumeName, pwszDiffAreaVolumeName, maximumDiffSpace, isVolatile));
 #else
       UnsupportedOs();
 #endif
@@ -212,7 +221,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
     void VssDifferentialSoftwareSnapshotManagement::ClearVolumeProtectFault(String^ volumeName)
    {
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      CheckCom(RequireIVssDifferentialSoftwareSnapshotMgmt3()->ClearVolumeProtectFault(NoNullAutoMStr(volumeName)));
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      CheckCom(RequireIVssDifferentialSoftwareSnapshotMgmt3()->ClearVolumeProtectFault(pwszVolumeName));
 #else
       UnsupportedOs();
 #endif
@@ -221,7 +231,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    void VssDifferentialSoftwareSnapshotManagement::DeleteUnusedDiffAreas(String^ diffAreaVolumeName)
    {
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      CheckCom(RequireIVssDifferentialSoftwareSnapshotMgmt3()->DeleteUnusedDiffAreas(NoNullAutoMStr(diffAreaVolumeName)));
+      NoNullPinMStr(pwszDiffAreaVolumeName, diffAreaVolumeName);
+      CheckCom(RequireIVssDifferentialSoftwareSnapshotMgmt3()->DeleteUnusedDiffAreas(pwszDiffAreaVolumeName));
 #else
       UnsupportedOs();
 #endif
@@ -231,7 +242,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    {
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
       VSS_VOLUME_PROTECTION_INFO info;
-      CheckCom(RequireIVssDifferentialSoftwareSnapshotMgmt3()->GetVolumeProtectLevel(NoNullAutoMStr(volumeName), &info));
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      CheckCom(RequireIVssDifferentialSoftwareSnapshotMgmt3()->GetVolumeProtectLevel(pwszVolumeName, &info));
       return CreateVssVolumeProtectionInfo(&info);
 #else
       UnsupportedOs();
@@ -241,7 +253,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
     void VssDifferentialSoftwareSnapshotManagement::SetVolumeProtectionLevel(String^ volumeName, VssProtectionLevel protectionLevel)
    {
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-      CheckCom(RequireIVssDifferentialSoftwareSnapshotMgmt3()->SetVolumeProtectLevel(NoNullAutoMStr(volumeName), (VSS_PROTECTION_LEVEL)protectionLevel));
+      NoNullPinMStr(pwszVolumeName, volumeName);
+      CheckCom(RequireIVssDifferentialSoftwareSnapshotMgmt3()->SetVolumeProtectLevel(pwszVolumeName, (VSS_PROTECTION_LEVEL)protectionLevel));
 #else
       UnsupportedOs();
 #endif
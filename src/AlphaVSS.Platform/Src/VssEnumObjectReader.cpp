@@ -0,0 +1,94 @@
+#include "StdAfx.h"
+
+#include "VssEnumObjectReader.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   VssEnumObjectReader::VssEnumObjectReader(IVssEnumObject *pEnum, ULONG batchSize)
+      : m_pEnum(pEnum), m_buffer(0), m_capacity(0), m_batchSize(batchSize), m_adaptive(batchSize == 0),
+        m_fetched(0), m_position(0), m_fetchCount(0), m_exhausted(false)
+   {
+      if (m_adaptive)
+         m_batchSize = AdaptiveInitialBatchSize;
+      else if (m_batchSize > MaxBatchSize)
+         m_batchSize = MaxBatchSize;
+   }
+
+   VssEnumObjectReader::~VssEnumObjectReader()
+   {
+      // Free any objects fetched from the enumerator but never handed out.
+      while (m_position < m_fetched)
+         FreeObjectProp(m_buffer[m_position++]);
+
+      delete [] m_buffer;
+      m_buffer = 0;
+
+      if (m_pEnum != 0)
+      {
+         m_pEnum->Release();
+         m_pEnum = 0;
+      }
+   }
+
+   VSS_OBJECT_PROP *VssEnumObjectReader::Next()
+   {
+      if (m_position >= m_fetched && !Fill())
+         return 0;
+
+      return &m_buffer[m_position++];
+   }
+
+   bool VssEnumObjectReader::Fill()
+   {
+      if (m_exhausted)
+         return false;
+
+      // The buffer is only (re)allocated when it is empty, so no objects can be lost here.
+      if (m_capacity < m_batchSize)
+      {
+         delete [] m_buffer;
+         m_buffer = 0;
+         m_capacity = 0;
+         m_buffer = new VSS_OBJECT_PROP[m_batchSize];
+         m_capacity = m_batchSize;
+      }
+
+      m_fetched = 0;
+      m_position = 0;
+
+      ULONG celtFetched = 0;
+      HRESULT hr = m_pEnum->Next(m_batchSize, m_buffer, &celtFetched);
+      m_fetchCount++;
+
+      if (FAILED(hr))
+      {
+         m_exhausted = true;
+         ThrowException(hr);
+      }
+
+      m_fetched = celtFetched;
+
+      // S_FALSE, or fewer objects than requested, signals the end of the enumeration.
+      if (hr == S_FALSE || celtFetched < m_batchSize)
+         m_exhausted = true;
+      else if (m_adaptive && m_batchSize < MaxBatchSize)
+         m_batchSize = min(m_batchSize * 2, MaxBatchSize);
+
+      return m_fetched > 0;
+   }
+
+   void VssEnumObjectReader::FreeObjectProp(VSS_OBJECT_PROP &prop)
+   {
+      switch (prop.Type)
+      {
+      case VSS_OBJECT_SNAPSHOT:
+         ::VssFreeSnapshotProperties(&prop.Obj.Snap);
+         break;
+      case VSS_OBJECT_PROVIDER:
+         ::CoTaskMemFree(prop.Obj.Prov.m_pwszProviderName);
+         ::CoTaskMemFree(prop.Obj.Prov.m_pwszProviderVersion);
+         break;
+      }
+   }
+}
+} }
@@ -2,24 +2,30 @@
 #include "StdAfx.h"
 
 #include "VssExamineWriterMetadata.h"
+#include "VssXmlStream.h"
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
-   IVssExamineWriterMetadata^ VssExamineWriterMetadata::Adopt(::IVssExamineWriterMetadata *ewm)
+   IVssExamineWriterMetadata^ VssExamineWriterMetadata::Adopt(::IVssExamineWriterMetadata *ewm, VssStringCache^ stringCache)
    {
+      VssScope^ scope = VssScope::Current;
+      VssExamineWriterMetadata^ metadata;
       try
       {
-         return gcnew VssExamineWriterMetadata(ewm);
+         metadata = gcnew VssExamineWriterMetadata(ewm, stringCache, scope);
       }
       catch (...)
       {
          ewm->Release();
          throw;
       }
+
+      AttachToScope(scope, metadata);
+      return metadata;
    }
 
-   VssExamineWriterMetadata::VssExamineWriterMetadata(::IVssExamineWriterMetadata *examineWriterMetadata)
-      : mExamineWriterMetadata(examineWriterMetadata)
+   VssExamineWriterMetadata::VssExamineWriterMetadata(::IVssExamineWriterMetadata *examineWriterMetadata, VssStringCache^ stringCache, VssScope^ scope)
+      : mExamineWriterMetadata(examineWriterMetadata), m_stringCache(stringCache), m_scope(scope)
    {
       Initialize();
    }
@@ -35,7 +41,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       bool hasExIdentity = false;
 
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WIN2003
-      if (OperatingSystemInfo::IsAtLeast(OSVersionName::WindowsServer2003, 1))
+      if (OperatingSystemFlags::IsWindowsServer2003SP1OrLater)
       {	
          IVssExamineWriterMetadataEx *ex = GetIVssExamineWriterMetadataEx();
          if (ex != 0)
@@ -50,8 +56,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
       m_instanceId = ToGuid(idInstance);
       m_writerId = ToGuid(idWriter);
-      m_writerName = bsWriterName;
-      m_instanceName = bsInstanceName;
+      m_writerName = VssStringCache::FromBStr(m_stringCache, bsWriterName);
+      m_instanceName = VssStringCache::FromBStr(m_stringCache, bsInstanceName);
       m_usage = (VssUsageType)usage;
       m_source = (VssSourceType)source;
 
@@ -65,6 +71,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
    VssExamineWriterMetadata::~VssExamineWriterMetadata()
    {
+      DetachFromScope(m_scope, this);
       this->!VssExamineWriterMetadata();
    }
 
@@ -95,6 +102,17 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    bool VssExamineWriterMetadata::LoadFromXml(String^ xml)
    {
       HRESULT hr = mExamineWriterMetadata->LoadFromXML(NoNullAutoMBStr(xml));
+      return LoadFromXmlResult(hr);
+   }
+
+   bool VssExamineWriterMetadata::LoadFromXml(System::IO::Stream^ stream, VssXmlStreamFormat format)
+   {
+      AutoBStr xml(VssXmlStream::Read(stream, format));
+      return LoadFromXmlResult(mExamineWriterMetadata->LoadFromXML(xml));
+   }
+
+   bool VssExamineWriterMetadata::LoadFromXmlResult(HRESULT hr)
+   {
       if (FAILED(hr))
          ThrowException(hr);
 
@@ -114,6 +132,15 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       return xml;
    }
 
+   void VssExamineWriterMetadata::SaveAsXml(System::IO::Stream^ stream, VssXmlStreamFormat format)
+   {
+      VssXmlStream::ValidateArguments(stream, format);
+
+      AutoBStr xml;
+      CheckCom(mExamineWriterMetadata->SaveAsXML(&xml));
+      VssXmlStream::Write(xml, stream, format);
+   }
+
    Guid VssExamineWriterMetadata::InstanceId::get()
    {
       return m_instanceId;
@@ -152,7 +179,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       {
          IVssWMFiledesc *filedesc;
          CheckCom(mExamineWriterMetadata->GetExcludeFile(i, &filedesc));
-         list->Add(CreateVssWMFileDescriptor(filedesc));
+         list->Add(CreateVssWMFileDescriptor(filedesc, m_stringCache));
       }
       m_excludeFiles = list;
       return m_excludeFiles;
@@ -171,7 +198,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       {
          ::IVssWMComponent *component;
          CheckCom(mExamineWriterMetadata->GetComponent(i, &component));
-         list->Add(VssWMComponent::Adopt(component));
+         list->Add(VssWMComponent::Adopt(component, m_stringCache, m_scope));
       }
       m_components = list;
       return m_components;
@@ -215,7 +242,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       {
          IVssWMFiledesc *filedesc;
          CheckCom(mExamineWriterMetadata->GetAlternateLocationMapping(i, &filedesc));
-         list->Add(CreateVssWMFileDescriptor(filedesc));
+         list->Add(CreateVssWMFileDescriptor(filedesc, m_stringCache));
       }
       m_alternateLocationMappings = list;
       return m_alternateLocationMappings;
@@ -224,7 +251,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    VssBackupSchema VssExamineWriterMetadata::BackupSchema::get()
    {
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WIN2003
-      OperatingSystemInfo::RequireAtLeast(OSVersionName::WindowsServer2003);
+      OperatingSystemFlags::Require(OperatingSystemFlags::IsWindowsServer2003OrLater);
       DWORD schema;
       CheckCom(mExamineWriterMetadata->GetBackupSchema(&schema));
       return (VssBackupSchema)schema;
@@ -241,15 +268,18 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
    Version^ VssExamineWriterMetadata::Version::get()
    {
       if (m_version == nullptr)
-      {
-         DWORD dwMajorVersion = 0;
-         DWORD dwMinorVersion = 0;
+         m_version = ReadVersion();
+      return m_version;
+   }
+
+   System::Version^ VssExamineWriterMetadata::ReadVersion()
+   {
+      DWORD dwMajorVersion = 0;
+      DWORD dwMinorVersion = 0;
 #if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
-         CheckCom(RequireIVssExamineWriterMetadataEx2()->GetVersion(&dwMajorVersion, &dwMinorVersion));
+      CheckCom(RequireIVssExamineWriterMetadataEx2()->GetVersion(&dwMajorVersion, &dwMinorVersion));
 #endif
-         m_version = gcnew System::Version(dwMajorVersion, dwMinorVersion);
-      }
-      return m_version;
+      return gcnew System::Version(dwMajorVersion, dwMinorVersion);
    }
 
    IList<VssWMFileDescriptor^>^ VssExamineWriterMetadata::ExcludeFromSnapshotFiles::get()
@@ -267,13 +297,32 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
       {
          IVssWMFiledesc *filedesc;
          CheckCom(RequireIVssExamineWriterMetadataEx2()->GetExcludeFromSnapshotFile(i, &filedesc));
-         list->Add(CreateVssWMFileDescriptor(filedesc));
+         list->Add(CreateVssWMFileDescriptor(filedesc, m_stringCache));
       }
-      m_excludeFiles = list;
+      m_excludeFilesFromSnapshot = list;
 #else
-      m_excludeFiles = gcnew List<VssWMFileDescriptor^>();
+      m_excludeFilesFromSnapshot = gcnew List<VssWMFileDescriptor^>();
 #endif
-      return m_excludeFiles;
+      return m_excludeFilesFromSnapshot;
+   }
+
+   int VssExamineWriterMetadata::Materialize()
+   {
+      int descriptorCount = ExcludeFiles->Count + AlternateLocationMappings->Count;
+
+#if ALPHAVSS_TARGET >= ALPHAVSS_TARGET_WINVISTAORLATER
+      if (GetIVssExamineWriterMetadataEx2() != 0)
+      {
+         descriptorCount += ExcludeFromSnapshotFiles->Count;
+         if (m_version == nullptr)
+            m_version = ReadVersion();
+      }
+#endif
+
+      for each (IVssWMComponent^ component in Components)
+         descriptorCount += safe_cast<VssWMComponent^>(component)->Materialize();
+
+      return descriptorCount;
    }
 
 }
@@ -21,7 +21,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 	{
 		LONG lSnapshotCapability = 0;
 		BOOL bSnapshotsPresent = 0;
-		CheckCom(::IsVolumeSnapshotted((VSS_PWSZ)((const wchar_t *)NoNullAutoMStr(volumeName)), &bSnapshotsPresent, &lSnapshotCapability));	
+		NoNullPinMStr(pwszVolumeName, volumeName);
+		CheckCom(::IsVolumeSnapshotted(pwszVolumeName, &bSnapshotsPresent, &lSnapshotCapability));	
 		return bSnapshotsPresent != 0;
 	}
 
@@ -29,7 +30,8 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 	{
 		LONG lSnapshotCapability = 0;
 		BOOL bSnapshotsPresent = 0;
-		CheckCom(::IsVolumeSnapshotted((VSS_PWSZ)((const wchar_t *)NoNullAutoMStr(volumeName)), &bSnapshotsPresent, &lSnapshotCapability));
+		NoNullPinMStr(pwszVolumeName, volumeName);
+		CheckCom(::IsVolumeSnapshotted(pwszVolumeName, &bSnapshotsPresent, &lSnapshotCapability));
 		if (!bSnapshotsPresent)
 			throw gcnew InvalidOperationException("No snapshot exists for the specified volume");
 		return (VssSnapshotCompatibility)lSnapshotCapability;
@@ -41,9 +43,10 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		// present in the header-files or library files, except for the library files for ws03 
 		// in the vshadow sample directory in the VSSSDK72. Requiring WS08 here.
 #if ALPHAVSS_TARGET == ALPHAVSS_TARGET_WINVISTAORLATER
-		OperatingSystemInfo::RequireAtLeast(OSVersionName::WindowsServer2008);
+		OperatingSystemFlags::Require(OperatingSystemFlags::IsWindowsServer2008OrLater);
 		bool bBlock = 0;
-		CheckCom(::ShouldBlockRevert(NoNullAutoMStr(volumeName), &bBlock));
+		NoNullPinMStr(pwszVolumeName, volumeName);
+		CheckCom(::ShouldBlockRevert(pwszVolumeName, &bBlock));
 		return bBlock != 0;
 #else
 		throw gcnew NotSupportedException(L"This method requires Windows Server 2008.");
@@ -54,7 +57,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 	{
 		::IVssExamineWriterMetadata *pMetadata;
 		CheckCom(::CreateVssExamineWriterMetadata(NoNullAutoMBStr(xml), &pMetadata));
-		return VssExamineWriterMetadata::Adopt(pMetadata);
+		return VssExamineWriterMetadata::Adopt(pMetadata, nullptr);
 
 	}
 
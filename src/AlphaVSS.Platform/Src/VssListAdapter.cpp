@@ -1,9 +1,14 @@
-
 #include "StdAfx.h"
 #include "VssListAdapter.h"
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
+	generic<typename T>
+	VssListAdapter<T>::VssListAdapter()
+		: m_version(0)
+	{
+	}
+
 	generic<typename T>
 	void VssListAdapter<T>::Add(T item)
 	{
@@ -19,10 +24,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 	generic<typename T>
 	bool VssListAdapter<T>::Contains(T item)
 	{
-		for (int i = 0; i < Count; i++)
-			if (this[i]->Equals(item))
-				return true;
-		return false;
+		return IndexOf(item) != -1;
 	}
 
 	generic<typename T>
@@ -37,11 +39,12 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		if (arr->Rank != 1)
 			throw gcnew ArgumentException("array must be one-dimensional", "arr");
 
-		if (arrayIndex + Count > arr->Length)
+		int count = Count;
+		if (arrayIndex + count > arr->Length)
 			throw gcnew ArgumentException("invalid arrayIndex");
 
-		for (int i = 0; i < Count; i++)
-			arr[i + arrayIndex] = this[i];
+		for (int i = 0; i < count; i++)
+			arr[i + arrayIndex] = GetItem(i);
 	}
 
 	generic<typename T>
@@ -59,8 +62,9 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 	generic<typename T>
 	int VssListAdapter<T>::IndexOf(T item)
 	{
-		for (int i = 0; i < Count; i++)
-			if (this[i]->Equals(item))
+		int count = Count;
+		for (int i = 0; i < count; i++)
+			if (GetItem(i)->Equals(item))
 				return i;
 		return -1;
 	}
@@ -89,15 +93,36 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		return true;
 	}		
 
+	generic<typename T>
+	T VssListAdapter<T>::default::get(int index)
+	{
+		if (index < 0 || index >= Count)
+			throw gcnew ArgumentOutOfRangeException("index");
+
+		return GetItem(index);
+	}
+
 	generic<typename T>
 	void VssListAdapter<T>::default::set(int index, T value)
 	{
 		throw gcnew NotSupportedException(L"Cannot modify read-only list");		
 	}		
 
+	generic<typename T>
+	void VssListAdapter<T>::Invalidate()
+	{
+		System::Threading::Interlocked::Increment(m_version);
+	}
+
+	generic<typename T>
+	int VssListAdapter<T>::Version::get()
+	{
+		return m_version;
+	}
+
 	generic<typename T>
 	VssListAdapter<T>::Enumerator::Enumerator(VssListAdapter<T>^ list)
-		: m_list(list), m_index(-1)
+		: m_list(list), m_version(list->m_version), m_count(list->Count), m_index(-1)
 	{
 	}
 
@@ -105,41 +130,52 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 	VssListAdapter<T>::Enumerator::~Enumerator()
 	{
 	}
-	
+
 	generic<typename T>
-	VssListAdapter<T>::Enumerator::!Enumerator()
+	void VssListAdapter<T>::Enumerator::CheckVersion()
 	{
+		if (m_version != m_list->m_version)
+			throw gcnew InvalidOperationException(L"The list was modified after the enumerator was created.");
 	}
 
 	generic<typename T>
 	bool VssListAdapter<T>::Enumerator::MoveNext()
 	{
-		int count = m_list->Count;
-		if (++m_index >= count)
+		CheckVersion();
+
+		if (m_index + 1 >= m_count)
 		{
-			m_index = count;
+			m_index = m_count;
+			m_current = T();
 			return false;
 		}
+
+		m_current = m_list->GetItem(++m_index);
 		return true;
 	}
 
 	generic<typename T>
 	void VssListAdapter<T>::Enumerator::Reset()
 	{
+		CheckVersion();
 		m_index = -1;
+		m_current = T();
 	}
 
 	generic<typename T>
 	Object^ VssListAdapter<T>::Enumerator::CurrentObject::get()
 	{
-		return m_list[m_index];
+		if (m_index < 0 || m_index >= m_count)
+			throw gcnew InvalidOperationException(L"The enumerator is positioned before the first or after the last element.");
+
+		return m_current;
 	}
 
 	generic<typename T>
 	T VssListAdapter<T>::Enumerator::Current::get()
 	{
-		return m_list[m_index];
+		return m_current;
 	}
 
 
-} } }
\ No newline at end of file
+} } }
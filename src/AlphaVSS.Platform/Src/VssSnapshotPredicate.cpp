@@ -0,0 +1,85 @@
+#include "StdAfx.h"
+
+#include "VssSnapshotPredicate.h"
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   VssSnapshotPredicate::VssSnapshotPredicate(VssSnapshotFilter^ filter)
+      : m_hasSnapshotSetId(false), m_hasProviderId(false), m_requiredAttributes(0),
+        m_hasCreatedAfter(false), m_createdAfter(0), m_hasCreatedBefore(false), m_createdBefore(0),
+        m_originalVolumeName(0)
+   {
+      if (filter == nullptr)
+         throw gcnew ArgumentNullException("filter");
+
+      if (filter->SnapshotSetId.HasValue)
+      {
+         m_hasSnapshotSetId = true;
+         m_snapshotSetId = ToVssId(filter->SnapshotSetId.Value);
+      }
+
+      if (filter->ProviderId.HasValue)
+      {
+         m_hasProviderId = true;
+         m_providerId = ToVssId(filter->ProviderId.Value);
+      }
+
+      m_requiredAttributes = (LONG)filter->RequiredAttributes;
+
+      // VSS_TIMESTAMP is a UTC FILETIME, which is what DateTime::ToFileTime returns.
+      if (filter->CreatedAfter.HasValue)
+      {
+         m_hasCreatedAfter = true;
+         m_createdAfter = filter->CreatedAfter.Value.ToFileTime();
+      }
+
+      if (filter->CreatedBefore.HasValue)
+      {
+         m_hasCreatedBefore = true;
+         m_createdBefore = filter->CreatedBefore.Value.ToFileTime();
+      }
+
+      if (filter->OriginalVolumeName != nullptr)
+         m_originalVolumeName = (wchar_t *)System::Runtime::InteropServices::Marshal::StringToHGlobalUni(filter->OriginalVolumeName).ToPointer();
+   }
+
+   VssSnapshotPredicate::~VssSnapshotPredicate()
+   {
+      if (m_originalVolumeName != 0)
+      {
+         System::Runtime::InteropServices::Marshal::FreeHGlobal((IntPtr)m_originalVolumeName);
+         m_originalVolumeName = 0;
+      }
+   }
+
+   bool VssSnapshotPredicate::Matches(const VSS_SNAPSHOT_PROP &prop) const
+   {
+      // The cheapest tests go first; the string comparison is done last.
+      if (m_hasSnapshotSetId && !InlineIsEqualGUID(prop.m_SnapshotSetId, m_snapshotSetId))
+         return false;
+
+      if (m_hasProviderId && !InlineIsEqualGUID(prop.m_ProviderId, m_providerId))
+         return false;
+
+      if ((prop.m_lSnapshotAttributes & m_requiredAttributes) != m_requiredAttributes)
+         return false;
+
+      if (m_hasCreatedAfter && prop.m_tsCreationTimestamp < m_createdAfter)
+         return false;
+
+      if (m_hasCreatedBefore && prop.m_tsCreationTimestamp >= m_createdBefore)
+         return false;
+
+      if (m_originalVolumeName != 0)
+      {
+         if (prop.m_pwszOriginalVolumeName == 0)
+            return false;
+
+         if (::CompareStringOrdinal(prop.m_pwszOriginalVolumeName, -1, m_originalVolumeName, -1, TRUE) != CSTR_EQUAL)
+            return false;
+      }
+
+      return true;
+   }
+}
+} }
@@ -0,0 +1,100 @@
+#include "StdAfx.h"
+
+#include <vcclr.h>
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   VssStringCache::VssStringCache(int capacity)
+      : m_entries(nullptr), m_capacity(0), m_count(0), m_lookups(0), m_hits(0), m_bytesSaved(0)
+   {
+      if (capacity <= 0)
+         throw gcnew ArgumentOutOfRangeException("capacity");
+
+      // Round up to a power of two, so that the slot can be computed by masking the hash.
+      m_capacity = 1;
+      while (m_capacity < capacity && m_capacity < (1 << 30))
+         m_capacity <<= 1;
+
+      m_entries = gcnew array<String^>(m_capacity);
+   }
+
+   String^ VssStringCache::Intern(const wchar_t *str, int length)
+   {
+      if (length == 0)
+         return String::Empty;
+
+      array<String^>^ entries = m_entries;
+      if (entries == nullptr || length > MaxLength)
+         return gcnew String(str, 0, length);
+
+      // FNV-1a
+      UInt32 hash = 2166136261;
+      for (int i = 0; i < length; i++)
+      {
+         hash ^= str[i];
+         hash *= 16777619;
+      }
+
+      int slot = (int)(hash & (UInt32)(entries->Length - 1));
+
+      Interlocked::Increment(m_lookups);
+
+      String^ entry = entries[slot];
+      if (entry != nullptr && entry->Length == length)
+      {
+         pin_ptr<const wchar_t> chars = PtrToStringChars(entry);
+         if (wmemcmp(chars, str, length) == 0)
+         {
+            Interlocked::Increment(m_hits);
+            Interlocked::Add(m_bytesSaved, (Int64)length * sizeof(wchar_t));
+            return entry;
+         }
+      }
+
+      // The slot is only replaced if no other thread has replaced it since it was read, so that a
+      // slot filled concurrently by several threads is counted once.
+      String^ result = gcnew String(str, 0, length);
+      if (Interlocked::CompareExchange<String^>(entries[slot], result, entry) == entry && entry == nullptr)
+         Interlocked::Increment(m_count);
+      return result;
+   }
+
+   void VssStringCache::Release()
+   {
+      m_entries = nullptr;
+      Interlocked::Exchange(m_count, 0);
+   }
+
+   int VssStringCache::Capacity::get()
+   {
+      return m_capacity;
+   }
+
+   VssStringCacheStatistics^ VssStringCache::GetStatistics()
+   {
+      return gcnew VssStringCacheStatistics(m_capacity, Thread::VolatileRead(m_count), Interlocked::Read(m_lookups), Interlocked::Read(m_hits), Interlocked::Read(m_bytesSaved));
+   }
+
+   String^ VssStringCache::FromBStr(VssStringCache^ cache, BSTR str)
+   {
+      if (str == 0)
+         return nullptr;
+
+      if (cache == nullptr)
+         return Alphaleonis::Win32::Vss::FromBStr(str);
+
+      return cache->Intern(str, (int)::SysStringLen(str));
+   }
+
+   String^ VssStringCache::FromPwsz(VssStringCache^ cache, const wchar_t *str)
+   {
+      // Like gcnew String(str), a null pointer yields an empty string.
+      if (str == 0)
+         return String::Empty;
+
+      if (cache == nullptr)
+         return gcnew String(str);
+
+      return cache->Intern(str, (int)wcslen(str));
+   }
+}}}
@@ -5,30 +5,34 @@
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
-	VssWMComponent^ VssWMComponent::Adopt(::IVssWMComponent *component)
+	VssWMComponent^ VssWMComponent::Adopt(::IVssWMComponent *component, VssStringCache^ stringCache, VssScope^ scope)
 	{
+		VssWMComponent^ result;
 		try
 		{
-			return gcnew VssWMComponent(component);
+			result = gcnew VssWMComponent(component, stringCache, scope);
 		}
 		catch (...)
 		{
 			component->Release();
 			throw;
 		}
+
+		AttachToScope(scope, result);
+		return result;
 	}
 
-	VssWMComponent::VssWMComponent(::IVssWMComponent *component)
-		: m_component(component)
+	VssWMComponent::VssWMComponent(::IVssWMComponent *component, VssStringCache^ stringCache, VssScope^ scope)
+		: m_component(component), m_stringCache(stringCache), m_scope(scope)
 	{		
 		PVSSCOMPONENTINFO info;
 		CheckCom((m_component->GetComponentInfo(&info)));
 		try
 		{
 			m_type = ((VssComponentType)info->type);
-			m_logicalPath = (FromBStr(info->bstrLogicalPath));
-			m_componentName = (FromBStr(info->bstrComponentName));
-			m_caption = (FromBStr(info->bstrCaption));
+			m_logicalPath = (VssStringCache::FromBStr(m_stringCache, info->bstrLogicalPath));
+			m_componentName = (VssStringCache::FromBStr(m_stringCache, info->bstrComponentName));
+			m_caption = (VssStringCache::FromBStr(m_stringCache, info->bstrCaption));
 			m_restoreMetadata = (info->bRestoreMetadata);
 			m_notifyOnBackupComplete = (info->bNotifyOnBackupComplete);
 			m_selectable = (info->bSelectable);
@@ -56,6 +60,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
 	VssWMComponent::~VssWMComponent()
 	{
+		DetachFromScope(m_scope, this);
 		this->!VssWMComponent();
 	}
 
@@ -137,7 +142,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		{
 			IVssWMFiledesc *filedesc;
 			CheckCom(m_component->GetFile(i, &filedesc));
-			list->Add(CreateVssWMFileDescriptor(filedesc));
+			list->Add(CreateVssWMFileDescriptor(filedesc, m_stringCache));
 		}
 		m_files = list->AsReadOnly();
 		return m_files;
@@ -154,7 +159,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		{
 			IVssWMFiledesc *filedesc;
 			CheckCom(m_component->GetDatabaseFile(i, &filedesc));
-			list->Add(CreateVssWMFileDescriptor(filedesc));
+			list->Add(CreateVssWMFileDescriptor(filedesc, m_stringCache));
 		}
 		m_databaseFiles = list->AsReadOnly();
 		return m_databaseFiles;
@@ -171,7 +176,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		{
 			IVssWMFiledesc *filedesc;
 			CheckCom(m_component->GetDatabaseLogFile(i, &filedesc));
-			list->Add(CreateVssWMFileDescriptor(filedesc));
+			list->Add(CreateVssWMFileDescriptor(filedesc, m_stringCache));
 		}
 		m_databaseLogFiles = list->AsReadOnly();
 		return m_databaseLogFiles;
@@ -190,7 +195,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		{
 			IVssWMDependency *dependency;
 			CheckCom(m_component->GetDependency(i, &dependency));
-			list->Add(CreateVssWMDependency(dependency));
+			list->Add(CreateVssWMDependency(dependency, m_stringCache));
 		}
 		m_dependencies = list->AsReadOnly();
 		return m_dependencies;
@@ -199,6 +204,21 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 #endif
 	}
 
+	int VssWMComponent::Materialize()
+	{
+		int descriptorCount = Files->Count + DatabaseFiles->Count + DatabaseLogFiles->Count;
+		(void)Dependencies;
+
+		// Everything is cached now, so the native component is no longer needed.
+		if (m_component != 0)
+		{
+			m_component->Release();
+			m_component = 0;
+		}
+
+		return descriptorCount;
+	}
+
 
 }
 } }
\ No newline at end of file
@@ -5,21 +5,26 @@
 
 namespace Alphaleonis { namespace Win32 { namespace Vss
 {
-	VssWriterComponents^ VssWriterComponents::Adopt(IVssWriterComponentsExt *vssWriterComponents)
+	VssWriterComponents^ VssWriterComponents::Adopt(IVssWriterComponentsExt *vssWriterComponents, VssStringCache^ stringCache, VssListAdapter<IVssWriterComponents^>^ owner)
 	{
+		VssScope^ scope = VssScope::Current;
+		VssWriterComponents^ writerComponents;
 		try
 		{
-			return gcnew VssWriterComponents(vssWriterComponents);
+			writerComponents = gcnew VssWriterComponents(vssWriterComponents, stringCache, scope, owner);
 		}
 		catch (...)
 		{
 			vssWriterComponents->Release();
 			throw;
 		}
+
+		AttachToScope(scope, writerComponents);
+		return writerComponents;
 	}
 
-	VssWriterComponents::VssWriterComponents(IVssWriterComponentsExt *vssWriterComponents)
-		: mVssWriterComponents(vssWriterComponents), m_components(nullptr)
+	VssWriterComponents::VssWriterComponents(IVssWriterComponentsExt *vssWriterComponents, VssStringCache^ stringCache, VssScope^ scope, VssListAdapter<IVssWriterComponents^>^ owner)
+		: mVssWriterComponents(vssWriterComponents), m_stringCache(stringCache), m_scope(scope), m_owner(owner), m_components(nullptr)
 	{
 		m_components = gcnew ComponentList(this);
 		VSS_ID iid, wid;
@@ -30,6 +35,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 
 	VssWriterComponents::~VssWriterComponents()
 	{
+		DetachFromScope(m_scope, this);
 		this->!VssWriterComponents();
 	}
 
@@ -53,7 +59,7 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 	}
 
 	VssWriterComponents::ComponentList::ComponentList(VssWriterComponents^ writerComponents)
-		: mWriterComponents(writerComponents)
+		: mWriterComponents(writerComponents), m_items(nullptr)
 	{
 	}
 
@@ -67,14 +73,33 @@ namespace Alphaleonis { namespace Win32 { namespace Vss
 		return cComponents;
 	}
 
-	IVssComponent^ VssWriterComponents::ComponentList::default::get(int index)
+	IVssComponent^ VssWriterComponents::ComponentList::GetItem(int index)
 	{
 		if (mWriterComponents->mVssWriterComponents == 0)
 			throw gcnew ObjectDisposedException("Instance of IVssListAdapter must not be used after the object from which it was obtained has been disposed.");
 
-		::IVssComponent *component;
-		CheckCom(mWriterComponents->mVssWriterComponents->GetComponent(index, &component));
-		return VssComponent::Adopt(component);
+		Monitor::Enter(this);
+		try
+		{
+			if (m_items == nullptr || index >= m_items->Length)
+				Array::Resize<VssComponent^>(m_items, Count);
+
+			// A wrapper that has been disposed by the caller is replaced rather than returned.
+			VssComponent^ item = m_items[index];
+			if (item == nullptr || item->IsDisposed)
+			{
+				::IVssComponent *component;
+				CheckCom(mWriterComponents->mVssWriterComponents->GetComponent(index, &component));
+				item = VssComponent::Adopt(component, mWriterComponents->m_stringCache, mWriterComponents->m_scope, mWriterComponents->m_owner);
+				m_items[index] = item;
+			}
+
+			return item;
+		}
+		finally
+		{
+			Monitor::Exit(this);
+		}
 	}
 
 	IList<IVssComponent^>^ VssWriterComponents::Components::get()
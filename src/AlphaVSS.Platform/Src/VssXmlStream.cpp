@@ -0,0 +1,133 @@
+#include "StdAfx.h"
+
+#include "VssXmlStream.h"
+
+using namespace System::IO::Compression;
+using namespace System::Text;
+
+namespace Alphaleonis { namespace Win32 { namespace Vss
+{
+   void VssXmlStream::ValidateArguments(Stream^ stream, VssXmlStreamFormat format)
+   {
+      if (stream == nullptr)
+         throw gcnew ArgumentNullException("stream");
+
+      if (format != VssXmlStreamFormat::Unicode && format != VssXmlStreamFormat::Utf8 && format != VssXmlStreamFormat::Utf8GZip)
+         throw gcnew ArgumentOutOfRangeException("format");
+   }
+
+   Encoding^ VssXmlStream::GetEncoding(VssXmlStreamFormat format)
+   {
+      if (format == VssXmlStreamFormat::Unicode)
+         return Encoding::Unicode;
+      else
+         return gcnew UTF8Encoding(false);
+   }
+
+   void VssXmlStream::Write(BSTR xml, Stream^ stream, VssXmlStreamFormat format)
+   {
+      ValidateArguments(stream, format);
+
+      Encoding^ encoding = GetEncoding(format);
+      Encoder^ encoder = encoding->GetEncoder();
+      array<Byte>^ buffer = gcnew array<Byte>(encoding->GetMaxByteCount(ChunkSize));
+
+      Stream^ target = stream;
+      if (format == VssXmlStreamFormat::Utf8GZip)
+         target = gcnew GZipStream(stream, CompressionMode::Compress, true);
+
+      try
+      {
+         array<Byte>^ preamble = encoding->GetPreamble();
+         target->Write(preamble, 0, preamble->Length);
+
+         int length = (xml == 0) ? 0 : (int)SysStringLen(xml);
+         int offset = 0;
+         while (offset < length)
+         {
+            int count = Math::Min(ChunkSize, length - offset);
+            bool flush = (offset + count == length);
+            int byteCount;
+            {
+               pin_ptr<Byte> bytes = &buffer[0];
+               byteCount = encoder->GetBytes(xml + offset, count, bytes, buffer->Length, flush);
+            }
+            target->Write(buffer, 0, byteCount);
+            offset += count;
+         }
+      }
+      finally
+      {
+         // Disposing the GZipStream writes the GZip footer, but leaves the underlying stream open.
+         if (target != stream)
+            delete target;
+      }
+
+      stream->Flush();
+   }
+
+   BSTR VssXmlStream::Read(Stream^ stream, VssXmlStreamFormat format)
+   {
+      ValidateArguments(stream, format);
+
+      Stream^ source = stream;
+      if (format == VssXmlStreamFormat::Utf8GZip)
+         source = gcnew GZipStream(stream, CompressionMode::Decompress, true);
+
+      BSTR result = 0;
+      try
+      {
+         Encoding^ encoding = GetEncoding(format);
+         StreamReader^ reader = gcnew StreamReader(source, encoding, true, ChunkSize);
+         array<wchar_t>^ chunk = gcnew array<wchar_t>(ChunkSize);
+
+         // If the length of the document is known, the string is allocated at its final size up front,
+         // bounded by the number of characters the remaining bytes can decode to. The geometric growth
+         // below only applies to compressed and non-seekable streams, or if a byte order mark selects
+         // an encoding that decodes to more characters.
+         UINT capacity = ChunkSize;
+         if (source == stream && stream->CanSeek)
+         {
+            Int64 remaining = stream->Length - stream->Position;
+            if (remaining >= 0 && remaining < Int32::MaxValue)
+               capacity = (UINT)encoding->GetMaxCharCount((int)remaining);
+         }
+
+         UINT length = 0;
+         result = SysAllocStringLen(NULL, capacity);
+         if (result == 0)
+            throw gcnew OutOfMemoryException();
+
+         int count;
+         while ((count = reader->Read(chunk, 0, chunk->Length)) > 0)
+         {
+            if (length + count > capacity)
+            {
+               // Grow geometrically, so that the total amount of copying stays linear in the size of the document.
+               capacity = Math::Max(capacity * 2, length + count);
+               if (!SysReAllocStringLen(&result, NULL, capacity))
+                  throw gcnew OutOfMemoryException();
+            }
+
+            pin_ptr<wchar_t> chars = &chunk[0];
+            memcpy(result + length, chars, count * sizeof(wchar_t));
+            length += count;
+         }
+
+         if (length != capacity && !SysReAllocStringLen(&result, NULL, length))
+            throw gcnew OutOfMemoryException();
+      }
+      catch (...)
+      {
+         SysFreeString(result);
+         throw;
+      }
+      finally
+      {
+         if (source != stream)
+            delete source;
+      }
+
+      return result;
+   }
+}}}
@@ -9,6 +9,7 @@ namespace AlphaShadow
    class VssWriterDescriptor : IDisposable
    {
       private List<VssComponentDescriptor> m_components;
+      private VssComponentTree<VssComponentDescriptor> m_componentTree;
       private IUIHost m_host;
 
       public VssWriterDescriptor(IUIHost host, IVssExamineWriterMetadata writerMetadata)
@@ -21,15 +22,8 @@ namespace AlphaShadow
          m_components = new List<VssComponentDescriptor>(writerMetadata.Components.Select(c => new VssComponentDescriptor(host, WriterMetadata.WriterName, c)));         
 
          // Discover top-level components
-         for (int i = 0; i < m_components.Count; i++)
-         {
-            m_components[i].IsTopLevel = true;
-            for (int j = 0; j < m_components.Count; j++)
-            {
-               if (m_components[j].IsAncestorOf(m_components[i]))
-                  m_components[i].IsTopLevel = false;
-            }
-         }
+         foreach (VssComponentDescriptor component in ComponentTree.Roots)
+            component.IsTopLevel = true;
       }
 
       public IVssExamineWriterMetadata WriterMetadata { get; private set; }
@@ -42,6 +36,21 @@ namespace AlphaShadow
          }
       }
 
+      /// <summary>
+      /// Gets the index of the components of this writer. The index is rebuilt when the components are
+      /// reinitialized for restore, but does not reflect other modifications of <see cref="ComponentDescriptors"/>.
+      /// </summary>
+      public VssComponentTree<VssComponentDescriptor> ComponentTree
+      {
+         get
+         {
+            if (m_componentTree == null)
+               m_componentTree = new VssComponentTree<VssComponentDescriptor>(m_components, c => c.FullPath, c => c.IsSelectable);
+
+            return m_componentTree;
+         }
+      }
+
       public bool IsExcluded { get; set; }
 
       public void Dispose()
@@ -57,6 +66,7 @@ namespace AlphaShadow
       {
          // Erase the current list of components for this writer.
          ComponentDescriptors.Clear();         
+         m_componentTree = null;
 
          // Enumerate the components from the BC document
          foreach (IVssComponent component in components.Components)
@@ -23,6 +23,7 @@ namespace AlphaShadow
       private IVssBackupComponents m_backupComponents;
       private bool m_duringRestore;
       private List<VssWriterDescriptor> m_writers;
+      private Dictionary<Guid, VssWriterDescriptor> m_writersByInstanceId;
       private Guid m_latestSnapshotSetId;
       private IList<string> m_latestVolumeList;
       private List<Guid> m_latestSnapshotIdList = new List<Guid>();
@@ -100,19 +101,21 @@ namespace AlphaShadow
          else
             Host.WriteLine("- Querying all shadow copies with the SnapshotSetID {0:B}...", snapshotSetId);
 
-         Host.WriteVerbose("- Calling IVssBackupComponents.QuerySnapshots()");
-         IEnumerable<VssSnapshotProperties> snapshots = m_backupComponents.QuerySnapshots();
+         VssSnapshotFilter filter = new VssSnapshotFilter();
+         if (snapshotSetId != Guid.Empty)
+            filter.SnapshotSetId = snapshotSetId;
 
-         if (!snapshots.Any())
-            Host.WriteHeader("There are no snapshots in the system.");
+         Host.WriteVerbose("- Calling IVssBackupComponents.EnumerateSnapshots()");
+         bool foundAny = false;
 
-         foreach (VssSnapshotProperties props in snapshots)
+         foreach (VssSnapshotProperties props in m_backupComponents.EnumerateSnapshots(filter))
          {
-            if (snapshotSetId == Guid.Empty || props.SnapshotSetId == snapshotSetId)
-            {
-               PrintSnapshotProperties(props);
-            }
+            foundAny = true;
+            PrintSnapshotProperties(props);
          }
+
+         if (!foundAny)
+            Host.WriteHeader("There are no snapshots in the system.");
       }
 
       public void GetSnapshotProperties(Guid snapshotId)
@@ -174,7 +177,10 @@ namespace AlphaShadow
       {
          Host.WriteLine("Saving the backup components document ... ");
          
-         File.WriteAllText(outputXmlFile, m_backupComponents.SaveAsXml(), Encoding.Unicode);
+         using (FileStream stream = new FileStream(outputXmlFile, FileMode.Create, FileAccess.Write))
+         {
+            m_backupComponents.SaveAsXml(stream, VssXmlStreamFormat.Unicode);
+         }
       }
 
       private void DoSnapshotSet()
@@ -215,7 +221,7 @@ namespace AlphaShadow
 
          // Gets the number of writers in the gathered status info
          // (WARNING: GatherWriterStatus must be called before)
-         foreach (VssWriterStatusInfo writer in m_backupComponents.WriterStatus)
+         foreach (VssWriterStatusInfo writer in m_backupComponents.QueryWriterStatus())
          {
             if (!IsWriterSelected(writer.InstanceId))
                continue;
@@ -260,7 +266,8 @@ namespace AlphaShadow
 
       private bool IsWriterSelected(Guid guid)
       {
-         return m_writers.Any(writer => writer.WriterMetadata.InstanceId == guid && !writer.IsExcluded);
+         VssWriterDescriptor writer;
+         return m_writersByInstanceId.TryGetValue(guid, out writer) && !writer.IsExcluded;
       }
 
       private void AddToSnapshotSet(IEnumerable<string> volumeList)
@@ -334,40 +341,45 @@ namespace AlphaShadow
          foreach (VssWriterDescriptor writer in writerList.Where(w => !w.IsExcluded))
          {
             // Find the associated component
-            foreach (VssComponentDescriptor component in writer.ComponentDescriptors.Where(c => !c.IsExcluded))
+            string fullPath;
+            if (include.StartsWith(writer.WriterMetadata.WriterName + ":", StringComparison.Ordinal))
+               fullPath = include.Substring(writer.WriterMetadata.WriterName.Length + 1);
+            else if (include.StartsWith(writer.WriterMetadata.WriterId.ToString("B") + ":", StringComparison.OrdinalIgnoreCase) ||
+                     include.StartsWith(writer.WriterMetadata.InstanceId.ToString("B") + ":", StringComparison.OrdinalIgnoreCase))
+               fullPath = include.Substring(include.IndexOf(':') + 1);
+            else
+               continue;
+
+            VssComponentDescriptor component = writer.ComponentTree.Find(fullPath);
+            if (component != null && !component.IsExcluded)
             {
-               if (include.Equals(writer.WriterMetadata.WriterName + ":" + component.FullPath) ||
-                   include.Equals(writer.WriterMetadata.WriterId.ToString("B") + ":" + component.FullPath, StringComparison.OrdinalIgnoreCase) ||
-                   include.Equals(writer.WriterMetadata.InstanceId.ToString("B") + ":" + component.FullPath, StringComparison.OrdinalIgnoreCase))
-               {
-                  Host.WriteVerbose("- Found component '{0}' from writer '{1}.", component.FullPath, writer.WriterMetadata.WriterName);
+               Host.WriteVerbose("- Found component '{0}' from writer '{1}.", component.FullPath, writer.WriterMetadata.WriterName);
 
-                  // If we are during restore, we just found our component
-                  if (m_duringRestore)
-                  {
-                     Host.WriteLine(" - The component \"{0}\" is selected.", include);
-                     return;
-                  }
+               // If we are during restore, we just found our component
+               if (m_duringRestore)
+               {
+                  Host.WriteLine(" - The component \"{0}\" is selected.", include);
+                  return;
+               }
 
-                  // If not explicitly included, check to see if there is an explicitly included ancestor
-                  bool isIncluded = component.IsExplicitlyIncluded;
-                  if (!isIncluded)
-                  {
-                     isIncluded = writer.ComponentDescriptors.Any(ancestor => ancestor.IsAncestorOf(component) && ancestor.IsExplicitlyIncluded);
-                  }
+               // If not explicitly included, check to see if there is an explicitly included ancestor
+               bool isIncluded = component.IsExplicitlyIncluded;
+               if (!isIncluded)
+               {
+                  isIncluded = writer.ComponentTree.GetAncestors(component).Any(ancestor => ancestor.IsExplicitlyIncluded);
+               }
 
-                  if (isIncluded)
-                  {
-                     Host.WriteLine(" - The component \"{0}\" is selected.", include);
-                     return;
-                  }
-                  else
-                  {
-                     Host.WriteError("The component \"{0}\" was not included in the backup! Aborting backup...", include);
-                     Host.WriteError("- Please reveiw the component/subcomponent definitions");
-                     Host.WriteError("- Also, please verify list of volumes to be shadow copied.");
-                     throw new CommandAbortedException();
-                  }
+               if (isIncluded)
+               {
+                  Host.WriteLine(" - The component \"{0}\" is selected.", include);
+                  return;
+               }
+               else
+               {
+                  Host.WriteError("The component \"{0}\" was not included in the backup! Aborting backup...", include);
+                  Host.WriteError("- Please reveiw the component/subcomponent definitions");
+                  Host.WriteError("- Also, please verify list of volumes to be shadow copied.");
+                  throw new CommandAbortedException();
                }
             }
          }
@@ -421,11 +433,19 @@ namespace AlphaShadow
          // Enumerate all writers
          foreach (VssWriterDescriptor writer in m_writers.Where(w => w.IsExcluded == false))
          {
-            foreach (VssComponentDescriptor component in writer.ComponentDescriptors.Where(c => c.CanBeExplicitlyIncluded))
+            // Visit the components in pre-order, so that the ancestors of each component have been visited before it.
+            HashSet<VssComponentDescriptor> coveredByAncestor = new HashSet<VssComponentDescriptor>();
+            foreach (VssComponentDescriptor component in writer.ComponentTree.PreOrder)
             {
+               VssComponentDescriptor parent = writer.ComponentTree.GetParent(component);
+               bool hasIncludedAncestor = parent != null && (parent.CanBeExplicitlyIncluded || coveredByAncestor.Contains(parent));
+               if (hasIncludedAncestor)
+                  coveredByAncestor.Add(component);
+
                // Test if our component has a parent that is also included
                // If so this cannot be explicitely included since we have another ancestor that that must be (implictely or explicitely) included
-               component.IsExplicitlyIncluded = !writer.ComponentDescriptors.Any(ancestor => ancestor.IsAncestorOf(component) && ancestor.CanBeExplicitlyIncluded);
+               if (component.CanBeExplicitlyIncluded)
+                  component.IsExplicitlyIncluded = !hasIncludedAncestor;
             }
          }
       }
@@ -474,19 +494,23 @@ namespace AlphaShadow
          // volumes not in the shadow set. 
          foreach (VssWriterDescriptor writer in m_writers.Where(w => w.IsExcluded == false))
          {
-            // Enumerate all components
-            foreach (VssComponentDescriptor component in writer.ComponentDescriptors)
+            // Enumerate all components in reverse pre-order, so that all descendents of each component
+            // have been visited before it. A component with an excluded child then has an excluded
+            // descendent, and vice versa.
+            IList<VssComponentDescriptor> components = writer.ComponentTree.PreOrder;
+            for (int i = components.Count - 1; i >= 0; i--)
             {
+               VssComponentDescriptor component = components[i];
+               if (component.IsExcluded)
+                  continue;
+
                // Check if this component has any excluded children
                // If yes, deselect it
-               foreach (VssComponentDescriptor descendent in writer.ComponentDescriptors)
+               VssComponentDescriptor descendent = writer.ComponentTree.GetChildren(component).FirstOrDefault(child => child.IsExcluded);
+               if (descendent != null)
                {
-                  if (component.IsAncestorOf(descendent) && descendent.IsExcluded)
-                  {
-                     Host.WriteLine("- Component '{0}' from writer '{1} is excluded from backup (it has an excluded descendent: '{2}').", component.FullPath, writer.WriterMetadata.WriterName, descendent.WriterName);
-                     component.IsExcluded = true;
-                     break;
-                  }
+                  Host.WriteLine("- Component '{0}' from writer '{1} is excluded from backup (it has an excluded descendent: '{2}').", component.FullPath, writer.WriterMetadata.WriterName, descendent.FullPath);
+                  component.IsExcluded = true;
                }
             }
          }
@@ -557,15 +581,18 @@ namespace AlphaShadow
       {
          Host.WriteLine("Discover directly excluded components...");
 
+         HashSet<string> excludedNames = new HashSet<string>(excludedWriterAndComponentList);
+         HashSet<string> excludedIds = new HashSet<string>(excludedWriterAndComponentList, StringComparer.OrdinalIgnoreCase);
+
          // Discover components that should be excluded from the shadow set 
          // This means components that have at least one File Descriptor requiring 
          // volumes not in the shadow set. 
          foreach (var writer in writerList)
          {
             // Check if the writer is excluded
-            if (excludedWriterAndComponentList.Contains(writer.WriterMetadata.WriterName) ||
-                excludedWriterAndComponentList.Contains(writer.WriterMetadata.WriterId.ToString("B"), StringComparer.OrdinalIgnoreCase) ||
-                excludedWriterAndComponentList.Contains(writer.WriterMetadata.InstanceId.ToString("B"), StringComparer.OrdinalIgnoreCase))
+            if (excludedNames.Contains(writer.WriterMetadata.WriterName) ||
+                excludedIds.Contains(writer.WriterMetadata.WriterId.ToString("B")) ||
+                excludedIds.Contains(writer.WriterMetadata.InstanceId.ToString("B")))
             {
                writer.IsExcluded = true;
                continue;
@@ -575,9 +602,9 @@ namespace AlphaShadow
             foreach (VssComponentDescriptor component in writer.ComponentDescriptors)
             {
                // Check to see if this component is explicitly excluded
-               if (excludedWriterAndComponentList.Contains(writer.WriterMetadata.WriterName + ":" + component.FullPath) ||
-                   excludedWriterAndComponentList.Contains(writer.WriterMetadata.WriterId + ":" + component.FullPath) ||
-                  excludedWriterAndComponentList.Contains(writer.WriterMetadata.InstanceId + ":" + component.FullPath))
+               if (excludedNames.Contains(writer.WriterMetadata.WriterName + ":" + component.FullPath) ||
+                   excludedNames.Contains(writer.WriterMetadata.WriterId + ":" + component.FullPath) ||
+                   excludedNames.Contains(writer.WriterMetadata.InstanceId + ":" + component.FullPath))
                {
                   Host.WriteLine("- Component '{0}' from writer '{1}' is explicitly excluded from backup.", component.FullPath, writer.WriterMetadata.WriterName);
                   component.IsExcluded = true;
@@ -644,7 +671,7 @@ namespace AlphaShadow
 
          using (var i1 = Host.GetIndent())
          {
-            IList<VssWriterStatusInfo> statusList = m_backupComponents.WriterStatus;
+            IList<VssWriterStatusInfo> statusList = m_backupComponents.QueryWriterStatus();
             Host.WriteLine("Number of writers that responded: {0}", statusList.Count);
 
             using (var i2 = Host.GetIndent())
@@ -668,7 +695,21 @@ namespace AlphaShadow
 
       private void InitializeWriterMetadata()
       {
-         m_writers = new List<VssWriterDescriptor>(m_backupComponents.WriterMetadata.Select(wm => new VssWriterDescriptor(Host, wm)));         
+         DisposeWriterMetadata();
+
+         VssWriterMetadataPrefetchResult prefetch = m_backupComponents.PrefetchWriterMetadata();
+         Host.WriteVerbose("- Retrieved metadata of {0} writers in {1} ms.", prefetch.WriterMetadata.Count, (long)prefetch.Elapsed.TotalMilliseconds);
+         foreach (VssWriterMetadataTiming timing in prefetch.Timings)
+            Host.WriteVerbose("  - {0}: {1} components, {2} files in {3} ms.", timing.WriterName, timing.ComponentCount, timing.FileDescriptorCount, (long)timing.Elapsed.TotalMilliseconds);
+
+         m_writers = new List<VssWriterDescriptor>(prefetch.WriterMetadata.Select(wm => new VssWriterDescriptor(Host, wm)));
+
+         m_writersByInstanceId = new Dictionary<Guid, VssWriterDescriptor>();
+         foreach (VssWriterDescriptor writer in m_writers)
+         {
+            if (!m_writersByInstanceId.ContainsKey(writer.WriterMetadata.InstanceId))
+               m_writersByInstanceId.Add(writer.WriterMetadata.InstanceId, writer);
+         }
       }
       #endregion
 
@@ -719,6 +760,19 @@ namespace AlphaShadow
 
       }
 
+      // The prefetched writer metadata is owned by the caller of PrefetchWriterMetadata.
+      private void DisposeWriterMetadata()
+      {
+         if (m_writers == null)
+            return;
+
+         foreach (VssWriterDescriptor writer in m_writers)
+            writer.WriterMetadata.Dispose();
+
+         m_writers = null;
+         m_writersByInstanceId = null;
+      }
+
       #endregion
 
 
@@ -726,6 +780,8 @@ namespace AlphaShadow
 
       public void Dispose()
       {
+         DisposeWriterMetadata();
+
          if (m_backupComponents != null)
          {
             m_backupComponents.Dispose();
@@ -998,16 +1054,9 @@ namespace AlphaShadow
       internal void DeleteOldestSnapshot(string volume)
       {
          string uniqueVolume = Volume.GetUniqueVolumeNameForPath(Host, volume, false);
-         IList<VssSnapshotProperties> snapshots = m_backupComponents.QuerySnapshots().ToArray();
-
-         if (snapshots.Count == 0)
-         {
-            Host.WriteLine("There are now shadow copies in the system.");
-            return;
-         }
+         VssSnapshotFilter filter = new VssSnapshotFilter() { OriginalVolumeName = uniqueVolume };
 
-         VssSnapshotProperties snapshot = snapshots
-            .Where(snap => snap.OriginalVolumeName.Equals(uniqueVolume, StringComparison.OrdinalIgnoreCase))
+         VssSnapshotProperties snapshot = m_backupComponents.QuerySnapshots(filter)
             .OrderBy(snap => snap.CreationTimestamp).FirstOrDefault();
 
          if (snapshot == null)
@@ -1048,7 +1097,7 @@ namespace AlphaShadow
       private IList<string> GetSnapshotDevices(Guid snapshotSetID)
       {
          List<string> volumes = new List<string>();
-         foreach (VssSnapshotProperties snapshot in m_backupComponents.QuerySnapshots().Where(snap => snap.SnapshotSetId == snapshotSetID))
+         foreach (VssSnapshotProperties snapshot in m_backupComponents.EnumerateSnapshots(new VssSnapshotFilter(snapshotSetID)))
          {
             // Get the snapshot device object name which is a volume guid name for persistent snapshot
             // and a device name for non persistent snapshot.
@@ -27,7 +27,7 @@ namespace SnapshotQuery
 					backup.SetContext(VssSnapshotContext.All);
 				}
 				
-				foreach (VssSnapshotProperties prop in backup.QuerySnapshots())
+				foreach (VssSnapshotProperties prop in backup.EnumerateSnapshots())
 				{
 					Console.WriteLine("Snapshot ID: {0:B}", prop.SnapshotId);
 					Console.WriteLine("Snapshot Set ID: {0:B}", prop.SnapshotSetId);
@@ -256,8 +256,10 @@ namespace VssSample
                   //
                   // If this component is relevant, add it with AddComponent().
 
-                  // (The FileToPathSpecification method below might help with
-                  // some of these steps.)
+                  // (The VssFileSpecificationMatcher class can perform step 3
+                  // for all files of the components at once, and the
+                  // FileToPathSpecification method below might help with
+                  // the other steps.)
                }
             }
          }
@@ -430,9 +432,10 @@ namespace VssSample
       /// converts it to a full path specification - with wildcards.
       /// </summary>
       /// <remarks>
-      /// Using the wildcard-to-regex library found at
-      /// http://www.codeproject.com/KB/string/wildcmp.aspx on the
-      /// output of this method might be very helpful.
+      /// To test whether files are managed by a component, it is easier
+      /// and much faster to create a VssFileSpecificationMatcher from the
+      /// component's file descriptors than to match the output of this
+      /// method using regular expressions.
       /// </remarks>
       /// <param name="file">Object describing a component's file.</param>
       /// <returns>